@@ -0,0 +1,149 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+
+#ifndef ABEL_ATOMIC_MPMC_RING_H_
+#define ABEL_ATOMIC_MPMC_RING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "abel/base/profile.h"
+
+namespace abel {
+
+// Bounded multi-producer multi-consumer FIFO queue (Dmitry Vyukov's
+// algorithm), lock-free on both sides.
+//
+// Each slot carries a sequence number telling whether it's ready to be
+// written by a producer or read by a consumer. Producers (and consumers) only
+// contend on a single CAS of the enqueue (dequeue) position.
+//
+// Capacity is rounded up to a power of 2.
+template<typename T>
+class mpmc_ring {
+  public:
+    explicit mpmc_ring(size_t capacity)
+            : _mask(round_up_capacity(capacity) - 1),
+              _cells(new cell[_mask + 1]) {
+        for (size_t i = 0; i != _mask + 1; ++i) {
+            _cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~mpmc_ring() {
+        auto end = _enqueue_pos.load(std::memory_order_relaxed);
+        for (auto pos = _dequeue_pos.load(std::memory_order_relaxed); pos != end; ++pos) {
+            reinterpret_cast<T *>(&_cells[pos & _mask].storage)->~T();
+        }
+    }
+
+    mpmc_ring(const mpmc_ring &) = delete;
+
+    mpmc_ring &operator=(const mpmc_ring &) = delete;
+
+    // Returns false if the ring is full, `args` are not touched in this case.
+    template<typename... Args>
+    bool try_emplace(Args &&... args) {
+        cell *c;
+        size_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            c = &_cells[pos & _mask];
+            size_t seq = c->seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (_enqueue_pos.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Full.
+            } else {
+                pos = _enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        new(&c->storage) T(std::forward<Args>(args)...);
+        c->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // `value` is moved from only if it's pushed.
+    bool try_push(T &&value) { return try_emplace(std::move(value)); }
+
+    bool try_push(const T &value) { return try_emplace(value); }
+
+    // Returns false if the ring is empty.
+    bool try_pop(T *value) {
+        cell *c;
+        size_t pos = _dequeue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            c = &_cells[pos & _mask];
+            size_t seq = c->seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (_dequeue_pos.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Empty.
+            } else {
+                pos = _dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        auto item = reinterpret_cast<T *>(&c->storage);
+        *value = std::move(*item);
+        item->~T();
+        c->seq.store(pos + _mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Pops up to `max_items` items into `values`. Returns number of items
+    // popped.
+    size_t try_pop_bulk(T *values, size_t max_items) {
+        size_t popped = 0;
+        while (popped != max_items && try_pop(&values[popped])) {
+            ++popped;
+        }
+        return popped;
+    }
+
+    // Only accurate if no one else is touching the ring.
+    size_t size_approx() const noexcept {
+        auto enqueued = _enqueue_pos.load(std::memory_order_relaxed);
+        auto dequeued = _dequeue_pos.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    size_t capacity() const noexcept { return _mask + 1; }
+
+  private:
+    struct cell {
+        std::atomic<size_t> seq;
+        std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+    };
+
+    static size_t round_up_capacity(size_t capacity) {
+        size_t rc = 2;
+        while (rc < capacity) {
+            rc <<= 1;
+        }
+        return rc;
+    }
+
+  private:
+    const size_t _mask;
+    std::unique_ptr<cell[]> _cells;
+    // Producers and consumers don't share cache line with each other.
+    alignas(hardware_destructive_interference_size) std::atomic<size_t> _enqueue_pos{0};
+    alignas(hardware_destructive_interference_size) std::atomic<size_t> _dequeue_pos{0};
+};
+
+}  // namespace abel
+
+#endif  // ABEL_ATOMIC_MPMC_RING_H_
@@ -62,7 +62,8 @@ namespace abel {
         // FIXME: The fiber's stack is allocated on caller's NUMA node, it would be
         // beneficial if we can allocate if from the scheduling group it will run in.
         auto fiber =
-                fiber_internal::create_fiber_entity(sg, attr.system_fiber, std::move(start));
+                fiber_internal::create_fiber_entity(sg, attr.system_fiber, std::move(start),
+                                                    attr.stack_class);
         fiber->scheduling_group_local = attr.scheduling_group_local;
 
         // If `join()` is called, we'll sleep on this.
@@ -129,7 +130,8 @@ namespace abel {
             }
 
             auto fiber = fiber_internal::create_fiber_entity(sg, attrs.system_fiber,
-                                                             std::move(start_proc));
+                                                             std::move(start_proc),
+                                                             attrs.stack_class);
             fiber->scheduling_group_local = attrs.scheduling_group_local;
 
             if (attrs.launch_policy == fiber_internal::Launch::Post) {
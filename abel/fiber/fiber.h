@@ -10,6 +10,7 @@
 #include <utility>
 #include <vector>
 
+#include "abel/fiber/fiber_config.h"
 #include "abel/functional/function.h"
 #include "abel/memory/ref_ptr.h"
 
@@ -68,6 +69,12 @@ namespace abel {
             // on this fiber.)
             bool scheduling_group_local = false;
 
+            // Size class of fiber's stack. Use `eSmall` for massive number of
+            // lightweight fibers, and `eLarge` for fibers with deep call chains.
+            //
+            // Ignored for system fiber.
+            fiber_stack_class stack_class = fiber_stack_class::eNormal;
+
             // TODO(yinbinli): `bool start_in_detached_fashion`. If set, the fiber is
             // immediately detached once created. This provide us further optimization
             // possibility.
@@ -0,0 +1,61 @@
+//
+// Created by liyinbin on 2021/5/8.
+//
+
+#include "abel/fiber/fiber_channel.h"
+
+#include "abel/container/inlined_vector.h"
+
+namespace abel {
+
+    void fiber_channel_base::close() noexcept {
+        closed_.store(true, std::memory_order_release);
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    std::ptrdiff_t fiber_select(std::initializer_list<fiber_select_case> cases,
+                                abel::time_point expires_at) {
+        DCHECK(fiber_internal::is_fiber_context_present());
+
+        auto find_ready = [&]() -> std::ptrdiff_t {
+            std::ptrdiff_t index = 0;
+            for (auto &&e : cases) {
+                if (e.send ? e.channel->unsafe_sendable() : e.channel->unsafe_receivable()) {
+                    return index;
+                }
+                ++index;
+            }
+            return -1;
+        };
+
+        abel::inlined_vector<fiber_internal::event_count *, 8> events;
+        abel::inlined_vector<std::uint64_t, 8> keys;
+        for (auto &&e : cases) {
+            events.push_back(e.send ? &e.channel->not_full_ : &e.channel->not_empty_);
+        }
+
+        while (true) {
+            if (auto index = find_ready(); index != -1) {
+                return index;
+            }
+            keys.clear();
+            for (auto &&e : events) {
+                keys.push_back(e->prepare_wait());
+            }
+            // Re-check after `prepare_wait()`, as in `fiber_channel<T>`.
+            if (auto index = find_ready(); index != -1) {
+                for (auto &&e : events) {
+                    e->cancel_wait();
+                }
+                return index;
+            }
+            fiber_internal::event_count::wait_any(events.data(), keys.data(), events.size(),
+                                                  expires_at);
+            if (abel::time_now() >= expires_at) {
+                return find_ready();
+            }
+        }
+    }
+
+}  // namespace abel
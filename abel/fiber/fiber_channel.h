@@ -0,0 +1,386 @@
+//
+// Created by liyinbin on 2021/5/8.
+//
+
+#ifndef ABEL_FIBER_FIBER_CHANNEL_H_
+#define ABEL_FIBER_FIBER_CHANNEL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+
+#include "abel/base/profile.h"
+#include "abel/chrono/clock.h"
+#include "abel/fiber/internal/waitable.h"
+#include "abel/log/logging.h"
+
+namespace abel {
+
+    struct fiber_select_case;
+
+    // Type-independent part of `fiber_channel<T>`. It's what `fiber_select` works
+    // on.
+    class fiber_channel_base {
+    public:
+        // Close the channel. Blocking senders / receivers are woken up.
+        //
+        // Further sends fail. Values already in the channel can still be received,
+        // after which receives fail.
+        //
+        // Values sent concurrently with this call may or may not be accepted. If
+        // they're accepted after all receivers have given up, they're destroyed with
+        // the channel.
+        //
+        // It's explicitly allowed to call this method outside of fiber context.
+        void close() noexcept;
+
+        bool closed() const noexcept { return closed_.load(std::memory_order_acquire); }
+
+        // Test if there's a value to receive, or the channel is closed. Note that the
+        // result can be outdated as soon as it's returned.
+        bool unsafe_receivable() const noexcept { return closed() || has_value(); }
+
+        // Test if there's room for sending, or the channel is closed.
+        bool unsafe_sendable() const noexcept { return closed() || has_room(); }
+
+        // Non-copyable, non-movable.
+        fiber_channel_base(const fiber_channel_base &) = delete;
+
+        fiber_channel_base &operator=(const fiber_channel_base &) = delete;
+
+    protected:
+        fiber_channel_base() = default;
+
+        ~fiber_channel_base() = default;
+
+        virtual bool has_value() const noexcept = 0;
+
+        virtual bool has_room() const noexcept = 0;
+
+    protected:
+        friend std::ptrdiff_t fiber_select(std::initializer_list<fiber_select_case>,
+                                           abel::time_point);
+
+        // Receivers wait on `not_empty_`, senders wait on `not_full_`.
+        fiber_internal::event_count not_empty_;
+        fiber_internal::event_count not_full_;
+        std::atomic<bool> closed_{false};
+    };
+
+    // A bounded MPMC channel for passing values between fibers.
+    //
+    // Values are passed through a lock-free ring buffer (as in `run_queue`), the
+    // caller only blocks (and only the calling fiber, not the underlying pthread)
+    // if the channel is full (on sending) or empty (on receiving).
+    //
+    // Blocking methods may only be called in fiber context. `try_xxx` can be
+    // called anywhere.
+    template<class T>
+    class fiber_channel : public fiber_channel_base {
+    public:
+        // `capacity` is rounded up to a power of 2 (and at least 2).
+        explicit fiber_channel(std::size_t capacity);
+
+        ~fiber_channel();
+
+        // Send `value`, blocking while the channel is full.
+        //
+        // Returns `false` if the channel is closed, `value` is left untouched then.
+        template<class U = T>
+        bool send(U &&value);
+
+        // Send `value` if there's room in the channel. Returns `false` if the
+        // channel is full or closed, `value` is left untouched then.
+        template<class U = T>
+        bool try_send(U &&value);
+
+        // Send `[first, last)` (`*first` is sent as is, pass move iterators if
+        // moving is desired), blocking while the channel is full.
+        //
+        // Returns number of values sent. This is less than `last - first` only if
+        // the channel is closed.
+        //
+        // Receivers are woken up in batch, which is much cheaper than calling
+        // `send` in a loop.
+        template<class Iter>
+        std::size_t send_batch(Iter first, Iter last);
+
+        // Receive a value, blocking while the channel is empty.
+        //
+        // Returns `std::nullopt` if the channel is closed and drained.
+        std::optional<T> receive();
+
+        // Receive a value if there's one.
+        std::optional<T> try_receive();
+
+        // Receive at most `max` values into `out`, blocking until there's at least
+        // one.
+        //
+        // Returns number of values received. Returns 0 only if the channel is closed
+        // and drained.
+        template<class OutputIter>
+        std::size_t receive_batch(OutputIter out, std::size_t max);
+
+        std::size_t capacity() const noexcept { return mask_ + 1; }
+
+    protected:
+        bool has_value() const noexcept override;
+
+        bool has_room() const noexcept override;
+
+    private:
+        struct cell {
+            std::atomic<std::size_t> seq;
+            alignas(T) unsigned char storage[sizeof(T)];
+
+            T *get() noexcept { return std::launder(reinterpret_cast<T *>(storage)); }
+        };
+
+        template<class U>
+        bool push(U &&value);
+
+        std::optional<T> pop();
+
+        // Block until `ready()` holds, or the channel is closed.
+        template<class F>
+        void wait_until_ready(fiber_internal::event_count *event, F &&ready);
+
+    private:
+        std::size_t mask_;
+        std::unique_ptr<cell[]> cells_;
+        alignas(hardware_destructive_interference_size) std::atomic<std::size_t> head_{0};
+        alignas(hardware_destructive_interference_size) std::atomic<std::size_t> tail_{0};
+    };
+
+    // A case of `fiber_select`, created by `select_receive` / `select_send`.
+    struct fiber_select_case {
+        fiber_channel_base *channel;
+        bool send;
+    };
+
+    // Wait for receiving from `channel`.
+    inline fiber_select_case select_receive(fiber_channel_base &channel) {
+        return fiber_select_case{&channel, false};
+    }
+
+    // Wait for sending to `channel`.
+    inline fiber_select_case select_send(fiber_channel_base &channel) {
+        return fiber_select_case{&channel, true};
+    }
+
+    // Wait until any of `cases` is ready, or `expires_at` is reached. A channel
+    // that is closed is always treated as ready.
+    //
+    // Returns index of the ready case, or -1 on timeout.
+    //
+    // Other fibers can race with the caller, so the subsequent `try_receive` /
+    // `try_send` may still fail. e.g.:
+    //
+    //   while (true) {
+    //     auto index = fiber_select({select_receive(ch1), select_receive(ch2)});
+    //     if (index == 0 && (v1 = ch1.try_receive())) { ... }
+    //     ...
+    //   }
+    //
+    // May only be called in fiber context.
+    std::ptrdiff_t fiber_select(std::initializer_list<fiber_select_case> cases,
+                                abel::time_point expires_at = abel::time_point::infinite_future());
+
+    inline std::ptrdiff_t fiber_select(std::initializer_list<fiber_select_case> cases,
+                                       abel::duration expires_in) {
+        return fiber_select(cases, abel::time_now() + expires_in);
+    }
+
+    template<class T>
+    fiber_channel<T>::fiber_channel(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        mask_ = size - 1;
+        cells_ = std::make_unique<cell[]>(size);
+        for (std::size_t index = 0; index != size; ++index) {
+            cells_[index].seq.store(index, std::memory_order_relaxed);
+        }
+    }
+
+    template<class T>
+    fiber_channel<T>::~fiber_channel() {
+        while (pop()) {
+            // Destroy values not received.
+        }
+    }
+
+    template<class T>
+    template<class U>
+    bool fiber_channel<T>::send(U &&value) {
+        while (!closed()) {
+            if (push(std::forward<U>(value))) {
+                not_empty_.notify_one();
+                return true;
+            }
+            wait_until_ready(&not_full_, [&] { return has_room(); });
+        }
+        return false;
+    }
+
+    template<class T>
+    template<class U>
+    bool fiber_channel<T>::try_send(U &&value) {
+        if (closed() || !push(std::forward<U>(value))) {
+            return false;
+        }
+        not_empty_.notify_one();
+        return true;
+    }
+
+    template<class T>
+    template<class Iter>
+    std::size_t fiber_channel<T>::send_batch(Iter first, Iter last) {
+        std::size_t sent = 0, pending_notify = 0;
+        while (first != last && !closed()) {
+            if (push(*first)) {
+                ++first;
+                ++sent;
+                ++pending_notify;
+                continue;
+            }
+            // Let receivers drain what we've sent before we sleep.
+            not_empty_.notify(std::exchange(pending_notify, 0));
+            wait_until_ready(&not_full_, [&] { return has_room(); });
+        }
+        not_empty_.notify(pending_notify);
+        return sent;
+    }
+
+    template<class T>
+    std::optional<T> fiber_channel<T>::receive() {
+        while (true) {
+            if (auto rc = pop()) {
+                not_full_.notify_one();
+                return rc;
+            }
+            if (closed()) {
+                // Values sent before the channel was closed are visible now.
+                auto rc = pop();
+                if (rc) {
+                    not_full_.notify_one();
+                }
+                return rc;
+            }
+            wait_until_ready(&not_empty_, [&] { return has_value(); });
+        }
+    }
+
+    template<class T>
+    std::optional<T> fiber_channel<T>::try_receive() {
+        auto rc = pop();
+        if (rc) {
+            not_full_.notify_one();
+        }
+        return rc;
+    }
+
+    template<class T>
+    template<class OutputIter>
+    std::size_t fiber_channel<T>::receive_batch(OutputIter out, std::size_t max) {
+        if (ABEL_UNLIKELY(max == 0)) {
+            return 0;
+        }
+        auto first = receive();
+        if (!first) {
+            return 0;
+        }
+        *out++ = std::move(*first);
+        std::size_t received = 1;
+        while (received != max) {
+            auto rc = pop();
+            if (!rc) {
+                break;
+            }
+            *out++ = std::move(*rc);
+            ++received;
+        }
+        // One of them has been notified by `receive()`.
+        not_full_.notify(received - 1);
+        return received;
+    }
+
+    template<class T>
+    bool fiber_channel<T>::has_value() const noexcept {
+        auto pos = tail_.load(std::memory_order_relaxed);
+        return cells_[pos & mask_].seq.load(std::memory_order_acquire) == pos + 1;
+    }
+
+    template<class T>
+    bool fiber_channel<T>::has_room() const noexcept {
+        auto pos = head_.load(std::memory_order_relaxed);
+        return cells_[pos & mask_].seq.load(std::memory_order_acquire) == pos;
+    }
+
+    template<class T>
+    template<class U>
+    bool fiber_channel<T>::push(U &&value) {
+        auto pos = head_.load(std::memory_order_relaxed);
+        while (true) {
+            auto &&c = cells_[pos & mask_];
+            auto seq = c.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    new(c.storage) T(std::forward<U>(value));
+                    c.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // Full.
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    template<class T>
+    std::optional<T> fiber_channel<T>::pop() {
+        auto pos = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            auto &&c = cells_[pos & mask_];
+            auto seq = c.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    std::optional<T> rc(std::move(*c.get()));
+                    c.get()->~T();
+                    c.seq.store(pos + mask_ + 1, std::memory_order_release);
+                    return rc;
+                }
+            } else if (diff < 0) {
+                return std::nullopt;  // Empty.
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    template<class T>
+    template<class F>
+    void fiber_channel<T>::wait_until_ready(fiber_internal::event_count *event,
+                                            F &&ready) {
+        auto key = event->prepare_wait();
+        // Re-check after `prepare_wait()`, otherwise we'd miss a notification made
+        // before it.
+        if (closed() || ready()) {
+            event->cancel_wait();
+            return;
+        }
+        event->wait(key);
+    }
+
+}  // namespace abel
+
+#endif  // ABEL_FIBER_FIBER_CHANNEL_H_
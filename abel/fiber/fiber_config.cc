@@ -31,8 +31,8 @@ namespace abel {
             auto groups = (concurrency + kMaximumSchedulingGroupSize - 1) /
                           kMaximumSchedulingGroupSize;
             auto group_size = (concurrency + groups - 1) / groups;
-            return fiber_config{.scheduling_groups = groups,
-                    .workers_per_group = group_size,
+            return fiber_config{.workers_per_group = group_size,
+                    .scheduling_groups = groups,
                     .enable_numa_aware = false};
         }
 
@@ -49,8 +49,8 @@ namespace abel {
                                   kMaximumSchedulingGroupSize;
             auto group_size = (per_node + group_per_node - 1) / group_per_node;
             return fiber_config{
-                    .scheduling_groups = group_per_node * numa_domains,
                     .workers_per_group = group_size,
+                    .scheduling_groups = group_per_node * numa_domains,
                     .enable_numa_aware = true};
         }
 
@@ -58,8 +58,8 @@ namespace abel {
                 std::size_t numa_domains, std::size_t concurrency,
                 std::size_t group_size_low, std::size_t group_size_high) {
             if (concurrency <= group_size_low) {
-                return fiber_config{.scheduling_groups = 1,
-                        .workers_per_group = concurrency,
+                return fiber_config{.workers_per_group = concurrency,
+                        .scheduling_groups = 1,
                         .enable_numa_aware = false};
             }
 
@@ -98,9 +98,9 @@ namespace abel {
             }
 
             return fiber_config{
+                    .workers_per_group = best_group_size_so_far,
                     .scheduling_groups =
                     (concurrency + best_group_size_so_far - 1) / best_group_size_so_far,
-                    .workers_per_group = best_group_size_so_far,
                     .enable_numa_aware = numa_aware};
         }
     }  // namespace fiber_internal
@@ -21,6 +21,13 @@ namespace abel {
         eIoHeavy
     };
 
+    // Stack size class of user fibers, @sa: `fiber::attributes::stack_class`.
+    enum class fiber_stack_class {
+        eSmall,   // `fiber_small_stack_size`.
+        eNormal,  // `fiber_stack_size`.
+        eLarge    // `fiber_large_stack_size`.
+    };
+
     struct fiber_config {
 
         size_t workers_per_group{4};
@@ -35,8 +42,22 @@ namespace abel {
 
         size_t fiber_stack_size{131072};
 
+        // Stack sizes of fibers created with `fiber_stack_class::eSmall` /
+        // `fiber_stack_class::eLarge`. Must be multiples of page size.
+        size_t fiber_small_stack_size{32768};
+
+        size_t fiber_large_stack_size{1048576};
+
         bool fiber_stack_enable_guard_page{true};
 
+        // When a stack is recycled, pages deeper than this many bytes (counting from
+        // stack bottom) that were used are returned to the system. 0 disables it.
+        size_t fiber_stack_release_watermark{65536};
+
+        // Sample one in every so many fiber stacks for the maximum stack usage of
+        // the fiber, @sa: `fiber_internal::get_stack_usage_samples`. 0 disables it.
+        size_t fiber_stack_usage_sampling_rate{0};
+
         std::string fiber_worker_accessible_cpus{""};
 
         std::string fiber_worker_inaccessible_cpus{""};
@@ -51,6 +72,29 @@ namespace abel {
 
         size_t fiber_run_queue_size{65536};
 
+        // Capacity of each fiber worker's local queue, must be a power of 2. Fibers
+        // woken up by a fiber are put in the local queue of the worker running it,
+        // instead of the run queue shared by the scheduling group. 0 disables it.
+        size_t fiber_local_queue_size{256};
+
+        // Keep timers in a hierarchical timing wheel instead of a binary heap. This
+        // makes arming / cancelling timers O(1), at the cost of rounding expiration
+        // time up to `fiber_timer_wheel_tick_us`.
+        bool fiber_timer_timing_wheel{false};
+
+        size_t fiber_timer_wheel_tick_us{1000};
+
+        // Create an io_uring instance per scheduling group, which is used by
+        // `uring_io_stream`. Ignored if io_uring is not usable on this system.
+        bool fiber_enable_io_uring{false};
+
+        // Size of the io_uring submission queue.
+        size_t fiber_io_uring_entries{1024};
+
+        // Number of 16K blocks registered to each io_uring instance as fixed
+        // buffers. 0 disables it.
+        size_t fiber_io_uring_registered_blocks{256};
+
         std::shared_ptr<abel::core_affinity::affinity_policy> policy;
 
         fiber_config &set_worker_num(uint32_t n);
@@ -0,0 +1,89 @@
+//
+// Created by liyinbin on 2021/5/8.
+//
+
+#include "abel/fiber/fiber_io.h"
+
+#include <errno.h>
+
+#include "abel/log/logging.h"
+#include "abel/fiber/internal/event_poller.h"
+#include "abel/fiber/internal/scheduling_group.h"
+#include "abel/fiber/runtime.h"
+
+namespace abel {
+
+    fiber_io_descriptor::fiber_io_descriptor(int fd)
+            : fd_(fd), impl_(make_ref_counted<fiber_internal::io_descriptor>(fd)) {
+        auto sg = fiber_internal::nearest_scheduling_group();
+        DCHECK(sg, "Fiber runtime is not started yet.");
+        poller_ = sg->get_event_poller();
+        DCHECK(poller_, "Event poller is not available on this platform.");
+        if (!poller_->add_descriptor(impl_.get())) {
+            error_ = errno;
+            DLOG_ERROR("Failed to register fd #{} to event poller: {}", fd, error_);
+        }
+    }
+
+    fiber_io_descriptor::~fiber_io_descriptor() {
+        // The poller holds no reference to a descriptor it never took.
+        if (error_ == 0) {
+            poller_->remove_descriptor(impl_.get());
+        }
+    }
+
+    void fiber_io_descriptor::wait_readable() {
+        if (error_ == 0) {
+            impl_->wait_readable();
+        }
+    }
+
+    void fiber_io_descriptor::wait_writable() {
+        if (error_ == 0) {
+            impl_->wait_writable();
+        }
+    }
+
+    read_status fiber_read_iobuf(std::size_t max_bytes, fiber_io_descriptor *desc,
+                                 io_stream_base *io, iobuf *to,
+                                 std::size_t *bytes_read) {
+        while (true) {
+            auto rc = read_iobuf(max_bytes, io, to, bytes_read);
+            if (rc != read_status::eDrained || *bytes_read != 0) {
+                return rc;
+            }
+            // Nothing was read, wait until something arrives.
+            desc->wait_readable();
+        }
+    }
+
+    ssize_t fiber_flush_iobuf_list(write_iobuf_list *list, fiber_io_descriptor *desc,
+                                   io_stream_base *io, std::size_t max_bytes,
+                                   std::vector<std::uintptr_t> *flushed_ctxs,
+                                   bool *emptied) {
+        std::size_t written = 0;
+        *emptied = false;
+        while (written != max_bytes) {
+            bool short_write = false;
+            auto rc = list->flush(io, max_bytes - written, flushed_ctxs, emptied,
+                                  &short_write);
+            if (rc > 0) {
+                written += rc;
+                if (*emptied) {
+                    break;
+                }
+                continue;
+            }
+            if (rc < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                desc->wait_writable();
+                continue;
+            }
+            if (rc < 0) {
+                return -1;
+            }
+            break;  // Nothing can be written, but no error is reported either.
+        }
+        return written;
+    }
+
+}  // namespace abel
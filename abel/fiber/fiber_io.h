@@ -0,0 +1,96 @@
+//
+// Created by liyinbin on 2021/5/8.
+//
+
+#ifndef ABEL_FIBER_FIBER_IO_H_
+#define ABEL_FIBER_FIBER_IO_H_
+
+#include <sys/types.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "abel/io/io_stream.h"
+#include "abel/io/iobuf.h"
+#include "abel/io/read_iobuf.h"
+#include "abel/io/write_iobuf_list.h"
+#include "abel/memory/ref_ptr.h"
+
+namespace abel {
+
+    namespace fiber_internal {
+
+        class event_poller;
+
+        class io_descriptor;
+
+    }  // namespace fiber_internal
+
+    // Registers a (non-blocking) file descriptor to the event poller of the
+    // nearest scheduling group, so that fibers can wait for its readiness without
+    // blocking the underlying pthread worker.
+    //
+    // Ownership of the file descriptor is NOT taken. The descriptor must be kept
+    // open until this object is destroyed, and no fiber may be waiting on it by
+    // then.
+    class fiber_io_descriptor {
+    public:
+        explicit fiber_io_descriptor(int fd);
+
+        ~fiber_io_descriptor();
+
+        int fd() const noexcept { return fd_; }
+
+        // `errno` of the failed registration of `fd()` to the event poller, 0 if
+        // it's registered. Regular files, for example, are refused (`EPERM`).
+        //
+        // Waiting on a descriptor that is not registered returns immediately.
+        int error() const noexcept { return error_; }
+
+        // Block the calling fiber until `fd()` becomes readable.
+        //
+        // This method can return spuriously. Always retry your I/O and wait again
+        // on `EAGAIN`.
+        void wait_readable();
+
+        // Block the calling fiber until `fd()` becomes writable.
+        //
+        // This method can return spuriously as well.
+        void wait_writable();
+
+        // Noncopyable, nonmovable.
+        fiber_io_descriptor(const fiber_io_descriptor &) = delete;
+
+        fiber_io_descriptor &operator=(const fiber_io_descriptor &) = delete;
+
+    private:
+        const int fd_;
+        fiber_internal::event_poller *poller_;
+        int error_ = 0;
+        ref_ptr<fiber_internal::io_descriptor> impl_;
+    };
+
+    // Same as `read_iobuf`, except that if nothing can be read, the calling fiber
+    // is blocked until `desc` becomes readable.
+    //
+    // `read_status::eDrained` is only returned if at least one byte is read.
+    read_status fiber_read_iobuf(std::size_t max_bytes, fiber_io_descriptor *desc,
+                                 io_stream_base *io, iobuf *to,
+                                 std::size_t *bytes_read);
+
+    // Flush `list` into `io` until either `list` is emptied or `max_bytes` is
+    // written. The calling fiber is blocked whenever `desc` is not writable.
+    //
+    // Returns bytes written. On error, -1 is returned and `errno` is set. Contexts
+    // of buffers fully written are appended to `flushed_ctxs` in either case.
+    //
+    // `list` may not be empty.
+    ssize_t fiber_flush_iobuf_list(write_iobuf_list *list, fiber_io_descriptor *desc,
+                                   io_stream_base *io, std::size_t max_bytes,
+                                   std::vector<std::uintptr_t> *flushed_ctxs,
+                                   bool *emptied);
+
+}  // namespace abel
+
+#endif  // ABEL_FIBER_FIBER_IO_H_
@@ -0,0 +1,99 @@
+//
+// Created by liyinbin on 2021/5/8.
+//
+
+#include "abel/fiber/fiber_shared_mutex.h"
+
+#include <mutex>
+
+#include "abel/log/logging.h"
+
+namespace abel {
+
+    void fiber_shared_mutex::lock() {
+        DCHECK(fiber_internal::is_fiber_context_present());
+
+        writer_lock_.lock();
+
+        // Announce us to the readers, new readers are blocked from now on.
+        auto active = readers_.fetch_sub(kMaxReaders, std::memory_order_acquire);
+        DCHECK_GE(active, 0);
+
+        // Wait for active readers to leave.
+        if (active != 0 &&
+            departing_.fetch_add(active, std::memory_order_acq_rel) + active != 0) {
+            std::unique_lock lk(slow_path_lock_);
+            writer_cv_.wait(lk, [&] { return writer_ready_; });
+            writer_ready_ = false;
+        }
+    }
+
+    bool fiber_shared_mutex::try_lock() {
+        DCHECK(fiber_internal::is_fiber_context_present());
+
+        if (!writer_lock_.try_lock()) {
+            return false;
+        }
+        std::int32_t expected = 0;
+        if (readers_.compare_exchange_strong(expected, -kMaxReaders,
+                                             std::memory_order_acquire)) {
+            return true;
+        }
+        writer_lock_.unlock();
+        return false;
+    }
+
+    void fiber_shared_mutex::unlock() {
+        DCHECK(fiber_internal::is_fiber_context_present());
+
+        {
+            // Readers blocked by us were counted in `readers_`, each of them is granted
+            // a token. This is done with `slow_path_lock_` held, so that a reader who
+            // times out either gets its token, or is not counted here.
+            std::scoped_lock _(slow_path_lock_);
+            auto blocked = readers_.fetch_add(kMaxReaders, std::memory_order_release) +
+                           kMaxReaders;
+            DCHECK_GE(blocked, 0);
+            if (blocked) {
+                reader_tokens_ += blocked;
+                reader_cv_.notify_all();
+            }
+        }
+        writer_lock_.unlock();
+    }
+
+    bool fiber_shared_mutex::try_lock_shared() {
+        auto r = readers_.load(std::memory_order_relaxed);
+        while (r >= 0) {
+            if (readers_.compare_exchange_weak(r, r + 1, std::memory_order_acquire,
+                                               std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool fiber_shared_mutex::lock_shared_slow(abel::time_point expires_at) {
+        DCHECK(fiber_internal::is_fiber_context_present());
+
+        std::unique_lock lk(slow_path_lock_);
+        if (reader_cv_.wait_until(lk, expires_at, [&] { return reader_tokens_ != 0; })) {
+            --reader_tokens_;
+            return true;
+        }
+        // Timed out. We're still counted in `readers_`, take us out before the writer
+        // grants us a token in `unlock()` (which needs `slow_path_lock_`).
+        readers_.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    void fiber_shared_mutex::unlock_shared_slow() {
+        // A writer is waiting. Wake it up if we're the last one it's waiting for.
+        if (departing_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::scoped_lock _(slow_path_lock_);
+            writer_ready_ = true;
+            writer_cv_.notify_one();
+        }
+    }
+
+}  // namespace abel
@@ -0,0 +1,94 @@
+//
+// Created by liyinbin on 2021/5/8.
+//
+
+#ifndef ABEL_FIBER_FIBER_SHARED_MUTEX_H_
+#define ABEL_FIBER_FIBER_SHARED_MUTEX_H_
+
+#include <atomic>
+#include <cstdint>
+
+#include "abel/base/profile.h"
+#include "abel/chrono/clock.h"
+#include "abel/fiber/internal/waitable.h"
+
+namespace abel {
+
+    // Analogous to `std::shared_mutex`, but it's for fiber.
+    //
+    // Acquiring / releasing the lock in shared mode costs a single atomic add if
+    // there's no writer around. Once a writer is waiting for the lock, new readers
+    // are blocked until the writer is done, so writers won't starve.
+    //
+    // This class is not recursive, in either mode.
+    class fiber_shared_mutex {
+    public:
+        // Exclusive ownership.
+        void lock();
+
+        bool try_lock();
+
+        void unlock();
+
+        // Shared ownership.
+        void lock_shared() {
+            if (ABEL_LIKELY(readers_.fetch_add(1, std::memory_order_acquire) >= 0)) {
+                return;
+            }
+            lock_shared_slow(abel::time_point::infinite_future());
+        }
+
+        bool try_lock_shared();
+
+        // Returns `false` if the lock can't be acquired before timeout.
+        bool try_lock_shared_for(abel::duration expires_in) {
+            return try_lock_shared_until(abel::time_now() + expires_in);
+        }
+
+        bool try_lock_shared_until(abel::time_point expires_at) {
+            if (ABEL_LIKELY(readers_.fetch_add(1, std::memory_order_acquire) >= 0)) {
+                return true;
+            }
+            return lock_shared_slow(expires_at);
+        }
+
+        void unlock_shared() {
+            if (ABEL_LIKELY(readers_.fetch_sub(1, std::memory_order_release) > 0)) {
+                return;
+            }
+            unlock_shared_slow();
+        }
+
+    private:
+        // `readers_` is biased by this value while a writer owns (or is waiting for)
+        // the lock.
+        static constexpr std::int32_t kMaxReaders = 1 << 30;
+
+        bool lock_shared_slow(abel::time_point expires_at);
+
+        void unlock_shared_slow();
+
+    private:
+        // Serializes writers.
+        fiber_internal::fiber_mutex writer_lock_;
+
+        // Number of readers holding or waiting for the lock, minus `kMaxReaders` if
+        // there's a writer.
+        std::atomic<std::int32_t> readers_{0};
+
+        // Number of readers the pending writer is still waiting for.
+        std::atomic<std::int32_t> departing_{0};
+
+        // Slow path. Readers blocked by a writer wait on `reader_cv_` for a token
+        // granted on `unlock()`. The pending writer waits on `writer_cv_` for the
+        // last departing reader.
+        fiber_internal::fiber_mutex slow_path_lock_;
+        fiber_internal::fiber_cond reader_cv_;
+        fiber_internal::fiber_cond writer_cv_;
+        std::int32_t reader_tokens_ = 0;
+        bool writer_ready_ = false;
+    };
+
+}  // namespace abel
+
+#endif  // ABEL_FIBER_FIBER_SHARED_MUTEX_H_
@@ -0,0 +1,227 @@
+//
+// Created by liyinbin on 2021/5/8.
+//
+
+
+#include "abel/fiber/internal/event_poller.h"
+
+#if defined(ABEL_PLATFORM_LINUX)
+
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <array>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "abel/log/logging.h"
+#include "abel/fiber/internal/fiber_entity.h"
+#include "abel/fiber/internal/scheduling_group.h"
+
+namespace abel {
+    namespace fiber_internal {
+
+        namespace {
+
+            // Maximum number of events we handle in a single round of `epoll_wait`.
+            constexpr auto kMaxEventsPerPoll = 256;
+
+        }  // namespace
+
+        // Implementation of `io_descriptor` goes below.
+
+        void io_descriptor::wait_readable() { wait_for(&read_, POLLIN); }
+
+        void io_descriptor::wait_writable() { wait_for(&write_, POLLOUT); }
+
+        void io_descriptor::on_events(std::uint32_t events) {
+            // Errors and hang-ups are reported to both directions, the waiter will see
+            // the error on its next I/O attempt.
+            if (events & (EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP)) {
+                read_.ready.store(true, std::memory_order_release);
+                wake_all(&read_);
+            }
+            if (events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) {
+                write_.ready.store(true, std::memory_order_release);
+                wake_all(&write_);
+            }
+        }
+
+        void io_descriptor::wait_for(direction *dir, short poll_events) {
+            if (ABEL_UNLIKELY(!is_fiber_context_present())) {
+                // Not in fiber context, there's no one to be rescheduled. Block the
+                // pthread then.
+                pollfd pfd = {.fd = fd_, .events = poll_events, .revents = 0};
+                auto rc = ::poll(&pfd, 1, -1);
+                DCHECK(rc >= 0 || errno == EINTR);
+                return;
+            }
+
+            // An edge was seen (and not consumed) before we even start waiting.
+            if (dir->ready.exchange(false, std::memory_order_acquire)) {
+                return;
+            }
+
+            auto current = get_current_fiber_entity();
+            wait_block wb = {.waiter = current};
+            std::unique_lock lk(current->scheduler_lock);
+            DCHECK(dir->waiters.add_waiter(&wb));  // We never make it persistently
+            // awakened.
+
+            // The edge can arrive after our test above but before we're linked into
+            // the wait chain. Given that the poller sets `ready` before scanning the
+            // wait chain, testing it again here closes the window.
+            if (dir->ready.exchange(false, std::memory_order_acquire)) {
+                if (dir->waiters.try_remove_waiter(&wb)) {
+                    return;
+                }
+                // The poller has popped us from the wait chain concurrently, and it's
+                // going to `ready_fiber` us once we release our scheduler lock. We need
+                // to sleep to consume that wake-up.
+            }
+
+            // Block until the poller wakes us up. `lk` is released by `halt()`.
+            current->own_scheduling_group->halt(current, std::move(lk));
+            DCHECK(!dir->waiters.try_remove_waiter(&wb));
+
+            // Whoever woke us up must have set `ready`. Consume it so that we won't wake
+            // up spuriously next time. Anything arrived before this point will be seen
+            // by the caller's next I/O attempt.
+            dir->ready.store(false, std::memory_order_relaxed);
+        }
+
+        void io_descriptor::wake_all(direction *dir) {
+            // Same as `fiber_cond::notify_all`, drain the wait chain first.
+            std::array<fiber_entity *, 64> fibers_quick;
+            std::size_t array_usage = 0;
+            std::vector<fiber_entity *> fibers_slow;
+
+            while (auto fiber = dir->waiters.wake_one()) {
+                if (ABEL_LIKELY(array_usage < std::size(fibers_quick))) {
+                    fibers_quick[array_usage++] = fiber;
+                } else {
+                    fibers_slow.push_back(fiber);
+                }
+            }
+
+            for (std::size_t index = 0; index != array_usage; ++index) {
+                auto &&e = fibers_quick[index];
+                e->own_scheduling_group->ready_fiber(e, std::unique_lock(e->scheduler_lock));
+            }
+            for (auto &&e : fibers_slow) {
+                e->own_scheduling_group->ready_fiber(e, std::unique_lock(e->scheduler_lock));
+            }
+        }
+
+        // Implementation of `event_poller` goes below.
+
+        event_poller::event_poller(scheduling_group *sg) : sg_(sg) {
+            epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+            CHECK(epoll_fd_ >= 0, "Failed to create epoll instance: {}", errno);
+            wakeup_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            CHECK(wakeup_fd_ >= 0, "Failed to create eventfd: {}", errno);
+
+            // `data.ptr` being `nullptr` identifies our own wake-up event.
+            epoll_event ev = {.events = EPOLLIN | EPOLLET, .data = {.ptr = nullptr}};
+            CHECK(epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wakeup_fd_, &ev) == 0);
+        }
+
+        event_poller::~event_poller() {
+            reap_retired_descriptors();
+            close(wakeup_fd_);
+            close(epoll_fd_);
+        }
+
+        bool event_poller::add_descriptor(io_descriptor *desc) {
+            // Ref-count is incremented here. It's released by `remove_descriptor`.
+            ref_ptr ref(ref_ptr_v, desc);
+            epoll_event ev = {
+                    .events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET,
+                    .data = {.ptr = desc}};
+            if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, desc->fd(), &ev) != 0) {
+                return false;
+            }
+            (void) ref.leak();
+            return true;
+        }
+
+        void event_poller::remove_descriptor(io_descriptor *desc) {
+            ref_ptr ref(adopt_ptr_v, desc);
+            auto rc = epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, desc->fd(), nullptr);
+            DCHECK(rc == 0, "Failed to remove fd #{} from epoll: {}", desc->fd(), errno);
+
+            // The poller can be handling events returned on `desc` right now, so we
+            // can't release it here. Instead, leave it to the poller.
+            bool was_empty;
+            {
+                std::scoped_lock _(retired_lock_);
+                was_empty = retired_.empty();
+                retired_.push_back(std::move(ref));
+            }
+            if (was_empty) {
+                notify();
+            }
+        }
+
+        void event_poller::start() {
+            abel::core_affinity af;
+            worker_ = abel::thread(std::move(af), [&] {
+                worker_proc();
+            });
+        }
+
+        void event_poller::stop() {
+            stopped_.store(true, std::memory_order_relaxed);
+            notify();
+        }
+
+        void event_poller::join() { worker_.join(); }
+
+        void event_poller::worker_proc() {
+            epoll_event events[kMaxEventsPerPoll];
+
+            while (!stopped_.load(std::memory_order_relaxed)) {
+                auto nfds = epoll_wait(epoll_fd_, events, std::size(events), -1);
+                if (ABEL_UNLIKELY(nfds < 0)) {
+                    DCHECK(errno == EINTR, "Unexpected error on `epoll_wait`: {}", errno);
+                    continue;
+                }
+                for (int i = 0; i != nfds; ++i) {
+                    auto desc = reinterpret_cast<io_descriptor *>(events[i].data.ptr);
+                    if (ABEL_UNLIKELY(!desc)) {
+                        std::uint64_t discarded;
+                        while (read(wakeup_fd_, &discarded, sizeof(discarded)) > 0) {
+                        }
+                        continue;
+                    }
+                    desc->on_events(events[i].events);
+                }
+
+                // Events polled above have all been handled, it's safe to release
+                // descriptors removed so far.
+                reap_retired_descriptors();
+            }
+        }
+
+        void event_poller::notify() {
+            std::uint64_t one = 1;
+            auto rc = write(wakeup_fd_, &one, sizeof(one));
+            DCHECK(rc == sizeof(one) || errno == EAGAIN);
+        }
+
+        void event_poller::reap_retired_descriptors() {
+            std::vector<ref_ptr<io_descriptor>> releasing;
+            {
+                std::scoped_lock _(retired_lock_);
+                releasing.swap(retired_);
+            }
+            // Ref-counts are released on leaving the scope.
+        }
+
+    }  // namespace fiber_internal
+}  // namespace abel
+
+#endif  // ABEL_PLATFORM_LINUX
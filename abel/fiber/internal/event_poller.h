@@ -0,0 +1,136 @@
+//
+// Created by liyinbin on 2021/5/8.
+//
+
+#ifndef ABEL_FIBER_INTERNAL_EVENT_POLLER_H_
+#define ABEL_FIBER_INTERNAL_EVENT_POLLER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "abel/base/profile.h"
+#include "abel/fiber/internal/spin_lock.h"
+#include "abel/fiber/internal/waitable.h"
+#include "abel/memory/ref_ptr.h"
+#include "abel/thread/thread.h"
+
+namespace abel {
+    namespace fiber_internal {
+
+        class scheduling_group;
+
+        // Readiness state of a file descriptor registered to an `event_poller`.
+        //
+        // The descriptor is registered in edge-triggered mode. Each time the poller
+        // sees an edge, it sets the corresponding "ready" flag and wakes up all
+        // fibers waiting in that direction. The flag is consumed by the waiter, so an
+        // edge that arrives between a failed (`EAGAIN`) I/O and the subsequent wait is
+        // never lost.
+        //
+        // The file descriptor itself is NOT owned by this class.
+        class io_descriptor : public ref_counted<io_descriptor> {
+        public:
+            explicit io_descriptor(int fd) : fd_(fd) {}
+
+            int fd() const noexcept { return fd_; }
+
+            // Block the calling fiber until the descriptor becomes readable (or an
+            // error / hang-up is seen on it).
+            //
+            // The method can return spuriously, the caller should always retry its I/O
+            // and call this method again on `EAGAIN`.
+            //
+            // If called outside of fiber context, the calling pthread is blocked in
+            // `poll` instead.
+            void wait_readable();
+
+            // Same as `wait_readable`, but waits for writability.
+            void wait_writable();
+
+            // Called by `event_poller` once events on the descriptor are seen.
+            void on_events(std::uint32_t events);
+
+        private:
+            struct direction {
+                // Set if an edge has been seen and not yet consumed by a waiter.
+                std::atomic<bool> ready{false};
+                waitable waiters;
+            };
+
+            void wait_for(direction *dir, short poll_events);
+
+            static void wake_all(direction *dir);
+
+        private:
+            const int fd_;
+            direction read_;
+            direction write_;
+        };
+
+        // Each scheduling group owns an `event_poller`, it's a dedicated pthread
+        // blocking in `epoll_wait` and wakes up fibers waiting on file descriptors
+        // once they become ready.
+        //
+        // The poller itself does not run any fiber, fibers awakened are scheduled to
+        // the scheduling group they're waiting in (via `ready_fiber`).
+        class alignas(hardware_destructive_interference_size) event_poller {
+        public:
+            explicit event_poller(scheduling_group *sg);
+
+            ~event_poller();
+
+            // Start watching `desc`. A reference to `desc` is held by the poller until
+            // it's removed by `remove_descriptor`.
+            //
+            // Returns `false` (with `errno` set) if `epoll_ctl` fails.
+            bool add_descriptor(io_descriptor *desc);
+
+            // Stop watching `desc`.
+            //
+            // Once this method returns, it's safe to close the file descriptor. The
+            // reference held by the poller is released asynchronously, after any events
+            // already polled on `desc` has been handled.
+            void remove_descriptor(io_descriptor *desc);
+
+            scheduling_group *get_scheduling_group() const noexcept { return sg_; }
+
+            // Start the poller thread.
+            void start();
+
+            // Stop & Join.
+            void stop();
+
+            void join();
+
+            // Non-copyable, non-movable.
+            event_poller(const event_poller &) = delete;
+
+            event_poller &operator=(const event_poller &) = delete;
+
+        private:
+            void worker_proc();
+
+            // Wake up the poller thread if it's blocking in `epoll_wait`.
+            void notify();
+
+            // Release descriptors removed since last call.
+            void reap_retired_descriptors();
+
+        private:
+            std::atomic<bool> stopped_{false};
+            scheduling_group *sg_;
+            int epoll_fd_ = -1;
+            int wakeup_fd_ = -1;
+
+            // Descriptors removed but not yet released.
+            abel::fiber_internal::spinlock retired_lock_;
+            std::vector<ref_ptr<io_descriptor>> retired_;
+
+            abel::thread worker_;
+        };
+
+    }  // namespace fiber_internal
+}  // namespace abel
+
+#endif  // ABEL_FIBER_INTERNAL_EVENT_POLLER_H_
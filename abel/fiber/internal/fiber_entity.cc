@@ -217,11 +217,16 @@ namespace abel {
 #endif
 
         fiber_entity *create_fiber_entity(scheduling_group *sg, bool system_fiber,
-                                       abel::function<void()> &&start_proc) noexcept {
-            auto stack = system_fiber ? create_system_stack() : create_user_stack();
+                                       abel::function<void()> &&start_proc,
+                                       fiber_stack_class stack_class) noexcept {
+            auto stack = system_fiber ? create_system_stack() : create_user_stack(stack_class);
             auto stack_size =
-                    system_fiber ? kSystemStackSize : fiber_config::get_global_fiber_config().fiber_stack_size;
+                    system_fiber ? kSystemStackSize : get_user_stack_size(stack_class);
             auto bottom = reinterpret_cast<char *>(stack) + stack_size;
+            auto sampled = !system_fiber && should_sample_stack_usage();
+            if (ABEL_UNLIKELY(sampled)) {
+                prepare_stack_usage_sampling(stack, stack_size - kFiberStackReservedSize);
+            }
             // `fiber_entity` (and magic) is stored at the stack bottom.
             auto ptr = bottom - kFiberStackReservedSize;
             DCHECK(reinterpret_cast<std::uintptr_t>(ptr) % alignof(fiber_entity) ==
@@ -232,6 +237,8 @@ namespace abel {
             fiber->debugging_fiber_id = abel::fiber_internal::next_id<fiber_id_traits>();
             // `fiber->ever_started_magic` is not filled here. @sa: `fiber_proc`.
             fiber->system_fiber = system_fiber;
+            fiber->stack_class = stack_class;
+            fiber->stack_usage_sampled = sampled;
             fiber->stack_size = stack_size - kFiberStackReservedSize;
             fiber->state_save_area =
                     fiber_make_context(fiber->get_stack_top(), fiber->get_stack_limit(), reinterpret_cast<void(*)(intptr_t)>(fiber_proc));
@@ -273,6 +280,12 @@ namespace abel {
 
         void free_fiber_entity(fiber_entity *fiber) noexcept {
             bool system_fiber = fiber->system_fiber;
+            auto stack_class = fiber->stack_class;
+            auto stack_size = fiber->stack_size;  // Excluding reserved space.
+            auto stack = reinterpret_cast<char *>(fiber) - stack_size;
+            if (ABEL_UNLIKELY(fiber->stack_usage_sampled)) {
+                record_stack_usage(stack, stack_size);
+            }
 
 #ifdef ABEL_INTERNAL_USE_TSAN
             abel::tsan::destroy_fiber(fiber->tsan_fiber);
@@ -282,12 +295,10 @@ namespace abel {
             // this away.
             fiber->~fiber_entity();
 
-            auto p = reinterpret_cast<char *>(fiber) + kFiberStackReservedSize -
-                     (system_fiber ? kSystemStackSize : fiber_config::get_global_fiber_config().fiber_stack_size);
             if (system_fiber) {
-                free_system_stack(p);
+                free_system_stack(stack);
             } else {
-                free_user_stack(p);
+                free_user_stack(stack, stack_class);
             }
         }
     }  // namespace fiber_internal
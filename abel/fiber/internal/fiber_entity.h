@@ -13,6 +13,7 @@
 #include <unordered_map>
 
 #include "abel/base/annotation.h"
+#include "abel/fiber/fiber_config.h"
 #include "abel/functional/function.h"
 #include "abel/fiber/internal/spin_lock.h"
 #include "abel/log/logging.h"
@@ -127,6 +128,12 @@ namespace abel {
             // overflow.
             bool system_fiber;
 
+            // Size class of user fiber's stack. Ignored for system fiber.
+            fiber_stack_class stack_class;
+
+            // Set if stack usage of this fiber is being sampled.
+            bool stack_usage_sampled;
+
             // Fiber's state.
             fiber_state state = fiber_state::Ready;
 
@@ -294,7 +301,8 @@ namespace abel {
 
         // Create & destroy fiber entity (both the control structure and the stack.)
         fiber_entity *create_fiber_entity(scheduling_group *sg, bool system_fiber,
-                                          abel::function<void()> &&start_proc) noexcept;
+                                          abel::function<void()> &&start_proc,
+                                          fiber_stack_class stack_class = fiber_stack_class::eNormal) noexcept;
 
         void free_fiber_entity(fiber_entity *fiber) noexcept;
 
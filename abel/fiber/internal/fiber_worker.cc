@@ -17,10 +17,12 @@ namespace abel {
                 : sg_(sg), worker_index_(worker_index) {}
 
         void fiber_worker::add_foreign_scheduling_group(scheduling_group *sg,
-                                                        std::uint64_t steal_every_n) {
+                                                        std::uint64_t steal_every_n,
+                                                        bool cross_numa) {
             victims_.push({.sg = sg,
                                   .steal_every_n = steal_every_n,
-                                  .next_steal = abel::Random(steal_every_n)});
+                                  .next_steal = abel::Random(steal_every_n),
+                                  .cross_numa = cross_numa});
         }
 
         void fiber_worker::start(bool no_cpu_migration) {
@@ -86,14 +88,17 @@ namespace abel {
             ++steal_vec_clock_;
             while (victims_.top().next_steal <= steal_vec_clock_) {
                 auto &&top = victims_.top();
-                if (auto rc = top.sg->remote_acquire_fiber()) {
+                auto rc = top.sg->remote_acquire_fiber();
+                sg_->record_foreign_steal(top.cross_numa, rc != nullptr);
+                if (rc) {
                     // We don't pop the top in this case, since it's not empty, maybe the next
                     // time we try to steal, there are still something for us.
                     return rc;
                 }
                 victims_.push({.sg = top.sg,
                                       .steal_every_n = top.steal_every_n,
-                                      .next_steal = top.next_steal + top.steal_every_n});
+                                      .next_steal = top.next_steal + top.steal_every_n,
+                                      .cross_numa = top.cross_numa});
                 victims_.pop();
                 // Try next victim then.
             }
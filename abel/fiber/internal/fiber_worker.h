@@ -26,9 +26,13 @@ namespace abel {
 
             // Add foreign scheduling group for stealing.
             //
+            // `cross_numa` tells if `sg` is in a different NUMA node, it only affects
+            // how steals are accounted (@sa: `scheduling_group_stats`).
+            //
             // May only be called prior to `start()`.
             void add_foreign_scheduling_group(scheduling_group* sg,
-                                           std::uint64_t steal_every_n);
+                                           std::uint64_t steal_every_n,
+                                           bool cross_numa = false);
 
             // start the worker thread.
             //
@@ -55,6 +59,7 @@ namespace abel {
                 scheduling_group* sg;
                 std::uint64_t steal_every_n;
                 std::uint64_t next_steal;
+                bool cross_numa;
 
                 // `std::priority_queue` orders elements descendingly.
                 bool operator<(const victim& v) const { return next_steal > v.next_steal; }
@@ -0,0 +1,403 @@
+//
+// Created by liyinbin on 2021/5/8.
+//
+
+
+#include "abel/fiber/internal/io_ring.h"
+
+#if defined(ABEL_PLATFORM_LINUX)
+
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <utility>
+
+#include "abel/log/logging.h"
+#include "abel/fiber/internal/fiber_entity.h"
+#include "abel/fiber/internal/scheduling_group.h"
+#include "abel/fiber/internal/waitable.h"
+#include "abel/fiber/this_fiber.h"
+
+namespace abel {
+    namespace fiber_internal {
+
+        namespace {
+
+            // `user_data` of our read on `wakeup_fd_`.
+            constexpr std::uint64_t kWakeupUserData = 0;
+
+            int io_uring_setup(unsigned entries, io_uring_params *params) {
+                return syscall(__NR_io_uring_setup, entries, params);
+            }
+
+            int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete,
+                               unsigned flags) {
+                return syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags,
+                               nullptr, 0);
+            }
+
+            int io_uring_register(int fd, unsigned opcode, const void *arg,
+                                  unsigned nr_args) {
+                return syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+            }
+
+            template<class T>
+            T *offset_ptr(void *base, std::size_t offset) {
+                return reinterpret_cast<T *>(reinterpret_cast<char *>(base) + offset);
+            }
+
+        }  // namespace
+
+        // Implementation of `registered_buffer_pool` goes below.
+
+        class registered_buffer_pool::block : public native_iobuf_block {
+        public:
+            char *mutable_data() noexcept override { return data_; }
+
+            const char *data() const noexcept override { return data_; }
+
+            std::size_t size() const noexcept override { return size_; }
+
+            void destroy() noexcept override { owner_->put_block(this); }
+
+        private:
+            friend class registered_buffer_pool;
+
+            registered_buffer_pool *owner_;
+            char *data_;
+            std::size_t size_;
+        };
+
+        registered_buffer_pool::registered_buffer_pool(std::size_t block_size,
+                                                       std::size_t blocks)
+                : region_size_(block_size * blocks),
+                  blocks_(std::make_unique<block[]>(blocks)) {
+            auto p = mmap(nullptr, region_size_, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            CHECK(p != MAP_FAILED, "Failed to allocate buffers for io_uring: {}", errno);
+            region_ = reinterpret_cast<char *>(p);
+            free_.reserve(blocks);
+            for (std::size_t i = 0; i != blocks; ++i) {
+                auto &&b = blocks_[i];
+                b.owner_ = this;
+                b.data_ = region_ + i * block_size;
+                b.size_ = block_size;
+                free_.push_back(&b);
+            }
+        }
+
+        registered_buffer_pool::~registered_buffer_pool() {
+            DCHECK_EQ(free_.size() * blocks_[0].size_, region_size_,
+                      "Destroying buffer pool with blocks in use.");
+            munmap(region_, region_size_);
+        }
+
+        ref_ptr<native_iobuf_block> registered_buffer_pool::try_get_block() {
+            block *b;
+            {
+                std::scoped_lock _(lock_);
+                if (free_.empty()) {
+                    return nullptr;
+                }
+                b = free_.back();
+                free_.pop_back();
+            }
+            ref();  // Released in `put_block`.
+            return ref_ptr<native_iobuf_block>(adopt_ptr_v, b);
+        }
+
+        void registered_buffer_pool::put_block(block *b) noexcept {
+            {
+                std::scoped_lock _(lock_);
+                free_.push_back(b);
+            }
+            deref();  // We can be destroyed here.
+        }
+
+        // Implementation of `io_ring` goes below.
+
+        struct io_ring::request {
+            int result;
+            wait_event done;
+        };
+
+        std::unique_ptr<io_ring> io_ring::create(scheduling_group *sg, std::size_t entries,
+                                                 std::size_t registered_blocks) {
+            std::unique_ptr<io_ring> ring(new io_ring());
+            ring->sg_ = sg;
+            if (!ring->initialize(entries, registered_blocks)) {
+                return nullptr;
+            }
+            return ring;
+        }
+
+        io_ring::~io_ring() {
+            // Closing the ring cancels our pending read on `wakeup_fd_`, and
+            // unregisters buffers.
+            if (sqes_) {
+                munmap(sqes_, sqes_size_);
+            }
+            if (cq_ring_ && cq_ring_ != sq_ring_) {
+                munmap(cq_ring_, cq_ring_size_);
+            }
+            if (sq_ring_) {
+                munmap(sq_ring_, sq_ring_size_);
+            }
+            if (ring_fd_ >= 0) {
+                close(ring_fd_);
+            }
+            if (wakeup_fd_ >= 0) {
+                close(wakeup_fd_);
+            }
+        }
+
+        bool io_ring::initialize(std::size_t entries, std::size_t registered_blocks) {
+            io_uring_params params;
+            memset(&params, 0, sizeof(params));
+            ring_fd_ = io_uring_setup(entries, &params);
+            if (ring_fd_ < 0) {
+                DLOG_WARN("io_uring is not available: {}", errno);
+                return false;
+            }
+            // Without fast poll, requests on sockets / pipes that are not ready are
+            // handed to kernel worker threads, which defeats the purpose.
+            if (!(params.features & IORING_FEAT_FAST_POLL) ||
+                !(params.features & IORING_FEAT_NODROP)) {
+                DLOG_WARN("io_uring is too old to be used, features: {:x}", params.features);
+                return false;
+            }
+
+            // Map the rings.
+            sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+            if (single_mmap) {
+                sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+            }
+            auto sq_ring = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+            if (sq_ring == MAP_FAILED) {
+                return false;
+            }
+            sq_ring_ = sq_ring;
+            if (single_mmap) {
+                cq_ring_ = sq_ring_;
+            } else {
+                auto cq_ring = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                                    MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+                if (cq_ring == MAP_FAILED) {
+                    return false;
+                }
+                cq_ring_ = cq_ring;
+            }
+            sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+            auto sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+            if (sqes == MAP_FAILED) {
+                return false;
+            }
+            sqes_ = reinterpret_cast<io_uring_sqe *>(sqes);
+
+            sq_head_ = offset_ptr<std::atomic<unsigned>>(sq_ring_, params.sq_off.head);
+            sq_tail_ = offset_ptr<std::atomic<unsigned>>(sq_ring_, params.sq_off.tail);
+            sq_mask_ = *offset_ptr<unsigned>(sq_ring_, params.sq_off.ring_mask);
+            sq_entries_ = *offset_ptr<unsigned>(sq_ring_, params.sq_off.ring_entries);
+            sq_array_ = offset_ptr<unsigned>(sq_ring_, params.sq_off.array);
+            cq_head_ = offset_ptr<std::atomic<unsigned>>(cq_ring_, params.cq_off.head);
+            cq_tail_ = offset_ptr<std::atomic<unsigned>>(cq_ring_, params.cq_off.tail);
+            cq_mask_ = *offset_ptr<unsigned>(cq_ring_, params.cq_off.ring_mask);
+            cqes_ = offset_ptr<io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+            // Our read on `wakeup_fd_` is counted as well, so it always has a slot.
+            max_outstanding_ = params.cq_entries;
+
+            // It's intentionally left blocking, so that the read we queue on it only
+            // completes once someone writes to it.
+            wakeup_fd_ = eventfd(0, EFD_CLOEXEC);
+            CHECK(wakeup_fd_ >= 0, "Failed to create eventfd: {}", errno);
+
+            if (registered_blocks) {
+                buffer_pool_ = make_ref_counted<registered_buffer_pool>(kRegisteredBlockSize,
+                                                                        registered_blocks);
+                auto region = buffer_pool_->region();
+                if (io_uring_register(ring_fd_, IORING_REGISTER_BUFFERS, &region, 1) != 0) {
+                    // Likely `RLIMIT_MEMLOCK` is too low, keep going without fixed
+                    // buffers.
+                    DLOG_WARN("Failed to register buffers to io_uring: {}", errno);
+                    buffer_pool_ = nullptr;
+                }
+            }
+
+            std::scoped_lock _(sq_lock_);
+            unsafe_arm_wakeup();
+            return true;
+        }
+
+        int io_ring::submit_and_wait(function_ref<void(io_uring_sqe *)> prep) {
+            DCHECK(is_fiber_context_present());
+
+            request req;
+            while (true) {
+                std::unique_lock lk(sq_lock_);
+                io_uring_sqe *sqe;
+                if (ABEL_LIKELY(pending_ + inflight_ < max_outstanding_) &&
+                    ABEL_LIKELY(sqe = unsafe_get_sqe(1))) {
+                    prep(sqe);
+                    sqe->user_data = reinterpret_cast<std::uint64_t>(&req);
+                    ++pending_;
+                    // Only the first request since the pthread went to sleep wakes it up,
+                    // the rest are submitted in the same batch.
+                    bool wake = sleeping_ && !std::exchange(wakeup_pending_, true);
+                    lk.unlock();
+                    if (wake) {
+                        notify();
+                    }
+                    break;
+                }
+                lk.unlock();
+                // Too many requests outstanding, let the pthread catch up.
+                fiber_yield();
+            }
+            req.done.wait();
+            return req.result;
+        }
+
+        void io_ring::start() {
+            abel::core_affinity af;
+            worker_ = abel::thread(std::move(af), [&] {
+                worker_proc();
+            });
+        }
+
+        void io_ring::stop() {
+            stopped_.store(true, std::memory_order_relaxed);
+            notify();
+        }
+
+        void io_ring::join() { worker_.join(); }
+
+        void io_ring::worker_proc() {
+            // Queued by us, but not accepted by the kernel yet.
+            std::size_t unsubmitted = 0;
+
+            while (true) {
+                {
+                    std::scoped_lock _(sq_lock_);
+                    // Nothing but our read on `wakeup_fd_` is outstanding.
+                    if (stopped_.load(std::memory_order_relaxed) &&
+                        pending_ + inflight_ == 1) {
+                        break;
+                    }
+                    // Requests not accepted by the kernel yet are counted as in-flight,
+                    // they're outstanding after all.
+                    inflight_ += pending_;
+                    unsubmitted += std::exchange(pending_, 0);
+                    sleeping_ = true;
+                }
+
+                // Submit everything queued since last round, and wait for at least one
+                // completion.
+                auto rc = io_uring_enter(ring_fd_, unsubmitted, 1, IORING_ENTER_GETEVENTS);
+                if (rc >= 0) {
+                    DCHECK_LE(static_cast<std::size_t>(rc), unsubmitted);
+                    unsubmitted -= rc;
+                } else {
+                    DCHECK(errno == EINTR || errno == EAGAIN || errno == EBUSY,
+                           "Unexpected error on `io_uring_enter`: {}", errno);
+                }
+
+                {
+                    std::scoped_lock _(sq_lock_);
+                    sleeping_ = false;
+                }
+                reap_completions();
+            }
+        }
+
+        std::size_t io_ring::reap_completions() {
+            auto head = cq_head_->load(std::memory_order_relaxed);
+            auto tail = cq_tail_->load(std::memory_order_acquire);
+            std::size_t reaped = 0;
+            bool rearm = false;
+
+            for (; head != tail; ++head) {
+                auto &&cqe = cqes_[head & cq_mask_];
+                if (ABEL_UNLIKELY(cqe.user_data == kWakeupUserData)) {
+                    rearm = true;
+                } else {
+                    auto req = reinterpret_cast<request *>(cqe.user_data);
+                    req->result = cqe.res;
+                    req->done.set();  // `req` can be gone once this call returns.
+                }
+                ++reaped;
+            }
+            cq_head_->store(head, std::memory_order_release);
+
+            std::scoped_lock _(sq_lock_);
+            DCHECK_LE(reaped, inflight_);
+            inflight_ -= reaped;
+            if (rearm) {
+                wakeup_pending_ = false;
+                unsafe_arm_wakeup();
+            }
+            return reaped;
+        }
+
+        void io_ring::unsafe_arm_wakeup() {
+            auto sqe = unsafe_get_sqe(0);
+            // Fibers always leave a slot for it.
+            DCHECK(sqe);
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = wakeup_fd_;
+            sqe->addr = reinterpret_cast<std::uint64_t>(&wakeup_buffer_);
+            sqe->len = sizeof(wakeup_buffer_);
+            sqe->user_data = kWakeupUserData;
+            ++pending_;
+        }
+
+        io_uring_sqe *io_ring::unsafe_get_sqe(unsigned reserve) {
+            // We're the only one that moves the tail (with `sq_lock_` held).
+            auto tail = sq_tail_->load(std::memory_order_relaxed);
+            if (tail - sq_head_->load(std::memory_order_acquire) + reserve >= sq_entries_) {
+                return nullptr;
+            }
+            auto index = tail & sq_mask_;
+            auto sqe = &sqes_[index];
+            memset(sqe, 0, sizeof(*sqe));
+            sq_array_[index] = index;
+            // The kernel only consumes entries submitted by `worker_proc`, which only
+            // counts entries filled by then (as they're filled with `sq_lock_` held).
+            sq_tail_->store(tail + 1, std::memory_order_release);
+            return sqe;
+        }
+
+        void io_ring::notify() {
+            std::uint64_t one = 1;
+            auto rc = write(wakeup_fd_, &one, sizeof(one));
+            DCHECK(rc == sizeof(one));
+        }
+
+    }  // namespace fiber_internal
+}  // namespace abel
+
+#else
+
+namespace abel {
+    namespace fiber_internal {
+
+        std::unique_ptr<io_ring> io_ring::create(scheduling_group *sg, std::size_t entries,
+                                                 std::size_t registered_blocks) {
+            return nullptr;
+        }
+
+        io_ring::~io_ring() = default;
+
+    }  // namespace fiber_internal
+}  // namespace abel
+
+#endif  // ABEL_PLATFORM_LINUX
@@ -0,0 +1,196 @@
+//
+// Created by liyinbin on 2021/5/8.
+//
+
+#ifndef ABEL_FIBER_INTERNAL_IO_RING_H_
+#define ABEL_FIBER_INTERNAL_IO_RING_H_
+
+#include <sys/uio.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "abel/base/profile.h"
+#include "abel/fiber/internal/spin_lock.h"
+#include "abel/functional/function_ref.h"
+#include "abel/io/internal/iobuf_block.h"
+#include "abel/memory/ref_ptr.h"
+#include "abel/thread/thread.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace abel {
+    namespace fiber_internal {
+
+        class scheduling_group;
+
+        // Memory registered to an `io_ring` as a fixed buffer, handed out in blocks
+        // of `native_iobuf_block`.
+        //
+        // Blocks can outlive the ring (they can be held in `iobuf`s for arbitrarily
+        // long), the memory is freed once both the ring and all blocks are gone.
+        class registered_buffer_pool : public ref_counted<registered_buffer_pool> {
+        public:
+            registered_buffer_pool(std::size_t block_size, std::size_t blocks);
+
+            ~registered_buffer_pool();
+
+            // Returns `nullptr` if all blocks are in use.
+            ref_ptr<native_iobuf_block> try_get_block();
+
+            // The whole region, for registering it to the ring.
+            iovec region() const noexcept { return {region_, region_size_}; }
+
+            // Test if `[ptr, ptr + size)` lies in the registered region.
+            bool contains(const void *ptr, std::size_t size) const noexcept {
+                auto p = reinterpret_cast<const char *>(ptr);
+                return p >= region_ && p + size <= region_ + region_size_;
+            }
+
+        private:
+            class block;
+
+            void put_block(block *b) noexcept;
+
+        private:
+            char *region_;
+            std::size_t region_size_;
+            std::unique_ptr<block[]> blocks_;
+
+            spinlock lock_;
+            std::vector<block *> free_;
+        };
+
+        // Each scheduling group (optionally) owns an `io_ring`. It's an io_uring
+        // instance plus a dedicated pthread reaping completions.
+        //
+        // Fibers put their requests into the submission queue without making any
+        // syscall, the pthread submits all requests queued since its last round in a
+        // single `io_uring_enter`, which also waits for completions. The requesting
+        // fiber is parked until its completion is reaped.
+        //
+        // If the pthread is blocked in `io_uring_enter` when a request is queued, it's
+        // woken up via an eventfd (which it always has a pending read on). Only the
+        // first request after it goes to sleep pays for that.
+        class alignas(hardware_destructive_interference_size) io_ring {
+        public:
+            // Returns `nullptr` if io_uring is not usable (not supported by the kernel,
+            // or disallowed by the system).
+            //
+            // `entries` is size of the submission queue. If `registered_blocks` is not
+            // 0, a region of that many blocks is registered as fixed buffer.
+            static std::unique_ptr<io_ring> create(scheduling_group *sg, std::size_t entries,
+                                                   std::size_t registered_blocks);
+
+            ~io_ring();
+
+            // Fill a submission queue entry via `prep`, submit it (along with those
+            // from other fibers), and block the calling fiber until it completes.
+            //
+            // `user_data` of the entry is overwritten.
+            //
+            // Returns `res` of the completion (negated `errno` on failure).
+            //
+            // May only be called in fiber context.
+            int submit_and_wait(function_ref<void(io_uring_sqe *)> prep);
+
+            // Registered buffers, or `nullptr` if there's none.
+            registered_buffer_pool *get_buffer_pool() const noexcept {
+                return buffer_pool_.get();
+            }
+
+            // Index of the registered buffer (to be used with `IORING_OP_READ_FIXED`
+            // and friends). We always register a single region.
+            static constexpr std::uint16_t kRegisteredBufferIndex = 0;
+
+            // Size of each block in registered buffers.
+            static constexpr std::size_t kRegisteredBlockSize = 16384;
+
+            scheduling_group *get_scheduling_group() const noexcept { return sg_; }
+
+            // Start the completion pthread.
+            void start();
+
+            // Stop & Join.
+            void stop();
+
+            void join();
+
+            // Non-copyable, non-movable.
+            io_ring(const io_ring &) = delete;
+
+            io_ring &operator=(const io_ring &) = delete;
+
+        private:
+            struct request;
+
+            io_ring() = default;
+
+            bool initialize(std::size_t entries, std::size_t registered_blocks);
+
+            void worker_proc();
+
+            // Queue a read on `wakeup_fd_`. `sq_lock_` must be held.
+            void unsafe_arm_wakeup();
+
+            // Get a free submission queue entry, or `nullptr` if there are no more
+            // than `reserve` entries left. `sq_lock_` must be held.
+            io_uring_sqe *unsafe_get_sqe(unsigned reserve);
+
+            // Returns number of completions reaped.
+            std::size_t reap_completions();
+
+            void notify();
+
+        private:
+            std::atomic<bool> stopped_{false};
+            scheduling_group *sg_ = nullptr;
+            int ring_fd_ = -1;
+            int wakeup_fd_ = -1;
+            std::uint64_t wakeup_buffer_;
+
+            // Mapped rings.
+            void *sq_ring_ = nullptr;
+            std::size_t sq_ring_size_ = 0;
+            void *cq_ring_ = nullptr;
+            std::size_t cq_ring_size_ = 0;
+            io_uring_sqe *sqes_ = nullptr;
+            std::size_t sqes_size_ = 0;
+
+            std::atomic<unsigned> *sq_head_;
+            std::atomic<unsigned> *sq_tail_;
+            unsigned sq_mask_;
+            unsigned sq_entries_;
+            unsigned *sq_array_;
+            std::atomic<unsigned> *cq_head_;
+            std::atomic<unsigned> *cq_tail_;
+            unsigned cq_mask_;
+            io_uring_cqe *cqes_;
+
+            // Protects submission queue and the counters below.
+            spinlock sq_lock_;
+            // Queued but not submitted yet.
+            std::size_t pending_ = 0;
+            // Submitted but not completed yet (including our read on `wakeup_fd_`).
+            std::size_t inflight_ = 0;
+            // Limit of `pending_ + inflight_`, so that the completion queue never
+            // overflows.
+            std::size_t max_outstanding_;
+            // Set if the pthread is (going to be) blocked in `io_uring_enter`.
+            bool sleeping_ = false;
+            // Set if someone has written to `wakeup_fd_` since the pthread went to sleep.
+            bool wakeup_pending_ = false;
+
+            ref_ptr<registered_buffer_pool> buffer_pool_;
+
+            abel::thread worker_;
+        };
+
+    }  // namespace fiber_internal
+}  // namespace abel
+
+#endif  // ABEL_FIBER_INTERNAL_IO_RING_H_
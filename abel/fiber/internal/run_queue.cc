@@ -136,6 +136,13 @@ namespace abel {
                    tail_seq_.load(std::memory_order_relaxed);
         }
 
+        std::size_t run_queue::unsafe_size() const {
+            // `tail_seq_` never goes beyond `head_seq_`, so load it first.
+            auto tail = tail_seq_.load(std::memory_order_relaxed);
+            auto head = head_seq_.load(std::memory_order_relaxed);
+            return head > tail ? head - tail : 0;
+        }
+
         template <class F>
         fiber_entity* run_queue::pop_if(F&& f) {
             while (true) {
@@ -6,6 +6,7 @@
 #define ABEL_FIBER_INTERNAL_RUN_QUEUE_H_
 
 #include <cstddef>
+#include <cstdint>
 
 #include <atomic>
 #include <memory>
@@ -87,6 +88,9 @@ namespace abel {
             // Test if the queue is empty. The result might be inaccurate.
             bool unsafe_empty() const;
 
+            // Number of fibers in the queue. The result might be inaccurate.
+            std::size_t unsafe_size() const;
+
         private:
             struct alignas(hardware_destructive_interference_size) queue_node {
                 fiber_entity *fiber;
@@ -12,11 +12,13 @@
 #include <sys/syscall.h>
 #include <sys/wait.h>
 
+#include <algorithm>
 #include <climits>
 #include <memory>
 #include <string>
 #include <thread>
 
+#include "abel/atomic/stealing_queue.h"
 #include "abel/base/profile.h"
 #include "abel/functional/function.h"
 #include "abel/base/annotation.h"
@@ -61,6 +63,18 @@ namespace abel {
 //                "fiber_latency_ready_to_run", 1us);
 
         namespace {
+
+            // A fiber in some worker's "run next" slot is only stolen by other workers
+            // after it has been waiting for this long. The owner is likely to run it
+            // soon (e.g., on `fiber_mutex` hand-off, the owner is going to wait), and
+            // running it on the same worker is much more cache friendly.
+            constexpr auto kRunNextStealDelay = abel::duration::microseconds(5);
+
+            // Each worker checks the shared run queue before its own local queue every
+            // so many times it acquires a fiber, so that fibers in the run queue won't
+            // starve when fibers in local queue keep waking each other.
+            constexpr std::uint32_t kLocalQueueFairnessInterval = 61;
+
         /*
             std::string WriteBitMask(std::uint64_t x) {
                 std::string s(64, 0);
@@ -169,6 +183,67 @@ namespace abel {
 
 #endif
 
+        // The owner worker pushes / pops fibers at the bottom of `deque`, others steal
+        // from its top.
+        class alignas(hardware_destructive_interference_size)
+                scheduling_group::local_queue {
+        public:
+            // The fiber most recently readied by the owner. It's run before anything in
+            // `deque`.
+            std::atomic<fiber_entity *> run_next{nullptr};
+
+            // When did the fiber in `run_next` become ready, in nanoseconds since epoch.
+            // This is only a hint, it's not updated atomically with `run_next`.
+            std::atomic<std::int64_t> run_next_since{0};
+
+            abel::stealing_queue<fiber_entity *> deque;
+
+            // Accessed by the owner only.
+            std::uint32_t acquired = 0;
+        };
+
+        // Counters are only written by the owner worker, so a plain load / store pair
+        // is enough for updating them (no RMW needed), and they're read elsewhere only
+        // when stats are collected.
+        class alignas(hardware_destructive_interference_size)
+                scheduling_group::worker_stats {
+        public:
+            using counter = std::atomic<std::uint64_t>;
+
+            static void add(counter &c, std::uint64_t n = 1) noexcept {
+                c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+            }
+
+            static void update_max(counter &c, std::uint64_t value) noexcept {
+                if (value > c.load(std::memory_order_relaxed)) {
+                    c.store(value, std::memory_order_relaxed);
+                }
+            }
+
+            static std::uint64_t read(const counter &c) noexcept {
+                return c.load(std::memory_order_relaxed);
+            }
+
+            void record_ready_to_run_latency(abel::duration latency) noexcept {
+                auto us = static_cast<std::uint64_t>(std::max<std::int64_t>(
+                        latency.to_int64_microseconds(), 0));
+                std::size_t index = us ? 64 - __builtin_clzll(us) : 0;
+                add(ready_to_run_latency[std::min(
+                        index, scheduling_group_stats::kLatencyBuckets - 1)]);
+            }
+
+            counter fibers_run{0};
+            counter run_queue_high_water{0};
+            counter local_steals{0};
+            counter foreign_steals[2] = {};
+            counter foreign_steal_failures[2] = {};
+            counter sleeps{0};
+            counter sleep_ns{0};
+            counter spins{0};
+            counter spin_hits{0};
+            counter ready_to_run_latency[scheduling_group_stats::kLatencyBuckets] = {};
+        };
+
         ABEL_INTERNAL_TLS_MODEL thread_local std::size_t
                 scheduling_group::worker_index_ = kUninitializedWorkerIndex;
 
@@ -195,12 +270,21 @@ namespace abel {
 //            });
 
             wait_slots_ = std::make_unique<wait_slot[]>(group_size_);
+            worker_stats_ = std::make_unique<worker_stats[]>(group_size_);
+            if (auto size = fiber_config::get_global_fiber_config().fiber_local_queue_size) {
+                local_queues_ = std::make_unique<local_queue[]>(group_size_);
+                for (std::size_t index = 0; index != group_size_; ++index) {
+                    CHECK(local_queues_[index].deque.init(size) == 0,
+                          "Failed to initialize local queue of size {}, it must be a power of 2.",
+                          size);
+                }
+            }
         }
 
         scheduling_group::~scheduling_group() = default;
 
         fiber_entity *scheduling_group::acquire_fiber() noexcept {
-            if (auto rc = run_queue_.pop()) {
+            if (auto rc = pop_ready_fiber()) {
                 // Acquiring the lock here guarantees us anyone who is working on this fiber
                 // (with the lock held) has done its job before we returning it to the
                 // caller (worker).
@@ -209,10 +293,18 @@ namespace abel {
                 DCHECK(rc->state == fiber_state::Ready);
                 rc->state = fiber_state::Running;
 
-//                auto now = ReadTsc();
-//                ready_to_run_latency->Report(TscElapsed(rc->last_ready_tsc, now));
-//                ready_to_run_latency_monitoring.Report(
-//                        DurationFromTsc(rc->last_ready_tsc, now));
+                if (auto stats = get_worker_stats()) {
+                    auto run = worker_stats::read(stats->fibers_run) + 1;
+                    stats->fibers_run.store(run, std::memory_order_relaxed);
+                    // Reading the clock (and the run queue's head / tail) on each
+                    // switch is not free, so we only sample them.
+                    if (run % scheduling_group_stats::kSampleInterval == 0) {
+                        stats->record_ready_to_run_latency(abel::time_now() -
+                                                           rc->last_ready_tsc);
+                        worker_stats::update_max(stats->run_queue_high_water,
+                                                 run_queue_.unsafe_size());
+                    }
+                }
                 return rc;
             }
             return stopped_.load(std::memory_order_relaxed) ? kSchedulingGroupShuttingDown
@@ -244,6 +336,9 @@ namespace abel {
             }
 
             if (need_spin) {
+                if (auto stats = get_worker_stats()) {
+                    worker_stats::add(stats->spins);
+                }
                 static constexpr auto kMaximumCyclesToSpin = abel::duration::nanoseconds(10000);
                 // Wait for some time between touching `run_queue_` to reduce contention.
                 static constexpr auto kCyclesBetweenRetry = abel::duration::nanoseconds(1000);
@@ -293,6 +388,9 @@ namespace abel {
                     kMaximumSpinners) {
                     pending_spinner_wakeup_.store(true, std::memory_order_relaxed);
                 }
+                if (auto stats = get_worker_stats()) {
+                    worker_stats::add(stats->spin_hits);
+                }
             }
             return fiber;
         }
@@ -301,6 +399,7 @@ namespace abel {
             DCHECK_NE(worker_index_, kUninitializedWorkerIndex);
             DCHECK_LT(worker_index_, group_size_);
             auto mask = 1ULL << worker_index_;
+            abel::time_point poll_until;
 
             while (true) {
                 scoped_deferred _([&] {
@@ -333,7 +432,30 @@ namespace abel {
                     return f;
                 }
 
+                if (has_pending_run_next(worker_index_)) {
+                    // A peer's "run next" fiber is too fresh to be stolen. Its owner is
+                    // likely to run it shortly, but if it's kept busy, we're the one
+                    // woken up for that fiber. Keep polling until it's old enough to be
+                    // stolen, but not for longer, so that a stream of fresh fibers (e.g.
+                    // ping-pong between two fibers) doesn't keep us from sleeping. Each
+                    // of them wakes us up again anyway.
+                    auto now = abel::time_now();
+                    if (poll_until == abel::time_point()) {
+                        poll_until = now + kRunNextStealDelay * 2;
+                    }
+                    if (now < poll_until) {
+                        pause();
+                        continue;
+                    }
+                }
+                poll_until = abel::time_point();
+
+                auto &&stats = worker_stats_[worker_index_];
+                auto sleep_since = abel::time_now();
                 wait_slots_[worker_index_].wait();
+                worker_stats::add(stats.sleeps);
+                worker_stats::add(stats.sleep_ns,
+                                  (abel::time_now() - sleep_since).to_int64_nanoseconds());
 
                 // We only return non-`nullptr` here. If we return `nullptr` to the caller,
                 // it'll go spinning immediately. Doing that will likely waste CPU cycles.
@@ -344,7 +466,13 @@ namespace abel {
         }
 
         fiber_entity *scheduling_group::remote_acquire_fiber() noexcept {
-            if (auto rc = run_queue_.steal()) {
+            auto rc = run_queue_.steal();
+            if (!rc && local_queues_) {
+                // Fibers in local queues are never `scheduling_group_local`, so they're
+                // free to be stolen.
+                rc = steal_local_fiber(kUninitializedWorkerIndex);
+            }
+            if (rc) {
                 std::scoped_lock _(rc->scheduler_lock);
 
                 DCHECK(rc->state == fiber_state::Ready);
@@ -404,7 +532,70 @@ namespace abel {
                 scheduler_lock.unlock();
             }
 
-            // push the fiber into run queue and (optionally) wake up a worker.
+            // push the fiber into run queue and wake up a worker.
+            //
+            // A fiber pushed into our "run next" slot is likely to be run by us as soon
+            // as the current fiber blocks, but the current fiber may as well keep
+            // running (or even spin, waiting for that fiber). So we wake a peer up all
+            // the same. It only steals the fiber if it's still there after
+            // `kRunNextStealDelay`.
+            if (!push_local_fiber(fiber)) {
+                push_run_queue(fiber);
+            }
+            if (ABEL_UNLIKELY(!wake_up_one_worker())) {
+                //no_worker_available->Increment();
+                //DLOG_WARN("no avaiable workers");
+            }
+        }
+
+        fiber_entity *scheduling_group::pop_ready_fiber() noexcept {
+            if (!local_queues_ || current_ != this || worker_index_ >= group_size_) {
+                return run_queue_.pop();
+            }
+
+            auto &&q = local_queues_[worker_index_];
+            fiber_entity *rc = nullptr;
+            if (ABEL_UNLIKELY(++q.acquired % kLocalQueueFairnessInterval == 0)) {
+                if ((rc = run_queue_.pop())) {
+                    return rc;
+                }
+            }
+            if (q.run_next.load(std::memory_order_relaxed) &&
+                (rc = q.run_next.exchange(nullptr, std::memory_order_acquire))) {
+                return rc;
+            }
+            if (q.deque.pop(&rc)) {
+                return rc;
+            }
+            if ((rc = run_queue_.pop())) {
+                return rc;
+            }
+            if ((rc = steal_local_fiber(worker_index_))) {
+                worker_stats::add(worker_stats_[worker_index_].local_steals);
+            }
+            return rc;
+        }
+
+        bool scheduling_group::push_local_fiber(fiber_entity *fiber) noexcept {
+            // Fibers readied on master fiber (e.g. by `yield()`) go to the run queue,
+            // otherwise a yielding fiber would be run again immediately.
+            if (!local_queues_ || current_ != this || worker_index_ >= group_size_ ||
+                fiber->scheduling_group_local ||
+                get_current_fiber_entity() == get_master_fiber_entity()) {
+                return false;
+            }
+            auto &&q = local_queues_[worker_index_];
+            q.run_next_since.store(fiber->last_ready_tsc.to_unix_nanos(),
+                                   std::memory_order_relaxed);
+            auto prev = q.run_next.exchange(fiber, std::memory_order_release);
+            if (prev && !q.deque.push(prev)) {
+                // Local queue is full, spill to the shared run queue.
+                push_run_queue(prev);
+            }
+            return true;
+        }
+
+        void scheduling_group::push_run_queue(fiber_entity *fiber) noexcept {
             if (ABEL_UNLIKELY(!run_queue_.push(fiber, fiber->scheduling_group_local))) {
                 DLOG_INFO("push fail");
                 auto since = abel::time_now();
@@ -419,10 +610,45 @@ namespace abel {
                     std::this_thread::sleep_for(100us);
                 }
             }
-            if (ABEL_UNLIKELY(!wake_up_one_worker())) {
-                //no_worker_available->Increment();
-                //DLOG_WARN("no avaiable workers");
+        }
+
+        fiber_entity *scheduling_group::steal_local_fiber(std::size_t self_index) noexcept {
+            // Start from a random victim, so that thieves don't all crowd on the first
+            // one.
+            auto start = Random(group_size_ - 1);
+            for (std::size_t i = 0; i != group_size_; ++i) {
+                auto index = (start + i) % group_size_;
+                if (index == self_index) {
+                    continue;
+                }
+                auto &&q = local_queues_[index];
+                fiber_entity *rc;
+                if (q.deque.steal(&rc)) {
+                    return rc;
+                }
+                rc = q.run_next.load(std::memory_order_relaxed);
+                if (rc &&
+                    abel::time_now().to_unix_nanos() -
+                    q.run_next_since.load(std::memory_order_relaxed) >=
+                    kRunNextStealDelay.to_int64_nanoseconds() &&
+                    q.run_next.compare_exchange_strong(rc, nullptr, std::memory_order_acquire)) {
+                    return rc;
+                }
             }
+            return nullptr;
+        }
+
+        bool scheduling_group::has_pending_run_next(std::size_t self_index) const noexcept {
+            if (!local_queues_) {
+                return false;
+            }
+            for (std::size_t i = 0; i != group_size_; ++i) {
+                if (i != self_index &&
+                    local_queues_[i].run_next.load(std::memory_order_relaxed)) {
+                    return true;
+                }
+            }
+            return false;
         }
 
         void scheduling_group::halt(
@@ -539,6 +765,61 @@ namespace abel {
             timer_worker_ = worker;
         }
 
+        void scheduling_group::set_event_poller(event_poller *poller) noexcept {
+            event_poller_ = poller;
+        }
+
+        void scheduling_group::set_io_ring(io_ring *ring) noexcept {
+            io_ring_ = ring;
+        }
+
+        void scheduling_group::record_foreign_steal(bool cross_numa,
+                                                    bool succeeded) noexcept {
+            if (auto stats = get_worker_stats()) {
+                worker_stats::add(succeeded ? stats->foreign_steals[cross_numa]
+                                            : stats->foreign_steal_failures[cross_numa]);
+            }
+        }
+
+        scheduling_group_stats scheduling_group::get_stats() const {
+            scheduling_group_stats result;
+            std::uint64_t sleep_ns = 0;
+            for (std::size_t index = 0; index != group_size_; ++index) {
+                auto &&e = worker_stats_[index];
+                result.fibers_run += worker_stats::read(e.fibers_run);
+                result.run_queue_high_water = std::max(result.run_queue_high_water,
+                                                       worker_stats::read(e.run_queue_high_water));
+                result.local_steals += worker_stats::read(e.local_steals);
+                for (int cross_numa = 0; cross_numa != 2; ++cross_numa) {
+                    result.foreign_steals[cross_numa] +=
+                            worker_stats::read(e.foreign_steals[cross_numa]);
+                    result.foreign_steal_failures[cross_numa] +=
+                            worker_stats::read(e.foreign_steal_failures[cross_numa]);
+                }
+                result.sleeps += worker_stats::read(e.sleeps);
+                sleep_ns += worker_stats::read(e.sleep_ns);
+                result.spins += worker_stats::read(e.spins);
+                result.spin_hits += worker_stats::read(e.spin_hits);
+                for (std::size_t i = 0; i != scheduling_group_stats::kLatencyBuckets; ++i) {
+                    result.ready_to_run_latency[i] +=
+                            worker_stats::read(e.ready_to_run_latency[i]);
+                }
+            }
+            result.sleep_time = abel::duration::nanoseconds(sleep_ns);
+            if (timer_worker_) {
+                result.timers_fired = timer_worker_->get_timers_fired();
+                result.timer_delay = timer_worker_->get_timer_delay();
+            }
+            return result;
+        }
+
+        scheduling_group::worker_stats *scheduling_group::get_worker_stats() noexcept {
+            if (ABEL_UNLIKELY(current_ != this || worker_index_ >= group_size_)) {
+                return nullptr;
+            }
+            return &worker_stats_[worker_index_];
+        }
+
         void scheduling_group::stop() {
             stopped_.store(true, std::memory_order_relaxed);
             for (std::size_t index = 0; index != group_size_; ++index) {
@@ -19,6 +19,59 @@ namespace abel {
 
         class timer_worker;
 
+        class event_poller;
+
+        class io_ring;
+
+        // Statistics about a scheduling group, summed up from counters maintained by
+        // each of its workers (and its timer worker). Counters are cumulative since the
+        // scheduling group was created.
+        //
+        // @sa: `scheduling_group::get_stats()`.
+        struct scheduling_group_stats {
+            // Ready-to-run latency is recorded in power-of-2 buckets (in
+            // microseconds). Bucket #0 counts latencies below 1us, bucket #i counts
+            // those in [2^(i-1), 2^i) us, and the last bucket counts everything else.
+            static constexpr std::size_t kLatencyBuckets = 21;
+
+            // Ready-to-run latency and run queue depth are only sampled once every so
+            // many fibers a worker runs.
+            static constexpr std::uint64_t kSampleInterval = 8;
+
+            // Fibers run by workers in this group, not including those stolen from
+            // other groups (@sa: `foreign_steals`).
+            std::uint64_t fibers_run = 0;
+
+            // Highest run queue depth ever seen (sampled).
+            std::uint64_t run_queue_high_water = 0;
+
+            // Fibers stolen from local queues of other workers in this group.
+            std::uint64_t local_steals = 0;
+
+            // Steals from other scheduling groups, indexed by whether the victim is in
+            // a different NUMA node (i.e., `[0]` for same-node, `[1]` for cross-node).
+            std::uint64_t foreign_steals[2] = {};
+            std::uint64_t foreign_steal_failures[2] = {};
+
+            // Times workers went to sleep in `wait_for_fiber`, and total time they
+            // slept there.
+            std::uint64_t sleeps = 0;
+            abel::duration sleep_time;
+
+            // Times workers spun in `spinning_acquire_fiber`, and how many of them
+            // got a fiber.
+            std::uint64_t spins = 0;
+            std::uint64_t spin_hits = 0;
+
+            // Time between a fiber is made ready and it starts running (sampled).
+            std::uint64_t ready_to_run_latency[kLatencyBuckets] = {};
+
+            // Timers fired by the timer worker, and total delay of them (from their
+            // expiration time to the time they're fired).
+            std::uint64_t timers_fired = 0;
+            abel::duration timer_delay;
+        };
+
         // Each scheduling group consists of a group of pthread worker and exactly one
         // timer worker (who is responsible for, timers).
         //
@@ -53,6 +106,9 @@ namespace abel {
             // returned when it's pushed into scheduling queue (by `ready_fiber`) are
             // visible to the caller.
             //
+            // The caller's local queue is tried first, then the shared run queue, and
+            // then local queues of other workers in this group.
+            //
             // Returns `nullptr` if there's none.
             //
             // Returns `kSchedulingGroupShuttingDown` if the entire scheduling group is
@@ -72,6 +128,8 @@ namespace abel {
             // Acquire a fiber. The calling thread does not belong to this scheduling
             // group (i.e., it's stealing a fiber.).
             //
+            // Both the shared run queue and workers' local queues are tried.
+            //
             // Returns `nullptr` if there's none. This method never returns
             // `kSchedulingGroupShuttingDown`.
             fiber_entity *remote_acquire_fiber() noexcept;
@@ -98,6 +156,11 @@ namespace abel {
             // Special case: `scheduler_lock` can be empty if `fiber` has never been run,
             // in this case there is no race possible that should be prevented by
             // `scheduler_lock`.
+            //
+            // If called by a fiber running in this scheduling group, `fiber` is put in
+            // the calling worker's "run next" slot, so that it runs once the caller
+            // gives up its worker (unless it's stolen by other workers after a while).
+            // The fiber previously in the slot is moved to the worker's local queue.
             void ready_fiber(fiber_entity *fiber,
                             std::unique_lock <abel::fiber_internal::spinlock> &&scheduler_lock) noexcept;
 
@@ -229,6 +292,24 @@ namespace abel {
             // workers, otherwise use-after-free can occur.
             void set_timer_worker(timer_worker *worker) noexcept;
 
+            // Set event poller. This method must be called before starting any fiber
+            // worker.
+            //
+            // Fibers in this scheduling group wait for file descriptors' readiness via
+            // this poller.
+            void set_event_poller(event_poller *poller) noexcept;
+
+            // Get event poller of this scheduling group, or `nullptr` if there's none.
+            event_poller *get_event_poller() const noexcept { return event_poller_; }
+
+            // Set io_uring instance. This method must be called before starting any
+            // fiber worker.
+            void set_io_ring(io_ring *ring) noexcept;
+
+            // Get io_uring instance of this scheduling group, or `nullptr` if there's
+            // none.
+            io_ring *get_io_ring() const noexcept { return io_ring_; }
+
             // Shutdown the scheduling group.
             //
             // All further calls to `set_timer` / `DispatchFiber` leads to abort.
@@ -242,7 +323,34 @@ namespace abel {
             // down.
             void stop();
 
+            // Record an attempt of the calling worker to steal fibers from another
+            // scheduling group. Called by `fiber_worker`.
+            void record_foreign_steal(bool cross_numa, bool succeeded) noexcept;
+
+            // Get statistics about this scheduling group. Callable from any thread.
+            //
+            // Counters are read without synchronization, the result is not a consistent
+            // snapshot.
+            scheduling_group_stats get_stats() const;
+
         private:
+            fiber_entity *pop_ready_fiber() noexcept;
+
+            // Try to push `fiber` into calling worker's local queue. Returns `false` if
+            // it should be pushed into the shared run queue instead.
+            bool push_local_fiber(fiber_entity *fiber) noexcept;
+
+            void push_run_queue(fiber_entity *fiber) noexcept;
+
+            // Steal a fiber from local queues of workers in this group (other than
+            // `self_index`). Fibers in "run next" slots are only stolen if they have been
+            // waiting there for a while.
+            fiber_entity *steal_local_fiber(std::size_t self_index) noexcept;
+
+            // Test if any worker other than `self_index` has a fiber in its "run next"
+            // slot.
+            bool has_pending_run_next(std::size_t self_index) const noexcept;
+
             bool wake_up_one_worker() noexcept;
 
             bool wake_up_workers(std::size_t n) noexcept;
@@ -251,6 +359,12 @@ namespace abel {
 
             bool wake_up_one_deep_sleeping_worker() noexcept;
 
+            class worker_stats;
+
+            // Counters of the calling worker, or `nullptr` if the caller is not a fiber
+            // worker of this group.
+            worker_stats *get_worker_stats() noexcept;
+
         private:
             static constexpr auto kUninitializedWorkerIndex =
                     std::numeric_limits<std::size_t>::max();
@@ -262,9 +376,13 @@ namespace abel {
 
             class wait_slot;
 
+            class local_queue;
+
             std::atomic<bool> stopped_{false};
             std::size_t group_size_;
             timer_worker *timer_worker_ = nullptr;
+            event_poller *event_poller_ = nullptr;
+            io_ring *io_ring_ = nullptr;
             core_affinity affinity_;
 
             // Exposes internal state.
@@ -277,6 +395,13 @@ namespace abel {
             // Fiber workers sleep on this.
             std::unique_ptr<wait_slot[]> wait_slots_;
 
+            // Per-worker local queues, or `nullptr` if disabled (by setting
+            // `fiber_config::fiber_local_queue_size` to 0).
+            std::unique_ptr<local_queue[]> local_queues_;
+
+            // Per-worker counters, each only updated by its own worker.
+            std::unique_ptr<worker_stats[]> worker_stats_;
+
             // Bit mask.
             //
             // We carefully chose to use 1 to represent "spinning" and "sleeping", instead
@@ -10,6 +10,8 @@
 #include <sys/mman.h>
 #include <sys/syscall.h>
 #include <unistd.h>
+#include <atomic>
+#include <cstring>
 #include <memory>
 
 #include "abel/base/annotation.h"
@@ -137,16 +139,28 @@ namespace abel {
             return fiber_config::get_global_fiber_config().fiber_stack_enable_guard_page ? kPageSize : 0;
         }
 
-        inline std::size_t GetAllocationSize() {
-            DCHECK(fiber_config::get_global_fiber_config().fiber_stack_size % kPageSize == 0,
+        inline std::size_t GetAllocationSize(std::size_t stack_size) {
+            DCHECK(stack_size % kPageSize == 0,
                         "user_stack size ({}) must be a multiple of page size ({}).",
-                       fiber_config::get_global_fiber_config().fiber_stack_size, kPageSize);
+                       stack_size, kPageSize);
 
-            return fiber_config::get_global_fiber_config().fiber_stack_size + GetBias();
+            return stack_size + GetBias();
         }
 
-        user_stack *create_user_stack_impl() {
-            auto p = mmap(nullptr, GetAllocationSize(), PROT_READ | PROT_WRITE,
+        std::size_t get_user_stack_size(fiber_stack_class stack_class) {
+            auto &&config = fiber_config::get_global_fiber_config();
+            switch (stack_class) {
+                case fiber_stack_class::eSmall:
+                    return config.fiber_small_stack_size;
+                case fiber_stack_class::eLarge:
+                    return config.fiber_large_stack_size;
+                default:
+                    return config.fiber_stack_size;
+            }
+        }
+
+        void *create_user_stack_impl(std::size_t stack_size) {
+            auto p = mmap(nullptr, GetAllocationSize(stack_size), PROT_READ | PROT_WRITE,
                           MAP_PRIVATE | MAP_ANONYMOUS /*| MAP_STACK*/, 0, 0);
             DLOG_CRITICAL_IF(p == nullptr, "{}", kOutOfMemoryError);
             DCHECK_EQ(reinterpret_cast<std::uintptr_t>(p) % kPageSize, 0ul);
@@ -158,25 +172,102 @@ namespace abel {
             // Actual start (lowest address) of the stack.
             auto stack = reinterpret_cast<char *>(p) + GetBias();
             // One byte past the stack region.
-            auto stack_bottom = stack + fiber_config::get_global_fiber_config().fiber_stack_size;
+            auto stack_bottom = stack + stack_size;
 
             // Register the stack.
             stack_registry.RegisterStack(stack_bottom);
 
             // Give it back to the caller.
-            return reinterpret_cast<user_stack *>(stack);
+            return stack;
         }
 
-        void destroy_user_stack_impl(user_stack *ptr) {
+        void destroy_user_stack_impl(void *ptr, std::size_t stack_size) {
             DCHECK(reinterpret_cast<std::uintptr_t>(ptr) % kPageSize == 0);
 
             // Remove the stack from our registry.
-            auto stack_bottom =
-                    reinterpret_cast<char *>(ptr) + fiber_config::get_global_fiber_config().fiber_stack_size;
+            auto stack_bottom = reinterpret_cast<char *>(ptr) + stack_size;
             stack_registry.DeregisterStack(stack_bottom);
 
             //ABEL_PCHECK(munmap(reinterpret_cast<char *>(ptr) - GetBias(),
-              //                  GetAllocationSize()) == 0);
+              //                  GetAllocationSize(stack_size)) == 0);
+        }
+
+        namespace {
+
+            // Returns `true` if `[ptr, ptr + size)` is all zero.
+            bool is_zero_filled(const void *ptr, std::size_t size) {
+                auto p = reinterpret_cast<const std::uint64_t *>(ptr);
+                std::uint64_t acc = 0;
+                for (std::size_t i = 0; i != size / sizeof(std::uint64_t); ++i) {
+                    acc |= p[i];
+                }
+                return acc == 0;
+            }
+
+            // Lowest address in `[ptr, ptr + size)` that is not zero, or `ptr + size`.
+            const char *find_lowest_dirty(const void *ptr, std::size_t size) {
+                auto p = reinterpret_cast<const std::uint64_t *>(ptr);
+                auto words = size / sizeof(std::uint64_t);
+                std::size_t i = 0;
+                while (i != words && p[i] == 0) {
+                    ++i;
+                }
+                return reinterpret_cast<const char *>(p + i);
+            }
+
+            std::atomic<std::uint64_t> stack_usage_samples[kStackUsageBuckets];
+
+        }  // namespace
+
+        void release_user_stack_pages(void *ptr, std::size_t stack_size) {
+            auto watermark = fiber_config::get_global_fiber_config().fiber_stack_release_watermark;
+            if (watermark == 0 || watermark >= stack_size) {
+                return;
+            }
+            DCHECK(watermark % kPageSize == 0,
+                        "Stack release watermark ({}) must be a multiple of page size ({}).",
+                       watermark, kPageSize);
+
+            // Pages beyond the watermark are zero-filled unless the stack has grown
+            // that far since it was (created or) released last time. Checking the page
+            // right beyond the watermark is enough to tell, since the stack grows
+            // contiguously. (Well, unless a large frame skipped the page entirely, in
+            // which case we miss the release, that's acceptable.)
+            //
+            // `MADV_FREE` is not used: Lazily freed pages keep their content until
+            // they're reclaimed, so we couldn't tell them apart from dirty ones here.
+            auto release_limit = reinterpret_cast<char *>(ptr) + stack_size - watermark;
+            if (ABEL_LIKELY(is_zero_filled(release_limit - kPageSize, kPageSize))) {
+                return;
+            }
+            [[maybe_unused]] auto rc =
+                    madvise(ptr, release_limit - reinterpret_cast<char *>(ptr), MADV_DONTNEED);
+            DCHECK_EQ(rc, 0);
+        }
+
+        void prepare_stack_usage_sampling(void *stack, std::size_t usable_size) {
+            // Zero out what previous fibers have used, so that what we see on fiber's
+            // exit is what it has used.
+            auto dirty = find_lowest_dirty(stack, usable_size);
+            auto end = reinterpret_cast<char *>(stack) + usable_size;
+            memset(const_cast<char *>(dirty), 0, end - dirty);
+        }
+
+        void record_stack_usage(const void *stack, std::size_t usable_size) {
+            auto dirty = find_lowest_dirty(stack, usable_size);
+            auto used = reinterpret_cast<const char *>(stack) + usable_size - dirty;
+            std::size_t bucket = 0;
+            while (bucket + 1 != kStackUsageBuckets &&
+                   used > (static_cast<std::ptrdiff_t>(1024) << bucket)) {
+                ++bucket;
+            }
+            stack_usage_samples[bucket].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void get_stack_usage_samples(std::uint64_t (&buckets)[kStackUsageBuckets]) {
+            for (std::size_t i = 0; i != kStackUsageBuckets; ++i) {
+                buckets[i] = stack_usage_samples[i].load(std::memory_order_relaxed);
+            }
         }
 
         system_stack *create_system_stack_impl() {
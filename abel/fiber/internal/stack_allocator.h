@@ -6,9 +6,12 @@
 #define ABEL_FIBER_INTERNAL_STACK_ALLOCATOR_H_
 
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <utility>
 
+#include "abel/base/profile.h"
 #include "abel/memory/object_pool.h"
 #include "abel/log/logging.h"
 #include "abel/fiber/fiber_config.h"
@@ -44,15 +47,61 @@ namespace fiber_internal {
     //
     // The real "object" represented by it is a fiber stack (contiguous pages
     // allocated by `create_user_stack_impl()`.).
+    //
+    // Each size class of user stacks is pooled separately.
         struct user_stack {};
+        struct small_user_stack {};
+        struct large_user_stack {};
         struct system_stack {};
 
-        user_stack* create_user_stack_impl();
-        void destroy_user_stack_impl(user_stack* ptr);
+        // Size of user stacks of the given class.
+        std::size_t get_user_stack_size(fiber_stack_class stack_class);
+
+        template<class T>
+        constexpr fiber_stack_class kStackClassOf = fiber_stack_class::eNormal;
+        template<>
+        constexpr fiber_stack_class kStackClassOf<small_user_stack> = fiber_stack_class::eSmall;
+        template<>
+        constexpr fiber_stack_class kStackClassOf<large_user_stack> = fiber_stack_class::eLarge;
+
+        void *create_user_stack_impl(std::size_t stack_size);
+        void destroy_user_stack_impl(void *ptr, std::size_t stack_size);
+
+        // Called when a user stack is returned to the pool. If the stack was used
+        // beyond `fiber_config::fiber_stack_release_watermark`, the pages beyond the
+        // watermark are returned to the system.
+        void release_user_stack_pages(void *ptr, std::size_t stack_size);
 
         system_stack* create_system_stack_impl();
         void destroy_system_stack_impl(system_stack* ptr);
 
+        // Maximum stack usage of sampled fibers (@sa:
+        // `fiber_config::fiber_stack_usage_sampling_rate`).
+        //
+        // Bucket `i` counts fibers that used at most `2 ** (i + 10)` bytes of stack,
+        // i.e. the first bucket is 1K. The last bucket counts the rest.
+        constexpr std::size_t kStackUsageBuckets = 16;
+
+        void get_stack_usage_samples(std::uint64_t (&buckets)[kStackUsageBuckets]);
+
+        // Returns `true` if the fiber being created should have its stack usage
+        // sampled. Stack of such fiber should be passed to
+        // `prepare_stack_usage_sampling` before use, and to `record_stack_usage`
+        // once the fiber exits.
+        inline bool should_sample_stack_usage() {
+            auto rate = fiber_config::get_global_fiber_config().fiber_stack_usage_sampling_rate;
+            if (ABEL_LIKELY(rate == 0)) {
+                return false;
+            }
+            thread_local std::size_t next = 0;
+            return next++ % rate == 0;
+        }
+
+        // `[stack, stack + usable_size)` is the region the fiber can use.
+        void prepare_stack_usage_sampling(void *stack, std::size_t usable_size);
+
+        void record_stack_usage(const void *stack, std::size_t usable_size);
+
 // System stacks are used solely by us. It's our own responsibility not to
 // overflow the stack. This restriction permits several optimization
 // possibilities.
@@ -67,61 +116,94 @@ constexpr auto kSystemStackSize = 16384 + kSystemStackPoisonedSize;
 
 namespace abel {
 
-    template <>
-    struct pool_traits<abel::fiber_internal::user_stack> {
-        using user_stack = abel::fiber_internal::user_stack;
+    namespace fiber_internal {
 
-        static constexpr auto kType = pool_type::ThreadLocal;
-        static constexpr auto kLowWaterMark = 512;
-        // Don't set high water-mark too large, or we risk running out of
-        // `vm.max_map_count`.
-        static constexpr auto kHighWaterMark = 16384;
-        static constexpr auto kMaxIdle = abel::duration::seconds(10);
-        static constexpr auto kMinimumThreadCacheSize = 32;
-        // If we allocate more stack than necessary, we're risking reaching
-        // max_map_count limit.
-        static constexpr auto kTransferBatchSize = 128;
+        // Shared by pools of all size classes of user stacks.
+        template<class T>
+        struct user_stack_pool_traits {
+            static constexpr auto kType = pool_type::ThreadLocal;
+            static constexpr auto kMaxIdle = abel::duration::seconds(10);
 
-        static auto create() {
-            auto ptr = abel::fiber_internal::create_user_stack_impl();
+            static std::size_t stack_size() {
+                return get_user_stack_size(kStackClassOf<T>);
+            }
+
+            static auto create() {
+                auto ptr = reinterpret_cast<T *>(create_user_stack_impl(stack_size()));
 
 #ifdef ABEL_INTERNAL_USE_ASAN
-            // Poisoned immediately. It's un-poisoned prior to use.
-    abel::asan::poison_memory_region(ptr,
-                                              fiber_config::get_global_fiber_config().fiber_stack_size);
+                // Poisoned immediately. It's un-poisoned prior to use.
+    abel::asan::poison_memory_region(ptr, stack_size());
 #endif
 
-            return ptr;
-        }
+                return ptr;
+            }
 
-        static void destroy(fiber_internal::user_stack* ptr) {
+            static void destroy(T *ptr) {
 #ifdef ABEL_INTERNAL_USE_ASAN
-            // Un-poisoned prior to free so as not to interference with other
+                // Un-poisoned prior to free so as not to interference with other
     // allocations.
-    abel::asan::UnpoisonMemoryRegion(ptr,
-                                                fiber_config::get_global_fiber_config().fiber_stack_size);
+    abel::asan::UnpoisonMemoryRegion(ptr, stack_size());
 #endif
 
-            destroy_user_stack_impl(ptr);
-        }
+                destroy_user_stack_impl(ptr, stack_size());
+            }
 
-        // Canary value here? We've done this for system stack, where guard page is
-        // not applicable.
+            // Canary value here? We've done this for system stack, where guard page is
+            // not applicable.
 
 #ifdef ABEL_INTERNAL_USE_ASAN
 
-        // The stack is not "unpoison"-ed (if ASAN is in use) on get and re-poisoned
+            // The stack is not "unpoison"-ed (if ASAN is in use) on get and re-poisoned
   // on put. This helps us to detect use-after-free of the stack as well.
-  static void OnGet(user_stack* ptr) {
-    abel::asan::UnpoisonMemoryRegion(ptr, fiber_config::get_global_fiber_config().fiber_stack_size.get());
+  static void OnGet(T* ptr) {
+    abel::asan::UnpoisonMemoryRegion(ptr, stack_size());
   }
 
-  static void OnPut(user_stack* ptr) {
-    abel::asan::poison_memory_region(ptr,
-                                              fiber_config::get_global_fiber_config().fiber_stack_size.get());
+  static void OnPut(T* ptr) {
+    release_user_stack_pages(ptr, stack_size());
+    abel::asan::poison_memory_region(ptr, stack_size());
   }
 
+#else
+
+            static void OnPut(T *ptr) { release_user_stack_pages(ptr, stack_size()); }
+
 #endif
+        };
+
+    }  // namespace fiber_internal
+
+    template <>
+    struct pool_traits<abel::fiber_internal::user_stack>
+            : fiber_internal::user_stack_pool_traits<fiber_internal::user_stack> {
+        static constexpr auto kLowWaterMark = 512;
+        // Don't set high water-mark too large, or we risk running out of
+        // `vm.max_map_count`.
+        static constexpr auto kHighWaterMark = 16384;
+        static constexpr auto kMinimumThreadCacheSize = 32;
+        // If we allocate more stack than necessary, we're risking reaching
+        // max_map_count limit.
+        static constexpr auto kTransferBatchSize = 128;
+    };
+
+    template <>
+    struct pool_traits<abel::fiber_internal::small_user_stack>
+            : fiber_internal::user_stack_pool_traits<fiber_internal::small_user_stack> {
+        static constexpr auto kLowWaterMark = 512;
+        static constexpr auto kHighWaterMark = 16384;
+        static constexpr auto kMinimumThreadCacheSize = 32;
+        static constexpr auto kTransferBatchSize = 128;
+    };
+
+    template <>
+    struct pool_traits<abel::fiber_internal::large_user_stack>
+            : fiber_internal::user_stack_pool_traits<fiber_internal::large_user_stack> {
+        // Large stacks are expected to be rare, don't keep too many of them around.
+        static constexpr auto kLowWaterMark = 32;
+        static constexpr auto kHighWaterMark = 1024;
+        static constexpr auto kMinimumThreadCacheSize = 4;
+        static constexpr auto kTransferBatchSize = 16;
     };
 
     template <>
@@ -238,14 +320,34 @@ namespace abel {
 namespace abel {
     namespace fiber_internal {
 
-        // Allocate a memory block of size `fiber_config::fiber_stack_size`.
+        // Allocate a memory block of size `get_user_stack_size(stack_class)`.
         //
         // The result points to the top of the stack (lowest address).
-        inline void* create_user_stack() { return object_pool::get<abel::fiber_internal::user_stack>().leak(); }
+        inline void* create_user_stack(fiber_stack_class stack_class = fiber_stack_class::eNormal) {
+            switch (stack_class) {
+                case fiber_stack_class::eSmall:
+                    return object_pool::get<small_user_stack>().leak();
+                case fiber_stack_class::eLarge:
+                    return object_pool::get<large_user_stack>().leak();
+                default:
+                    return object_pool::get<user_stack>().leak();
+            }
+        }
 
-        // `stack` should point to the top of the stack.
-        inline void free_user_stack(void* stack) {
-            object_pool::put<abel::fiber_internal::user_stack>(reinterpret_cast<abel::fiber_internal::user_stack*>(stack));
+        // `stack` should point to the top of the stack. `stack_class` must be the
+        // one it was created with.
+        inline void free_user_stack(void* stack,
+                                    fiber_stack_class stack_class = fiber_stack_class::eNormal) {
+            switch (stack_class) {
+                case fiber_stack_class::eSmall:
+                    object_pool::put<small_user_stack>(reinterpret_cast<small_user_stack *>(stack));
+                    break;
+                case fiber_stack_class::eLarge:
+                    object_pool::put<large_user_stack>(reinterpret_cast<large_user_stack *>(stack));
+                    break;
+                default:
+                    object_pool::put<user_stack>(reinterpret_cast<user_stack *>(stack));
+            }
         }
 
         // For allocating / deallocating system stacks.
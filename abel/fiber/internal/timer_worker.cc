@@ -16,6 +16,8 @@
 #include "abel/memory/ref_ptr.h"
 #include "abel/fiber/internal/spin_lock.h"
 #include "abel/fiber/internal/scheduling_group.h"
+#include "abel/fiber/internal/timing_wheel.h"
+#include "abel/fiber/fiber_config.h"
 #include "abel/thread/lazy_task.h"
 
 using namespace std::literals;
@@ -55,7 +57,7 @@ namespace abel {
 
         }  // namespace
 
-        struct timer_worker::Entry : abel::pool_ref_counted<timer_worker::Entry> {
+        struct timer_worker::Entry : abel::pool_ref_counted<timer_worker::Entry>, timing_wheel_hook {
             abel::fiber_internal::spinlock lock;  // Protects `cb`.
             std::atomic<bool> cancelled = false;
             bool periodic = false;
@@ -74,6 +76,11 @@ namespace abel {
             std::vector<EntryPtr> timers;
             abel::time_point earliest;
 
+            // Timers cancelled by this thread. They're removed from the timing wheel
+            // by the worker. Not used if timing wheel is disabled.
+            std::vector<EntryPtr> cancelled;
+            timer_worker *owner = nullptr;
+
             // This seemingly useless destructor comforts TSan. Otherwise a data race will
             // be reported between this queue's destruction and its last read (by
             // `timer_worker`).
@@ -87,9 +94,24 @@ namespace abel {
 
         timer_worker::timer_worker(scheduling_group *sg)
         // `+ 1` below for our own worker thread.
-                : sg_(sg), latch(sg_->group_size() + 1), producers_(sg_->group_size() + 1) {}
+                : sg_(sg), latch(sg_->group_size() + 1), producers_(sg_->group_size() + 1) {
+            auto &&config = fiber_config::get_global_fiber_config();
+            if (config.fiber_timer_timing_wheel) {
+                DCHECK_GT(config.fiber_timer_wheel_tick_us, 0);
+                wheel_origin_us_ = abel::time_now().to_unix_micros();
+                wheel_tick_us_ = config.fiber_timer_wheel_tick_us;
+                wheel_ = std::make_unique<timing_wheel<Entry>>();
+            }
+        }
 
-        timer_worker::~timer_worker() = default;
+        timer_worker::~timer_worker() {
+            if (wheel_) {
+                wheel_->clear([](Entry *e) {
+                    // Release the reference held by the wheel.
+                    EntryPtr ptr(adopt_ptr_v, e);
+                });
+            }
+        }
 
         timer_worker *timer_worker::get_timer_owner(std::uint64_t timer_id) {
             return reinterpret_cast<Entry *>(timer_id)->owner;
@@ -151,6 +173,19 @@ namespace abel {
                 ptr->cancelled.store(true, std::memory_order_relaxed);
                 cb = std::move(ptr->cb);
             }
+            if (wheel_ && tls_queue_initialized) {
+                // Let the worker erase it from the wheel on its next round.
+                //
+                // Otherwise (a thread not producing timers for this worker cancelled it)
+                // the timer stays in the wheel and is dropped when its tick is reached.
+                // Without a wheel, the timer is always left in the heap and dropped once
+                // it reaches the top of the heap.
+                auto &&tls_queue = get_thread_local_queue();
+                if (tls_queue->owner == this) {
+                    std::scoped_lock _(tls_queue->lock);
+                    tls_queue->cancelled.push_back(std::move(ptr));
+                }
+            }
             // `cb` is released out of the (timer's) lock.
             // Ref-count on `timer_id` is implicitly release by destruction of `ptr`.
         }
@@ -174,6 +209,7 @@ namespace abel {
                        "Someone else has registered itself as worker #{}.",
                        worker_index);
             producers_[worker_index] = get_thread_local_queue();
+            producers_[worker_index]->owner = this;
             tls_queue_initialized = true;
             latch.count_down();
         }
@@ -216,10 +252,14 @@ namespace abel {
                 // And fire those who has expired.
                 fire_timers();
 
-                if (!timers_.empty()) {
-                    // Do not reset `next_expires_at_` directly here, we need to compare our
-                    // earliest timer with thread-local queues (which is handled by this
-                    // `WakeWorkerIfNeeded`).
+                // Do not reset `next_expires_at_` directly here, we need to compare our
+                // earliest timer with thread-local queues (which is handled by this
+                // `WakeWorkerIfNeeded`).
+                if (wheel_) {
+                    if (!wheel_->empty()) {
+                        wake_worker_if_needed(get_wheel_time(wheel_->next_expiry_tick()));
+                    }
+                } else if (!timers_.empty()) {
                     wake_worker_if_needed(timers_.top()->expires_at);
                 }
 
@@ -261,64 +301,135 @@ namespace abel {
         void timer_worker::wait_for_workers() { latch.wait(); }
 
         void timer_worker::reap_thread_local_queues() {
+            std::vector<EntryPtr> cancelled;
             for (auto &&p : producers_) {
                 std::vector<EntryPtr> t;
                 {
                     std::scoped_lock _(p->lock);
                     t.swap(p->timers);
                     p->earliest = abel::time_point::from_unix_micros(std::numeric_limits<int64_t>::max());
+                    for (auto &&e : p->cancelled) {
+                        cancelled.push_back(std::move(e));
+                    }
+                    p->cancelled.clear();
                 }
                 for (auto &&e : t) {
                     if (e->cancelled.load(std::memory_order_relaxed)) {
                         continue;
                     }
-                    timers_.push(std::move(e));
+                    if (wheel_) {
+                        add_to_wheel(std::move(e));
+                    } else {
+                        timers_.push(std::move(e));
+                    }
+                }
+            }
+
+            // Timers are added before cancellations are handled. In case a timer is
+            // cancelled before it's added (from different threads), it has been dropped
+            // above since its `cancelled` is set.
+            for (auto &&e : cancelled) {
+                DCHECK(e->owner == this);
+                if (wheel_->erase(e.get())) {
+                    // Release the reference held by the wheel.
+                    EntryPtr ptr(adopt_ptr_v, e.get());
                 }
             }
         }
 
         void timer_worker::fire_timers() {
             auto now = abel::time_now();
+            if (wheel_) {
+                // Round down here, a timer fires only if its (rounded up) tick passed.
+                auto now_us = now.to_unix_micros();
+                auto now_tick =
+                        now_us <= wheel_origin_us_ ? 0 : (now_us - wheel_origin_us_) / wheel_tick_us_;
+                wheel_->advance(now_tick, [&](Entry *e) {
+                    EntryPtr ptr(adopt_ptr_v, e);  // Reference held by the wheel.
+                    if (run_timer(ptr.get(), now)) {
+                        add_to_wheel(std::move(ptr));
+                    }
+                });
+                return;
+            }
+
             while (!timers_.empty()) {
-                auto &&e = timers_.top();
-                if (e->cancelled.load(std::memory_order_relaxed)) {
+                auto &&top = timers_.top();
+                if (top->cancelled.load(std::memory_order_relaxed)) {
                     timers_.pop();
                     continue;
                 }
-                if (e->expires_at > now) {
+                if (top->expires_at > now) {
                     break;
                 }
 
-                // This IS slow, but if you have many timers to actually *fire*, you're in
-                // trouble anyway.
-                std::unique_lock lk(e->lock);
-                auto cb = std::move(e->cb);
-                lk.unlock();
-                if (cb) {
-                    // `timer_id` is, actually, pointer to `Entry`.
-                    cb(reinterpret_cast<std::uint64_t>(e.get()));
-                }  // The timer is cancel between we were testing `e->cancelled` and
+                // The timer must be popped before it's (possibly) pushed back.
+                auto e = top;
+                timers_.pop();
+                if (run_timer(e.get(), now)) {
+                    timers_.push(std::move(e));
+                }
+            }
+        }
+
+        bool timer_worker::run_timer(Entry *e, abel::time_point now) {
+            if (e->cancelled.load(std::memory_order_relaxed)) {
+                return false;
+            }
+
+            // This IS slow, but if you have many timers to actually *fire*, you're in
+            // trouble anyway.
+            std::unique_lock lk(e->lock);
+            auto cb = std::move(e->cb);
+            lk.unlock();
+            if (!cb) {
+                // The timer is cancel between we were testing `e->cancelled` and
                 // grabbing `e->lock`.
+                return false;
+            }
+            timers_fired_.store(timers_fired_.load(std::memory_order_relaxed) + 1,
+                                std::memory_order_relaxed);
+            timer_delay_ns_.store(timer_delay_ns_.load(std::memory_order_relaxed) +
+                                  std::max<std::int64_t>(
+                                          (now - e->expires_at).to_int64_nanoseconds(), 0),
+                                  std::memory_order_relaxed);
 
-                // If it's a periodic timer, add a new pending timer.
-                if (e->periodic) {
-                    if (cb) {
-                        // CAUTION: Do NOT create a new `Entry` otherwise timer ID we returned
-                        // in `AddTimer` will be invalidated.
-                        auto cp = std::move(e);  // FIXME: This `std::move` has no effect.
-                        std::unique_lock cplk(cp->lock);
-                        if (!cp->cancelled) {
-                            cp->expires_at = cp->expires_at + cp->interval;
-                            cp->cb = std::move(cb);  // Move user's callback back.
-                            cplk.unlock();
-                            timers_.push(std::move(cp));
-                        }
-                    } else {
-                        DCHECK(e->cancelled.load(std::memory_order_relaxed));
-                    }
-                }
-                timers_.pop();
+            // `timer_id` is, actually, pointer to `Entry`.
+            cb(reinterpret_cast<std::uint64_t>(e));
+
+            // If it's a periodic timer, add a new pending timer.
+            //
+            // CAUTION: Do NOT create a new `Entry` otherwise timer ID we returned in
+            // `AddTimer` will be invalidated.
+            if (!e->periodic) {
+                return false;
             }
+            lk.lock();
+            if (e->cancelled.load(std::memory_order_relaxed)) {
+                lk.unlock();  // `cb` is released out of the lock.
+                return false;
+            }
+            e->expires_at = e->expires_at + e->interval;
+            e->cb = std::move(cb);  // Move user's callback back.
+            return true;
+        }
+
+        std::uint64_t timer_worker::get_wheel_tick(abel::time_point expires_at) const {
+            auto us = expires_at.to_unix_micros();
+            if (us <= wheel_origin_us_) {
+                return 0;
+            }
+            auto elapsed = static_cast<std::uint64_t>(us - wheel_origin_us_);
+            return elapsed / wheel_tick_us_ + (elapsed % wheel_tick_us_ != 0);
+        }
+
+        abel::time_point timer_worker::get_wheel_time(std::uint64_t tick) const {
+            return abel::time_point::from_unix_micros(wheel_origin_us_ + tick * wheel_tick_us_);
+        }
+
+        void timer_worker::add_to_wheel(EntryPtr timer) {
+            auto tick = get_wheel_tick(timer->expires_at);
+            wheel_->insert(timer.leak(), tick);  // Reference is kept by the wheel.
         }
 
         void timer_worker::wake_worker_if_needed(
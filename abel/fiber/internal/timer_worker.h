@@ -8,6 +8,7 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <thread>
@@ -32,7 +33,17 @@ namespace abel {
 
         class scheduling_group;
 
+        template<class>
+        class timing_wheel;
+
         // This class contains a dedicated pthread for running timers.
+        //
+        // Timers are kept in a binary heap by default. If
+        // `fiber_config::fiber_timer_timing_wheel` is set, a hierarchical timing
+        // wheel is used instead. In this case timers are fired at the granularity of
+        // `fiber_config::fiber_timer_wheel_tick_us`, but insertion and cancellation
+        // are O(1), and cancelled timers are released without waiting for them to
+        // expire.
         class alignas(hardware_destructive_interference_size) timer_worker {
         public:
             explicit timer_worker(scheduling_group *sg);
@@ -61,6 +72,16 @@ namespace abel {
 
             scheduling_group *get_scheduling_group();
 
+            // Number of timers fired so far, and the total delay of them (from their
+            // expiration time to the time they're fired). Callable from any thread.
+            std::uint64_t get_timers_fired() const noexcept {
+                return timers_fired_.load(std::memory_order_relaxed);
+            }
+
+            abel::duration get_timer_delay() const noexcept {
+                return abel::duration::nanoseconds(timer_delay_ns_.load(std::memory_order_relaxed));
+            }
+
             // Caller MUST be one of the pthread workers belong to the same scheduling
             // group.
             void initialize_local_queue(std::size_t worker_index);
@@ -96,6 +117,18 @@ namespace abel {
 
             void wake_worker_if_needed(abel::time_point local_expires_at);
 
+            // Run the callback of `e`. Returns `true` if `e` is a periodic timer and
+            // it has been rescheduled (i.e., it should be added back).
+            bool run_timer(Entry *e, abel::time_point now);
+
+            // Conversion between time and ticks of `wheel_`. `expires_at` is rounded
+            // up, so that no timer will fire early.
+            std::uint64_t get_wheel_tick(abel::time_point expires_at) const;
+
+            abel::time_point get_wheel_time(std::uint64_t tick) const;
+
+            void add_to_wheel(EntryPtr timer);
+
             static ThreadLocalQueue *get_thread_local_queue();
 
         private:
@@ -115,6 +148,16 @@ namespace abel {
             std::atomic<int64_t> next_expires_at_{std::numeric_limits<int64_t>::max()};
             std::priority_queue<EntryPtr, std::vector<EntryPtr>, EntryPtrComp> timers_;
 
+            // Used in place of `timers_` if timing wheel is enabled. A reference to
+            // each timer in it is held (but not managed by `ref_ptr`).
+            std::unique_ptr<timing_wheel<Entry>> wheel_;
+            std::int64_t wheel_origin_us_;
+            std::int64_t wheel_tick_us_;
+
+            // Only updated by the timer worker itself.
+            std::atomic<std::uint64_t> timers_fired_{0};
+            std::atomic<std::int64_t> timer_delay_ns_{0};
+
             abel::thread worker_;
 
             // `WorkerProc` sleeps on this.
@@ -0,0 +1,277 @@
+//
+// Created by liyinbin on 2021/5/8.
+//
+
+#ifndef ABEL_FIBER_INTERNAL_TIMING_WHEEL_H_
+#define ABEL_FIBER_INTERNAL_TIMING_WHEEL_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "abel/base/profile.h"
+#include "abel/container/doubly_linked_list.h"
+#include "abel/log/logging.h"
+
+namespace abel {
+    namespace fiber_internal {
+
+        // Objects stored in `timing_wheel` must derive from this class.
+        struct timing_wheel_hook {
+            doubly_linked_list_entry chain;
+            std::uint64_t expires_tick = 0;
+            std::uint16_t slot = 0;  // Index of the slot we're linked in.
+            std::uint8_t level = 0;
+        };
+
+        // A hierarchical timing wheel (in the fashion of the classical Linux kernel
+        // timer), with O(1) insertion and removal.
+        //
+        // Time is measured in abstract "ticks" here, conversion between wall clock
+        // and ticks is left to the user.
+        //
+        // The innermost level has 256 slots, each covering one tick. Each of the 3
+        // outer levels has 64 slots, each covering a whole revolution of its inner
+        // level. Timers in an outer level are moved inwards ("cascaded") once the
+        // inner levels revolve to them. Timers farther than `kMaxSpan` ticks are
+        // parked in the farthest slot and re-evaluated each time they're cascaded.
+        //
+        // Objects are NOT owned by the wheel. This class is not thread-safe.
+        template<class T>
+        class timing_wheel {
+            static_assert(std::is_base_of_v<timing_wheel_hook, T>);
+
+        public:
+            static constexpr std::size_t kLevels = 4;
+            static constexpr std::size_t kInnerBits = 8;
+            static constexpr std::size_t kOuterBits = 6;
+            static constexpr std::uint64_t kMaxSpan = 1ULL
+                    << (kInnerBits + kOuterBits * (kLevels - 1));
+
+            explicit timing_wheel(std::uint64_t current_tick = 0)
+                    : current_(current_tick) {}
+
+            // Tick up to which (inclusive) timers have been expired.
+            std::uint64_t current_tick() const noexcept { return current_; }
+
+            std::size_t size() const noexcept { return size_; }
+
+            bool empty() const noexcept { return size_ == 0; }
+
+            // Insert `entry` to be expired at `expires_tick`. If `expires_tick` has
+            // already been reached, `entry` is expired on next call to `advance`.
+            void insert(T *entry, std::uint64_t expires_tick);
+
+            // Remove `entry` from the wheel. Returns `false` if it's not in the wheel
+            // (either never inserted or has been expired).
+            bool erase(T *entry);
+
+            // Advance the wheel to `to_tick`, calling `on_expired(T *)` for each timer
+            // that expires, in order of their expiration tick. `on_expired` may insert
+            // (or re-insert) timers.
+            template<class F>
+            void advance(std::uint64_t to_tick, F &&on_expired);
+
+            // Returns a tick no later than the earliest timer in the wheel, or
+            // `std::numeric_limits<std::uint64_t>::max()` if the wheel is empty.
+            //
+            // The result is exact for timers in the innermost level. For outer levels,
+            // the tick at which they'll be cascaded is returned.
+            std::uint64_t next_expiry_tick() const;
+
+            // Remove all timers from the wheel, calling `f(T *)` on each of them.
+            template<class F>
+            void clear(F &&f);
+
+            // Non-copyable, non-movable.
+            timing_wheel(const timing_wheel &) = delete;
+
+            timing_wheel &operator=(const timing_wheel &) = delete;
+
+        private:
+            using slot_list = doubly_linked_list<timing_wheel_hook, &timing_wheel_hook::chain>;
+
+            static constexpr std::size_t shift_of(std::size_t level) {
+                return level == 0 ? 0 : kInnerBits + kOuterBits * (level - 1);
+            }
+
+            static constexpr std::size_t slots_of(std::size_t level) {
+                return level == 0 ? (1 << kInnerBits) : (1 << kOuterBits);
+            }
+
+            static constexpr std::size_t base_of(std::size_t level) {
+                return level == 0 ? 0 : slots_of(0) + slots_of(1) * (level - 1);
+            }
+
+            // Timers already due are linked here.
+            static constexpr std::size_t kExpiredSlot = base_of(kLevels);
+
+            void link(T *entry, std::size_t slot, std::size_t level);
+
+            T *pop(std::size_t slot, std::size_t level);
+
+            void cascade(std::uint64_t tick);
+
+            template<class F>
+            void expire(std::size_t slot, std::size_t level, F &&on_expired);
+
+        private:
+            std::uint64_t current_;
+            std::size_t size_ = 0;
+            std::array<std::size_t, kLevels + 1> level_size_{};
+            std::array<slot_list, kExpiredSlot + 1> slots_;
+        };
+
+        template<class T>
+        void timing_wheel<T>::insert(T *entry, std::uint64_t expires_tick) {
+            static_cast<timing_wheel_hook *>(entry)->expires_tick = expires_tick;
+            if (expires_tick <= current_) {
+                link(entry, kExpiredSlot, kLevels);
+                return;
+            }
+            auto delta = expires_tick - current_;
+            auto slot_tick = expires_tick;
+            if (ABEL_UNLIKELY(delta >= kMaxSpan)) {
+                // Park it in the farthest slot. It'll be re-inserted on cascading.
+                delta = kMaxSpan - 1;
+                slot_tick = current_ + delta;
+            }
+            std::size_t level = 0;
+            while ((delta >> shift_of(level + 1)) != 0) {
+                ++level;
+            }
+            auto index = (slot_tick >> shift_of(level)) & (slots_of(level) - 1);
+            link(entry, base_of(level) + index, level);
+        }
+
+        template<class T>
+        bool timing_wheel<T>::erase(T *entry) {
+            timing_wheel_hook *hook = entry;
+            if (!slots_[hook->slot].erase(hook)) {
+                return false;
+            }
+            --size_;
+            --level_size_[hook->level];
+            return true;
+        }
+
+        template<class T>
+        template<class F>
+        void timing_wheel<T>::advance(std::uint64_t to_tick, F &&on_expired) {
+            expire(kExpiredSlot, kLevels, on_expired);
+            while (current_ < to_tick) {
+                if (size_ == 0) {
+                    current_ = to_tick;
+                    break;
+                }
+                if (level_size_[0] == 0) {
+                    // Nothing can expire before next cascading of the innermost
+                    // non-empty level, skip to it directly.
+                    std::size_t level = 1;
+                    while (level != kLevels - 1 && level_size_[level] == 0) {
+                        ++level;
+                    }
+                    auto next = ((current_ >> shift_of(level)) + 1) << shift_of(level);
+                    if (next > to_tick) {
+                        current_ = to_tick;
+                        break;
+                    }
+                    current_ = next - 1;
+                }
+                ++current_;
+                cascade(current_);
+                expire(current_ & (slots_of(0) - 1), 0, on_expired);
+                expire(kExpiredSlot, kLevels, on_expired);
+            }
+        }
+
+        template<class T>
+        std::uint64_t timing_wheel<T>::next_expiry_tick() const {
+            if (level_size_[kLevels] != 0) {
+                return current_;
+            }
+            auto result = std::numeric_limits<std::uint64_t>::max();
+            for (std::size_t level = 0; level != kLevels; ++level) {
+                if (level_size_[level] == 0) {
+                    continue;
+                }
+                auto shift = shift_of(level);
+                auto mask = slots_of(level) - 1;
+                for (std::uint64_t i = 1; i <= slots_of(level); ++i) {
+                    auto block = (current_ >> shift) + i;
+                    if (!slots_[base_of(level) + (block & mask)].empty()) {
+                        auto tick = block << shift;
+                        result = tick < result ? tick : result;
+                        break;
+                    }
+                }
+            }
+            return result;
+        }
+
+        template<class T>
+        template<class F>
+        void timing_wheel<T>::clear(F &&f) {
+            for (std::size_t slot = 0; slot != slots_.size(); ++slot) {
+                while (auto hook = slots_[slot].pop_front()) {
+                    --size_;
+                    --level_size_[hook->level];
+                    f(static_cast<T *>(hook));
+                }
+            }
+            DCHECK_EQ(size_, 0);
+        }
+
+        template<class T>
+        void timing_wheel<T>::link(T *entry, std::size_t slot, std::size_t level) {
+            timing_wheel_hook *hook = entry;
+            hook->slot = static_cast<std::uint16_t>(slot);
+            hook->level = static_cast<std::uint8_t>(level);
+            slots_[slot].push_back(hook);
+            ++size_;
+            ++level_size_[level];
+        }
+
+        template<class T>
+        T *timing_wheel<T>::pop(std::size_t slot, std::size_t level) {
+            auto hook = slots_[slot].pop_front();
+            if (!hook) {
+                return nullptr;
+            }
+            --size_;
+            --level_size_[level];
+            return static_cast<T *>(hook);
+        }
+
+        template<class T>
+        void timing_wheel<T>::cascade(std::uint64_t tick) {
+            for (std::size_t level = 1; level != kLevels; ++level) {
+                if ((tick & ((1ULL << shift_of(level)) - 1)) != 0) {
+                    break;
+                }
+                // Timers here expire in `[tick, tick + (1 << shift_of(level)))` (unless
+                // it's parked), so re-inserting them never lands in the same slot.
+                auto slot = base_of(level) + ((tick >> shift_of(level)) & (slots_of(level) - 1));
+                while (auto entry = pop(slot, level)) {
+                    insert(entry, static_cast<timing_wheel_hook *>(entry)->expires_tick);
+                }
+            }
+        }
+
+        template<class T>
+        template<class F>
+        void timing_wheel<T>::expire(std::size_t slot, std::size_t level, F &&on_expired) {
+            // Timers are popped one by one (instead of splicing the whole slot out),
+            // so that `on_expired` is free to `erase` other timers in this slot.
+            while (auto entry = pop(slot, level)) {
+                DCHECK_LE(static_cast<timing_wheel_hook *>(entry)->expires_tick, current_);
+                on_expired(entry);
+            }
+        }
+
+    }  // namespace fiber_internal
+}  // namespace abel
+
+#endif  // ABEL_FIBER_INTERNAL_TIMING_WHEEL_H_
@@ -6,6 +6,7 @@
 #include "abel/fiber/internal/waitable.h"
 
 #include <array>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -22,9 +23,11 @@ namespace abel {
             // Utility for waking up a fiber sleeping on a `waitable` asynchronously.
             class async_waker {
             public:
-                // Initialize an `async_waker`.
-                async_waker(scheduling_group *sg, fiber_entity *self, wait_block *wb)
-                        : sg_(sg), self_(self), wb_(wb) {}
+                // Initialize an `async_waker`. `satisfied` is the flag shared with whoever
+                // else may wake `self` up (e.g., `wait_block::satisfied`).
+                async_waker(scheduling_group *sg, fiber_entity *self,
+                            std::atomic<bool> *satisfied)
+                        : sg_(sg), self_(self), satisfied_(satisfied) {}
 
                 // The destructor does some sanity checks.
                 ~async_waker() { DCHECK(timer_ == 0, "Have you called `Cleanup()`?"); }
@@ -35,13 +38,13 @@ namespace abel {
                     wait_cb_->waiter = self_;
 
                     // This callback wakes us up if we times out.
-                    auto timer_cb = [wait_cb = wait_cb_ /* ref-counted */, wb = wb_](auto) {
+                    auto timer_cb = [wait_cb = wait_cb_ /* ref-counted */, satisfied = satisfied_](auto) {
                         std::scoped_lock lk(wait_cb->lock);
                         if (!wait_cb->awake) {  // It's (possibly) timed out.
                             // We're holding the lock, and `wait_cb->awake` has not been set yet, so
                             // `Cleanup()` cannot possibly finished yet. Therefore, we can be sure
-                            // `wb` is still alive.
-                            if (wb->satisfied.exchange(true, std::memory_order_relaxed)) {
+                            // `satisfied` is still alive.
+                            if (satisfied->exchange(true, std::memory_order_relaxed)) {
                                 // Someone else satisfied the wait earlier.
                                 return;
                             }
@@ -84,7 +87,7 @@ namespace abel {
 
                 scheduling_group *sg_;
                 fiber_entity *self_;
-                wait_block *wb_;
+                std::atomic<bool> *satisfied_;
                 ref_ptr<WaitCb> wait_cb_;
                 std::uint64_t timer_ = 0;
             };
@@ -144,6 +147,108 @@ namespace abel {
             persistent_awakened_ = false;
         }
 
+        // Implementation of `event_count` goes below.
+
+        std::ptrdiff_t event_count::wait_impl(event_count *const *events,
+                                              const std::uint64_t *keys, std::size_t count,
+                                              abel::time_point expires_at, bool counted) {
+            DCHECK(is_fiber_context_present());
+
+            auto current = get_current_fiber_entity();
+            auto sg = current->own_scheduling_group;
+            std::atomic<bool> satisfied{false};
+            // Not many fibers select on more than a handful of channels.
+            std::array<wait_entry, 8> entries_quick;
+            std::unique_ptr<wait_entry[]> entries_slow;
+            auto entries = entries_quick.data();
+            if (ABEL_UNLIKELY(count > entries_quick.size())) {
+                entries_slow = std::make_unique<wait_entry[]>(count);
+                entries = entries_slow.get();
+            }
+            lazy_init<async_waker> awaker;
+
+            // Holding our scheduler lock, anyone who claimed `satisfied` (and is
+            // going to wake us up) blocks in `ready_fiber()` until we halted.
+            std::unique_lock slk(current->scheduler_lock);
+            std::size_t linked = 0;
+            for (; linked != count; ++linked) {
+                auto &&e = *events[linked];
+                entries[linked].waiter = current;
+                entries[linked].satisfied = &satisfied;
+                entries[linked].counted = counted;
+                std::scoped_lock _(e.lock_);
+                if (e.epoch_.load(std::memory_order_relaxed) != keys[linked]) {
+                    break;  // Notified already.
+                }
+                e.wait_entries_.push_back(&entries[linked]);
+            }
+            if (linked == count) {
+                if (expires_at != abel::time_point::infinite_future()) {
+                    awaker.init(sg, current, &satisfied);
+                    awaker->set_timer(expires_at);
+                }
+                sg->halt(current, std::move(slk));
+            } else if (satisfied.exchange(true, std::memory_order_relaxed)) {
+                // Some notifier has claimed us, and it's going to wake us up.
+                sg->halt(current, std::move(slk));
+            } else {
+                slk.unlock();
+            }
+
+            std::ptrdiff_t result = -1;
+            for (std::size_t index = 0; index != count; ++index) {
+                auto &&e = *events[index];
+                if (index < linked) {
+                    std::scoped_lock _(e.lock_);
+                    e.wait_entries_.erase(&entries[index]);
+                }
+                if (result == -1 && (e.epoch_.load(std::memory_order_relaxed) != keys[index])) {
+                    result = index;
+                }
+                e.cancel_wait();
+            }
+            if (awaker) {
+                awaker->cleanup();
+            }
+            return result;
+        }
+
+        void event_count::notify_slow(std::size_t n) noexcept {
+            // Fibers to wake up. Likewise, `std::vector` won't allocate unless we have
+            // many waiters to wake.
+            std::array<fiber_entity *, 16> fibers_quick;
+            std::size_t array_usage = 0;
+            std::vector<fiber_entity *> fibers_slow;
+            {
+                std::scoped_lock _(lock_);
+                epoch_.fetch_add(1, std::memory_order_relaxed);
+                while (n) {
+                    auto entry = wait_entries_.pop_front();
+                    if (!entry) {
+                        break;
+                    }
+                    if (entry->satisfied->exchange(true, std::memory_order_relaxed)) {
+                        continue;  // Woken up by someone else.
+                    }
+                    if (ABEL_LIKELY(array_usage < std::size(fibers_quick))) {
+                        fibers_quick[array_usage++] = entry->waiter;
+                    } else {
+                        fibers_slow.push_back(entry->waiter);
+                    }
+                    if (entry->counted) {
+                        --n;
+                    }
+                }
+            }
+            for (std::size_t index = 0; index != array_usage; ++index) {
+                auto &&e = fibers_quick[index];
+                e->own_scheduling_group->ready_fiber(e, std::unique_lock(e->scheduler_lock));
+            }
+            for (auto &&e : fibers_slow) {
+                e->own_scheduling_group->ready_fiber(e, std::unique_lock(e->scheduler_lock));
+            }
+        }
+
         waitable_timer::waitable_timer(abel::time_point expires_at)
                 : sg_(scheduling_group::current()),
                 // Does it sense if we use object pool here?
@@ -269,7 +374,7 @@ namespace abel {
             wait_block wb = {.waiter = current};
             DCHECK(impl_.add_waiter(&wb));
             if (use_timeout) {  // Set a timeout if needed.
-                awaker.init(sg, current, &wb);
+                awaker.init(sg, current, &wb.satisfied);
                 awaker->set_timer(expires_at);
             }
 
@@ -95,6 +95,94 @@ namespace abel {
             abel::doubly_linked_list<wait_block, &wait_block::chain> waiters_;
         };
 
+        // Event count, for blocking fibers on lock-free data structures.
+        //
+        // A consumer that found nothing to do calls `prepare_wait()`, re-checks its
+        // condition, and either calls `cancel_wait()` (if the condition is satisfied
+        // now) or `wait()`. A producer calls `notify_xxx()` after it has made the
+        // condition true. Wake-ups between `prepare_wait()` and `wait()` are not lost,
+        // in which case `wait()` returns immediately.
+        //
+        // `notify_xxx` is cheap if no one is waiting. Spurious wake-ups are possible.
+        //
+        // Thread-safe.
+        class event_count {
+        public:
+            // Returns a key to be passed to `wait()`.
+            std::uint64_t prepare_wait() noexcept {
+                // Paired with the fence in `notify()`.
+                waiters_.fetch_add(1, std::memory_order_seq_cst);
+                return epoch_.load(std::memory_order_seq_cst);
+            }
+
+            void cancel_wait() noexcept {
+                waiters_.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            // Block until `notify_xxx()` is called after the call to `prepare_wait()`
+            // that returned `key`, or `expires_at` is reached.
+            //
+            // Returns `false` on timeout.
+            bool wait(std::uint64_t key,
+                      abel::time_point expires_at = abel::time_point::infinite_future()) {
+                auto self = this;
+                return wait_impl(&self, &key, 1, expires_at, true) == 0;
+            }
+
+            // Same as `wait()`, but waits on several event counts at the same time.
+            // `keys[i]` is the key returned by `events[i]->prepare_wait()`.
+            //
+            // Returns index of an event count that was notified, or -1 on timeout.
+            // (As wake-ups can be spurious, the returned one is only a hint.)
+            //
+            // The caller may well not act on the wake-up (e.g., `fiber_select` returns
+            // another ready case, or its caller doesn't take the value), so waking it
+            // up doesn't count against `n` of `notify(n)`: it's woken up in addition
+            // to `n` waiters of `wait()`.
+            static std::ptrdiff_t wait_any(event_count *const *events, const std::uint64_t *keys,
+                                           std::size_t count, abel::time_point expires_at) {
+                return wait_impl(events, keys, count, expires_at, false);
+            }
+
+            // Wake up at most `n` waiters.
+            void notify(std::size_t n) noexcept {
+                // Paired with `prepare_wait()`. Either we see the waiter, or it sees
+                // the condition we made true.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (ABEL_LIKELY(waiters_.load(std::memory_order_relaxed) == 0)) {
+                    return;
+                }
+                notify_slow(n);
+            }
+
+            void notify_one() noexcept { notify(1); }
+
+            void notify_all() noexcept { notify(std::numeric_limits<std::size_t>::max()); }
+
+        private:
+            // Allocated on waiter's stack, one for each event count it waits on.
+            struct wait_entry {
+                fiber_entity *waiter;
+                abel::doubly_linked_list_entry chain;
+                // Shared by all entries of the same waiter.
+                std::atomic<bool> *satisfied;
+                // Whether waking this waiter up counts against `n` of `notify(n)`.
+                bool counted;
+            };
+
+            static std::ptrdiff_t wait_impl(event_count *const *events, const std::uint64_t *keys,
+                                            std::size_t count, abel::time_point expires_at,
+                                            bool counted);
+
+            void notify_slow(std::size_t n) noexcept;
+
+        private:
+            abel::fiber_internal::spinlock lock_;
+            std::atomic<std::uint64_t> epoch_{0};
+            std::atomic<std::uint32_t> waiters_{0};
+            abel::doubly_linked_list<wait_entry, &wait_entry::chain> wait_entries_;
+        };
+
         // "waitable" timer. This `waitable` signals all its waiters once the given time
         // point is reached.
         class waitable_timer {
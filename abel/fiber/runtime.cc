@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -16,9 +17,13 @@
 
 #include "abel/base/annotation.h"
 #include "abel/base/random.h"
+#include "abel/metrics/scope.h"
 #include "abel/thread/numa.h"
+#include "abel/fiber/internal/event_poller.h"
+#include "abel/fiber/internal/io_ring.h"
 #include "abel/fiber/internal/fiber_worker.h"
 #include "abel/fiber/internal/scheduling_group.h"
+#include "abel/fiber/internal/stack_allocator.h"
 #include "abel/fiber/internal/timer_worker.h"
 #include "abel/strings/case_conv.h"
 #include "abel/fiber/fiber_config.h"
@@ -28,15 +33,24 @@ namespace abel {
 
     namespace {
 
-        // `scheduling_group` and its workers (both fiber worker and timer worker).
+        // `scheduling_group` and its workers (fiber worker, timer worker, event
+        // poller and io_uring instance).
         struct scheduling_worker {
             int node_id;
             std::unique_ptr<fiber_internal::scheduling_group> scheduling_group;
             std::vector<std::unique_ptr<fiber_internal::fiber_worker>> fiber_workers;
             std::unique_ptr<fiber_internal::timer_worker> timer_worker;
+            std::unique_ptr<fiber_internal::event_poller> event_poller;
+            std::unique_ptr<fiber_internal::io_ring> io_ring;
 
             void start(bool no_cpu_migration) {
                 timer_worker->start();
+                if (event_poller) {
+                    event_poller->start();
+                }
+                if (io_ring) {
+                    io_ring->start();
+                }
                 for (auto &&e : fiber_workers) {
                     e->start(no_cpu_migration);
                 }
@@ -44,11 +58,23 @@ namespace abel {
 
             void stop() {
                 timer_worker->stop();
+                if (event_poller) {
+                    event_poller->stop();
+                }
+                if (io_ring) {
+                    io_ring->stop();
+                }
                 scheduling_group->stop();
             }
 
             void join() {
                 timer_worker->join();
+                if (event_poller) {
+                    event_poller->join();
+                }
+                if (io_ring) {
+                    io_ring->join();
+                }
                 for (auto &&e : fiber_workers) {
                     e->join();
                 }
@@ -108,6 +134,20 @@ namespace abel {
             rc->timer_worker =
                     std::make_unique<fiber_internal::timer_worker>(rc->scheduling_group.get());
             rc->scheduling_group->set_timer_worker(rc->timer_worker.get());
+#if defined(ABEL_PLATFORM_LINUX)
+            rc->event_poller =
+                    std::make_unique<fiber_internal::event_poller>(rc->scheduling_group.get());
+            rc->scheduling_group->set_event_poller(rc->event_poller.get());
+            auto &&conf = fiber_config::get_global_fiber_config();
+            if (conf.fiber_enable_io_uring) {
+                rc->io_ring = fiber_internal::io_ring::create(
+                        rc->scheduling_group.get(), conf.fiber_io_uring_entries,
+                        conf.fiber_io_uring_registered_blocks);
+                DLOG_WARN_IF(!rc->io_ring,
+                             "io_uring is not usable, falling back to plain syscalls.");
+                rc->scheduling_group->set_io_ring(rc->io_ring.get());
+            }
+#endif
             return rc;
         }
 
@@ -118,13 +158,17 @@ namespace abel {
         void initialize_foreign_scheduling_groups(
                 const std::vector<std::unique_ptr<scheduling_worker>> &thieves,
                 const std::vector<std::unique_ptr<scheduling_worker>> &victims,
-                std::uint64_t steal_every_n) {
-            ABEL_UNUSED(steal_every_n);
+                std::uint64_t steal_every_n, bool cross_numa = false) {
             for (std::size_t thief = 0; thief != thieves.size(); ++thief) {
                 for (std::size_t victim = 0; victim != victims.size(); ++victim) {
                     if (thieves[thief]->scheduling_group ==
                         victims[victim]->scheduling_group) {
-                        return;
+                        continue;
+                    }
+                    for (auto &&e : thieves[thief]->fiber_workers) {
+                        e->add_foreign_scheduling_group(
+                                victims[victim]->scheduling_group.get(), steal_every_n,
+                                cross_numa);
                     }
                 }
             }
@@ -217,7 +261,8 @@ namespace abel {
                     initialize_foreign_scheduling_groups(
                             scheduling_groups[i], scheduling_groups[j],
                             i == j ? fiber_config::get_global_fiber_config().work_stealing_ratio
-                                   : fiber_config::get_global_fiber_config().cross_numa_work_stealing_ratio);
+                                   : fiber_config::get_global_fiber_config().cross_numa_work_stealing_ratio,
+                            i != j);
                 }
             }
         }
@@ -296,6 +341,65 @@ namespace abel {
             return result;
         }
 
+        // Our counters are cumulative, so is `counter`. Reporting them repeatedly
+        // only moves `counter` forward by the difference.
+        void report_counter(const metrics::counter_ptr &counter, double value) {
+            auto delta = value - counter->value();
+            if (delta > 0) {
+                counter->inc(delta);
+            }
+        }
+
+        // Same as above, for counts. They go into `int_counter`s, which stay
+        // exact and are updated without a CAS loop.
+        void report_counter(const metrics::int_counter_ptr &counter, std::uint64_t value) {
+            auto current = counter->value();
+            if (value > current) {
+                counter->inc(value - current);
+            }
+        }
+
+        // `buckets` are counts of the histogram buckets bounded by `bounds`, the last
+        // one is `+Inf`.
+        void report_histogram(const metrics::scope_ptr &scope, const std::string &name,
+                              const std::vector<double> &bounds,
+                              const std::uint64_t *buckets, std::size_t size) {
+            DCHECK_EQ(bounds.size() + 1, size);
+            auto histogram = scope->get_histogram(name, bounds);
+            auto reported = histogram->collect().histogram.bucket;
+            DCHECK_EQ(reported.size(), size);
+            std::uint64_t previous = 0;
+            for (std::size_t i = 0; i != size; ++i) {
+                auto count = reported[i].cumulative_count - previous;
+                previous = reported[i].cumulative_count;
+                if (buckets[i] > count) {
+                    // Only bucket boundaries are known, so is the sum.
+                    auto value = i + 1 == size ? bounds.back() * 2 : bounds[i];
+                    histogram->observe(value, buckets[i] - count);
+                }
+            }
+        }
+
+        void report_ready_to_run_latency(
+                const metrics::scope_ptr &scope,
+                const std::uint64_t (&buckets)[fiber_internal::scheduling_group_stats::kLatencyBuckets]) {
+            constexpr auto kBuckets = fiber_internal::scheduling_group_stats::kLatencyBuckets;
+            // Buckets are powers of 2 in microseconds, the last one is `+Inf`.
+            static const auto kBounds =
+                    metrics::bucket_builder::exponential_values(1, 2, kBuckets - 1);
+            report_histogram(scope, "ready_to_run_latency_us", kBounds, buckets, kBuckets);
+        }
+
+        void report_stack_usage(const metrics::scope_ptr &scope) {
+            constexpr auto kBuckets = fiber_internal::kStackUsageBuckets;
+            // Buckets are powers of 2 in bytes starting from 1K, the last one is `+Inf`.
+            static const auto kBounds =
+                    metrics::bucket_builder::exponential_values(1024, 2, kBuckets - 1);
+            std::uint64_t buckets[kBuckets];
+            fiber_internal::get_stack_usage_samples(buckets);
+            report_histogram(scope, "fiber_stack_usage_bytes", kBounds, buckets, kBuckets);
+        }
+
     }  // namespace
 
     namespace fiber_internal {
@@ -370,6 +474,41 @@ namespace abel {
         return flatten_scheduling_groups[sg_index]->node_id;
     }
 
+    void report_runtime_metrics(const std::shared_ptr<metrics::scope> &scope) {
+        // Concurrent calls would race on computing the difference to report.
+        static std::mutex lock;
+        std::scoped_lock _(lock);
+
+        for (std::size_t index = 0; index != flatten_scheduling_groups.size(); ++index) {
+            auto stats = flatten_scheduling_groups[index]->scheduling_group->get_stats();
+            auto sg_scope = scope->tagged({{"scheduling_group", std::to_string(index)}});
+
+            report_counter(sg_scope->get_int_counter("fibers_run"), stats.fibers_run);
+            sg_scope->get_gauge("run_queue_high_water")->update(stats.run_queue_high_water);
+            report_counter(sg_scope->get_int_counter("local_steals"), stats.local_steals);
+            report_counter(sg_scope->get_int_counter("foreign_steals_same_numa"),
+                           stats.foreign_steals[0]);
+            report_counter(sg_scope->get_int_counter("foreign_steals_cross_numa"),
+                           stats.foreign_steals[1]);
+            report_counter(sg_scope->get_int_counter("foreign_steal_failures_same_numa"),
+                           stats.foreign_steal_failures[0]);
+            report_counter(sg_scope->get_int_counter("foreign_steal_failures_cross_numa"),
+                           stats.foreign_steal_failures[1]);
+            report_counter(sg_scope->get_int_counter("sleeps"), stats.sleeps);
+            report_counter(sg_scope->get_counter("sleep_seconds"),
+                           stats.sleep_time.to_double_seconds());
+            report_counter(sg_scope->get_int_counter("spins"), stats.spins);
+            report_counter(sg_scope->get_int_counter("spin_hits"), stats.spin_hits);
+            report_counter(sg_scope->get_int_counter("timers_fired"), stats.timers_fired);
+            report_counter(sg_scope->get_counter("timer_delay_seconds"),
+                           stats.timer_delay.to_double_seconds());
+            report_ready_to_run_latency(sg_scope, stats.ready_to_run_latency);
+        }
+        if (fiber_config::get_global_fiber_config().fiber_stack_usage_sampling_rate) {
+            report_stack_usage(scope);
+        }
+    }
+
     namespace fiber_internal {
 
         scheduling_group *routine_get_scheduling_group(std::size_t index) {
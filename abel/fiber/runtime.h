@@ -7,12 +7,19 @@
 
 
 #include <cstdlib>
+#include <memory>
 
 #include "abel/base/annotation.h"
 #include "abel/base/profile.h"
 
 namespace abel {
 
+    namespace metrics {
+
+        class scope;
+
+    }  // namespace metrics
+
     namespace fiber_internal {
 
         std::size_t get_current_scheduling_groupIndex_slow();
@@ -46,6 +53,15 @@ namespace abel {
     // sense if NUMA aware is enabled. Otherwise 0 is returned.
     int get_scheduling_group_assigned_node(std::size_t sg_index);
 
+    // Report statistics about the fiber runtime (@sa: `scheduling_group_stats`) to
+    // `scope`. Metrics of each scheduling group are reported to a sub-scope tagged
+    // with `scheduling_group=<index>`. If stack usage sampling is enabled, the
+    // histogram of sampled stack usage is reported to `scope` itself.
+    //
+    // The statistics are collected from workers' counters on call, so you'd call
+    // this periodically, or before `scope` is serialized.
+    void report_runtime_metrics(const std::shared_ptr<metrics::scope> &scope);
+
     namespace fiber_internal {
 
         class scheduling_group;
@@ -0,0 +1,142 @@
+//
+// Created by liyinbin on 2021/5/8.
+//
+
+#include "abel/fiber/uring_io_stream.h"
+
+#include <errno.h>
+#include <fcntl.h>
+
+#include <algorithm>
+
+#include "abel/base/profile.h"
+#include "abel/fiber/internal/fiber_entity.h"
+#include "abel/fiber/internal/io_ring.h"
+#include "abel/fiber/internal/scheduling_group.h"
+#include "abel/fiber/runtime.h"
+#include "abel/io/safe_io.h"
+#include "abel/log/logging.h"
+
+#if defined(ABEL_PLATFORM_LINUX)
+
+#include <linux/io_uring.h>
+
+#endif
+
+namespace abel {
+
+    namespace {
+
+#if defined(ABEL_PLATFORM_LINUX)
+
+        void prep_rw(io_uring_sqe *sqe, int op, int fd, int flags, const void *addr,
+                     std::size_t len) {
+            sqe->opcode = op;
+            sqe->rw_flags = flags;
+            sqe->fd = fd;
+            sqe->off = -1;  // Current file position, as `readv` / `writev` does.
+            sqe->addr = reinterpret_cast<std::uint64_t>(addr);
+            sqe->len = len;
+        }
+
+        // Translate `res` of completions into return value of `readv` & friends.
+        ssize_t to_syscall_result(int res) {
+            if (ABEL_UNLIKELY(res < 0)) {
+                errno = -res;
+                return -1;
+            }
+            return res;
+        }
+
+        // Submit a read / write request to `ring`. If the buffer lies in registered
+        // region, `*_FIXED` variant of `op` is used.
+        ssize_t submit_rw(fiber_internal::io_ring *ring, int op, int fixed_op, int fd,
+                          int flags, const void *buf, std::size_t len) {
+            auto pool = ring->get_buffer_pool();
+            bool fixed = pool && pool->contains(buf, len);
+            return to_syscall_result(ring->submit_and_wait([&](io_uring_sqe *sqe) {
+                prep_rw(sqe, fixed ? fixed_op : op, fd, flags, buf, len);
+                if (fixed) {
+                    sqe->buf_index = fiber_internal::io_ring::kRegisteredBufferIndex;
+                }
+            }));
+        }
+
+#endif
+
+    }  // namespace
+
+    uring_io_stream::uring_io_stream(int fd) : fd_(fd) {
+        auto sg = fiber_internal::nearest_scheduling_group();
+        DCHECK(sg, "Fiber runtime is not started yet.");
+        ring_ = sg->get_io_ring();
+#if defined(ABEL_PLATFORM_LINUX)
+        // io_uring waits for readiness even if `O_NONBLOCK` is set, ask it to
+        // report `EAGAIN` instead.
+        rw_flags_ = (fcntl(fd, F_GETFL) & O_NONBLOCK) ? RWF_NOWAIT : 0;
+#endif
+    }
+
+    ssize_t uring_io_stream::readv(const iovec *iov, int iovcnt) {
+#if defined(ABEL_PLATFORM_LINUX)
+        if (auto ring = get_usable_ring()) {
+            if (iovcnt == 1) {
+                return submit_rw(ring, IORING_OP_READ, IORING_OP_READ_FIXED, fd_,
+                                 rw_flags_, iov->iov_base, iov->iov_len);
+            }
+            return to_syscall_result(ring->submit_and_wait([&](io_uring_sqe *sqe) {
+                prep_rw(sqe, IORING_OP_READV, fd_, rw_flags_, iov, iovcnt);
+            }));
+        }
+#endif
+        return abel::safe_readv(fd_, iov, iovcnt);
+    }
+
+    ssize_t uring_io_stream::writev(const iovec *iov, int iovcnt) {
+#if defined(ABEL_PLATFORM_LINUX)
+        if (auto ring = get_usable_ring()) {
+            if (iovcnt == 1) {
+                return submit_rw(ring, IORING_OP_WRITE, IORING_OP_WRITE_FIXED, fd_,
+                                 rw_flags_, iov->iov_base, iov->iov_len);
+            }
+            return to_syscall_result(ring->submit_and_wait([&](io_uring_sqe *sqe) {
+                prep_rw(sqe, IORING_OP_WRITEV, fd_, rw_flags_, iov, iovcnt);
+            }));
+        }
+#endif
+        return abel::safe_writev(fd_, iov, iovcnt);
+    }
+
+    ssize_t uring_io_stream::read(iobuf *to, std::size_t max_bytes) {
+        ref_ptr<native_iobuf_block> block;
+#if defined(ABEL_PLATFORM_LINUX)
+        if (auto ring = get_usable_ring(); ring && ring->get_buffer_pool()) {
+            block = ring->get_buffer_pool()->try_get_block();
+        }
+#endif
+        if (!block) {  // Registered blocks are exhausted.
+            block = make_native_ionuf_block();
+        }
+
+        iovec iov = {block->mutable_data(), std::min(max_bytes, block->size())};
+        auto rc = readv(&iov, 1);
+        if (rc > 0) {
+            to->append(iobuf_slice(std::move(block), 0, rc));
+        }
+        return rc;
+    }
+
+    fiber_internal::io_ring *uring_io_stream::get_usable_ring() const noexcept {
+        // The pthread worker would be blocked otherwise.
+        return ring_ && fiber_internal::is_fiber_context_present() ? ring_ : nullptr;
+    }
+
+    std::unique_ptr<io_stream_base> make_fiber_io_stream(int fd) {
+        auto sg = fiber_internal::nearest_scheduling_group();
+        if (sg && sg->get_io_ring()) {
+            return std::make_unique<uring_io_stream>(fd);
+        }
+        return std::make_unique<system_io_stream>(fd);
+    }
+
+}  // namespace abel
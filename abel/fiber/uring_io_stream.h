@@ -0,0 +1,81 @@
+//
+// Created by liyinbin on 2021/5/8.
+//
+
+#ifndef ABEL_FIBER_URING_IO_STREAM_H_
+#define ABEL_FIBER_URING_IO_STREAM_H_
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <cstddef>
+#include <memory>
+
+#include "abel/io/io_stream.h"
+#include "abel/io/iobuf.h"
+
+namespace abel {
+
+    namespace fiber_internal {
+
+        class io_ring;
+
+    }  // namespace fiber_internal
+
+    // `io_stream_base` implemented on top of io_uring instance of the nearest
+    // scheduling group (@sa: `fiber_config::fiber_enable_io_uring`).
+    //
+    // I/O requests issued by fibers in the same scheduling group are batched and
+    // submitted to the kernel in a single syscall, the calling fiber is parked
+    // (instead of blocking the pthread worker) until its request completes. For
+    // non-blocking file descriptors (checked on construction), `EAGAIN` is
+    // reported as usual, so this class can be used as a drop-in replacement of
+    // `system_io_stream` (e.g., with `fiber_read_iobuf`).
+    //
+    // If io_uring is not available (disabled, unsupported by the kernel, or not
+    // called in fiber context), plain `readv` / `writev` is used instead.
+    //
+    // Ownership of the file descriptor is NOT taken.
+    class uring_io_stream : public io_stream_base {
+    public:
+        // Must be constructed after fiber runtime is started.
+        explicit uring_io_stream(int fd);
+
+        hand_shake_status handshake() override {
+            return hand_shake_status::eSuccess;
+        }
+
+        ssize_t readv(const iovec *iov, int iovcnt) override;
+
+        ssize_t writev(const iovec *iov, int iovcnt) override;
+
+        // Read at most `max_bytes` bytes (but no more than a single block) into
+        // `to`, into buffers registered to the kernel if possible, saving the kernel
+        // from pinning pages on each request.
+        //
+        // Returns bytes read (0 on EOF). On error, -1 is returned and `errno` is
+        // set.
+        ssize_t read(iobuf *to, std::size_t max_bytes);
+
+        int get_fd() const noexcept { return fd_; }
+
+        // Test if requests are actually carried out by io_uring.
+        bool is_uring_enabled() const noexcept { return ring_ != nullptr; }
+
+    private:
+        // Returns `ring_` if it can be used by the caller.
+        fiber_internal::io_ring *get_usable_ring() const noexcept;
+
+    private:
+        const int fd_;
+        fiber_internal::io_ring *ring_;
+        int rw_flags_ = 0;
+    };
+
+    // Create an `uring_io_stream` if io_uring is enabled on the nearest scheduling
+    // group, or `system_io_stream` otherwise.
+    std::unique_ptr<io_stream_base> make_fiber_io_stream(int fd);
+
+}  // namespace abel
+
+#endif  // ABEL_FIBER_URING_IO_STREAM_H_
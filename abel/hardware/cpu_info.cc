@@ -23,6 +23,7 @@ cpu_info::cpu_info()
           has_sse42_(false),
           has_avx_(false),
           has_avx_hardware_(false),
+          has_avx2_(false),
           has_aesni_(false),
           has_non_stop_time_stamp_counter_(false),
           cpu_vendor_("unknown") {
@@ -46,6 +47,16 @@ void __cpuid(int cpu_info[4], int info_type) {
   );
 }
 
+void __cpuidex(int cpu_info[4], int info_type, int sub_type) {
+  __asm__ volatile (
+    "mov %%ebx, %%edi\n"
+    "cpuid\n"
+    "xchg %%edi, %%ebx\n"
+    : "=a"(cpu_info[0]), "=D"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
+    : "a"(info_type), "c"(sub_type)
+  );
+}
+
 #else
 
 void __cpuid(int cpu_info[4], int info_type) {
@@ -56,6 +67,14 @@ void __cpuid(int cpu_info[4], int info_type) {
     );
 }
 
+void __cpuidex(int cpu_info[4], int info_type, int sub_type) {
+    __asm__ volatile (
+    "cpuid \n\t"
+    : "=a"(cpu_info[0]), "=b"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
+    : "a"(info_type), "c"(sub_type)
+    );
+}
+
 #endif
 
 // _xgetbv returns the value of an Intel Extended Control Register (XCR).
@@ -184,6 +203,13 @@ void cpu_info::initialize() {
         has_aesni_ = (cpu_info[2] & 0x02000000) != 0;
     }
 
+    // Structured extended feature flags.
+    if (num_ids >= 7) {
+        __cpuidex(cpu_info, 7, 0);
+        // AVX2 relies on the same OS support (saving YMM state) as AVX.
+        has_avx2_ = has_avx_ && (cpu_info[1] & 0x00000020) != 0;
+    }
+
     // Get the brand string of the cpu.
     __cpuid(cpu_info, 0x80000000);
     const int parameter_end = 0x80000004;
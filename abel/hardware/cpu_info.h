@@ -71,6 +71,10 @@ class cpu_info {
     // to workaround a bug in NSS but |has_avx()| is what you want.
     bool has_avx_hardware() const { return has_avx_hardware_; }
 
+    // AVX2 instructions are usable (both the CPU and the operating system
+    // support them.)
+    bool has_avx2() const { return has_avx2_; }
+
     bool has_aesni() const { return has_aesni_; }
 
     bool has_non_stop_time_stamp_counter() const {
@@ -100,6 +104,7 @@ class cpu_info {
     bool has_sse42_;
     bool has_avx_;
     bool has_avx_hardware_;
+    bool has_avx2_;
     bool has_aesni_;
     bool has_non_stop_time_stamp_counter_;
     std::string cpu_vendor_;
@@ -6,6 +6,8 @@
 #define ABEL_IO_INTERNAL_IOBUF_BASE_H_
 
 
+#include <sys/types.h>
+
 #include <atomic>
 #include <chrono>
 #include <limits>
@@ -34,6 +36,11 @@ namespace abel {
         virtual std::size_t size() const noexcept = 0;
 
         virtual void destroy() noexcept { delete this; }
+
+        // If this block is backed by a file, returns the file descriptor, and
+        // `*offset` is set to the position in the file where `data()` begins.
+        // Otherwise -1 is returned.
+        virtual int get_file(off_t * /*offset*/) const noexcept { return -1; }
     };
 
 
@@ -70,6 +77,9 @@ namespace abel {
 
         std::size_t size() const noexcept { return size_; }
 
+        // The buffer block we're referencing.
+        const iobuf_block *block() const noexcept { return ref_.get(); }
+
         // Changes the portion of buffer we're seeing.
         void skip(std::size_t bytes) {
             DCHECK_LT(bytes, size_);
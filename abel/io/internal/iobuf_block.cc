@@ -5,6 +5,9 @@
 
 #include "abel/io/internal/iobuf_block.h"
 
+#include <sys/mman.h>
+#include <unistd.h>
+
 #include <string>
 #include <unordered_map>
 
@@ -42,19 +45,72 @@ namespace abel {
         abel::ref_ptr<native_iobuf_block> (*make_native_buffer_block)() =
         make_buffer_block_of_bytes<4096>;
 
+        // Size of blocks returned by `make_native_buffer_block`.
+        const std::size_t kNativeBufferBlockSize = fixed_buffer_block<4096>::kBufferSize;
+
     }  // namespace
 
     abel::ref_ptr<native_iobuf_block> make_native_ionuf_block() {
         return make_native_buffer_block();
     }
 
+    abel::ref_ptr<native_iobuf_block> make_native_ionuf_block(std::size_t size_hint) {
+        if (size_hint >= fixed_buffer_block<1048576>::kBufferSize / 2) {
+            return make_buffer_block_of_bytes<1048576>();
+        }
+        if (size_hint >= fixed_buffer_block<65536>::kBufferSize / 2) {
+            return make_buffer_block_of_bytes<65536>();
+        }
+        return make_native_buffer_block();
+    }
+
+    std::size_t get_native_iobuf_block_size(std::size_t size_hint) noexcept {
+        if (size_hint >= fixed_buffer_block<1048576>::kBufferSize / 2) {
+            return fixed_buffer_block<1048576>::kBufferSize;
+        }
+        if (size_hint >= fixed_buffer_block<65536>::kBufferSize / 2) {
+            return fixed_buffer_block<65536>::kBufferSize;
+        }
+        return kNativeBufferBlockSize;
+    }
+
+    abel::ref_ptr<file_iobuf_block> file_iobuf_block::create(int fd, off_t offset,
+                                                             std::size_t size) {
+        // Closes `fd` on failure.
+        abel::ref_ptr<file_iobuf_block> block(abel::adopt_ptr_v, new file_iobuf_block());
+        block->fd_ = fd;
+        block->offset_ = offset;
+        block->size_ = size;
+
+        // The mapping must start at page boundary.
+        static const auto kPageSize = getpagesize();
+        auto aligned = offset / kPageSize * kPageSize;
+        block->mapping_size_ = size + (offset - aligned);
+        auto p = mmap(nullptr, block->mapping_size_, PROT_READ, MAP_SHARED, fd, aligned);
+        if (p == MAP_FAILED) {
+            return nullptr;
+        }
+        block->mapping_ = p;
+        block->data_ = reinterpret_cast<const char *>(p) + (offset - aligned);
+        return block;
+    }
+
+    file_iobuf_block::~file_iobuf_block() {
+        if (mapping_) {
+            munmap(mapping_, mapping_size_);
+        }
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
 }  // namespace abel
 
 namespace abel {
 
     template<>
     struct pool_traits<abel::fixed_buffer_block<4096>> {
-        static constexpr auto kType = pool_type::ThreadLocal;
+        static constexpr auto kType = pool_type::MemoryNodeShared;
         static constexpr auto kLowWaterMark = 16384;  // 64M per node.
         static constexpr auto kHighWaterMark =
                 std::numeric_limits<std::size_t>::max();
@@ -65,7 +121,7 @@ namespace abel {
 
     template<>
     struct pool_traits<abel::fixed_buffer_block<65536>> {
-        static constexpr auto kType = pool_type::ThreadLocal;
+        static constexpr auto kType = pool_type::MemoryNodeShared;
         static constexpr auto kLowWaterMark = 1024;  // 64M per node.
         static constexpr auto kHighWaterMark =
                 std::numeric_limits<std::size_t>::max();
@@ -76,7 +132,7 @@ namespace abel {
 
     template<>
     struct pool_traits<abel::fixed_buffer_block<1048576>> {
-        static constexpr auto kType = pool_type::ThreadLocal;
+        static constexpr auto kType = pool_type::MemoryNodeShared;
         static constexpr auto kLowWaterMark = 128;  // 128M per node.
         static constexpr auto kHighWaterMark =
                 std::numeric_limits<std::size_t>::max();
@@ -30,6 +30,17 @@ namespace abel {
     // implementation for detail.
     abel::ref_ptr<native_iobuf_block> make_native_ionuf_block();
 
+    // Allocate a buffer block for holding (about) `size_hint` bytes.
+    //
+    // Blocks come in three size classes: 4K, 64K and 1M (block header included).
+    // The largest class that is no more than twice of `size_hint` is used, so at
+    // most half of the block is wasted if the hint is accurate. Large transfers
+    // are therefore carried by much fewer blocks (and therefore slices.)
+    abel::ref_ptr<native_iobuf_block> make_native_ionuf_block(std::size_t size_hint);
+
+    // Size of the block `make_native_ionuf_block(size_hint)` would return.
+    std::size_t get_native_iobuf_block_size(std::size_t size_hint) noexcept;
+
     // This buffer references a non-owning memory region.
     //
     // The buffer creator is responsible for making sure the memory region
@@ -57,6 +68,45 @@ namespace abel {
         std::size_t size_;
     };
 
+    // This buffer references a (read-only) mapping of a file region.
+    //
+    // The file descriptor is kept open as long as the block is alive, so that
+    // the region can be sent out via `sendfile` instead of through the mapping.
+    //
+    // The file may not be truncated while the block is alive, otherwise accessing
+    // the mapping leads to `SIGBUS`.
+    class file_iobuf_block : public iobuf_block {
+    public:
+        // Ownership of `fd` is taken. `[offset, offset + size)` of the file must
+        // exist.
+        //
+        // Returns `nullptr` with `errno` set on failure.
+        static abel::ref_ptr<file_iobuf_block> create(int fd, off_t offset,
+                                                      std::size_t size);
+
+        ~file_iobuf_block();
+
+        const char *data() const noexcept override { return data_; }
+
+        std::size_t size() const noexcept override { return size_; }
+
+        int get_file(off_t *offset) const noexcept override {
+            *offset = offset_;
+            return fd_;
+        }
+
+    private:
+        file_iobuf_block() = default;
+
+    private:
+        int fd_ = -1;
+        off_t offset_;
+        void *mapping_ = nullptr;
+        std::size_t mapping_size_ = 0;
+        const char *data_;
+        std::size_t size_;
+    };
+
 }  // namespace abel
 
 #endif  // ABEL_IO_INTERNAL_IOBUF_BLOCK_H_
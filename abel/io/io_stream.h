@@ -29,6 +29,20 @@ namespace abel {
         virtual ssize_t readv(const iovec *iov, int iovcnt) = 0;
 
         virtual ssize_t writev(const iovec *iov, int iovcnt) = 0;
+
+        // Test if `sendfile` below is implemented.
+        virtual bool is_sendfile_supported() const noexcept { return false; }
+
+        // Write `count` bytes starting at `offset` of file `in_fd` to this stream
+        // without copying them through userspace.
+        //
+        // Returns bytes written. On error, -1 is returned and `errno` is set. If the
+        // stream does not accept data this way (`EINVAL` / `ENOSYS`), the caller
+        // should fall back to `writev`.
+        virtual ssize_t sendfile(int /*in_fd*/, off_t /*offset*/, std::size_t /*count*/) {
+            errno = ENOSYS;
+            return -1;
+        }
     };
 
     class system_io_stream : public io_stream_base {
@@ -47,6 +61,16 @@ namespace abel {
             return abel::safe_writev(_fd, iov, iovcnt);
         }
 
+#if defined(ABEL_PLATFORM_LINUX)
+
+        bool is_sendfile_supported() const noexcept override { return true; }
+
+        ssize_t sendfile(int in_fd, off_t offset, std::size_t count) override {
+            return abel::safe_sendfile(_fd, in_fd, offset, count);
+        }
+
+#endif
+
         int get_fd() const {
             return _fd;
         }
@@ -5,6 +5,11 @@
 
 #include "abel/io/iobuf.h"
 
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
 #include <utility>
 
@@ -100,10 +105,27 @@ namespace abel {
             DCHECK(size_available());
             return;  // Nothing to do then.
         }
-        current_ = make_native_ionuf_block();
+        current_ = make_native_ionuf_block(next_block_size_hint());
         used_ = 0;
     }
 
+    std::size_t iobuf_builder::next_block_size_hint() const noexcept {
+        auto written = byte_size();
+        // Grows geometrically with bytes written so far, unless the user told us
+        // more are coming.
+        return std::max(written,
+                        expected_bytes_ > written ? expected_bytes_ - written : 0);
+    }
+
+    void iobuf_builder::reserve_hint(std::size_t bytes) {
+        expected_bytes_ = byte_size() + bytes;
+        // If the current block is still clean, replace it with a larger one if
+        // that's preferable.
+        if (!used_ && get_native_iobuf_block_size(bytes) > current_->size()) {
+            current_ = make_native_ionuf_block(bytes);
+        }
+    }
+
     // Move the buffer block we're working on into the non-contiguous buffer we're
     // building.
     void iobuf_builder::flush_current_block() {
@@ -203,6 +225,37 @@ namespace abel {
                 size);
     }
 
+    std::optional<iobuf> make_file_iobuf(const std::string &path, off_t offset,
+                                         std::size_t length) {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return std::nullopt;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            return std::nullopt;
+        }
+        if (offset < 0 || offset > st.st_size ||
+            length > static_cast<std::size_t>(st.st_size - offset)) {
+            close(fd);
+            errno = EINVAL;
+            return std::nullopt;
+        }
+
+        iobuf rc;
+        if (!length) {
+            close(fd);
+            return rc;
+        }
+        auto block = file_iobuf_block::create(fd, offset, length);
+        if (!block) {
+            return std::nullopt;
+        }
+        rc.append(iobuf_slice(std::move(block), 0, length));
+        return rc;
+    }
+
     template<class T>
     iobuf_slice make_foreign_slice(std::vector<T> buffer) {
         auto size = buffer.size() * sizeof(T);
@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <limits>
 #include <numeric>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -247,6 +248,14 @@ namespace abel {
         // Total number of bytes written.
         std::size_t byte_size() const noexcept { return nb_.byte_size() + used_; }
 
+        // Hint the builder that about `bytes` more bytes are going to be written.
+        //
+        // Without a hint, size of new buffer blocks grows with bytes already
+        // written. With a hint, large blocks can be used from the start. This
+        // greatly reduces number of slices in the resulting buffer for large
+        // payloads.
+        void reserve_hint(std::size_t bytes);
+
         // Clean up internal state and move buffer built out.
         //
         // CAUTION: You may not touch the builder after calling this method.
@@ -353,6 +362,9 @@ namespace abel {
         // Allocate a new buffer.
         void initialize_next_block();
 
+        // Determines size of the next buffer block.
+        std::size_t next_block_size_hint() const noexcept;
+
         // Move the buffer block we're working on into the non-contiguous buffer we're
         // building.
         void flush_current_block();
@@ -366,19 +378,21 @@ namespace abel {
 
         template<class T, class... Ts>
         [[gnu::always_inline]] void unchecked_append(char *ptr, const T &sv) {
-            memcpy(ptr, abel::detail::data(sv), io_internal::size(sv));
+            memcpy(ptr, io_internal::data(sv), io_internal::size(sv));
         }
 
         template<class T, class... Ts>
         [[gnu::always_inline]] void unchecked_append(char *ptr, const T &sv,
                                                      const Ts &... svs) {
-            memcpy(ptr, data(sv), io_internal::size(sv));
+            memcpy(ptr, io_internal::data(sv), io_internal::size(sv));
             unchecked_append(ptr + io_internal::size(sv), svs...);
         }
 
     private:
         iobuf nb_;
-        std::size_t used_;
+        std::size_t used_ = 0;
+        // Total bytes expected to be written, @sa: `reserve_hint`.
+        std::size_t expected_bytes_ = 0;
         abel::ref_ptr<native_iobuf_block> current_;
     };
 
@@ -442,6 +456,17 @@ namespace abel {
     template<class T>
     iobuf_slice make_foreign_slice(std::vector<T> buffer);
 
+    // Create a buffer referencing `[offset, offset + length)` of file at `path`,
+    // without reading the file. The file is mapped into memory, and is sent via
+    // `sendfile` by `write_iobuf_list` if the stream supports it.
+    //
+    // The file may not be truncated while the resulting buffer is alive.
+    //
+    // Returns `std::nullopt` with `errno` set on failure. Requesting bytes beyond
+    // the end of file fails with `EINVAL`.
+    std::optional<iobuf> make_file_iobuf(const std::string &path, off_t offset,
+                                         std::size_t length);
+
 }  //namespace abel
 
 #endif  // ABEL_IO_IOBUF_H_
@@ -0,0 +1,355 @@
+//
+// Created by liyinbin on 2021/4/19.
+//
+
+#include "abel/io/iobuf_search.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "abel/base/profile.h"
+#include "abel/hardware/cpu_info.h"
+
+#if defined(ABEL_PROCESSOR_X86_64)
+#include <immintrin.h>
+#endif
+
+namespace abel {
+
+    namespace {
+
+        // Characters to search for by `find_any_of`.
+        struct needle_set {
+            explicit needle_set(std::string_view c) : chars(c) {
+                for (auto&& e : chars) {
+                    bitmap[static_cast<unsigned char>(e)] = true;
+                }
+            }
+
+            std::string_view chars;
+            bool bitmap[256] = {};
+        };
+
+        // SIMD kernels are only used if there are no more needles than this,
+        // comparing with each of them costs more than a table lookup otherwise.
+        constexpr std::size_t kMaxSimdNeedles = 16;
+
+        // Each method below scans `[p, p + n)` and returns offset of the match, or
+        // `n` if there's none.
+        struct search_kernels {
+            std::size_t (*find_char)(const char *p, std::size_t n, char c);
+
+            std::size_t (*find_any_of)(const char *p, std::size_t n,
+                                       const needle_set &needles);
+
+            // Only matches lying entirely in `[p, p + n)` are reported. `m` is
+            // at least 2.
+            std::size_t (*find_pattern)(const char *p, std::size_t n,
+                                        const char *pattern, std::size_t m);
+        };
+
+        std::size_t find_any_of_scalar(const char *p, std::size_t n,
+                                       const needle_set &needles) {
+            for (std::size_t i = 0; i != n; ++i) {
+                if (needles.bitmap[static_cast<unsigned char>(p[i])]) {
+                    return i;
+                }
+            }
+            return n;
+        }
+
+        // Checks candidates in `[from, n - m]`, one by one.
+        std::size_t find_pattern_scalar(const char *p, std::size_t n, std::size_t from,
+                                        const char *pattern, std::size_t m) {
+            for (std::size_t i = from; i + m <= n; ++i) {
+                if (p[i] == pattern[0] && p[i + m - 1] == pattern[m - 1] &&
+                    memcmp(p + i + 1, pattern + 1, m - 2) == 0) {
+                    return i;
+                }
+            }
+            return n;
+        }
+
+        std::size_t find_char_generic(const char *p, std::size_t n, char c) {
+            auto ptr = memchr(p, c, n);
+            return ptr ? static_cast<const char *>(ptr) - p : n;
+        }
+
+        std::size_t find_pattern_generic(const char *p, std::size_t n,
+                                         const char *pattern, std::size_t m) {
+            auto pos = std::string_view(p, n).find(std::string_view(pattern, m));
+            return pos == std::string_view::npos ? n : pos;
+        }
+
+        constexpr search_kernels kGenericKernels = {
+                find_char_generic, find_any_of_scalar, find_pattern_generic};
+
+#if defined(ABEL_PROCESSOR_X86_64)
+
+        // SSE2 is always available on x86-64.
+
+        std::size_t find_char_sse2(const char *p, std::size_t n, char c) {
+            auto needle = _mm_set1_epi8(c);
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+                auto mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, needle));
+                if (mask) {
+                    return i + __builtin_ctz(mask);
+                }
+            }
+            for (; i != n; ++i) {
+                if (p[i] == c) {
+                    return i;
+                }
+            }
+            return n;
+        }
+
+        std::size_t find_any_of_sse2(const char *p, std::size_t n,
+                                     const needle_set &needles) {
+            if (needles.chars.size() > kMaxSimdNeedles) {
+                return find_any_of_scalar(p, n, needles);
+            }
+            __m128i ns[kMaxSimdNeedles];
+            auto count = needles.chars.size();
+            for (std::size_t j = 0; j != count; ++j) {
+                ns[j] = _mm_set1_epi8(needles.chars[j]);
+            }
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+                auto eq = _mm_setzero_si128();
+                for (std::size_t j = 0; j != count; ++j) {
+                    eq = _mm_or_si128(eq, _mm_cmpeq_epi8(v, ns[j]));
+                }
+                if (auto mask = _mm_movemask_epi8(eq)) {
+                    return i + __builtin_ctz(mask);
+                }
+            }
+            return i + find_any_of_scalar(p + i, n - i, needles);
+        }
+
+        // Candidates are filtered by comparing both the first and the last
+        // character of the pattern, `memcmp` is only called on those survived.
+        std::size_t find_pattern_sse2(const char *p, std::size_t n,
+                                      const char *pattern, std::size_t m) {
+            if (n < m) {
+                return n;
+            }
+            auto first = _mm_set1_epi8(pattern[0]);
+            auto last = _mm_set1_epi8(pattern[m - 1]);
+            std::size_t i = 0;
+            for (; i + 16 + m - 1 <= n; i += 16) {
+                auto vf = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+                auto vl = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i *>(p + i + m - 1));
+                unsigned mask = _mm_movemask_epi8(
+                        _mm_and_si128(_mm_cmpeq_epi8(vf, first), _mm_cmpeq_epi8(vl, last)));
+                while (mask) {
+                    auto bit = __builtin_ctz(mask);
+                    if (memcmp(p + i + bit + 1, pattern + 1, m - 2) == 0) {
+                        return i + bit;
+                    }
+                    mask &= mask - 1;
+                }
+            }
+            return find_pattern_scalar(p, n, i, pattern, m);
+        }
+
+        __attribute__((target("avx2")))
+        std::size_t find_char_avx2(const char *p, std::size_t n, char c) {
+            auto needle = _mm256_set1_epi8(c);
+            std::size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+                unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, needle));
+                if (mask) {
+                    return i + __builtin_ctz(mask);
+                }
+            }
+            return i + find_char_sse2(p + i, n - i, c);
+        }
+
+        __attribute__((target("avx2")))
+        std::size_t find_any_of_avx2(const char *p, std::size_t n,
+                                     const needle_set &needles) {
+            if (needles.chars.size() > kMaxSimdNeedles) {
+                return find_any_of_scalar(p, n, needles);
+            }
+            __m256i ns[kMaxSimdNeedles];
+            auto count = needles.chars.size();
+            for (std::size_t j = 0; j != count; ++j) {
+                ns[j] = _mm256_set1_epi8(needles.chars[j]);
+            }
+            std::size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+                auto eq = _mm256_setzero_si256();
+                for (std::size_t j = 0; j != count; ++j) {
+                    eq = _mm256_or_si256(eq, _mm256_cmpeq_epi8(v, ns[j]));
+                }
+                if (unsigned mask = _mm256_movemask_epi8(eq)) {
+                    return i + __builtin_ctz(mask);
+                }
+            }
+            return i + find_any_of_sse2(p + i, n - i, needles);
+        }
+
+        __attribute__((target("avx2")))
+        std::size_t find_pattern_avx2(const char *p, std::size_t n,
+                                      const char *pattern, std::size_t m) {
+            if (n < m) {
+                return n;
+            }
+            auto first = _mm256_set1_epi8(pattern[0]);
+            auto last = _mm256_set1_epi8(pattern[m - 1]);
+            std::size_t i = 0;
+            for (; i + 32 + m - 1 <= n; i += 32) {
+                auto vf = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+                auto vl = _mm256_loadu_si256(
+                        reinterpret_cast<const __m256i *>(p + i + m - 1));
+                unsigned mask = _mm256_movemask_epi8(_mm256_and_si256(
+                        _mm256_cmpeq_epi8(vf, first), _mm256_cmpeq_epi8(vl, last)));
+                while (mask) {
+                    auto bit = __builtin_ctz(mask);
+                    if (memcmp(p + i + bit + 1, pattern + 1, m - 2) == 0) {
+                        return i + bit;
+                    }
+                    mask &= mask - 1;
+                }
+            }
+            return find_pattern_scalar(p, n, i, pattern, m);
+        }
+
+        constexpr search_kernels kSse2Kernels = {
+                find_char_sse2, find_any_of_sse2, find_pattern_sse2};
+        constexpr search_kernels kAvx2Kernels = {
+                find_char_avx2, find_any_of_avx2, find_pattern_avx2};
+
+#endif
+
+        const search_kernels &get_kernels() {
+            static const search_kernels *kernels = [] {
+#if defined(ABEL_PROCESSOR_X86_64)
+                abel::cpu_info cpu;
+                if (cpu.has_avx2()) {
+                    return &kAvx2Kernels;
+                }
+                if (cpu.has_sse2()) {
+                    return &kSse2Kernels;
+                }
+#endif
+                return &kGenericKernels;
+            }();
+            return *kernels;
+        }
+
+        // Calls `f(slice, from)` for each slice overlapping with bytes at or after
+        // `start`, until `f` returns a match. `from` is where in `slice` to start
+        // scanning.
+        //
+        // `f` returns offset (in slice) of the match, or `slice.size()` if there's
+        // none.
+        template<class F>
+        std::size_t for_each_slice_from(const iobuf &buffer, std::size_t start,
+                                        F &&f) {
+            if (start >= buffer.byte_size()) {
+                return iobuf_npos;
+            }
+            std::size_t base = 0;  // Offset of the current slice in `buffer`.
+            for (auto iter = buffer.begin(); iter != buffer.end(); ++iter) {
+                auto size = iter->size();
+                if (base + size > start) {
+                    auto from = start > base ? start - base : 0;
+                    if (auto pos = f(iter, from); pos != size) {
+                        return base + pos;
+                    }
+                }
+                base += size;
+            }
+            return iobuf_npos;
+        }
+
+        // Tests if `pattern` starts at `pos` of the slice pointed to by `iter`,
+        // and continues into the following slices.
+        template<class Iterator>
+        bool match_across_slices(Iterator iter, Iterator end, std::size_t pos,
+                                 std::string_view pattern) {
+            while (!pattern.empty()) {
+                if (iter == end) {
+                    return false;
+                }
+                auto len = std::min(iter->size() - pos, pattern.size());
+                if (memcmp(iter->data() + pos, pattern.data(), len) != 0) {
+                    return false;
+                }
+                pattern.remove_prefix(len);
+                ++iter;
+                pos = 0;
+            }
+            return true;
+        }
+
+    }  // namespace
+
+    std::size_t find(const iobuf &buffer, char c, std::size_t start) {
+        auto &&kernels = get_kernels();
+        return for_each_slice_from(buffer, start, [&](auto iter, std::size_t from) {
+            return from + kernels.find_char(iter->data() + from, iter->size() - from, c);
+        });
+    }
+
+    std::size_t find(const iobuf &buffer, std::string_view pattern,
+                     std::size_t start) {
+        if (pattern.empty()) {
+            return start <= buffer.byte_size() ? start : iobuf_npos;
+        }
+        if (pattern.size() == 1) {
+            return find(buffer, pattern[0], start);
+        }
+        auto &&kernels = get_kernels();
+        auto m = pattern.size();
+        return for_each_slice_from(buffer, start, [&](auto iter, std::size_t from) {
+            auto p = iter->data();
+            auto n = iter->size();
+            if (from + m <= n) {
+                auto pos = kernels.find_pattern(p + from, n - from, pattern.data(), m);
+                if (pos != n - from) {
+                    return from + pos;
+                }
+            }
+            // Matches lying entirely in this slice have all been checked, now
+            // for those starting in the last `m - 1` bytes.
+            for (auto i = std::max(from, n >= m ? n - m + 1 : 0); i < n; ++i) {
+                if (p[i] == pattern[0] &&
+                    match_across_slices(iter, buffer.end(), i, pattern)) {
+                    return i;
+                }
+            }
+            return n;
+        });
+    }
+
+    std::size_t find_any_of(const iobuf &buffer, std::string_view chars,
+                            std::size_t start) {
+        if (chars.empty()) {
+            return iobuf_npos;
+        }
+        auto &&kernels = get_kernels();
+        needle_set needles(chars);
+        return for_each_slice_from(buffer, start, [&](auto iter, std::size_t from) {
+            return from + kernels.find_any_of(iter->data() + from, iter->size() - from,
+                                              needles);
+        });
+    }
+
+    std::optional<iobuf> cut_until(iobuf *buffer, std::string_view delim) {
+        auto pos = find(*buffer, delim);
+        if (pos == iobuf_npos) {
+            return std::nullopt;
+        }
+        return buffer->cut(pos + delim.size());
+    }
+
+}  // namespace abel
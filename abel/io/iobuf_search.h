@@ -0,0 +1,49 @@
+//
+// Created by liyinbin on 2021/4/19.
+//
+
+#ifndef ABEL_IO_IOBUF_SEARCH_H_
+#define ABEL_IO_IOBUF_SEARCH_H_
+
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <string_view>
+
+#include "abel/io/iobuf.h"
+
+namespace abel {
+
+    // Returned by methods below if nothing is found.
+    inline constexpr std::size_t iobuf_npos = std::numeric_limits<std::size_t>::max();
+
+    // Methods below scan each slice of the buffer with SIMD instructions (AVX2 or
+    // SSE2, whichever is the best the CPU supports), matches crossing slice
+    // boundaries are handled as well. They're much faster than scanning through
+    // `iobuf_forward_view` or flattening the buffer.
+    //
+    // All of them start scanning at `start`-th byte, this helps in not rescanning
+    // bytes already scanned when more bytes arrive. Offset of the match (from the
+    // beginning of the buffer) is returned.
+
+    // Find the first occurrence of `c`.
+    std::size_t find(const iobuf &buffer, char c, std::size_t start = 0);
+
+    // Find the first occurrence of `pattern`. If `pattern` is empty, `start` is
+    // returned (if it's not beyond the end of the buffer.)
+    std::size_t find(const iobuf &buffer, std::string_view pattern,
+                     std::size_t start = 0);
+
+    // Find the first occurrence of any of `chars`.
+    std::size_t find_any_of(const iobuf &buffer, std::string_view chars,
+                            std::size_t start = 0);
+
+    // Cut off bytes up to (and including) the first occurrence of `delim`.
+    //
+    // If `delim` is not found, `buffer` is left untouched and `std::nullopt` is
+    // returned.
+    std::optional<iobuf> cut_until(iobuf *buffer, std::string_view delim);
+
+}  // namespace abel
+
+#endif  // ABEL_IO_IOBUF_SEARCH_H_
@@ -4,6 +4,7 @@
 
 #include  "abel/io/read_iobuf.h"
 #include <limits.h>
+#include <sys/ioctl.h>
 
 #include <algorithm>
 #include <utility>
@@ -17,27 +18,65 @@ namespace abel {
     namespace io_internal {
         constexpr auto kMaxBlocksPerRead = 8;
 
-        std::vector<ref_ptr<native_iobuf_block>> *refill_and_get_blocks() {
-            thread_local std::vector<ref_ptr<native_iobuf_block>> cache;
-            while (cache.size() < kMaxBlocksPerRead) {
+        // Get at least `count` (at most `kMaxBlocksPerRead`) blocks of the default
+        // size.
+        std::vector<ref_ptr<native_iobuf_block>> *refill_and_get_blocks(std::size_t count) {
+            // Blocks are allocated from the object pool inside `cache`'s initializer,
+            // so that the (thread-local) pool is fully constructed before `cache` and
+            // therefore destroyed after it on thread exit. Otherwise blocks held by
+            // `cache` would be returned to a pool that has already been destroyed.
+            thread_local std::vector<ref_ptr<native_iobuf_block>> cache = [] {
+                std::vector<ref_ptr<native_iobuf_block>> blocks;
+                blocks.push_back(make_native_ionuf_block());
+                return blocks;
+            }();
+            // Only what's needed is refilled, so small reads don't churn the pool.
+            while (cache.size() < count) {
                 cache.push_back(make_native_ionuf_block());
             }
             return &cache;
         }
 
+        // Get blocks for reading `max_bytes` bytes (about `size_hint` bytes are
+        // expected.) Small reads are served from `refill_and_get_blocks()`. Blocks
+        // of larger size classes are pooled by the object pool already, they're
+        // allocated into `large_blocks`.
+        std::vector<ref_ptr<native_iobuf_block>> *get_blocks(
+                std::size_t max_bytes, std::size_t size_hint,
+                std::vector<ref_ptr<native_iobuf_block>> *large_blocks) {
+            static const auto kDefaultBlockSize = get_native_iobuf_block_size(0);
+            if (get_native_iobuf_block_size(size_hint) <= kDefaultBlockSize) {
+                auto count = std::min<std::size_t>(
+                        kMaxBlocksPerRead,
+                        (max_bytes + kDefaultBlockSize - 1) / kDefaultBlockSize);
+                return refill_and_get_blocks(count);
+            }
+            std::size_t bytes = 0;
+            while (large_blocks->size() < kMaxBlocksPerRead &&
+                   bytes < std::min(size_hint, max_bytes)) {
+                large_blocks->push_back(make_native_ionuf_block(size_hint));
+                bytes += large_blocks->back()->size();
+            }
+            return large_blocks;
+        }
+
         ssize_t read_partial(std::size_t max_bytes, io_stream_base *io,
-                             iobuf *to, bool *short_read) {
-            auto &&block_cache = refill_and_get_blocks();
+                             iobuf *to, bool *short_read, std::size_t size_hint,
+                             std::size_t *wasted) {
+            // Blocks left unused are freed (back to the pool) on return.
+            std::vector<ref_ptr<native_iobuf_block>> large_blocks;
+            auto &&block_cache = get_blocks(max_bytes, size_hint, &large_blocks);
             iovec iov[kMaxBlocksPerRead];
-            DCHECK_EQ(block_cache->size(), std::size(iov));
+            auto blocks = block_cache->size();
+            DCHECK_LE(blocks, std::size(iov));
 
             std::size_t iov_elements = 0;
             std::size_t bytes_to_read = 0;
-            while (bytes_to_read != max_bytes && iov_elements != kMaxBlocksPerRead) {
+            while (bytes_to_read != max_bytes && iov_elements != blocks) {
                 auto &&iove = iov[iov_elements];
                 // Use blocks from back to front. This helps when we removes used blocks
                 // from the cache (popping from back of a vector is cheaper.).
-                auto &&block = (*block_cache)[kMaxBlocksPerRead - 1 - iov_elements];
+                auto &&block = (*block_cache)[blocks - 1 - iov_elements];
                 auto len =
                         std::min(block->size(), max_bytes - bytes_to_read /* Bytes left */);
 
@@ -60,6 +99,8 @@ namespace abel {
             while (bytes_left) {
                 auto current = std::move(block_cache->back());
                 auto len = std::min(bytes_left, current->size());
+                // Tail of the last block is pinned by `to` but left unused.
+                *wasted = current->size() - len;
                 to->append(iobuf_slice(std::move(current), 0, len));
                 bytes_left -= len;
                 block_cache->pop_back();
@@ -76,7 +117,12 @@ namespace abel {
             // Read from the socket.
             bool short_read = false;  // GCC 10 reports a spurious uninitialized-var.
             auto bytes_to_read = bytes_left;
-            auto read = io_internal::read_partial(bytes_to_read, io, to, &short_read);
+            // Once a read saturates our buffers, more are likely pending. Size the
+            // blocks after what we've read so far (bounded by what's left).
+            auto size_hint = std::min(*bytes_read, bytes_left);
+            std::size_t wasted = 0;
+            auto read = io_internal::read_partial(bytes_to_read, io, to, &short_read,
+                                                  size_hint, &wasted);
             if (ABEL_UNLIKELY(read == 0)) {  // The remote side closed the connection.
                 return read_status::eEof;
             }
@@ -102,4 +148,63 @@ namespace abel {
         return read_status::eMaxBytesRead;
     }
 
+    read_status adaptive_iobuf_reader::read(std::size_t max_bytes, io_stream_base *io,
+                                            iobuf *to, std::size_t *bytes_read) {
+        auto pending = probe_pending_bytes();
+        auto expecting = pending ? pending : expected_bytes();
+        auto status = read_status::eMaxBytesRead;
+        auto bytes_left = max_bytes;
+        *bytes_read = 0;
+        while (bytes_left) {
+            // Read as much as we expect, rounded up to size of the block(s) we'd
+            // allocate anyway. If the read saturates the buffers, we grow the buffers
+            // geometrically, as `read_iobuf` does.
+            auto size_hint = *bytes_read ? *bytes_read : expecting;
+            auto block_size = get_native_iobuf_block_size(size_hint);
+            auto bytes_to_read = std::min(
+                    bytes_left, (size_hint + block_size - 1) / block_size * block_size);
+            bool short_read = false;
+            std::size_t wasted = 0;
+            auto read = io_internal::read_partial(bytes_to_read, io, to, &short_read,
+                                                  size_hint, &wasted);
+            if (ABEL_UNLIKELY(read == 0)) {
+                status = read_status::eEof;
+                break;
+            }
+            if (ABEL_UNLIKELY(read < 0)) {
+                status = (errno == EAGAIN || errno == EWOULDBLOCK) ? read_status::eDrained
+                                                                   : read_status::eError;
+                break;
+            }
+            *bytes_read += read;
+            bytes_left -= read;
+            bytes_wasted_ += wasted;
+
+            // Everything pending (at the time we probed) has been read, no need to
+            // try again.
+            if (short_read || (pending && *bytes_read >= pending)) {
+                status = read_status::eDrained;
+                break;
+            }
+        }
+
+        if (*bytes_read) {
+            bytes_read_ += *bytes_read;
+            average_read_ = (average_read_ * 3 + *bytes_read) / 4;
+        }
+        return status;
+    }
+
+    std::size_t adaptive_iobuf_reader::expected_bytes() const noexcept {
+        return std::max<std::size_t>(average_read_, 1);
+    }
+
+    std::size_t adaptive_iobuf_reader::probe_pending_bytes() const noexcept {
+        int pending = 0;
+        if (fd_ < 0 || ioctl(fd_, FIONREAD, &pending) != 0) {
+            return 0;
+        }
+        return pending;
+    }
+
 }  // namespace abel
@@ -5,6 +5,8 @@
 #ifndef ABEL_IO_READ_IOBUF_H_
 #define ABEL_IO_READ_IOBUF_H_
 
+#include <cstdint>
+
 #include "abel/io/iobuf.h"
 #include "abel/io/io_stream.h"
 
@@ -23,6 +25,46 @@ namespace abel {
     read_status read_iobuf(std::size_t max_bytes, io_stream_base* io,
                           iobuf* to, std::size_t* bytes_read);
 
+    // Same as `read_iobuf`, except that buffers are sized after bytes likely
+    // pending, instead of always preparing for a large read. This saves chatty
+    // connections from touching (and pinning) buffers they never fill.
+    //
+    // Bytes pending are probed via `ioctl(FIONREAD)` if a file descriptor is
+    // given (at the cost of an extra syscall per read), or estimated from
+    // history of previous reads otherwise.
+    //
+    // One object should be used for each connection. It's not thread-safe.
+    class adaptive_iobuf_reader {
+    public:
+        // `fd` is used for probing bytes pending. Pass -1 to disable probing.
+        explicit adaptive_iobuf_reader(int fd = -1) : fd_(fd) {}
+
+        // Same as `read_iobuf`.
+        read_status read(std::size_t max_bytes, io_stream_base* io, iobuf* to,
+                         std::size_t* bytes_read);
+
+        // Bytes expected to be read by the next call to `read`, from history.
+        std::size_t expected_bytes() const noexcept;
+
+        // Total bytes read.
+        std::uint64_t total_bytes_read() const noexcept { return bytes_read_; }
+
+        // Total bytes allocated but left unused in the blocks handed out to `to`
+        // (i.e., tail of the last block filled by each read.)
+        std::uint64_t total_bytes_wasted() const noexcept { return bytes_wasted_; }
+
+    private:
+        // Returns 0 if unknown.
+        std::size_t probe_pending_bytes() const noexcept;
+
+    private:
+        int fd_;
+        // Moving average of bytes read by each call to `read`.
+        std::size_t average_read_ = 0;
+        std::uint64_t bytes_read_ = 0;
+        std::uint64_t bytes_wasted_ = 0;
+    };
+
 }  // namespace abel
 
 #endif  // ABEL_IO_READ_IOBUF_H_
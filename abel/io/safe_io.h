@@ -15,6 +15,12 @@
 
 #include "abel/base/profile.h"
 
+#if defined(ABEL_PLATFORM_LINUX)
+
+#include <sys/sendfile.h>
+
+#endif
+
 namespace abel {
 
     namespace io_internal {
@@ -59,6 +65,15 @@ namespace abel {
         return io_internal::safe_call([&] { return ::writev(fd, iov, iovcnt); });
     }
 
+#if defined(ABEL_PLATFORM_LINUX)
+
+    inline ssize_t safe_sendfile(int out_fd, int in_fd, off_t offset, size_t count) {
+        return io_internal::safe_call(
+                [&] { return ::sendfile(out_fd, in_fd, &offset, count); });
+    }
+
+#endif
+
 
 }  // namespace abel
 
@@ -4,6 +4,7 @@
 
 #include "abel/io/write_iobuf_list.h"
 
+#include <errno.h>
 #include <limits.h>
 #include <algorithm>
 #include <limits>
@@ -29,6 +30,27 @@ namespace abel {
         }
     };
 
+    namespace {
+
+        // Write `bytes` bytes of `slice` (which is backed by a file) out.
+        ssize_t write_file_slice(io_stream_base *io, const iobuf_slice &slice,
+                                 std::size_t bytes) {
+            off_t offset;
+            auto block = slice.block();
+            auto fd = block->get_file(&offset);
+            offset += slice.data() - block->data();
+            auto rc = io->sendfile(fd, offset, bytes);
+            if (rc < 0 && (errno == EINVAL || errno == ENOSYS)) {
+                // The stream does not accept `sendfile`, write it from the mapping
+                // instead.
+                iovec iov = {const_cast<char *>(slice.data()), bytes};
+                return io->writev(&iov, 1);
+            }
+            return rc;
+        }
+
+    }  // namespace
+
     /// write_iobuf_list
 
 
@@ -61,6 +83,10 @@ namespace abel {
 
         std::size_t nv = 0;
         std::size_t flushing = 0;
+        // Set if the first slice to be flushed is backed by a file. It's sent
+        // separately via `sendfile` then.
+        const iobuf_slice *file_slice = nullptr;
+        bool use_sendfile = io->is_sendfile_supported();
 
         auto head = _head.load(std::memory_order_acquire);
         auto current = head;
@@ -72,22 +98,41 @@ namespace abel {
                  iter != current->buffer.end() && nv != std::size(iov) &&
                  flushing < max_bytes;
                  ++iter) {
+                off_t offset;
+                if (use_sendfile && ABEL_UNLIKELY(iter->block()->get_file(&offset) >= 0)) {
+                    if (!nv) {
+                        file_slice = &*iter;
+                        flushing = iter->size();
+                    }
+                    // Otherwise flush what we've gathered so far first.
+                    current = nullptr;
+                    break;
+                }
                 auto &&e = iov[nv++];
                 e.iov_base = const_cast<char *>(iter->data());
                 e.iov_len = iter->size();  // For the last iov, we revise its size later.
 
                 flushing += e.iov_len;
             }
-            current = current->next.load(std::memory_order_acquire);
+            if (current) {
+                current = current->next.load(std::memory_order_acquire);
+            }
         }
 
         if (ABEL_LIKELY(flushing > max_bytes)) {
             auto diff = flushing - max_bytes;
-            iov[nv - 1].iov_len -= diff;
+            if (!file_slice) {
+                iov[nv - 1].iov_len -= diff;
+            }
             flushing -= diff;
         }
 
-        ssize_t rc = io->writev(iov, nv);
+        ssize_t rc;
+        if (ABEL_UNLIKELY(file_slice)) {
+            rc = write_file_slice(io, *file_slice, flushing);
+        } else {
+            rc = io->writev(iov, nv);
+        }
         if (rc <= 0) {
             return rc;  // Nothing is really flushed then.
         }
@@ -52,6 +52,7 @@ namespace abel {
 
         void flush_impl() override;
 
+        // doesn't flush, the thread pool flushes once per batch of messages.
         void backend_sink_it_(const details::log_msg &incoming_log_msg);
 
         void backend_flush_();
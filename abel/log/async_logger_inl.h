@@ -49,10 +49,6 @@ ABEL_FORCE_INLINE void abel::async_logger::backend_sink_it_(const details::log_m
             LOG_LOGGER_CATCH()
         }
     }
-
-    if (should_flush_(msg)) {
-        backend_flush_();
-    }
 }
 
 ABEL_FORCE_INLINE void abel::async_logger::backend_flush_() {
@@ -0,0 +1,124 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Low latency logger with deferred formatting.
+//
+// Upon each deferred log write (`log_deferred`, or the BINLOG_* macros) the
+// logger:
+//    1. Checks if its log level is enough to log the message
+//    2. Copies the raw arguments, along with a pointer to the static
+//    description of the call site (format string, source location, level), to
+//    the calling thread's staging ring. No formatting, no allocation, no lock.
+// The backend thread (see details/binlog_backend.h) formats the messages and
+// hands them to the sinks.
+//
+// Arguments must be strings or trivially copyable. They are copied by value,
+// so they may go away as soon as the call returns.
+//
+// The regular logging api still works: messages are formatted by the caller
+// and go through the staging ring too, so ordering is preserved.
+// Backtrace only applies to messages logged through the regular api.
+// Upon destruction, logs all pending messages of the logger.
+
+#include "abel/log/async_logger.h"
+#include "abel/log/details/binlog_backend.h"
+
+namespace abel {
+
+class ABEL_API binary_logger final : public logger {
+    friend class details::binlog_backend;
+
+  public:
+    template<typename It>
+    binary_logger(std::string logger_name, It begin, It end,
+                  async_overflow_policy overflow_policy = async_overflow_policy::block)
+            : logger(std::move(logger_name), begin, end), backend_(details::binlog_backend::instance()),
+              overflow_policy_(overflow_policy) {}
+
+    binary_logger(std::string logger_name, sinks_init_list sinks_list,
+                  async_overflow_policy overflow_policy = async_overflow_policy::block);
+
+    binary_logger(std::string logger_name, sink_ptr single_sink,
+                  async_overflow_policy overflow_policy = async_overflow_policy::block);
+
+    binary_logger(const binary_logger &other);
+
+    ~binary_logger() override;
+
+    // `site` must outlive the logger, it's usually a static of the call site.
+    template<typename... Args>
+    void log_deferred(const details::binlog_site &site, const Args &... args) {
+        if (!should_log(site.level)) {
+            return;
+        }
+        auto size = record_size_(sizeof(details::binlog_record) +
+                                 (details::binlog_arg<typename std::decay<Args>::type>::size(args) + ... + 0));
+        auto buffer = backend_->local_buffer();
+        if (ABEL_UNLIKELY(size > buffer->ring.max_record_size())) {
+            // too large for the ring, format it here instead.
+            log(site.loc, site.level, site.fmt, args...);
+            return;
+        }
+        auto chunk = reserve_(buffer, size);
+        if (!chunk) {
+            return;
+        }
+        auto record = reinterpret_cast<details::binlog_record *>(chunk);
+        record->header = {static_cast<uint32_t>(size), 0};
+        record->logger = this;
+        record->site = &site;
+        record->format = &details::binlog_format<typename std::decay<Args>::type...>;
+        record->time = log_clock::now();
+        auto p = chunk + sizeof(details::binlog_record);
+        ((p = details::binlog_arg<typename std::decay<Args>::type>::encode(p, args)), ...);
+        (void) p;
+        buffer->ring.commit(size);
+    }
+
+    // number of messages dropped because the staging ring was full (only with
+    // async_overflow_policy::overrun_oldest).
+    size_t dropped_counter() const;
+
+    std::shared_ptr<logger> clone(std::string new_name) override;
+
+  protected:
+    void sink_it_impl(const details::log_msg &msg) override;
+
+    // hand everything logged so far to the sinks, then flush them.
+    void flush_impl() override;
+
+    // called from the backend thread.
+    void backend_log_(const details::binlog_record &record, size_t thread_id, memory_buf_t &buf);
+
+  private:
+    static size_t record_size_(size_t size) {
+        return (size + details::binlog_ring::alignment - 1) & ~(details::binlog_ring::alignment - 1);
+    }
+
+    // returns nullptr if the message is to be dropped.
+    char *reserve_(details::binlog_thread_buffer *buffer, size_t size);
+
+    std::shared_ptr<details::binlog_backend> backend_;
+    async_overflow_policy overflow_policy_;
+    std::atomic<size_t> dropped_counter_{0};
+};
+
+}  // namespace abel
+
+#define BINLOG_CALL(logger, level, fmt, ...)                                                                  \
+    do {                                                                                                      \
+        static const ::abel::details::binlog_site abel_binlog_site{                                           \
+                fmt, ::abel::source_loc{__FILE__, __LINE__, ABEL_PRETTY_FUNCTION}, level};                    \
+        (logger)->log_deferred(abel_binlog_site, ##__VA_ARGS__);                                              \
+    } while (0)
+
+#define BINLOG_TRACE(logger, ...) BINLOG_CALL(logger, abel::level::trace, __VA_ARGS__)
+#define BINLOG_DEBUG(logger, ...) BINLOG_CALL(logger, abel::level::debug, __VA_ARGS__)
+#define BINLOG_INFO(logger, ...) BINLOG_CALL(logger, abel::level::info, __VA_ARGS__)
+#define BINLOG_WARN(logger, ...) BINLOG_CALL(logger, abel::level::warn, __VA_ARGS__)
+#define BINLOG_ERROR(logger, ...) BINLOG_CALL(logger, abel::level::err, __VA_ARGS__)
+#define BINLOG_CRITICAL(logger, ...) BINLOG_CALL(logger, abel::level::critical, __VA_ARGS__)
+
+#include "abel/log/binary_logger_inl.h"
@@ -0,0 +1,118 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "abel/log/sinks/sink.h"
+#include "abel/log/details/binlog_backend_inl.h"
+
+
+ABEL_FORCE_INLINE abel::binary_logger::binary_logger(
+        std::string logger_name, sinks_init_list sinks_list, async_overflow_policy overflow_policy)
+        : binary_logger(std::move(logger_name), sinks_list.begin(), sinks_list.end(), overflow_policy) {}
+
+ABEL_FORCE_INLINE abel::binary_logger::binary_logger(
+        std::string logger_name, sink_ptr single_sink, async_overflow_policy overflow_policy)
+        : binary_logger(std::move(logger_name), {std::move(single_sink)}, overflow_policy) {}
+
+ABEL_FORCE_INLINE abel::binary_logger::binary_logger(const binary_logger &other)
+        : logger(other), backend_(other.backend_), overflow_policy_(other.overflow_policy_) {}
+
+// pending records point to us.
+ABEL_FORCE_INLINE abel::binary_logger::~binary_logger() {
+    backend_->drain();
+}
+
+ABEL_FORCE_INLINE size_t abel::binary_logger::dropped_counter() const {
+    return dropped_counter_.load(std::memory_order_relaxed);
+}
+
+ABEL_FORCE_INLINE std::shared_ptr<abel::logger> abel::binary_logger::clone(std::string new_name) {
+    auto cloned = std::make_shared<abel::binary_logger>(*this);
+    cloned->name_ = std::move(new_name);
+    return cloned;
+}
+
+ABEL_FORCE_INLINE char *abel::binary_logger::reserve_(details::binlog_thread_buffer *buffer, size_t size) {
+    while (true) {
+        auto chunk = buffer->ring.reserve(size);
+        if (ABEL_LIKELY(chunk != nullptr)) {
+            return chunk;
+        }
+        // the staging ring is per thread, so the newest message is the only
+        // one we can drop without racing with the backend.
+        if (overflow_policy_ == async_overflow_policy::overrun_oldest) {
+            dropped_counter_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        std::this_thread::yield();
+    }
+}
+
+// messages of the regular api, already formatted. the record carries a copy of
+// its site, followed by the payload.
+ABEL_FORCE_INLINE void abel::binary_logger::sink_it_impl(const details::log_msg &msg) {
+    auto buffer = backend_->local_buffer();
+    auto max_payload = buffer->ring.max_record_size() - sizeof(details::binlog_record) -
+                       sizeof(details::binlog_site) - sizeof(uint32_t) - details::binlog_ring::alignment;
+    auto payload = msg.payload.substr(0, std::min(msg.payload.size(), max_payload));
+    auto size = record_size_(sizeof(details::binlog_record) + sizeof(details::binlog_site) +
+                             details::binlog_string_arg::size(payload));
+    auto chunk = reserve_(buffer, size);
+    if (!chunk) {
+        return;
+    }
+    auto record = reinterpret_cast<details::binlog_record *>(chunk);
+    record->header = {static_cast<uint32_t>(size), 0};
+    record->logger = this;
+    record->site = nullptr;
+    record->format = &details::binlog_format<std::string_view>;
+    record->time = msg.time;
+    details::binlog_site site{"{}", msg.source, msg.level};
+    auto p = chunk + sizeof(details::binlog_record);
+    std::memcpy(p, &site, sizeof(site));
+    details::binlog_string_arg::encode(p + sizeof(site), payload);
+    buffer->ring.commit(size);
+}
+
+ABEL_FORCE_INLINE void abel::binary_logger::flush_impl() {
+    backend_->drain();
+    logger::flush_impl();
+}
+
+ABEL_FORCE_INLINE void abel::binary_logger::backend_log_(const details::binlog_record &record, size_t thread_id,
+                                                          memory_buf_t &buf) {
+    auto args = reinterpret_cast<const char *>(&record + 1);
+    details::binlog_site site;
+    if (record.site) {
+        site = *record.site;
+    } else {
+        std::memcpy(&site, args, sizeof(site));
+        args += sizeof(site);
+    }
+
+    ABEL_TRY {
+        buf.clear();
+        record.format(site.fmt, args, buf);
+        details::log_msg msg(record.time, site.loc, name_, site.level, std::string_view(buf.data(), buf.size()));
+        msg.thread_id = thread_id;
+        for (auto &sink : sinks_) {
+            if (sink->should_log(msg.level)) {
+                ABEL_TRY {
+                    sink->log(msg);
+                }
+                LOG_LOGGER_CATCH()
+            }
+        }
+        // flushing through flush_impl() would wait for ourselves.
+        if (should_flush_(msg)) {
+            logger::flush_impl();
+        }
+    }
+    LOG_LOGGER_CATCH()
+}
@@ -0,0 +1,116 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// raw encoding of deferred log arguments.
+//
+// the call site copies its arguments as is into the staging buffer, and the
+// backend thread decodes them back to format the message. strings are copied
+// by value (length + bytes) and decoded as string views into the buffer, other
+// arguments must be trivially copyable.
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "abel/log/common.h"
+
+namespace abel {
+namespace details {
+
+template<typename T, typename = void>
+struct binlog_arg {
+    static_assert(std::is_trivially_copyable<T>::value && std::is_default_constructible<T>::value,
+                  "deferred log arguments must be strings or trivially copyable types");
+
+    using decoded_type = T;
+
+    static size_t size(const T &) {
+        return sizeof(T);
+    }
+
+    static char *encode(char *dest, const T &v) {
+        std::memcpy(dest, &v, sizeof(T));
+        return dest + sizeof(T);
+    }
+
+    static T decode(const char *&src) {
+        T v;
+        std::memcpy(&v, src, sizeof(T));
+        src += sizeof(T);
+        return v;
+    }
+};
+
+struct binlog_string_arg {
+    using decoded_type = std::string_view;
+
+    static size_t size(std::string_view v) {
+        return sizeof(uint32_t) + v.size();
+    }
+
+    static char *encode(char *dest, std::string_view v) {
+        auto len = static_cast<uint32_t>(v.size());
+        std::memcpy(dest, &len, sizeof(len));
+        std::memcpy(dest + sizeof(len), v.data(), len);
+        return dest + sizeof(len) + len;
+    }
+
+    static std::string_view decode(const char *&src) {
+        uint32_t len;
+        std::memcpy(&len, src, sizeof(len));
+        std::string_view v(src + sizeof(len), len);
+        src += sizeof(len) + len;
+        return v;
+    }
+};
+
+template<>
+struct binlog_arg<std::string> : binlog_string_arg {
+};
+
+template<>
+struct binlog_arg<std::string_view> : binlog_string_arg {
+};
+
+// c strings, which is also what string literals decay to. a null pointer is
+// logged as an empty string.
+template<typename T>
+struct binlog_arg<T *, typename std::enable_if<std::is_same<typename std::remove_cv<T>::type, char>::value>::type> {
+    using decoded_type = std::string_view;
+
+    static std::string_view view(const char *v) {
+        return v ? std::string_view(v) : std::string_view();
+    }
+
+    static size_t size(const char *v) {
+        return binlog_string_arg::size(view(v));
+    }
+
+    static char *encode(char *dest, const char *v) {
+        return binlog_string_arg::encode(dest, view(v));
+    }
+
+    static std::string_view decode(const char *&src) {
+        return binlog_string_arg::decode(src);
+    }
+};
+
+// formats encoded `Args` (decayed) with `fmt` into `dest`.
+using binlog_format_fn = void (*)(std::string_view fmt, const char *args, memory_buf_t &dest);
+
+template<typename... Args>
+void binlog_format(std::string_view fmt, const char *args, memory_buf_t &dest) {
+    // braced initialization decodes the arguments from left to right.
+    std::tuple<typename binlog_arg<Args>::decoded_type...> decoded{binlog_arg<Args>::decode(args)...};
+    (void) args;
+    std::apply([&](const typename binlog_arg<Args>::decoded_type &... v) {
+        abel::format_to(dest, fmt, v...);
+    }, decoded);
+}
+
+} // namespace details
+}  // namespace abel
@@ -0,0 +1,155 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// backend of deferred (binary) logging.
+//
+// each thread logging through a `binary_logger` gets its own staging ring, the
+// call site only copies its raw arguments in there. a single backend thread
+// polls the rings, merges their records by timestamp, formats them and hands
+// them to the loggers' sinks.
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "abel/log/common.h"
+#include "abel/log/details/binlog_args.h"
+#include "abel/log/details/binlog_ring.h"
+
+
+namespace abel {
+class binary_logger;
+
+namespace details {
+
+// static part of a deferred log call, defined once per call site.
+struct binlog_site {
+    std::string_view fmt;
+    source_loc loc;
+    level::level_enum level;
+};
+
+// layout of a record in the staging ring, followed by the encoded arguments.
+struct binlog_record {
+    binlog_chunk_header header;
+    binary_logger *logger;
+    const binlog_site *site;
+    binlog_format_fn format;
+    log_clock::time_point time;
+};
+
+// staging ring of a thread.
+struct binlog_thread_buffer {
+    explicit binlog_thread_buffer(size_t size, size_t tid)
+            : ring(size), thread_id(tid) {}
+
+    binlog_ring ring;
+    const size_t thread_id;
+    // the thread has exited, the buffer can be freed once drained.
+    std::atomic<bool> retired{false};
+};
+
+class ABEL_API binlog_backend {
+  public:
+    static const size_t default_thread_buffer_size = 256 * 1024;
+
+    // the process wide backend. loggers keep it alive.
+    static std::shared_ptr<binlog_backend> instance();
+
+    // process everything left and stop the backend thread.
+    ~binlog_backend();
+
+    binlog_backend(const binlog_backend &) = delete;
+
+    binlog_backend &operator=(const binlog_backend &) = delete;
+
+    // staging ring of the calling thread, created on first use.
+    binlog_thread_buffer *local_buffer() {
+        auto &holder = local_holder_();
+        if (ABEL_LIKELY(holder.buffer)) {
+            return holder.buffer.get();
+        }
+        return create_local_buffer_(holder);
+    }
+
+    // size of staging rings of threads that haven't logged yet.
+    void set_thread_buffer_size(size_t size);
+
+    // how long the backend thread sleeps when there's nothing to log.
+    void set_poll_interval(std::chrono::microseconds interval);
+
+    // block until every record committed before the call is handed to the
+    // sinks. records committed meanwhile don't hold it up.
+    void drain();
+
+  private:
+    binlog_backend();
+
+    struct local_holder {
+        ~local_holder() {
+            if (buffer) {
+                buffer->retired.store(true, std::memory_order_release);
+            }
+        }
+
+        std::shared_ptr<binlog_thread_buffer> buffer;
+    };
+
+    static local_holder &local_holder_() {
+        static thread_local local_holder holder;
+        return holder;
+    }
+
+    // oldest record of a ring, in the merge heap.
+    struct pending_record {
+        log_clock::time_point time;
+        binlog_thread_buffer *buffer;
+        const binlog_record *record;
+    };
+
+    // keeps the oldest record on top of the heap.
+    static bool later_record_(const pending_record &a, const pending_record &b) {
+        return a.time > b.time;
+    }
+
+    binlog_thread_buffer *create_local_buffer_(local_holder &holder);
+
+    void worker_loop_();
+
+    // process records until every ring is empty or `max_records` records
+    // were processed. return true if the rings were emptied.
+    bool process_records_(size_t max_records);
+
+    void process_record_(binlog_thread_buffer *buffer, const binlog_record *record);
+
+    // push the oldest record of `buffer`, if any, to `merge_heap_`.
+    void push_oldest_(binlog_thread_buffer *buffer);
+
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable drained_cv_;
+    std::vector<std::shared_ptr<binlog_thread_buffer>> buffers_;
+    // bumped whenever `buffers_` changes.
+    std::atomic<uint64_t> buffers_version_{0};
+    size_t thread_buffer_size_{default_thread_buffer_size};
+    std::chrono::microseconds poll_interval_{std::chrono::microseconds(500)};
+    size_t drain_waiters_{0};
+    bool active_{true};
+
+    // owned by the backend thread.
+    std::vector<std::shared_ptr<binlog_thread_buffer>> polled_;
+    uint64_t polled_version_{0};
+    // min heap (by time) of the oldest record of each ring.
+    std::vector<pending_record> merge_heap_;
+    memory_buf_t format_buf_;
+
+    std::thread worker_;
+};
+
+} // namespace details
+}  // namespace abel
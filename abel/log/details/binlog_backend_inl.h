@@ -0,0 +1,150 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "abel/log/details/os.h"
+
+
+namespace abel {
+namespace details {
+
+ABEL_FORCE_INLINE std::shared_ptr<binlog_backend> binlog_backend::instance() {
+    static std::shared_ptr<binlog_backend> s_instance(new binlog_backend());
+    return s_instance;
+}
+
+ABEL_FORCE_INLINE binlog_backend::binlog_backend() {
+    worker_ = std::thread([this] { worker_loop_(); });
+}
+
+ABEL_FORCE_INLINE binlog_backend::~binlog_backend() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        active_ = false;
+    }
+    work_cv_.notify_one();
+    worker_.join();
+}
+
+ABEL_FORCE_INLINE void binlog_backend::set_thread_buffer_size(size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    thread_buffer_size_ = size;
+}
+
+ABEL_FORCE_INLINE void binlog_backend::set_poll_interval(std::chrono::microseconds interval) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    poll_interval_ = interval;
+}
+
+ABEL_FORCE_INLINE void binlog_backend::drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // where each ring is to be consumed up to. rings of exited threads are
+    // only freed once empty, so holding them here is enough.
+    std::vector<std::pair<std::shared_ptr<binlog_thread_buffer>, size_t>> targets;
+    for (auto &buffer : buffers_) {
+        auto committed = buffer->ring.committed();
+        if (buffer->ring.consumed() != committed) {
+            targets.emplace_back(buffer, committed);
+        }
+    }
+    if (targets.empty()) {
+        return;
+    }
+    ++drain_waiters_;
+    work_cv_.notify_one();
+    drained_cv_.wait(lock, [&] {
+        return std::all_of(targets.begin(), targets.end(), [](const auto &target) {
+            return target.first->ring.consumed() >= target.second;
+        });
+    });
+    --drain_waiters_;
+}
+
+ABEL_FORCE_INLINE binlog_thread_buffer *binlog_backend::create_local_buffer_(local_holder &holder) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    holder.buffer = std::make_shared<binlog_thread_buffer>(thread_buffer_size_, os::thread_id());
+    buffers_.push_back(holder.buffer);
+    buffers_version_.fetch_add(1, std::memory_order_relaxed);
+    return holder.buffer.get();
+}
+
+ABEL_FORCE_INLINE void binlog_backend::worker_loop_() {
+    while (true) {
+        bool drained = process_records_(4096);
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (drain_waiters_) {
+            drained_cv_.notify_all();
+        }
+        if (!drained) {
+            continue;
+        }
+        if (!active_) {
+            break;
+        }
+        work_cv_.wait_for(lock, poll_interval_, [this] { return drain_waiters_ || !active_; });
+    }
+}
+
+ABEL_FORCE_INLINE bool binlog_backend::process_records_(size_t max_records) {
+    if (polled_version_ != buffers_version_.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        polled_ = buffers_;
+        polled_version_ = buffers_version_.load(std::memory_order_relaxed);
+    }
+
+    // merge the rings by timestamp. rings that were empty are only looked at
+    // again once the others are.
+    size_t processed = 0;
+    while (true) {
+        merge_heap_.clear();
+        for (auto &buffer : polled_) {
+            push_oldest_(buffer.get());
+        }
+        if (merge_heap_.empty()) {
+            break;
+        }
+        while (!merge_heap_.empty()) {
+            if (processed == max_records) {
+                return false;
+            }
+            std::pop_heap(merge_heap_.begin(), merge_heap_.end(), later_record_);
+            auto oldest = merge_heap_.back();
+            merge_heap_.pop_back();
+            process_record_(oldest.buffer, oldest.record);
+            oldest.buffer->ring.consume(reinterpret_cast<const char *>(oldest.record));
+            ++processed;
+            push_oldest_(oldest.buffer);
+        }
+    }
+
+    // free the rings of exited threads. they can't be written to anymore.
+    auto exited = [](const std::shared_ptr<binlog_thread_buffer> &buffer) {
+        return buffer->retired.load(std::memory_order_acquire) && !buffer->ring.peek();
+    };
+    if (std::any_of(polled_.begin(), polled_.end(), exited)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(), exited), buffers_.end());
+        polled_ = buffers_;
+        polled_version_ = buffers_version_.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+    return true;
+}
+
+ABEL_FORCE_INLINE void binlog_backend::push_oldest_(binlog_thread_buffer *buffer) {
+    auto record = reinterpret_cast<const binlog_record *>(buffer->ring.peek());
+    if (record) {
+        merge_heap_.push_back({record->time, buffer, record});
+        std::push_heap(merge_heap_.begin(), merge_heap_.end(), later_record_);
+    }
+}
+
+ABEL_FORCE_INLINE void binlog_backend::process_record_(binlog_thread_buffer *buffer, const binlog_record *record) {
+    record->logger->backend_log_(*record, buffer->thread_id, format_buf_);
+}
+
+} // namespace details
+}  // namespace abel
@@ -0,0 +1,140 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// single producer-single consumer ring of variable sized records.
+//
+// the producer reserves a contiguous chunk, writes the record in place and
+// commits it. the consumer peeks the oldest record, reads it in place and
+// consumes it. neither side ever takes a lock or copies a record.
+//
+// records are 8 bytes aligned and start with a `binlog_chunk_header`. when a
+// record doesn't fit before the end of the ring, the remaining bytes are
+// skipped with a padding chunk and the record is written at the beginning.
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include "abel/base/profile.h"
+
+namespace abel {
+namespace details {
+
+struct binlog_chunk_header {
+    uint32_t size;  // including this header
+    uint32_t padding;  // non zero if the chunk is to be skipped
+};
+
+class binlog_ring {
+  public:
+    static constexpr size_t alignment = 8;
+
+    // `capacity` is rounded up to a power of 2.
+    explicit binlog_ring(size_t capacity)
+            : capacity_(round_up_capacity(capacity)), mask_(capacity_ - 1), buffer_(new char[capacity_]) {}
+
+    binlog_ring(const binlog_ring &) = delete;
+
+    binlog_ring &operator=(const binlog_ring &) = delete;
+
+    // largest record the ring accepts.
+    size_t max_record_size() const {
+        return capacity_ / 2;
+    }
+
+    // producer side. returns a chunk of `size` bytes (a multiple of
+    // `alignment`), or nullptr if there's not enough room left.
+    char *reserve(size_t size) {
+        assert(size % alignment == 0 && size <= max_record_size());
+        auto head = head_.load(std::memory_order_relaxed);
+        auto offset = head & mask_;
+        auto skip = capacity_ - offset < size ? capacity_ - offset : 0;
+        if (head + skip + size - tail_cache_ > capacity_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head + skip + size - tail_cache_ > capacity_) {
+                return nullptr;
+            }
+        }
+        if (skip) {
+            auto pad = reinterpret_cast<binlog_chunk_header *>(buffer_.get() + offset);
+            pad->size = static_cast<uint32_t>(skip);
+            pad->padding = 1;
+            offset = 0;
+        }
+        reserved_skip_ = skip;
+        return buffer_.get() + offset;
+    }
+
+    // publish the chunk returned by the last `reserve(size)`.
+    void commit(size_t size) {
+        auto head = head_.load(std::memory_order_relaxed);
+        head_.store(head + reserved_skip_ + size, std::memory_order_release);
+    }
+
+    // consumer side. returns the oldest record (starting with its header), or
+    // nullptr if the ring is empty. the record stays valid until consumed.
+    const char *peek() {
+        auto tail = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            if (tail == head_cache_) {
+                head_cache_ = head_.load(std::memory_order_acquire);
+                if (tail == head_cache_) {
+                    return nullptr;
+                }
+            }
+            auto chunk = buffer_.get() + (tail & mask_);
+            auto header = reinterpret_cast<const binlog_chunk_header *>(chunk);
+            if (!header->padding) {
+                return chunk;
+            }
+            tail += header->size;
+            tail_.store(tail, std::memory_order_release);
+        }
+    }
+
+    // release the record returned by `peek()`.
+    void consume(const char *record) {
+        auto header = reinterpret_cast<const binlog_chunk_header *>(record);
+        auto tail = tail_.load(std::memory_order_relaxed);
+        tail_.store(tail + header->size, std::memory_order_release);
+    }
+
+    // position past the last committed record, from any thread.
+    size_t committed() const {
+        return head_.load(std::memory_order_acquire);
+    }
+
+    // position past the last consumed record, from any thread. the records
+    // before it were handed to the consumer and released.
+    size_t consumed() const {
+        return tail_.load(std::memory_order_acquire);
+    }
+
+  private:
+    static size_t round_up_capacity(size_t capacity) {
+        size_t rc = 4096;
+        while (rc < capacity) {
+            rc <<= 1;
+        }
+        return rc;
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<char[]> buffer_;
+
+    // written by the producer.
+    alignas(hardware_destructive_interference_size) std::atomic<size_t> head_{0};
+    size_t tail_cache_{0};
+    size_t reserved_skip_{0};
+
+    // written by the consumer.
+    alignas(hardware_destructive_interference_size) std::atomic<size_t> tail_{0};
+    size_t head_cache_{0};
+};
+
+} // namespace details
+}  // namespace abel
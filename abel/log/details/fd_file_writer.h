@@ -0,0 +1,95 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include "abel/log/common.h"
+
+
+namespace abel {
+
+// When file sinks ask the kernel to persist written data (fdatasync).
+enum class file_sync_policy {
+    none,           // Leave it to the kernel
+    every_n_bytes,  // After every `sync_bytes` bytes written
+    every_interval  // Every `sync_interval` if data was written since
+};
+
+struct fd_file_options {
+    // user space buffer. messages are written in batches of this size.
+    size_t buffer_size = 1024 * 1024;
+    // buffered messages are written out at least this often (0 to only write
+    // them when the buffer fills or on flush). ignored by fd_file_sink_st.
+    std::chrono::milliseconds flush_interval{1000};
+    file_sync_policy sync_policy = file_sync_policy::none;
+    size_t sync_bytes = 16 * 1024 * 1024;
+    std::chrono::milliseconds sync_interval{1000};
+    // reserve disk space for this many bytes whenever a file is (re)opened,
+    // avoiding block allocation (and fragmentation) on the write path.
+    size_t preallocate_size = 0;
+};
+
+namespace details {
+
+// Helper class for fd file sinks.
+// Appends to a raw fd through a user space buffer: messages are written with a
+// single write(v) when the buffer fills, or when flushed.
+// When failing to open a file, retry several times(5) with a delay interval(10 ms).
+// Throw log_ex exception on errors.
+
+class ABEL_API fd_file_writer {
+  public:
+    explicit fd_file_writer(const fd_file_options &options);
+
+    fd_file_writer(const fd_file_writer &) = delete;
+
+    fd_file_writer &operator=(const fd_file_writer &) = delete;
+
+    ~fd_file_writer();
+
+    void open(const filename_t &fname, bool truncate = false);
+
+    void reopen(bool truncate);
+
+    // write buffered data to the file, then sync it if the policy asks so.
+    void flush();
+
+    // write buffered data to the file and sync it.
+    void sync();
+
+    void close();
+
+    void write(const memory_buf_t &buf);
+
+    // size of the file, including buffered data.
+    size_t size() const;
+
+    const filename_t &filename() const;
+
+    const fd_file_options &options() const;
+
+  private:
+    // write the buffer and `extra` with a single syscall.
+    void write_out_(const char *extra, size_t extra_size);
+
+    void sync_if_due_();
+
+    void preallocate_();
+
+    const int open_tries_ = 5;
+    const int open_interval_ = 10;
+    const fd_file_options options_;
+    int fd_{-1};
+    filename_t filename_;
+    std::unique_ptr<char[]> buffer_;
+    size_t buffered_{0};
+    size_t file_size_{0};
+    size_t unsynced_bytes_{0};
+    std::chrono::steady_clock::time_point last_sync_;
+};
+} // namespace details
+}  // namespace abel
+
+#include "abel/log/details/fd_file_writer_inl.h"
@@ -0,0 +1,201 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "abel/log/details/os.h"
+#include "abel/log/common.h"
+
+
+namespace abel {
+namespace details {
+
+ABEL_FORCE_INLINE fd_file_writer::fd_file_writer(const fd_file_options &options)
+        : options_(options), buffer_(new char[options.buffer_size]) {}
+
+ABEL_FORCE_INLINE fd_file_writer::~fd_file_writer() {
+    ABEL_TRY {
+        close();
+    }
+    ABEL_CATCH_ALL() {}
+}
+
+ABEL_FORCE_INLINE void fd_file_writer::open(const filename_t &fname, bool truncate) {
+    close();
+    filename_ = fname;
+    int flags = O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC | (truncate ? O_TRUNC : 0);
+
+    for (int tries = 0; tries < open_tries_; ++tries) {
+        // create containing folder if not exists already.
+        os::create_dir(os::dir_name(fname));
+        fd_ = ::open(fname.c_str(), flags, 0644);
+        if (fd_ != -1) {
+            struct stat st;
+            file_size_ = ::fstat(fd_, &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+            unsynced_bytes_ = 0;
+            last_sync_ = std::chrono::steady_clock::now();
+            preallocate_();
+            return;
+        }
+
+        details::os::sleep_for_millis(open_interval_);
+    }
+
+    throw_log_ex("Failed opening file " + os::filename_to_str(filename_) + " for writing", errno);
+}
+
+ABEL_FORCE_INLINE void fd_file_writer::reopen(bool truncate) {
+    if (filename_.empty()) {
+        throw_log_ex("Failed re opening file - was not opened before");
+    }
+    this->open(filename_, truncate);
+}
+
+ABEL_FORCE_INLINE void fd_file_writer::flush() {
+    if (buffered_) {
+        write_out_(nullptr, 0);
+    }
+    sync_if_due_();
+}
+
+ABEL_FORCE_INLINE void fd_file_writer::sync() {
+    if (buffered_) {
+        write_out_(nullptr, 0);
+    }
+    if (fd_ != -1 && unsynced_bytes_) {
+#ifdef __linux__
+        ::fdatasync(fd_);
+#else
+        ::fsync(fd_);
+#endif
+        unsynced_bytes_ = 0;
+        last_sync_ = std::chrono::steady_clock::now();
+    }
+}
+
+ABEL_FORCE_INLINE void fd_file_writer::close() {
+    if (fd_ != -1) {
+        // don't lose buffered messages, but don't throw either if we can't.
+        ABEL_TRY {
+            if (options_.sync_policy == file_sync_policy::none) {
+                flush();
+            } else {
+                sync();
+            }
+        }
+        ABEL_CATCH_ALL() {}
+        ::close(fd_);
+        fd_ = -1;
+        buffered_ = 0;
+    }
+}
+
+ABEL_FORCE_INLINE void fd_file_writer::write(const memory_buf_t &buf) {
+    size_t msg_size = buf.size();
+    if (ABEL_LIKELY(buffered_ + msg_size <= options_.buffer_size)) {
+        std::memcpy(buffer_.get() + buffered_, buf.data(), msg_size);
+        buffered_ += msg_size;
+        file_size_ += msg_size;
+        return;
+    }
+    // no room left, write the buffer along with the message.
+    file_size_ += msg_size;
+    write_out_(buf.data(), msg_size);
+    sync_if_due_();
+}
+
+ABEL_FORCE_INLINE size_t fd_file_writer::size() const {
+    if (fd_ == -1) {
+        throw_log_ex("Cannot use size() on closed file " + os::filename_to_str(filename_));
+    }
+    return file_size_;
+}
+
+ABEL_FORCE_INLINE const filename_t &fd_file_writer::filename() const {
+    return filename_;
+}
+
+ABEL_FORCE_INLINE const fd_file_options &fd_file_writer::options() const {
+    return options_;
+}
+
+ABEL_FORCE_INLINE void fd_file_writer::write_out_(const char *extra, size_t extra_size) {
+    if (fd_ == -1) {
+        throw_log_ex("Cannot write to closed file " + os::filename_to_str(filename_));
+    }
+    struct iovec iov[2];
+    int iov_cnt = 0;
+    if (buffered_) {
+        iov[iov_cnt++] = {buffer_.get(), buffered_};
+    }
+    if (extra_size) {
+        iov[iov_cnt++] = {const_cast<char *>(extra), extra_size};
+    }
+    size_t total = buffered_ + extra_size;
+    // the buffer is given up even if we fail, so that we don't fail forever.
+    buffered_ = 0;
+
+    struct iovec *pending = iov;
+    while (iov_cnt) {
+        auto written = ::writev(fd_, pending, iov_cnt);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw_log_ex("Failed writing to file " + os::filename_to_str(filename_), errno);
+        }
+        // partial write, skip what's been written.
+        auto left = static_cast<size_t>(written);
+        while (iov_cnt && left >= pending->iov_len) {
+            left -= pending->iov_len;
+            ++pending;
+            --iov_cnt;
+        }
+        if (iov_cnt) {
+            pending->iov_base = static_cast<char *>(pending->iov_base) + left;
+            pending->iov_len -= left;
+        }
+    }
+    unsynced_bytes_ += total;
+}
+
+ABEL_FORCE_INLINE void fd_file_writer::sync_if_due_() {
+    if (!unsynced_bytes_) {
+        return;
+    }
+    switch (options_.sync_policy) {
+        case file_sync_policy::every_n_bytes:
+            if (unsynced_bytes_ >= options_.sync_bytes) {
+                sync();
+            }
+            break;
+        case file_sync_policy::every_interval:
+            if (std::chrono::steady_clock::now() - last_sync_ >= options_.sync_interval) {
+                sync();
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+ABEL_FORCE_INLINE void fd_file_writer::preallocate_() {
+#ifdef __linux__
+    if (options_.preallocate_size) {
+        // keep the size, appends must still start at the end of the data.
+        // best effort, not every file system supports it.
+        (void) ::fallocate(fd_, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(file_size_),
+                           static_cast<off_t>(options_.preallocate_size));
+    }
+#endif
+}
+
+} // namespace details
+}  // namespace abel
@@ -0,0 +1,161 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Rate limiting of log call sites, for log storms.
+//
+// Each rate limited call site (the LOG_*_RATE_LIMITED macros) owns a token
+// bucket, and every message let through by its site's bucket also takes a
+// token from the process wide budget (unlimited unless set_log_budget() is
+// called). A message the budget drops gives its token back to its site.
+// Messages that don't get a token are dropped and counted:
+//    - per site: the count is appended to the next message the site emits,
+//    - per logger: in the `log_suppressed{logger="..."}` counter of
+//    log_metrics_scope().
+//
+// Checking a bucket reads the coarse monotonic clock (from the vdso on linux,
+// no syscall) and, when a message is rejected, doesn't write any shared
+// memory but the site's suppression count.
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "abel/log/common.h"
+#include "abel/log/logger.h"
+
+
+namespace abel {
+namespace metrics {
+class int_counter;
+
+class scope;
+}  // namespace metrics
+
+namespace details {
+
+// milliseconds since an unspecified epoch, with the resolution of the kernel
+// tick (1 to 4ms).
+int64_t coarse_now_ms() ABEL_NOEXCEPT;
+
+// Token bucket, implemented as a GCRA: the whole state is the (theoretical)
+// time at which the bucket will be full again.
+// A rate of 0 means unlimited.
+class ABEL_API token_bucket {
+  public:
+    token_bucket() = default;
+
+    token_bucket(uint32_t per_second, uint32_t burst);
+
+    // thread safe, though acquires racing with it may use the old rate.
+    void reset(uint32_t per_second, uint32_t burst);
+
+    bool try_acquire(int64_t now_ms) ABEL_NOEXCEPT;
+
+    // give back a token taken by try_acquire().
+    void release() ABEL_NOEXCEPT;
+
+  private:
+    // in microseconds.
+    std::atomic<int64_t> interval_{0};
+    std::atomic<int64_t> tolerance_{0};
+    std::atomic<int64_t> full_at_{0};
+};
+
+// suppression counter of a logger, never freed once created.
+struct log_suppression_counter {
+    std::string logger_name;
+    std::shared_ptr<metrics::int_counter> counter;
+};
+
+// state of a rate limited call site, usually a static of the site.
+struct log_sampling_site {
+    log_sampling_site(uint32_t per_second, uint32_t burst) : bucket(per_second, burst) {}
+
+    token_bucket bucket;
+    // messages dropped since the site last emitted one.
+    std::atomic<uint64_t> suppressed{0};
+    // counter of the logger the site last dropped a message of.
+    std::atomic<const log_suppression_counter *> counter{nullptr};
+};
+
+class ABEL_API log_sampler {
+  public:
+    static log_sampler &instance();
+
+    log_sampler(const log_sampler &) = delete;
+
+    log_sampler &operator=(const log_sampler &) = delete;
+
+    // true if a message of `site` may be logged now.
+    bool try_acquire(log_sampling_site &site) ABEL_NOEXCEPT;
+
+    // count a message of `site`, logged by `logger_name`, that was dropped.
+    void suppressed(log_sampling_site &site, const std::string &logger_name);
+
+    void set_budget(uint32_t per_second, uint32_t burst);
+
+    const std::shared_ptr<metrics::scope> &scope() const;
+
+  private:
+    log_sampler();
+
+    const log_suppression_counter *counter_of_(const std::string &logger_name);
+
+    token_bucket budget_;
+    std::shared_ptr<metrics::scope> scope_;
+    std::mutex counters_mutex_;
+    std::unordered_map<std::string, std::unique_ptr<log_suppression_counter>> counters_;
+};
+
+// log a message of a rate limited call site.
+template<typename FormatString, typename... Args>
+inline void log_sampled(logger *target, log_sampling_site &site, source_loc loc, level::level_enum lvl,
+                        const FormatString &fmt, const Args &... args) {
+    if (!target->should_log(lvl)) {
+        return;
+    }
+    auto &sampler = log_sampler::instance();
+    if (!sampler.try_acquire(site)) {
+        sampler.suppressed(site, target->name());
+        return;
+    }
+    auto suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+    if (ABEL_LIKELY(suppressed == 0)) {
+        target->log(loc, lvl, fmt, args...);
+        return;
+    }
+    ABEL_TRY {
+        memory_buf_t buf;
+        abel::format_to(buf, fmt, args...);
+        abel::format_to(buf, " [{} similar messages suppressed]", suppressed);
+        target->log(loc, lvl, std::string_view(buf.data(), buf.size()));
+    }
+    ABEL_CATCH_ALL() {}
+}
+
+template<typename FormatString, typename... Args>
+inline void log_sampled(const std::shared_ptr<logger> &target, log_sampling_site &site, source_loc loc,
+                        level::level_enum lvl, const FormatString &fmt, const Args &... args) {
+    log_sampled(target.get(), site, loc, lvl, fmt, args...);
+}
+
+} // namespace details
+
+// process wide budget of rate limited call sites: messages they let through
+// are dropped once it's exhausted. a rate of 0 (the default) means unlimited.
+inline void set_log_budget(uint32_t per_second, uint32_t burst) {
+    details::log_sampler::instance().set_budget(per_second, burst);
+}
+
+// scope holding the per logger counters of dropped messages.
+inline const std::shared_ptr<metrics::scope> &log_metrics_scope() {
+    return details::log_sampler::instance().scope();
+}
+
+}  // namespace abel
+
+#include "abel/log/details/log_sampler_inl.h"
@@ -0,0 +1,90 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+
+
+namespace abel {
+namespace details {
+
+ABEL_FORCE_INLINE int64_t coarse_now_ms() ABEL_NOEXCEPT {
+#if defined(__linux__) && defined(CLOCK_MONOTONIC_COARSE)
+    timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+#else
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+ABEL_FORCE_INLINE token_bucket::token_bucket(uint32_t per_second, uint32_t burst) {
+    reset(per_second, burst);
+}
+
+ABEL_FORCE_INLINE void token_bucket::reset(uint32_t per_second, uint32_t burst) {
+    int64_t interval = per_second == 0 ? 0 : std::max<int64_t>(1000000 / per_second, 1);
+    tolerance_.store(interval * (std::max<uint32_t>(burst, 1) - 1), std::memory_order_relaxed);
+    interval_.store(interval, std::memory_order_relaxed);
+}
+
+ABEL_FORCE_INLINE bool token_bucket::try_acquire(int64_t now_ms) ABEL_NOEXCEPT {
+    auto interval = interval_.load(std::memory_order_relaxed);
+    if (interval == 0) {
+        return true;
+    }
+    auto tolerance = tolerance_.load(std::memory_order_relaxed);
+    auto now = now_ms * 1000;
+    auto full_at = full_at_.load(std::memory_order_relaxed);
+    int64_t next;
+    do {
+        auto start = std::max(full_at, now);
+        if (start - now > tolerance) {
+            // empty, leave the cache line alone.
+            return false;
+        }
+        next = start + interval;
+    } while (!full_at_.compare_exchange_weak(full_at, next, std::memory_order_relaxed));
+    return true;
+}
+
+ABEL_FORCE_INLINE void token_bucket::release() ABEL_NOEXCEPT {
+    auto interval = interval_.load(std::memory_order_relaxed);
+    if (interval != 0) {
+        // going back past the current time just means the bucket is full.
+        full_at_.fetch_sub(interval, std::memory_order_relaxed);
+    }
+}
+
+ABEL_FORCE_INLINE log_sampler &log_sampler::instance() {
+    static log_sampler s_instance;
+    return s_instance;
+}
+
+ABEL_FORCE_INLINE bool log_sampler::try_acquire(log_sampling_site &site) ABEL_NOEXCEPT {
+    auto now = coarse_now_ms();
+    if (!site.bucket.try_acquire(now)) {
+        return false;
+    }
+    if (ABEL_LIKELY(budget_.try_acquire(now))) {
+        return true;
+    }
+    // the message is dropped anyway, it mustn't count against its site.
+    site.bucket.release();
+    return false;
+}
+
+ABEL_FORCE_INLINE void log_sampler::set_budget(uint32_t per_second, uint32_t burst) {
+    budget_.reset(per_second, burst);
+}
+
+ABEL_FORCE_INLINE const std::shared_ptr<metrics::scope> &log_sampler::scope() const {
+    return scope_;
+}
+
+} // namespace details
+}  // namespace abel
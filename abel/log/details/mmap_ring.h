@@ -0,0 +1,113 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// file backed ring of records, written through a shared memory mapping.
+//
+// once written, a record is in the page cache: it survives the process
+// crashing (though not the machine, unless synced), and nothing on the write
+// path is a syscall.
+//
+// layout: a header page, followed by the data area (`capacity` bytes, a power
+// of 2). positions are logical byte offsets, the data area being written
+// round robin:
+//
+//   [tail, head)      records still intact, oldest first.
+//   [head, reserved)  record being written.
+//
+// records are 16 bytes aligned, start with a `mmap_ring_record` and never
+// wrap: the bytes left at the end of the data area are skipped with a padding
+// record. the writer moves `tail` past the records it's about to overwrite
+// before touching them, so the ring can be decoded at any time, even if the
+// writer died in the middle of a record.
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include "abel/log/common.h"
+
+
+namespace abel {
+namespace details {
+
+struct mmap_ring_header {
+    static constexpr char magic_value[8] = {'A', 'B', 'E', 'L', 'R', 'I', 'N', 'G'};
+    static constexpr uint32_t current_version = 1;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t data_offset;
+    uint64_t capacity;
+    std::atomic<uint64_t> tail;
+    std::atomic<uint64_t> head;
+    std::atomic<uint64_t> reserved;
+    // sequence number of the next record.
+    std::atomic<uint64_t> next_seq;
+};
+
+struct mmap_ring_record {
+    static constexpr uint32_t padding_payload = UINT32_MAX;
+
+    uint32_t size;          // including this header and trailing alignment
+    uint32_t payload_size;  // `padding_payload` for padding records
+    uint64_t seq;
+};
+
+class ABEL_API mmap_ring {
+  public:
+    static constexpr size_t alignment = 16;
+    static constexpr size_t page_size = 4096;
+
+    mmap_ring() = default;
+
+    mmap_ring(const mmap_ring &) = delete;
+
+    mmap_ring &operator=(const mmap_ring &) = delete;
+
+    ~mmap_ring();
+
+    // records of an existing ring with the same capacity are kept, otherwise
+    // the file is reset. `capacity` is rounded up to a power of 2 (64KB at
+    // least).
+    void open(const filename_t &fname, size_t capacity);
+
+    void close();
+
+    // append a record, truncated to `max_payload_size()` bytes.
+    // not thread safe.
+    void append(const char *data, size_t size);
+
+    // ask the kernel to write the ring to disk, so that it survives the
+    // machine crashing too.
+    void sync();
+
+    size_t max_payload_size() const;
+
+    const filename_t &filename() const;
+
+    // call `callback(seq, payload)` for each record of the ring file `fname`,
+    // oldest first. throw log_ex if `fname` isn't a ring file.
+    static void read(const filename_t &fname, const std::function<void(uint64_t, std::string_view)> &callback);
+
+  private:
+    static size_t round_up_capacity(size_t capacity);
+
+    mmap_ring_record *record_at_(uint64_t pos) const;
+
+    // move `tail` past records overlapping [.., end).
+    void make_room_(uint64_t end);
+
+    int fd_{-1};
+    filename_t filename_;
+    char *mapping_{nullptr};
+    size_t mapping_size_{0};
+    mmap_ring_header *header_{nullptr};
+    char *data_{nullptr};
+    uint64_t mask_{0};
+};
+
+} // namespace details
+}  // namespace abel
+
+#include "abel/log/details/mmap_ring_inl.h"
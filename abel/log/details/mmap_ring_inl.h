@@ -0,0 +1,236 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "abel/log/details/os.h"
+#include "abel/log/common.h"
+
+
+namespace abel {
+namespace details {
+
+ABEL_FORCE_INLINE mmap_ring::~mmap_ring() {
+    close();
+}
+
+ABEL_FORCE_INLINE void mmap_ring::open(const filename_t &fname, size_t capacity) {
+    close();
+    filename_ = fname;
+    capacity = round_up_capacity(capacity);
+
+    os::create_dir(os::dir_name(fname));
+    fd_ = ::open(fname.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ == -1) {
+        throw_log_ex("Failed opening file " + os::filename_to_str(filename_) + " for writing", errno);
+    }
+
+    mapping_size_ = page_size + capacity;
+    struct stat st;
+    bool reuse = ::fstat(fd_, &st) == 0 && static_cast<size_t>(st.st_size) == mapping_size_;
+    if (!reuse) {
+        if (::ftruncate(fd_, 0) != 0 || ::ftruncate(fd_, static_cast<off_t>(mapping_size_)) != 0) {
+            auto err = errno;
+            close();
+            throw_log_ex("Failed resizing file " + os::filename_to_str(fname), err);
+        }
+    }
+#ifdef __linux__
+    // allocate the blocks now, rather than getting SIGBUS on the write path
+    // if the disk is full. best effort.
+    (void) ::posix_fallocate(fd_, 0, static_cast<off_t>(mapping_size_));
+#endif
+
+    auto mapping = ::mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        auto err = errno;
+        mapping_ = nullptr;
+        close();
+        throw_log_ex("Failed mapping file " + os::filename_to_str(fname), err);
+    }
+    mapping_ = static_cast<char *>(mapping);
+    header_ = reinterpret_cast<mmap_ring_header *>(mapping_);
+    data_ = mapping_ + page_size;
+    mask_ = capacity - 1;
+
+    reuse = reuse && std::memcmp(header_->magic, mmap_ring_header::magic_value, sizeof(header_->magic)) == 0 &&
+            header_->version == mmap_ring_header::current_version && header_->data_offset == page_size &&
+            header_->capacity == capacity &&
+            header_->tail.load() <= header_->head.load() &&
+            header_->head.load() - header_->tail.load() <= capacity;
+    if (reuse) {
+        // drop the record being written when the last writer died, if any.
+        header_->reserved.store(header_->head.load());
+        return;
+    }
+    std::memset(mapping_, 0, page_size);
+    header_->version = mmap_ring_header::current_version;
+    header_->data_offset = page_size;
+    header_->capacity = capacity;
+    header_->tail.store(0);
+    header_->head.store(0);
+    header_->reserved.store(0);
+    header_->next_seq.store(0);
+    // marks the header valid.
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header_->magic, mmap_ring_header::magic_value, sizeof(header_->magic));
+}
+
+ABEL_FORCE_INLINE void mmap_ring::close() {
+    if (mapping_ != nullptr) {
+        ::munmap(mapping_, mapping_size_);
+        mapping_ = nullptr;
+        header_ = nullptr;
+        data_ = nullptr;
+    }
+    if (fd_ != -1) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+ABEL_FORCE_INLINE void mmap_ring::append(const char *data, size_t size) {
+    if (header_ == nullptr) {
+        throw_log_ex("Cannot write to closed file " + os::filename_to_str(filename_));
+    }
+    size = std::min(size, max_payload_size());
+    auto record_size = (sizeof(mmap_ring_record) + size + alignment - 1) & ~(alignment - 1);
+    auto capacity = mask_ + 1;
+    auto pos = header_->head.load(std::memory_order_relaxed);
+
+    // records never wrap, skip what's left of the data area.
+    auto left = capacity - (pos & mask_);
+    if (left < record_size) {
+        make_room_(pos + left);
+        auto padding = record_at_(pos);
+        padding->size = static_cast<uint32_t>(left);
+        padding->payload_size = mmap_ring_record::padding_payload;
+        padding->seq = 0;
+        pos += left;
+        header_->reserved.store(pos, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        header_->head.store(pos, std::memory_order_relaxed);
+    }
+
+    make_room_(pos + record_size);
+    header_->reserved.store(pos + record_size, std::memory_order_relaxed);
+    // tail and reserved must be updated before the record is overwritten.
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto record = record_at_(pos);
+    record->size = static_cast<uint32_t>(record_size);
+    record->payload_size = static_cast<uint32_t>(size);
+    record->seq = header_->next_seq.load(std::memory_order_relaxed);
+    std::memcpy(record + 1, data, size);
+
+    // the record must be complete before it's published.
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->next_seq.store(record->seq + 1, std::memory_order_relaxed);
+    header_->head.store(pos + record_size, std::memory_order_relaxed);
+}
+
+ABEL_FORCE_INLINE void mmap_ring::sync() {
+    if (mapping_ != nullptr) {
+        ::msync(mapping_, mapping_size_, MS_SYNC);
+    }
+}
+
+ABEL_FORCE_INLINE size_t mmap_ring::max_payload_size() const {
+    // a quarter of the ring, so that a large record doesn't evict everything.
+    return (mask_ + 1) / 4 - sizeof(mmap_ring_record);
+}
+
+ABEL_FORCE_INLINE const filename_t &mmap_ring::filename() const {
+    return filename_;
+}
+
+ABEL_FORCE_INLINE size_t mmap_ring::round_up_capacity(size_t capacity) {
+    size_t rc = 64 * 1024;
+    while (rc < capacity) {
+        rc <<= 1;
+    }
+    return rc;
+}
+
+ABEL_FORCE_INLINE mmap_ring_record *mmap_ring::record_at_(uint64_t pos) const {
+    return reinterpret_cast<mmap_ring_record *>(data_ + (pos & mask_));
+}
+
+ABEL_FORCE_INLINE void mmap_ring::make_room_(uint64_t end) {
+    auto capacity = mask_ + 1;
+    auto tail = header_->tail.load(std::memory_order_relaxed);
+    auto head = header_->head.load(std::memory_order_relaxed);
+    while (end - tail > capacity) {
+        auto size = tail != head ? record_at_(tail)->size : 0;
+        if (size == 0 || size % alignment != 0 || size > head - tail) {
+            // garbage, left by an earlier writer. drop everything.
+            tail = head;
+            break;
+        }
+        tail += size;
+    }
+    header_->tail.store(tail, std::memory_order_relaxed);
+}
+
+ABEL_FORCE_INLINE void
+mmap_ring::read(const filename_t &fname, const std::function<void(uint64_t, std::string_view)> &callback) {
+    int fd = ::open(fname.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        throw_log_ex("Failed opening file " + os::filename_to_str(fname), errno);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < page_size) {
+        ::close(fd);
+        throw_log_ex("Not a ring file: " + os::filename_to_str(fname));
+    }
+    auto size = static_cast<size_t>(st.st_size);
+    auto mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw_log_ex("Failed mapping file " + os::filename_to_str(fname), errno);
+    }
+    struct unmapper {
+        ~unmapper() { ::munmap(p, n); }
+
+        void *p;
+        size_t n;
+    } unmap{mapping, size};
+
+    auto header = static_cast<const mmap_ring_header *>(mapping);
+    auto capacity = header->capacity;
+    auto tail = header->tail.load();
+    auto head = header->head.load();
+    if (std::memcmp(header->magic, mmap_ring_header::magic_value, sizeof(header->magic)) != 0 ||
+        header->version != mmap_ring_header::current_version || header->data_offset != page_size ||
+        capacity == 0 || (capacity & (capacity - 1)) != 0 || size != page_size + capacity || tail > head ||
+        head - tail > capacity) {
+        throw_log_ex("Not a ring file: " + os::filename_to_str(fname));
+    }
+
+    auto data = static_cast<const char *>(mapping) + page_size;
+    for (auto pos = tail; pos != head;) {
+        auto record = reinterpret_cast<const mmap_ring_record *>(data + (pos & (capacity - 1)));
+        if (record->size == 0 || record->size % alignment != 0 || record->size > head - pos) {
+            throw_log_ex("Corrupted ring file: " + os::filename_to_str(fname));
+        }
+        if (record->payload_size != mmap_ring_record::padding_payload) {
+            if (record->payload_size > record->size - sizeof(mmap_ring_record)) {
+                throw_log_ex("Corrupted ring file: " + os::filename_to_str(fname));
+            }
+            callback(record->seq, std::string_view(reinterpret_cast<const char *>(record + 1),
+                                                   record->payload_size));
+        }
+        pos += record->size;
+    }
+}
+
+} // namespace details
+}  // namespace abel
@@ -0,0 +1,143 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// multi producer-multi consumer bounded queue, lock-free unless a side has to
+// wait. Same interface as `mpmc_blocking_queue`, plus bulk dequeue.
+//
+// enqueue(..) - will block until room found to put the new message.
+// enqueue_nowait(..) - will overrun the oldest message if no room left in the
+// queue.
+// dequeue_for(..) / dequeue_bulk_for(..) - will block until the queue is not
+// empty or timeout have passed.
+//
+// Producers and consumers only take the mutex when the other side is (or is
+// about to be) sleeping on the queue, i.e. the queue is full or empty.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include "abel/atomic/mpmc_ring.h"
+
+
+namespace abel {
+namespace details {
+
+// Lets threads sleep until some condition holds, without making the threads
+// that fulfill the condition pay for a mutex unless someone is sleeping.
+class lockfree_q_waiter {
+  public:
+    // Returns the result of the last `pred()` evaluation.
+    template<typename Pred>
+    bool wait_for(std::chrono::milliseconds wait_duration, Pred &&pred) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        waiters_.fetch_add(1, std::memory_order_relaxed);
+        // Pairs with the fence in `has_waiters_()`: either the notifier sees
+        // `waiters_` incremented, or we see what it has done (in `pred()`).
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto rc = cv_.wait_for(lock, wait_duration, pred);
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+        return rc;
+    }
+
+    template<typename Pred>
+    void wait(Pred &&pred) {
+        while (!wait_for(std::chrono::seconds(1), pred)) {
+        }
+    }
+
+    // Called after making the condition true.
+    void notify_one() {
+        if (has_waiters_()) {
+            cv_.notify_one();
+        }
+    }
+
+    void notify_all() {
+        if (has_waiters_()) {
+            cv_.notify_all();
+        }
+    }
+
+  private:
+    bool has_waiters_() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!waiters_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        // Waiters are either waiting on `cv_`, or have yet to evaluate their
+        // predicate with `mutex_` held.
+        { std::lock_guard<std::mutex> lock(mutex_); }
+        return true;
+    }
+
+  private:
+    std::atomic<int> waiters_{0};
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+template<typename T>
+class mpmc_lockfree_queue {
+  public:
+    using item_type = T;
+
+    // `max_items` is rounded up to a power of 2.
+    explicit mpmc_lockfree_queue(size_t max_items)
+            : q_(max_items) {}
+
+    // try to enqueue and block if no room left
+    void enqueue(T &&item) {
+        if (!q_.try_push(std::move(item))) {
+            not_full_.wait([&] { return q_.try_push(std::move(item)); });
+        }
+        not_empty_.notify_one();
+    }
+
+    // enqueue immediately. overrun oldest message in the queue if no room left.
+    void enqueue_nowait(T &&item) {
+        while (!q_.try_push(std::move(item))) {
+            T discarded;
+            if (q_.try_pop(&discarded)) {
+                overrun_counter_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        not_empty_.notify_one();
+    }
+
+    // try to dequeue item. if no item found. wait upto timeout and try again
+    // Return true, if succeeded dequeue item, false otherwise
+    bool dequeue_for(T &popped_item, std::chrono::milliseconds wait_duration) {
+        return dequeue_bulk_for(&popped_item, 1, wait_duration) == 1;
+    }
+
+    // dequeue up to `max_items` items into `items`. if no item found, wait upto
+    // timeout for one. Returns number of items dequeued.
+    size_t dequeue_bulk_for(T *items, size_t max_items, std::chrono::milliseconds wait_duration) {
+        size_t n = q_.try_pop_bulk(items, max_items);
+        if (!n) {
+            not_empty_.wait_for(wait_duration, [&] {
+                return (n = q_.try_pop_bulk(items, max_items)) != 0;
+            });
+        }
+        if (n) {
+            // Several slots may have been freed.
+            not_full_.notify_all();
+        }
+        return n;
+    }
+
+    size_t overrun_counter() {
+        return overrun_counter_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    abel::mpmc_ring<T> q_;
+    std::atomic<size_t> overrun_counter_{0};
+    lockfree_q_waiter not_empty_;
+    lockfree_q_waiter not_full_;
+};
+} // namespace details
+}  // namespace abel
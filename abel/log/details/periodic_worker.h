@@ -20,7 +20,7 @@ namespace details {
 
 class ABEL_API periodic_worker {
   public:
-    periodic_worker(const std::function<void()> &callback_fun, std::chrono::seconds interval);
+    periodic_worker(const std::function<void()> &callback_fun, std::chrono::milliseconds interval);
 
     periodic_worker(const periodic_worker &) = delete;
 
@@ -8,8 +8,8 @@ namespace abel {
 namespace details {
 
 ABEL_FORCE_INLINE periodic_worker::periodic_worker(const std::function<void()> &callback_fun,
-                                                   std::chrono::seconds interval) {
-    active_ = (interval > std::chrono::seconds::zero());
+                                                   std::chrono::milliseconds interval) {
+    active_ = (interval > std::chrono::milliseconds::zero());
     if (!active_) {
         return;
     }
@@ -9,7 +9,7 @@
 #include <vector>
 #include <functional>
 #include "abel/log/details/log_msg_buffer.h"
-#include "abel/log/details/mpmc_blocking_q.h"
+#include "abel/log/details/mpmc_lockfree_q.h"
 #include "abel/log/details/os.h"
 
 
@@ -78,7 +78,10 @@ struct async_msg : log_msg_buffer {
 class ABEL_API thread_pool {
   public:
     using item_type = async_msg;
-    using q_type = details::mpmc_blocking_queue<item_type>;
+    using q_type = details::mpmc_lockfree_queue<item_type>;
+
+    // max number of messages a worker takes off the queue at once
+    static constexpr size_t batch_size = 64;
 
     thread_pool(size_t q_max_items, size_t threads_n, std::function<void()> on_thread_start);
 
@@ -107,10 +110,11 @@ class ABEL_API thread_pool {
 
     void worker_loop_();
 
-    // process next message in the queue
+    // process next batch of messages in the queue, flushing each logger at
+    // most once for the whole batch.
     // return true if this thread should still be active (while no terminate msg
     // was received)
-    bool process_next_msg_();
+    bool process_next_batch_(std::vector<async_msg> &batch);
 };
 
 } // namespace details
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include "abel/log/common.h"
 
@@ -66,39 +67,64 @@ void ABEL_FORCE_INLINE thread_pool::post_async_msg_(async_msg &&new_msg, async_o
 }
 
 void ABEL_FORCE_INLINE thread_pool::worker_loop_() {
-    while (process_next_msg_()) {}
+    std::vector<async_msg> batch(batch_size);
+    while (process_next_batch_(batch)) {}
 }
 
-// process next message in the queue
+// process next batch of messages in the queue
 // return true if this thread should still be active (while no terminate msg
 // was received)
-bool ABEL_FORCE_INLINE thread_pool::process_next_msg_() {
-    async_msg incoming_async_msg;
-    bool dequeued = q_.dequeue_for(incoming_async_msg, std::chrono::seconds(10));
-    if (!dequeued) {
-        return true;
-    }
-
-    switch (incoming_async_msg.msg_type) {
-        case async_msg_type::log: {
-            incoming_async_msg.worker_ptr->backend_sink_it_(incoming_async_msg);
-            return true;
-        }
-        case async_msg_type::flush: {
-            incoming_async_msg.worker_ptr->backend_flush_();
-            return true;
-        }
-
-        case async_msg_type::terminate: {
-            return false;
-        }
-
-        default: {
-            assert(false);
+bool ABEL_FORCE_INLINE thread_pool::process_next_batch_(std::vector<async_msg> &batch) {
+    size_t dequeued = q_.dequeue_bulk_for(batch.data(), batch.size(), std::chrono::seconds(10));
+
+    // loggers to flush once the batch is written. there are usually only a
+    // few of them, a linear search is fine.
+    std::vector<async_logger *> to_flush;
+    bool active = true;
+    for (size_t i = 0; i < dequeued; i++) {
+        auto &incoming_async_msg = batch[i];
+        auto worker = incoming_async_msg.worker_ptr.get();
+        switch (incoming_async_msg.msg_type) {
+            case async_msg_type::log: {
+                worker->backend_sink_it_(incoming_async_msg);
+                if (worker->should_flush_(incoming_async_msg) &&
+                    std::find(to_flush.begin(), to_flush.end(), worker) == to_flush.end()) {
+                    to_flush.push_back(worker);
+                }
+                break;
+            }
+            case async_msg_type::flush: {
+                // flush requests are synchronous to the caller's eyes in the
+                // order of the queue, so don't defer them.
+                worker->backend_flush_();
+                to_flush.erase(std::remove(to_flush.begin(), to_flush.end(), worker), to_flush.end());
+                break;
+            }
+
+            case async_msg_type::terminate: {
+                if (active) {
+                    active = false;
+                } else {
+                    // meant for another worker, hand it back.
+                    post_async_msg_(async_msg(async_msg_type::terminate), async_overflow_policy::block);
+                }
+                break;
+            }
+
+            default: {
+                assert(false);
+            }
         }
     }
 
-    return true;
+    for (auto worker : to_flush) {
+        worker->backend_flush_();
+    }
+    // don't keep the loggers alive until the slots are reused.
+    for (size_t i = 0; i < dequeued; i++) {
+        batch[i].worker_ptr.reset();
+    }
+    return active;
 }
 
 } // namespace details
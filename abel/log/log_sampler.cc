@@ -0,0 +1,34 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+
+#include "abel/log/details/log_sampler.h"
+#include "abel/metrics/scope.h"
+
+namespace abel {
+namespace details {
+
+log_sampler::log_sampler() : scope_(metrics::scope::new_root_scope("log", "_", {})) {}
+
+void log_sampler::suppressed(log_sampling_site &site, const std::string &logger_name) {
+    site.suppressed.fetch_add(1, std::memory_order_relaxed);
+    auto counter = site.counter.load(std::memory_order_acquire);
+    if (ABEL_UNLIKELY(counter == nullptr || counter->logger_name != logger_name)) {
+        counter = counter_of_(logger_name);
+        site.counter.store(counter, std::memory_order_release);
+    }
+    counter->counter->inc();
+}
+
+const log_suppression_counter *log_sampler::counter_of_(const std::string &logger_name) {
+    std::lock_guard<std::mutex> lock(counters_mutex_);
+    auto &counter = counters_[logger_name];
+    if (!counter) {
+        counter.reset(new log_suppression_counter{
+                logger_name, scope_->get_int_counter(metrics::metric_key("suppressed", {{"logger", logger_name}}))});
+    }
+    return counter.get();
+}
+
+} // namespace details
+}  // namespace abel
@@ -384,55 +384,46 @@ namespace abel {
             return *this;
         }
 
-        template<>
         log_stream &operator<<(const std::string_view &v) {
             write(v);
             return *this;
         }
 
-        template<>
         log_stream &operator<<(const int &v) {
             write(v);
             return *this;
         }
 
-        template<>
         log_stream &operator<<(const char &v) {
             write(v);
             return *this;
         }
 
-        template<>
         log_stream &operator<<(const short &v) {
             write(v);
             return *this;
         }
 
-        template<>
         log_stream &operator<<(const long &v) {
             write(v);
             return *this;
         }
 
-        template<>
         log_stream &operator<<(const long long &v) {
             write(v);
             return *this;
         }
 
-        template<>
         log_stream &operator<<(const float &v) {
             write(v);
             return *this;
         }
 
-        template<>
         log_stream &operator<<(const double &v) {
             write(v);
             return *this;
         }
 
-        template<>
         log_stream &operator<<(const bool &v) {
             v ? write("true") : write("false");
             return *this;
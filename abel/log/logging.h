@@ -9,6 +9,7 @@
 #include "abel/utility/every.h"
 #include "abel/chrono/clock.h"
 #include "abel/log/common.h"
+#include "abel/log/details/log_sampler.h"
 
 //Introduction
 //
@@ -28,18 +29,17 @@
 // LOG_LEVEL_OFF
 //
 
+namespace abel {
 struct every_second {
-    every_second() {
-
-    }
-
     bool feed() {
-        int64_t sec = abel::time_now().to_unix_seconds();
-        return sec > epoch_second ? epoch_second.compare_exchange_weak(sec, std::memory_order_relaxed) : false;
+        int64_t sec = details::coarse_now_ms() / 1000;
+        int64_t last = epoch_second.load(std::memory_order_relaxed);
+        return sec > last && epoch_second.compare_exchange_strong(last, sec, std::memory_order_relaxed);
     }
 
     std::atomic<int64_t> epoch_second{0};
 };
+}  // namespace abel
 
 #define LOG_CALL(logger, level, ...) (logger)->log(abel::source_loc{__FILE__, __LINE__, ABEL_PRETTY_FUNCTION}, level, __VA_ARGS__)
 #define LOG_CALL_IF(logger, level, condition, ...) !(condition) ? (void)0 : LOG_CALL(logger, level, __VA_ARGS__)
@@ -53,9 +53,15 @@ struct every_second {
     LOG_CALL_IF(logger, level, (condition)&ABEL_CONCAT(log_every_n, __LINE__).feed(), __VA_ARGS__)
 
 #define LOG_CALL_IF_EVERY_SECOND(logger, level, condition, ...) \
-    static abel::every_second ABEL_CONCAT(log_every_n, __LINE__)(N); \
+    static abel::every_second ABEL_CONCAT(log_every_n, __LINE__); \
     LOG_CALL_IF(logger, level, (condition)&ABEL_CONCAT(log_every_n, __LINE__).feed(), __VA_ARGS__)
 
+// at most `per_second` messages a second (`burst` at once), see details/log_sampler.h.
+#define LOG_CALL_IF_RATE_LIMITED(logger, level, condition, per_second, burst, ...) \
+    static abel::details::log_sampling_site ABEL_CONCAT(log_sampling_site, __LINE__)(per_second, burst); \
+    !(condition) ? (void)0 : abel::details::log_sampled(logger, ABEL_CONCAT(log_sampling_site, __LINE__), \
+        abel::source_loc{__FILE__, __LINE__, ABEL_PRETTY_FUNCTION}, level, __VA_ARGS__)
+
 
 #if LOG_ACTIVE_LEVEL <= LOG_LEVEL_TRACE
 #define LOG_TRACE(logger, ...) LOG_CALL(logger, abel::level::trace, __VA_ARGS__)
@@ -66,6 +72,8 @@ struct every_second {
 #define LOG_TRACE_FIRST_N_IF(logger, condition, N, ...) LOG_CALL_IF_FIRST_N(logger, abel::level::trace, true, __VA_ARGS__)
 #define LOG_TRACE_EVERY_SECOND(logger, ...) LOG_CALL_IF_EVERY_SECOND(logger, abel::level::trace, true, __VA_ARGS__)
 #define LOG_TRACE_EVERY_SECOND_IF(logger, condition, ...) LOG_CALL_IF_EVERY_SECOND(logger, abel::level::trace, condition, __VA_ARGS__)
+#define LOG_TRACE_RATE_LIMITED(logger, per_second, burst, ...) LOG_CALL_IF_RATE_LIMITED(logger, abel::level::trace, true, per_second, burst, __VA_ARGS__)
+#define LOG_TRACE_RATE_LIMITED_IF(logger, condition, per_second, burst, ...) LOG_CALL_IF_RATE_LIMITED(logger, abel::level::trace, condition, per_second, burst, __VA_ARGS__)
 // default log
 #define DLOG_TRACE(...) LOG_TRACE(abel::default_logger_raw(), __VA_ARGS__)
 #define DLOG_TRACE_IF(condition, ...) LOG_TRACE_IF(abel::default_logger_raw(), condition, __VA_ARGS__)
@@ -75,6 +83,8 @@ struct every_second {
 #define DLOG_TRACE_FIRST_N_IF(condition, N, ...) LOG_TRACE_FIRST_N_IF(abel::default_logger_raw(), condition, N, __VA_ARGS__)
 #define DLOG_TRACE_EVERY_SECOND(...) LOG_TRACE_EVERY_SECOND(abel::default_logger_raw(), __VA_ARGS__)
 #define DLOG_TRACE_EVERY_SECOND_IF(condition, ...) LOG_TRACE_EVERY_SECOND_IF(abel::default_logger_raw(),condition, __VA_ARGS__)
+#define DLOG_TRACE_RATE_LIMITED(per_second, burst, ...) LOG_TRACE_RATE_LIMITED(abel::default_logger_raw(), per_second, burst, __VA_ARGS__)
+#define DLOG_TRACE_RATE_LIMITED_IF(condition, per_second, burst, ...) LOG_TRACE_RATE_LIMITED_IF(abel::default_logger_raw(), condition, per_second, burst, __VA_ARGS__)
 
 #else
 #define LOG_TRACE(logger, ...) (void)0
@@ -85,6 +95,8 @@ struct every_second {
 #define LOG_TRACE_FIRST_N_IF(logger, condition, N, ...) (void)0
 #define LOG_TRACE_EVERY_SECOND(logger, ...) (void)0
 #define LOG_TRACE_EVERY_SECOND_IF(logger, condition, ...) (void)0
+#define LOG_TRACE_RATE_LIMITED(logger, per_second, burst, ...) (void)0
+#define LOG_TRACE_RATE_LIMITED_IF(logger, condition, per_second, burst, ...) (void)0
 // default log
 #define DLOG_TRACE(...) (void)0
 #define DLOG_TRACE_IF(condition, ...) (void)0
@@ -94,6 +106,8 @@ struct every_second {
 #define DLOG_TRACE_FIRST_N_IF(condition, N, ...) (void)0
 #define DLOG_TRACE_EVERY_SECOND(...) (void)0
 #define DLOG_TRACE_EVERY_SECOND_IF(condition, ...) (void)0
+#define DLOG_TRACE_RATE_LIMITED(per_second, burst, ...) (void)0
+#define DLOG_TRACE_RATE_LIMITED_IF(condition, per_second, burst, ...) (void)0
 
 
 #endif
@@ -107,6 +121,8 @@ struct every_second {
 #define LOG_DEBUG_FIRST_N_IF(logger, condition, N, ...) LOG_CALL_IF_FIRST_N(logger, abel::level::debug, true, __VA_ARGS__)
 #define LOG_DEBUG_EVERY_SECOND(logger, ...) LOG_CALL_IF_EVERY_SECOND(logger, abel::level::debug, true, __VA_ARGS__)
 #define LOG_DEBUG_EVERY_SECOND_IF(logger, condition, ...) LOG_CALL_IF_EVERY_SECOND(logger, abel::level::debug, condition, __VA_ARGS__)
+#define LOG_DEBUG_RATE_LIMITED(logger, per_second, burst, ...) LOG_CALL_IF_RATE_LIMITED(logger, abel::level::debug, true, per_second, burst, __VA_ARGS__)
+#define LOG_DEBUG_RATE_LIMITED_IF(logger, condition, per_second, burst, ...) LOG_CALL_IF_RATE_LIMITED(logger, abel::level::debug, condition, per_second, burst, __VA_ARGS__)
 // default log
 #define DLOG_DEBUG(...) LOG_DEBUG(abel::default_logger_raw(), __VA_ARGS__)
 #define DLOG_DEBUG_IF(condition, ...) LOG_DEBUG_IF(abel::default_logger_raw(), condition, __VA_ARGS__)
@@ -116,6 +132,8 @@ struct every_second {
 #define DLOG_DEBUG_FIRST_N_IF(condition, N, ...) LOG_DEBUG_FIRST_N_IF(abel::default_logger_raw(), condition, N, __VA_ARGS__)
 #define DLOG_DEBUG_EVERY_SECOND(...) LOG_DEBUG_EVERY_SECOND(abel::default_logger_raw(), __VA_ARGS__)
 #define DLOG_DEBUG_EVERY_SECOND_IF(condition, ...) LOG_DEBUG_EVERY_SECOND_IF(abel::default_logger_raw(),condition, __VA_ARGS__)
+#define DLOG_DEBUG_RATE_LIMITED(per_second, burst, ...) LOG_DEBUG_RATE_LIMITED(abel::default_logger_raw(), per_second, burst, __VA_ARGS__)
+#define DLOG_DEBUG_RATE_LIMITED_IF(condition, per_second, burst, ...) LOG_DEBUG_RATE_LIMITED_IF(abel::default_logger_raw(), condition, per_second, burst, __VA_ARGS__)
 
 #else
 #define LOG_DEBUG(logger, ...) (void)0
@@ -126,6 +144,8 @@ struct every_second {
 #define LOG_DEBUG_FIRST_N_IF(logger, condition, N, ...) (void)0
 #define LOG_DEBUG_EVERY_SECOND(logger, ...) (void)0
 #define LOG_DEBUG_EVERY_SECOND_IF(logger, condition, ...) (void)0
+#define LOG_DEBUG_RATE_LIMITED(logger, per_second, burst, ...) (void)0
+#define LOG_DEBUG_RATE_LIMITED_IF(logger, condition, per_second, burst, ...) (void)0
 // default log
 #define DLOG_DEBUG(...) (void)0
 #define DLOG_DEBUG_IF(condition, ...) (void)0
@@ -135,6 +155,8 @@ struct every_second {
 #define DLOG_DEBUG_FIRST_N_IF(condition, N, ...) (void)0
 #define DLOG_DEBUG_EVERY_SECOND(...) (void)0
 #define DLOG_DEBUG_EVERY_SECOND_IF(condition, ...) (void)0
+#define DLOG_DEBUG_RATE_LIMITED(per_second, burst, ...) (void)0
+#define DLOG_DEBUG_RATE_LIMITED_IF(condition, per_second, burst, ...) (void)0
 
 
 #endif
@@ -148,6 +170,8 @@ struct every_second {
 #define LOG_INFO_FIRST_N_IF(logger, condition, N, ...) LOG_CALL_IF_FIRST_N(logger, abel::level::info, true, __VA_ARGS__)
 #define LOG_INFO_EVERY_SECOND(logger, ...) LOG_CALL_IF_EVERY_SECOND(logger, abel::level::info, true, __VA_ARGS__)
 #define LOG_INO_EVERY_SECOND_IF(logger, condition, ...) LOG_CALL_IF_EVERY_SECOND(logger, abel::level::info, condition, __VA_ARGS__)
+#define LOG_INFO_RATE_LIMITED(logger, per_second, burst, ...) LOG_CALL_IF_RATE_LIMITED(logger, abel::level::info, true, per_second, burst, __VA_ARGS__)
+#define LOG_INFO_RATE_LIMITED_IF(logger, condition, per_second, burst, ...) LOG_CALL_IF_RATE_LIMITED(logger, abel::level::info, condition, per_second, burst, __VA_ARGS__)
 // default log
 #define DLOG_INFO(...) LOG_INFO(abel::default_logger_raw(), __VA_ARGS__)
 #define DLOG_INFO_IF(condition, ...) LOG_INFO_IF(abel::default_logger_raw(), condition, __VA_ARGS__)
@@ -157,6 +181,8 @@ struct every_second {
 #define DLOG_INFO_FIRST_N_IF(condition, N, ...) LOG_INFO_FIRST_N_IF(abel::default_logger_raw(), condition, N, __VA_ARGS__)
 #define DLOG_INFO_EVERY_SECOND(...) LOG_INFO_EVERY_SECOND(abel::default_logger_raw(), __VA_ARGS__)
 #define DLOG_INO_EVERY_SECOND_IF(condition, ...) LOG_INO_EVERY_SECOND_IF(abel::default_logger_raw(),condition, __VA_ARGS__)
+#define DLOG_INFO_RATE_LIMITED(per_second, burst, ...) LOG_INFO_RATE_LIMITED(abel::default_logger_raw(), per_second, burst, __VA_ARGS__)
+#define DLOG_INFO_RATE_LIMITED_IF(condition, per_second, burst, ...) LOG_INFO_RATE_LIMITED_IF(abel::default_logger_raw(), condition, per_second, burst, __VA_ARGS__)
 
 #else
 #define LOG_INFO(logger, ...) (void)0
@@ -167,6 +193,8 @@ struct every_second {
 #define LOG_INFO_FIRST_N_IF(logger, condition, N, ...) (void)0
 #define LOG_INFO_EVERY_SECOND(logger, ...) (void)0
 #define LOG_INO_EVERY_SECOND_IF(logger, condition, ...) (void)0
+#define LOG_INFO_RATE_LIMITED(logger, per_second, burst, ...) (void)0
+#define LOG_INFO_RATE_LIMITED_IF(logger, condition, per_second, burst, ...) (void)0
 // default log
 #define DLOG_INFO(...) (void)0
 #define DLOG_INFO_IF(condition, ...) (void)0
@@ -176,6 +204,8 @@ struct every_second {
 #define DLOG_INFO_FIRST_N_IF(condition, N, ...) (void)0
 #define DLOG_INFO_EVERY_SECOND(...) (void)0
 #define DLOG_INO_EVERY_SECOND_IF(condition, ...) (void)0
+#define DLOG_INFO_RATE_LIMITED(per_second, burst, ...) (void)0
+#define DLOG_INFO_RATE_LIMITED_IF(condition, per_second, burst, ...) (void)0
 #endif
 
 #if LOG_ACTIVE_LEVEL <= LOG_LEVEL_WARN
@@ -187,6 +217,8 @@ struct every_second {
 #define LOG_WARN_FIRST_N_IF(logger, condition, N, ...) LOG_CALL_IF_FIRST_N(logger, abel::level::warn, true, __VA_ARGS__)
 #define LOG_WARN_EVERY_SECOND(logger, ...) LOG_CALL_IF_EVERY_SECOND(logger, abel::level::warn, true, __VA_ARGS__)
 #define LOG_WARN_EVERY_SECOND_IF(logger, condition, ...) LOG_CALL_IF_EVERY_SECOND(logger, abel::level::warn, condition, __VA_ARGS__)
+#define LOG_WARN_RATE_LIMITED(logger, per_second, burst, ...) LOG_CALL_IF_RATE_LIMITED(logger, abel::level::warn, true, per_second, burst, __VA_ARGS__)
+#define LOG_WARN_RATE_LIMITED_IF(logger, condition, per_second, burst, ...) LOG_CALL_IF_RATE_LIMITED(logger, abel::level::warn, condition, per_second, burst, __VA_ARGS__)
 // default log
 #define DLOG_WARN(...) LOG_WARN(abel::default_logger_raw(), __VA_ARGS__)
 #define DLOG_WARN_IF(condition, ...) LOG_WARN_IF(abel::default_logger_raw(), condition, __VA_ARGS__)
@@ -196,6 +228,8 @@ struct every_second {
 #define DLOG_WARN_FIRST_N_IF(condition, N, ...) LOG_WARN_FIRST_N_IF(abel::default_logger_raw(), condition, N, __VA_ARGS__)
 #define DLOG_WARN_EVERY_SECOND(...) LOG_WARN_EVERY_SECOND(abel::default_logger_raw(), __VA_ARGS__)
 #define DLOG_WARN_EVERY_SECOND_IF(condition, ...) LOG_WARN_EVERY_SECOND_IF(abel::default_logger_raw(),condition, __VA_ARGS__)
+#define DLOG_WARN_RATE_LIMITED(per_second, burst, ...) LOG_WARN_RATE_LIMITED(abel::default_logger_raw(), per_second, burst, __VA_ARGS__)
+#define DLOG_WARN_RATE_LIMITED_IF(condition, per_second, burst, ...) LOG_WARN_RATE_LIMITED_IF(abel::default_logger_raw(), condition, per_second, burst, __VA_ARGS__)
 
 #else
 #define LOG_WARN(logger, ...) (void)0
@@ -206,6 +240,8 @@ struct every_second {
 #define LOG_WARN_FIRST_N_IF(logger, condition, N, ...) (void)0
 #define LOG_WARN_EVERY_SECOND(logger, ...) (void)0
 #define LOG_WARN_EVERY_SECOND_IF(logger, condition, ...) (void)0
+#define LOG_WARN_RATE_LIMITED(logger, per_second, burst, ...) (void)0
+#define LOG_WARN_RATE_LIMITED_IF(logger, condition, per_second, burst, ...) (void)0
 // default log
 #define DLOG_WARN(...) (void)0
 #define DLOG_WARN_IF(condition, ...) (void)0
@@ -215,6 +251,8 @@ struct every_second {
 #define DLOG_WARN_FIRST_N_IF(condition, N, ...) (void)0
 #define DLOG_WARN_EVERY_SECOND(...) (void)0
 #define DLOG_WARN_EVERY_SECOND_IF(condition, ...) (void)0
+#define DLOG_WARN_RATE_LIMITED(per_second, burst, ...) (void)0
+#define DLOG_WARN_RATE_LIMITED_IF(condition, per_second, burst, ...) (void)0
 #endif
 
 #if LOG_ACTIVE_LEVEL <= LOG_LEVEL_ERROR
@@ -227,6 +265,8 @@ struct every_second {
 #define LOG_ERROR_FIRST_N_IF(logger, condition, N, ...) LOG_CALL_IF_FIRST_N(logger, abel::level::err, true, __VA_ARGS__)
 #define LOG_ERROR_EVERY_SECOND(logger, ...) LOG_CALL_IF_EVERY_SECOND(logger, abel::level::err, true, __VA_ARGS__)
 #define LOG_ERROR_EVERY_SECOND_IF(logger, condition, ...) LOG_CALL_IF_EVERY_SECOND(logger, abel::level::err, condition, __VA_ARGS__)
+#define LOG_ERROR_RATE_LIMITED(logger, per_second, burst, ...) LOG_CALL_IF_RATE_LIMITED(logger, abel::level::err, true, per_second, burst, __VA_ARGS__)
+#define LOG_ERROR_RATE_LIMITED_IF(logger, condition, per_second, burst, ...) LOG_CALL_IF_RATE_LIMITED(logger, abel::level::err, condition, per_second, burst, __VA_ARGS__)
 // default log
 #define DLOG_ERROR(...) LOG_ERROR(abel::default_logger_raw(), __VA_ARGS__)
 #define DLOG_ERROR_IF(condition, ...) LOG_ERROR_IF(abel::default_logger_raw(), condition, __VA_ARGS__)
@@ -236,6 +276,8 @@ struct every_second {
 #define DLOG_ERROR_FIRST_N_IF(condition, N, ...) LOG_ERROR_FIRST_N_IF(abel::default_logger_raw(), condition, N, __VA_ARGS__)
 #define DLOG_ERROR_EVERY_SECOND(...) LOG_ERROR_EVERY_SECOND(abel::default_logger_raw(), __VA_ARGS__)
 #define DLOG_ERROR_EVERY_SECOND_IF(condition, ...) LOG_ERROR_EVERY_SECOND_IF(abel::default_logger_raw(),condition, __VA_ARGS__)
+#define DLOG_ERROR_RATE_LIMITED(per_second, burst, ...) LOG_ERROR_RATE_LIMITED(abel::default_logger_raw(), per_second, burst, __VA_ARGS__)
+#define DLOG_ERROR_RATE_LIMITED_IF(condition, per_second, burst, ...) LOG_ERROR_RATE_LIMITED_IF(abel::default_logger_raw(), condition, per_second, burst, __VA_ARGS__)
 
 #else
 #define LOG_ERROR(logger, ...) (void)0
@@ -246,6 +288,8 @@ struct every_second {
 #define LOG_ERROR_FIRST_N_IF(logger, condition, N, ...) (void)0
 #define LOG_ERROR_EVERY_SECOND(logger, ...) (void)0
 #define LOG_ERROR_EVERY_SECOND_IF(logger, condition, ...) (void)0
+#define LOG_ERROR_RATE_LIMITED(logger, per_second, burst, ...) (void)0
+#define LOG_ERROR_RATE_LIMITED_IF(logger, condition, per_second, burst, ...) (void)0
 // default log
 #define DLOG_ERROR(...) (void)0
 #define DLOG_ERROR_IF(condition, ...) (void)0
@@ -255,6 +299,8 @@ struct every_second {
 #define DLOG_ERROR_FIRST_N_IF(condition, N, ...) (void)0
 #define DLOG_ERROR_EVERY_SECOND(...) (void)0
 #define DLOG_ERROR_EVERY_SECOND_IF(condition, ...) (void)0
+#define DLOG_ERROR_RATE_LIMITED(per_second, burst, ...) (void)0
+#define DLOG_ERROR_RATE_LIMITED_IF(condition, per_second, burst, ...) (void)0
 
 #endif
 
@@ -267,6 +313,8 @@ struct every_second {
 #define LOG_CRITICAL_FIRST_N_IF(logger, condition, N, ...) LOG_CALL_IF_FIRST_N(logger, abel::level::critical, true, __VA_ARGS__)
 #define LOG_CRITICAL_EVERY_SECOND(logger, ...) LOG_CALL_IF_EVERY_SECOND(logger, abel::level::critical, true, __VA_ARGS__)
 #define LOG_CRITICAL_EVERY_SECOND_IF(logger, condition, ...) LOG_CALL_IF_EVERY_SECOND(logger, abel::level::critical, condition, __VA_ARGS__)
+#define LOG_CRITICAL_RATE_LIMITED(logger, per_second, burst, ...) LOG_CALL_IF_RATE_LIMITED(logger, abel::level::critical, true, per_second, burst, __VA_ARGS__)
+#define LOG_CRITICAL_RATE_LIMITED_IF(logger, condition, per_second, burst, ...) LOG_CALL_IF_RATE_LIMITED(logger, abel::level::critical, condition, per_second, burst, __VA_ARGS__)
 // default log
 #define DLOG_CRITICAL(...) LOG_CRITICAL(abel::default_logger_raw(), __VA_ARGS__)
 #define DLOG_CRITICAL_IF(condition, ...) LOG_CRITICAL_IF(abel::default_logger_raw(), condition, __VA_ARGS__)
@@ -276,6 +324,8 @@ struct every_second {
 #define DLOG_CRITICAL_FIRST_N_IF(condition, N, ...) LOG_CRITICAL_FIRST_N_IF(abel::default_logger_raw(), condition, N, __VA_ARGS__)
 #define DLOG_CRITICAL_EVERY_SECOND(...) LOG_CRITICAL_EVERY_SECOND(abel::default_logger_raw(), __VA_ARGS__)
 #define DLOG_CRITICAL_EVERY_SECOND_IF(condition, ...) LOG_CRITICAL_EVERY_SECOND_IF(abel::default_logger_raw(),condition, __VA_ARGS__)
+#define DLOG_CRITICAL_RATE_LIMITED(per_second, burst, ...) LOG_CRITICAL_RATE_LIMITED(abel::default_logger_raw(), per_second, burst, __VA_ARGS__)
+#define DLOG_CRITICAL_RATE_LIMITED_IF(condition, per_second, burst, ...) LOG_CRITICAL_RATE_LIMITED_IF(abel::default_logger_raw(), condition, per_second, burst, __VA_ARGS__)
 
 #else
 #define LOG_CRITICAL(logger, ...) (void)0
@@ -286,6 +336,8 @@ struct every_second {
 #define LOG_CRITICAL_FIRST_N_IF(logger, condition, N, ...) (void)0
 #define LOG_CRITICAL_EVERY_SECOND(logger, ...) (void)0
 #define LOG_CRITICAL_EVERY_SECOND_IF(logger, condition, ...) (void)0
+#define LOG_CRITICAL_RATE_LIMITED(logger, per_second, burst, ...) (void)0
+#define LOG_CRITICAL_RATE_LIMITED_IF(logger, condition, per_second, burst, ...) (void)0
 // default log
 #define DLOG_CRITICAL(...) (void)0
 #define DLOG_CRITICAL_IF(condition, ...) (void)0
@@ -295,6 +347,8 @@ struct every_second {
 #define DLOG_CRITICAL_FIRST_N_IF(condition, N, ...) (void)0
 #define DLOG_CRITICAL_EVERY_SECOND(...) (void)0
 #define DLOG_CRITICAL_EVERY_SECOND_IF(condition, ...) (void)0
+#define DLOG_CRITICAL_RATE_LIMITED(per_second, burst, ...) (void)0
+#define DLOG_CRITICAL_RATE_LIMITED_IF(condition, per_second, burst, ...) (void)0
 
 #endif
 
@@ -19,6 +19,8 @@
 namespace abel {
 namespace details {
 
+enum class flag_dependence;
+
 // padding information.
 struct padding_info {
     enum pad_side {
@@ -116,6 +118,10 @@ class ABEL_API pattern_formatter final : public log_formatter {
     static details::padding_info handle_padspec_(std::string::const_iterator &it, std::string::const_iterator end);
 
     void compile_pattern_(const std::string &pattern);
+
+    // merge consecutive formatters that depend on the time only into cached
+    // runs. `dependences` tells what each of `formatters_` depends on.
+    void cache_time_runs_(const std::vector<details::flag_dependence> &dependences);
 };
 }  // namespace abel
 
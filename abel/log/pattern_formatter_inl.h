@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <ctime>
@@ -837,6 +838,95 @@ class full_formatter final : public flag_formatter {
     memory_buf_t cached_datetime_;
 };
 
+// what a flag's output depends on, from the least to the most volatile.
+enum class flag_dependence {
+    none,     // constant text
+    seconds,  // calendar time, up to the second
+    millis,
+    micros,
+    message   // anything else
+};
+
+ABEL_FORCE_INLINE flag_dependence flag_dependence_of(char flag) {
+    switch (flag) {
+        case 'a':
+        case 'A':
+        case 'b':
+        case 'h':
+        case 'B':
+        case 'c':
+        case 'C':
+        case 'Y':
+        case 'D':
+        case 'x':
+        case 'm':
+        case 'd':
+        case 'H':
+        case 'I':
+        case 'M':
+        case 'S':
+        case 'E':
+        case 'p':
+        case 'r':
+        case 'R':
+        case 'T':
+        case 'X':
+        case 'z':
+            return flag_dependence::seconds;
+        case 'e':
+            return flag_dependence::millis;
+        case 'f':
+            return flag_dependence::micros;
+        case '%':
+            return flag_dependence::none;
+        default:
+            // unknown flags are printed as is, but can't tell them from the
+            // others here.
+            return flag_dependence::message;
+    }
+}
+
+// consecutive flags depending on the time only (and constant text in
+// between), rendered once per tick (second, millisecond or microsecond,
+// whichever the finest flag needs) and copied as is for the following messages
+// of the same tick.
+class time_run_formatter final : public flag_formatter {
+  public:
+    time_run_formatter(std::vector<std::unique_ptr<flag_formatter>> formatters, flag_dependence resolution)
+            : formatters_(std::move(formatters)), resolution_(resolution) {}
+
+    void format(const details::log_msg &msg, const std::tm &tm_time, memory_buf_t &dest) override {
+        auto tick = tick_of_(msg.time);
+        if (tick != cached_tick_ || cached_.size() == 0) {
+            cached_.clear();
+            for (auto &f : formatters_) {
+                f->format(msg, tm_time, cached_);
+            }
+            cached_tick_ = tick;
+        }
+        dest.append(cached_.data(), cached_.data() + cached_.size());
+    }
+
+  private:
+    int64_t tick_of_(log_clock::time_point tp) const {
+        using namespace std::chrono;
+        auto duration = tp.time_since_epoch();
+        switch (resolution_) {
+            case flag_dependence::micros:
+                return duration_cast<microseconds>(duration).count();
+            case flag_dependence::millis:
+                return duration_cast<milliseconds>(duration).count();
+            default:
+                return duration_cast<seconds>(duration).count();
+        }
+    }
+
+    std::vector<std::unique_ptr<flag_formatter>> formatters_;
+    const flag_dependence resolution_;
+    int64_t cached_tick_{0};
+    memory_buf_t cached_;
+};
+
 } // namespace details
 
 ABEL_FORCE_INLINE pattern_formatter::pattern_formatter(
@@ -1138,12 +1228,14 @@ pattern_formatter::handle_padspec_(std::string::const_iterator &it, std::string:
 ABEL_FORCE_INLINE void pattern_formatter::compile_pattern_(const std::string &pattern) {
     auto end = pattern.end();
     std::unique_ptr<details::aggregate_formatter> user_chars;
+    std::vector<details::flag_dependence> dependences;
     formatters_.clear();
     for (auto it = pattern.begin(); it != end; ++it) {
         if (*it == '%') {
             if (user_chars) // append user chars found so far
             {
                 formatters_.push_back(std::move(user_chars));
+                dependences.push_back(details::flag_dependence::none);
             }
 
             auto padding = handle_padspec_(++it, end);
@@ -1154,6 +1246,8 @@ ABEL_FORCE_INLINE void pattern_formatter::compile_pattern_(const std::string &pa
                 } else {
                     handle_flag_<details::null_scoped_padder>(*it, padding);
                 }
+                dependences.push_back(custom_handlers_.count(*it) ? details::flag_dependence::message
+                                                                  : details::flag_dependence_of(*it));
             } else {
                 break;
             }
@@ -1168,6 +1262,39 @@ ABEL_FORCE_INLINE void pattern_formatter::compile_pattern_(const std::string &pa
     if (user_chars) // append raw chars found so far
     {
         formatters_.push_back(std::move(user_chars));
+        dependences.push_back(details::flag_dependence::none);
+    }
+    cache_time_runs_(dependences);
+}
+
+ABEL_FORCE_INLINE void pattern_formatter::cache_time_runs_(const std::vector<details::flag_dependence> &dependences) {
+    using details::flag_dependence;
+    std::vector<std::unique_ptr<details::flag_formatter>> compiled;
+    size_t i = 0;
+    while (i != formatters_.size()) {
+        if (dependences[i] == flag_dependence::message) {
+            compiled.push_back(std::move(formatters_[i++]));
+            continue;
+        }
+        // a run of formatters not depending on the message.
+        auto resolution = flag_dependence::none;
+        auto run_end = i;
+        for (; run_end != formatters_.size() && dependences[run_end] != flag_dependence::message; ++run_end) {
+            resolution = std::max(resolution, dependences[run_end]);
+        }
+        if (resolution == flag_dependence::none || run_end - i == 1) {
+            // nothing to gain.
+            for (; i != run_end; ++i) {
+                compiled.push_back(std::move(formatters_[i]));
+            }
+            continue;
+        }
+        std::vector<std::unique_ptr<details::flag_formatter>> run;
+        for (; i != run_end; ++i) {
+            run.push_back(std::move(formatters_[i]));
+        }
+        compiled.push_back(abel::make_unique<details::time_run_formatter>(std::move(run), resolution));
     }
+    formatters_ = std::move(compiled);
 }
 }  // namespace abel
@@ -0,0 +1,97 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include "abel/log/details/fd_file_writer.h"
+#include "abel/log/details/null_mutex.h"
+#include "abel/log/details/periodic_worker.h"
+#include "abel/log/sinks/base_sink.h"
+#include "abel/log/details/synchronous_factory.h"
+
+
+namespace abel {
+namespace sinks {
+
+//
+// File sink writing to a raw fd through a large user space buffer, for heavy
+// logging: messages are written in batches (one writev) when the buffer fills,
+// on flush, or every `flush_interval`. Durability is controlled by
+// `sync_policy`.
+//
+// Rotates files the way rotating_file_sink does if `max_size` is not 0.
+//
+// fd_file_sink_st ignores `flush_interval`, as the periodic flush would race
+// with the logging thread: messages are only written when the buffer fills or
+// on flush.
+//
+// Note that buffered messages are lost if the process crashes, use a short
+// `flush_interval` (or flush_on()) for messages that must not be lost.
+//
+template<typename Mutex>
+class fd_file_sink final : public base_sink<Mutex> {
+  public:
+    explicit fd_file_sink(const filename_t &filename, bool truncate = false,
+                          const fd_file_options &options = fd_file_options(), std::size_t max_size = 0,
+                          std::size_t max_files = 0);
+
+    ~fd_file_sink() override;
+
+    filename_t filename();
+
+    // write buffered messages and fdatasync the file, regardless of the policy.
+    void sync();
+
+  protected:
+    void sink_it_(const details::log_msg &msg) override;
+
+    void flush_() override;
+
+  private:
+    // Rotate files:
+    // log.txt -> log.1.txt
+    // log.1.txt -> log.2.txt
+    // log.2.txt -> log.3.txt
+    // log.3.txt -> delete
+    void rotate_();
+
+    filename_t base_filename_;
+    std::size_t max_size_;
+    std::size_t max_files_;
+    details::fd_file_writer writer_;
+    // declared last, so that it's stopped before anything else is destroyed.
+    std::unique_ptr<details::periodic_worker> flusher_;
+};
+
+using fd_file_sink_mt = fd_file_sink<std::mutex>;
+using fd_file_sink_st = fd_file_sink<details::null_mutex>;
+
+} // namespace sinks
+
+//
+// factory functions
+//
+template<typename Factory = abel::synchronous_factory>
+inline std::shared_ptr<logger>
+fd_file_logger_mt(const std::string &logger_name, const filename_t &filename, bool truncate = false,
+                  const fd_file_options &options = fd_file_options(), std::size_t max_size = 0,
+                  std::size_t max_files = 0) {
+    return Factory::template create<sinks::fd_file_sink_mt>(logger_name, filename, truncate, options, max_size,
+                                                            max_files);
+}
+
+template<typename Factory = abel::synchronous_factory>
+inline std::shared_ptr<logger>
+fd_file_logger_st(const std::string &logger_name, const filename_t &filename, bool truncate = false,
+                  const fd_file_options &options = fd_file_options(), std::size_t max_size = 0,
+                  std::size_t max_files = 0) {
+    return Factory::template create<sinks::fd_file_sink_st>(logger_name, filename, truncate, options, max_size,
+                                                            max_files);
+}
+
+}  // namespace abel
+
+#include "abel/log/sinks/fd_file_sink_inl.h"
@@ -0,0 +1,95 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cerrno>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include "abel/log/common.h"
+#include "abel/log/details/os.h"
+#include "abel/log/sinks/rotating_file_sink.h"
+
+
+namespace abel {
+namespace sinks {
+
+template<typename Mutex>
+ABEL_FORCE_INLINE fd_file_sink<Mutex>::fd_file_sink(const filename_t &filename, bool truncate,
+                                                     const fd_file_options &options, std::size_t max_size,
+                                                     std::size_t max_files)
+        : base_filename_(filename), max_size_(max_size), max_files_(max_files), writer_(options) {
+    writer_.open(filename, truncate);
+    // the flusher would run concurrently with the logging thread, which
+    // null_mutex doesn't guard against.
+    if (options.flush_interval.count() > 0 && !std::is_same<Mutex, details::null_mutex>::value) {
+        flusher_ = abel::make_unique<details::periodic_worker>([this] {
+            std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+            ABEL_TRY {
+                writer_.flush();
+            }
+            ABEL_CATCH_ALL() {}
+        }, options.flush_interval);
+    }
+}
+
+template<typename Mutex>
+ABEL_FORCE_INLINE fd_file_sink<Mutex>::~fd_file_sink() {
+    flusher_.reset();
+}
+
+template<typename Mutex>
+ABEL_FORCE_INLINE filename_t fd_file_sink<Mutex>::filename() {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    return writer_.filename();
+}
+
+template<typename Mutex>
+ABEL_FORCE_INLINE void fd_file_sink<Mutex>::sync() {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    writer_.sync();
+}
+
+template<typename Mutex>
+ABEL_FORCE_INLINE void fd_file_sink<Mutex>::sink_it_(const details::log_msg &msg) {
+    memory_buf_t formatted;
+    base_sink<Mutex>::formatter_->format(msg, formatted);
+    if (max_size_ && writer_.size() + formatted.size() > max_size_) {
+        rotate_();
+    }
+    writer_.write(formatted);
+}
+
+template<typename Mutex>
+ABEL_FORCE_INLINE void fd_file_sink<Mutex>::flush_() {
+    writer_.flush();
+}
+
+template<typename Mutex>
+ABEL_FORCE_INLINE void fd_file_sink<Mutex>::rotate_() {
+    using details::os::filename_to_str;
+    using details::os::path_exists;
+    using name_calculator = rotating_file_sink<details::null_mutex>;
+    // writes out what's buffered, the new file starts empty.
+    writer_.close();
+    for (auto i = max_files_; i > 0; --i) {
+        filename_t src = name_calculator::calc_filename(base_filename_, i - 1);
+        if (!path_exists(src)) {
+            continue;
+        }
+        filename_t target = name_calculator::calc_filename(base_filename_, i);
+        (void) details::os::remove(target);
+        if (details::os::rename(src, target) != 0) {
+            // truncate the log file anyway to prevent it to grow beyond its limit!
+            writer_.reopen(true);
+            throw_log_ex("fd_file_sink: failed renaming " + filename_to_str(src) + " to " +
+                         filename_to_str(target), errno);
+        }
+    }
+    // preallocates the new file.
+    writer_.reopen(true);
+}
+
+} // namespace sinks
+}  // namespace abel
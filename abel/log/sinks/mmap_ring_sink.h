@@ -0,0 +1,68 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include "abel/log/details/mmap_ring.h"
+#include "abel/log/details/null_mutex.h"
+#include "abel/log/sinks/base_sink.h"
+#include "abel/log/details/synchronous_factory.h"
+
+
+namespace abel {
+namespace sinks {
+/*
+ * Crash surviving sink: keeps the last `capacity` bytes of formatted messages
+ * in a file backed ring (see details/mmap_ring.h). Messages are copied to a
+ * shared mapping of the file, so they make it to the file even if the process
+ * crashes right after, and logging costs no syscall.
+ *
+ * Decode the file with details::mmap_ring::read() (or tools/log_ring_dump).
+ * Messages logged by an earlier run are kept if the capacity didn't change.
+ */
+template<typename Mutex>
+class mmap_ring_sink final : public base_sink<Mutex> {
+  public:
+    mmap_ring_sink(const filename_t &filename, size_t capacity);
+
+    const filename_t &filename() const;
+
+    // write the ring to disk, so that messages survive the machine crashing
+    // too.
+    void sync();
+
+  protected:
+    void sink_it_(const details::log_msg &msg) override;
+
+    // nothing to flush, messages are in the page cache already.
+    void flush_() override;
+
+  private:
+    details::mmap_ring ring_;
+};
+
+using mmap_ring_sink_mt = mmap_ring_sink<std::mutex>;
+using mmap_ring_sink_st = mmap_ring_sink<details::null_mutex>;
+
+} // namespace sinks
+
+//
+// factory functions
+//
+template<typename Factory = abel::synchronous_factory>
+inline std::shared_ptr<logger>
+mmap_ring_logger_mt(const std::string &logger_name, const filename_t &filename, size_t capacity) {
+    return Factory::template create<sinks::mmap_ring_sink_mt>(logger_name, filename, capacity);
+}
+
+template<typename Factory = abel::synchronous_factory>
+inline std::shared_ptr<logger>
+mmap_ring_logger_st(const std::string &logger_name, const filename_t &filename, size_t capacity) {
+    return Factory::template create<sinks::mmap_ring_sink_st>(logger_name, filename, capacity);
+}
+
+}  // namespace abel
+
+#include "abel/log/sinks/mmap_ring_sink_inl.h"
@@ -0,0 +1,40 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <mutex>
+#include "abel/log/common.h"
+
+
+namespace abel {
+namespace sinks {
+
+template<typename Mutex>
+ABEL_FORCE_INLINE mmap_ring_sink<Mutex>::mmap_ring_sink(const filename_t &filename, size_t capacity) {
+    ring_.open(filename, capacity);
+}
+
+template<typename Mutex>
+ABEL_FORCE_INLINE const filename_t &mmap_ring_sink<Mutex>::filename() const {
+    return ring_.filename();
+}
+
+template<typename Mutex>
+ABEL_FORCE_INLINE void mmap_ring_sink<Mutex>::sync() {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    ring_.sync();
+}
+
+template<typename Mutex>
+ABEL_FORCE_INLINE void mmap_ring_sink<Mutex>::sink_it_(const details::log_msg &msg) {
+    memory_buf_t formatted;
+    base_sink<Mutex>::formatter_->format(msg, formatted);
+    ring_.append(formatted.data(), formatted.size());
+}
+
+template<typename Mutex>
+ABEL_FORCE_INLINE void mmap_ring_sink<Mutex>::flush_() {}
+
+} // namespace sinks
+}  // namespace abel
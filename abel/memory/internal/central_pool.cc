@@ -0,0 +1,182 @@
+//
+// Created by liyinbin on 2021/4/3.
+//
+
+#include "abel/memory/internal/central_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "abel/base/profile.h"
+#include "abel/log/logging.h"
+#include "abel/thread/numa.h"
+
+namespace abel {
+
+    namespace memory_internal {
+
+        namespace {
+
+            constexpr auto kMinimumWashInterval = abel::duration::milliseconds(5);
+
+        }  // namespace
+
+        central_pool::central_pool(const type_descriptor *desc, pool_counters *stats,
+                                   std::size_t low_water_mark,
+                                   std::size_t high_water_mark,
+                                   abel::duration max_idle)
+                : desc_(desc),
+                  stats_(stats),
+                  low_water_mark_(low_water_mark),
+                  high_water_mark_(high_water_mark),
+                  max_idle_(max_idle) {}
+
+        bool central_pool::get_batch(std::vector<void *> *objects) {
+            DCHECK(objects->empty());
+            std::scoped_lock _(lock_);
+            if (batches_.empty()) {
+                return false;
+            }
+            *objects = std::move(batches_.back().objects);
+            batches_.pop_back();
+            objects_ -= objects->size();
+            stats_->cached.fetch_sub(objects->size(), std::memory_order_relaxed);
+            return true;
+        }
+
+        void central_pool::put_batch(std::vector<void *> *objects) {
+            auto now = abel::time_now();
+            object_batch batch = {.objects = std::move(*objects), .last_used = now};
+            objects->clear();
+
+            std::vector<object_batch> freeing;
+            {
+                std::scoped_lock _(lock_);
+                if (batch.objects.size() > high_water_mark_ - objects_) {
+                    // We've reached the high-water mark.
+                    freeing.push_back(std::move(batch));
+                } else {
+                    objects_ += batch.objects.size();
+                    stats_->cached.fetch_add(batch.objects.size(), std::memory_order_relaxed);
+                    batches_.push_back(std::move(batch));
+                }
+                wash_out(now, &freeing);
+            }
+            // Destroy them without holding the lock.
+            for (auto &&e : freeing) {
+                free_batch(&e);
+            }
+        }
+
+        std::size_t central_pool::size() const {
+            std::scoped_lock _(lock_);
+            return objects_;
+        }
+
+        void central_pool::wash_out(abel::time_point now,
+                                    std::vector<object_batch> *freeing) {
+            if (now < last_wash_ + kMinimumWashInterval) {
+                return;  // We're called too frequently.
+            }
+            last_wash_ = now;
+
+            // The least recently used batch is at the front.
+            while (!batches_.empty() && now - batches_.front().last_used >= max_idle_ &&
+                   objects_ - batches_.front().objects.size() >= low_water_mark_) {
+                auto count = batches_.front().objects.size();
+                objects_ -= count;
+                stats_->cached.fetch_sub(count, std::memory_order_relaxed);
+                stats_->washed_out.fetch_add(count, std::memory_order_relaxed);
+                freeing->push_back(std::move(batches_.front()));
+                batches_.pop_front();
+            }
+        }
+
+        void central_pool::free_batch(object_batch *batch) {
+            stats_->freed.fetch_add(batch->objects.size(), std::memory_order_relaxed);
+            for (auto &&e : batch->objects) {
+                desc_->destroy(e);
+            }
+            batch->objects.clear();
+        }
+
+        central_pool *const *create_central_pools(const type_descriptor *desc,
+                                                  pool_stats_entry *stats,
+                                                  std::size_t count,
+                                                  std::size_t low_water_mark,
+                                                  std::size_t high_water_mark,
+                                                  abel::duration max_idle) {
+            DCHECK_GT(count, 0);
+            auto pools = new central_pool *[count];
+            for (std::size_t i = 0; i != count; ++i) {
+                pools[i] = new central_pool(desc, stats->shared(), low_water_mark,
+                                            high_water_mark, max_idle);
+            }
+            return pools;
+        }
+
+        thread_cache::thread_cache(const type_descriptor *desc,
+                                   pool_stats_entry *stats,
+                                   central_pool *const *pools,
+                                   std::size_t pool_count,
+                                   std::size_t minimum_cache_size,
+                                   std::size_t transfer_batch_size)
+                : desc(desc),
+                  pools(pools),
+                  pool_count(pool_count),
+                  transfer_batch_size(transfer_batch_size),
+                  max_cache_size(minimum_cache_size + transfer_batch_size),
+                  stats(stats) {
+            DCHECK_GT(transfer_batch_size, 0);
+        }
+
+        thread_cache::~thread_cache() {
+            auto pool = get_central_pool();
+            while (!objects.empty()) {
+                auto count = std::min(objects.size(), transfer_batch_size);
+                std::vector<void *> batch(objects.end() - count, objects.end());
+                objects.resize(objects.size() - count);
+                pool->put_batch(&batch);
+            }
+            stats.set_cached(0);
+        }
+
+        central_pool *thread_cache::get_central_pool() const {
+            if (pool_count == 1) {
+                return pools[0];
+            }
+            auto index = numa::get_current_node_index();
+            return pools[index < pool_count ? index : 0];
+        }
+
+        void *cache_get(const type_descriptor &desc, thread_cache *cache) {
+            if (ABEL_UNLIKELY(cache->objects.empty())) {
+                if (!cache->get_central_pool()->get_batch(&cache->objects)) {
+                    cache->stats.on_get(false);
+                    return desc.create();
+                }
+                DCHECK(!cache->objects.empty());
+            }
+            cache->stats.on_get(true);
+            auto rc = cache->objects.back();
+            cache->objects.pop_back();
+            cache->stats.set_cached(cache->objects.size());
+            return rc;
+        }
+
+        void cache_put(const type_descriptor &desc, thread_cache *cache, void *ptr) {
+            DCHECK(&desc == cache->desc);
+            cache->stats.on_put();
+            cache->objects.push_back(ptr);
+            if (ABEL_UNLIKELY(cache->objects.size() >= cache->max_cache_size)) {
+                // Keep the most recently used ones (at the back) locally.
+                auto first = cache->objects.begin();
+                std::vector<void *> batch(first, first + cache->transfer_batch_size);
+                cache->objects.erase(first, first + cache->transfer_batch_size);
+                cache->get_central_pool()->put_batch(&batch);
+            }
+            cache->stats.set_cached(cache->objects.size());
+        }
+
+    }  // namespace memory_internal
+}  // namespace abel
@@ -0,0 +1,110 @@
+//
+// Created by liyinbin on 2021/4/3.
+//
+
+#ifndef ABEL_MEMORY_INTERNAL_CENTRAL_POOL_H_
+#define ABEL_MEMORY_INTERNAL_CENTRAL_POOL_H_
+
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "abel/chrono/clock.h"
+#include "abel/memory/internal/pool_stats.h"
+#include "abel/memory/internal/type_descriptor.h"
+
+namespace abel {
+    namespace memory_internal {
+
+        // Pool shared by several threads (all threads in the same NUMA node for
+        // `MemoryNodeShared`, or all threads in the process for `Global`).
+        //
+        // Objects are transferred between this pool and thread caches in batches,
+        // so as to amortize the cost of locking.
+        class central_pool {
+        public:
+            central_pool(const type_descriptor *desc, pool_counters *stats,
+                         std::size_t low_water_mark, std::size_t high_water_mark,
+                         abel::duration max_idle);
+
+            // Moves a batch of objects into `objects`, which must be empty.
+            //
+            // Returns false if there's no object in the pool.
+            bool get_batch(std::vector<void *> *objects);
+
+            // Moves all objects in `objects` into the pool. Objects beyond the
+            // high-water mark are freed instead.
+            void put_batch(std::vector<void *> *objects);
+
+            // Number of objects cached in this pool.
+            std::size_t size() const;
+
+        private:
+            struct object_batch {
+                std::vector<void *> objects;
+                abel::time_point last_used;
+            };
+
+            // Moves batches idle for too long into `freeing`. Called with `lock_`
+            // held.
+            void wash_out(abel::time_point now, std::vector<object_batch> *freeing);
+
+            void free_batch(object_batch *batch);
+
+        private:
+            const type_descriptor *desc_;
+            pool_counters *stats_;
+            const std::size_t low_water_mark_;
+            const std::size_t high_water_mark_;
+            const abel::duration max_idle_;
+
+            mutable std::mutex lock_;
+            abel::time_point last_wash_{abel::time_now()};
+            std::size_t objects_{0};
+            // Most recently used batches are at the back.
+            std::deque<object_batch> batches_;
+        };
+
+        // Allocates `count` pools. They're never freed, as thread caches might
+        // still be returning objects to them during program exit.
+        central_pool *const *create_central_pools(const type_descriptor *desc,
+                                                  pool_stats_entry *stats,
+                                                  std::size_t count,
+                                                  std::size_t low_water_mark,
+                                                  std::size_t high_water_mark,
+                                                  abel::duration max_idle);
+
+        // Objects cached by a thread, refilled from / flushed to a central pool.
+        //
+        // If several pools are given, the one for the NUMA node the calling thread
+        // is running on is used.
+        struct thread_cache {
+            thread_cache(const type_descriptor *desc, pool_stats_entry *stats,
+                         central_pool *const *pools, std::size_t pool_count,
+                         std::size_t minimum_cache_size,
+                         std::size_t transfer_batch_size);
+
+            // Objects still cached are returned to the central pool.
+            ~thread_cache();
+
+            central_pool *get_central_pool() const;
+
+            const type_descriptor *const desc;
+            central_pool *const *const pools;
+            const std::size_t pool_count;
+            const std::size_t transfer_batch_size;
+            // A batch is flushed to the central pool once we have this many
+            // objects.
+            const std::size_t max_cache_size;
+            std::vector<void *> objects;
+            thread_pool_stats stats;
+        };
+
+        void *cache_get(const type_descriptor &desc, thread_cache *cache);
+
+        void cache_put(const type_descriptor &desc, thread_cache *cache, void *ptr);
+
+    }  // namespace memory_internal
+}  // namespace abel
+
+#endif  // ABEL_MEMORY_INTERNAL_CENTRAL_POOL_H_
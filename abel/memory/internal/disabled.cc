@@ -8,12 +8,19 @@ namespace abel {
 
     namespace memory_internal {
 
-        void *disabled_get(const type_descriptor &desc) {
+        void *disabled_get(const type_descriptor &desc, pool_stats_entry *stats) {
+            stats->shared()->gets.fetch_add(1, std::memory_order_relaxed);
+            stats->shared()->misses.fetch_add(1, std::memory_order_relaxed);
             auto rc = desc.create();
             return rc;
         }
 
-        void disabled_put(const type_descriptor &desc, void *ptr) { desc.destroy(ptr); }
+        void disabled_put(const type_descriptor &desc, pool_stats_entry *stats,
+                          void *ptr) {
+            stats->shared()->puts.fetch_add(1, std::memory_order_relaxed);
+            stats->shared()->freed.fetch_add(1, std::memory_order_relaxed);
+            desc.destroy(ptr);
+        }
 
     }  // namespace memory_internal
 }  // namespace abel
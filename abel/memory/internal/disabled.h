@@ -5,14 +5,16 @@
 #ifndef ABEL_MEMORY_DISABLE_H_
 #define ABEL_MEMORY_DISABLE_H_
 
+#include "abel/memory/internal/pool_stats.h"
 #include "abel/memory/internal/type_descriptor.h"
 
 namespace abel {
     namespace memory_internal {
 
-        void *disabled_get(const type_descriptor &desc);
+        void *disabled_get(const type_descriptor &desc, pool_stats_entry *stats);
 
-        void disabled_put(const type_descriptor &desc, void *ptr);
+        void disabled_put(const type_descriptor &desc, pool_stats_entry *stats,
+                          void *ptr);
     }  // namespace memory_internal
 }
 #endif  // ABEL_MEMORY_DISABLE_H_
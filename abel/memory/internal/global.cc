@@ -3,20 +3,18 @@
 //
 
 #include "abel/memory/internal/global.h"
-#include "abel/log/logging.h"
 
 namespace abel {
 
     namespace memory_internal {
-        void *global_get(const type_descriptor &desc) {
-            ABEL_UNUSED(desc);
-            DCHECK(false, "not implement");
+
+        void *global_get(const type_descriptor &desc, thread_cache *cache) {
+            return cache_get(desc, cache);
         }
 
-        void global_put(const type_descriptor &desc, void *ptr) {
-            ABEL_UNUSED(desc);
-            ABEL_UNUSED(ptr);
-            DCHECK(false, "not implement");
+        void global_put(const type_descriptor &desc, thread_cache *cache, void *ptr) {
+            cache_put(desc, cache, ptr);
         }
+
     }  // namespace memory_internal
 }  // namespace abel
@@ -5,13 +5,38 @@
 #ifndef ABEL_MEMORY_GLOBAL_H_
 #define ABEL_MEMORY_GLOBAL_H_
 
+#include "abel/memory/internal/central_pool.h"
 #include "abel/memory/internal/type_descriptor.h"
 
 namespace abel {
 
     namespace memory_internal {
-        void* global_get(const type_descriptor& desc);
-        void global_put(const type_descriptor& desc, void* ptr);
+
+        // Each thread caches at most `kMinimumThreadCacheSize + kTransferBatchSize`
+        // objects, `kTransferBatchSize` of them are moved to (or from) a pool shared
+        // by all threads at a time. Water marks and `kMaxIdle` apply to the shared
+        // pool.
+        template<class T>
+        thread_cache *get_global_cache() {
+            static_assert(pool_traits<T>::kHighWaterMark > pool_traits<T>::kLowWaterMark,
+                          "You should leave some room between the water marks.");
+            static_assert(pool_traits<T>::kTransferBatchSize > 0,
+                          "Objects are transferred in batches of `kTransferBatchSize`.");
+
+            auto stats = get_pool_stats_entry<T>("Global");
+            static central_pool *const *pools = create_central_pools(
+                    get_type_desc<T>(), stats, 1, pool_traits<T>::kLowWaterMark,
+                    pool_traits<T>::kHighWaterMark, pool_traits<T>::kMaxIdle);
+            thread_local thread_cache cache(get_type_desc<T>(), stats, pools, 1,
+                                            pool_traits<T>::kMinimumThreadCacheSize,
+                                            pool_traits<T>::kTransferBatchSize);
+            return &cache;
+        }
+
+        void *global_get(const type_descriptor &desc, thread_cache *cache);
+
+        void global_put(const type_descriptor &desc, thread_cache *cache, void *ptr);
+
     }  // namespace memory_internal
 }  // namespace abel
 
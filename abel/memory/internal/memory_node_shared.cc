@@ -0,0 +1,21 @@
+//
+// Created by liyinbin on 2021/4/3.
+//
+
+#include "abel/memory/internal/memory_node_shared.h"
+
+namespace abel {
+
+    namespace memory_internal {
+
+        void *memory_node_shared_get(const type_descriptor &desc, thread_cache *cache) {
+            return cache_get(desc, cache);
+        }
+
+        void memory_node_shared_put(const type_descriptor &desc, thread_cache *cache,
+                                    void *ptr) {
+            cache_put(desc, cache, ptr);
+        }
+
+    }  // namespace memory_internal
+}  // namespace abel
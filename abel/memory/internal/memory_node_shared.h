@@ -0,0 +1,48 @@
+//
+// Created by liyinbin on 2021/4/3.
+//
+
+#ifndef ABEL_MEMORY_MEMORY_NODE_SHARED_H_
+#define ABEL_MEMORY_MEMORY_NODE_SHARED_H_
+
+#include <algorithm>
+
+#include "abel/memory/internal/central_pool.h"
+#include "abel/memory/internal/type_descriptor.h"
+#include "abel/thread/numa.h"
+
+namespace abel {
+
+    namespace memory_internal {
+
+        // Same as `get_global_cache`, except that there's a shared pool for each
+        // NUMA node, and objects are transferred to (or from) the one the calling
+        // thread is running on. Water marks and `kMaxIdle` apply to each of them.
+        template<class T>
+        thread_cache *get_memory_node_shared_cache() {
+            static_assert(pool_traits<T>::kHighWaterMark > pool_traits<T>::kLowWaterMark,
+                          "You should leave some room between the water marks.");
+            static_assert(pool_traits<T>::kTransferBatchSize > 0,
+                          "Objects are transferred in batches of `kTransferBatchSize`.");
+
+            static const auto nodes =
+                    std::max<std::size_t>(1, numa::get_number_of_nodes_available());
+            auto stats = get_pool_stats_entry<T>("MemoryNodeShared");
+            static central_pool *const *pools = create_central_pools(
+                    get_type_desc<T>(), stats, nodes, pool_traits<T>::kLowWaterMark,
+                    pool_traits<T>::kHighWaterMark, pool_traits<T>::kMaxIdle);
+            thread_local thread_cache cache(get_type_desc<T>(), stats, pools, nodes,
+                                            pool_traits<T>::kMinimumThreadCacheSize,
+                                            pool_traits<T>::kTransferBatchSize);
+            return &cache;
+        }
+
+        void *memory_node_shared_get(const type_descriptor &desc, thread_cache *cache);
+
+        void memory_node_shared_put(const type_descriptor &desc, thread_cache *cache,
+                                    void *ptr);
+
+    }  // namespace memory_internal
+}  // namespace abel
+
+#endif  // ABEL_MEMORY_MEMORY_NODE_SHARED_H_
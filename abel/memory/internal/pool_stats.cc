@@ -0,0 +1,137 @@
+//
+// Created by liyinbin on 2021/4/3.
+//
+
+#include "abel/memory/internal/pool_stats.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "abel/memory/non_destroy.h"
+#include "abel/strings/format.h"
+
+namespace abel {
+
+    namespace memory_internal {
+
+        namespace {
+
+            struct pool_registry {
+                std::mutex lock;
+                std::vector<pool_stats_entry *> entries;
+            };
+
+            pool_registry *get_registry() {
+                static non_destroy<pool_registry> registry;
+                return registry.get();
+            }
+
+            std::uint64_t load(const std::atomic<std::uint64_t> &value) {
+                return value.load(std::memory_order_relaxed);
+            }
+
+            std::uint64_t load_cached(const std::atomic<std::int64_t> &value) {
+                return std::max<std::int64_t>(0, value.load(std::memory_order_relaxed));
+            }
+
+            void accumulate(const pool_counters &from, object_pool_stats *to) {
+                to->gets += load(from.gets);
+                to->puts += load(from.puts);
+                to->hits += load(from.hits);
+                to->misses += load(from.misses);
+                to->washed_out += load(from.washed_out);
+                to->freed += load(from.freed);
+            }
+
+        }  // namespace
+
+        thread_pool_stats::thread_pool_stats(pool_stats_entry *entry) : entry_(entry) {
+            entry_->register_thread(this);
+        }
+
+        thread_pool_stats::~thread_pool_stats() { entry_->unregister_thread(this); }
+
+        pool_stats_entry::pool_stats_entry(const type_descriptor *desc,
+                                           std::string type_name,
+                                           std::size_t object_size,
+                                           std::string backend)
+                : desc_(desc),
+                  type_name_(std::move(type_name)),
+                  object_size_(object_size),
+                  backend_(std::move(backend)) {}
+
+        void pool_stats_entry::register_thread(thread_pool_stats *stats) {
+            std::scoped_lock _(lock_);
+            threads_.push_back(stats);
+        }
+
+        void pool_stats_entry::unregister_thread(thread_pool_stats *stats) {
+            std::scoped_lock _(lock_);
+            accumulate(*stats, &retired_);
+            // Objects still in the cache (if any) are freed along with it.
+            retired_.freed += load_cached(stats->cached);
+            threads_.erase(std::find(threads_.begin(), threads_.end(), stats));
+        }
+
+        object_pool_stats pool_stats_entry::read() const {
+            std::scoped_lock _(lock_);
+            object_pool_stats rc = retired_;
+            rc.type_name = type_name_;
+            rc.backend = backend_;
+            rc.object_size = object_size_;
+            rc.threads = threads_.size();
+            rc.thread_cached = 0;
+            for (auto &&e : threads_) {
+                accumulate(*e, &rc);
+                rc.thread_cached += load_cached(e->cached);
+            }
+            accumulate(shared_, &rc);
+            rc.shared_cached = load_cached(shared_.cached);
+            rc.alive = rc.misses > rc.freed ? rc.misses - rc.freed : 0;
+            rc.bytes_cached = (rc.thread_cached + rc.shared_cached) * object_size_;
+            return rc;
+        }
+
+        pool_stats_entry *register_object_pool(const type_descriptor *desc,
+                                               std::string type_name,
+                                               std::size_t object_size,
+                                               std::string backend) {
+            auto entry = new pool_stats_entry(desc, std::move(type_name), object_size,
+                                              std::move(backend));
+            auto &&registry = get_registry();
+            std::scoped_lock _(registry->lock);
+            registry->entries.push_back(entry);
+            return entry;
+        }
+
+    }  // namespace memory_internal
+
+    std::vector<object_pool_stats> get_object_pool_stats() {
+        std::vector<memory_internal::pool_stats_entry *> entries;
+        {
+            auto &&registry = memory_internal::get_registry();
+            std::scoped_lock _(registry->lock);
+            entries = registry->entries;
+        }
+        std::vector<object_pool_stats> rc;
+        for (auto &&e : entries) {
+            rc.push_back(e->read());
+        }
+        return rc;
+    }
+
+    std::string dump_object_pool_stats() {
+        std::string rc = abel::format(
+                "{:<48} {:>16} {:>8} {:>12} {:>12} {:>12} {:>10} {:>10} {:>10} {:>10} {:>14}\n",
+                "type", "backend", "size", "gets", "hits", "misses", "washed", "alive",
+                "t-cached", "s-cached", "bytes-cached");
+        for (auto &&e : get_object_pool_stats()) {
+            rc += abel::format(
+                    "{:<48} {:>16} {:>8} {:>12} {:>12} {:>12} {:>10} {:>10} {:>10} {:>10} {:>14}\n",
+                    e.type_name, e.backend, e.object_size, e.gets, e.hits, e.misses,
+                    e.washed_out, e.alive, e.thread_cached, e.shared_cached, e.bytes_cached);
+        }
+        return rc;
+    }
+
+}  // namespace abel
@@ -0,0 +1,120 @@
+//
+// Created by liyinbin on 2021/4/3.
+//
+
+#ifndef ABEL_MEMORY_INTERNAL_POOL_STATS_H_
+#define ABEL_MEMORY_INTERNAL_POOL_STATS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "abel/base/class_name.h"
+#include "abel/memory/object_pool_stats.h"
+#include "abel/memory/internal/type_descriptor.h"
+
+namespace abel {
+    namespace memory_internal {
+
+        struct pool_counters {
+            std::atomic<std::uint64_t> gets{0};
+            std::atomic<std::uint64_t> puts{0};
+            std::atomic<std::uint64_t> hits{0};
+            std::atomic<std::uint64_t> misses{0};
+            std::atomic<std::uint64_t> washed_out{0};
+            std::atomic<std::uint64_t> freed{0};
+            // Objects currently cached.
+            std::atomic<std::int64_t> cached{0};
+        };
+
+        class pool_stats_entry;
+
+        // Counters of a thread's cache. Only updated by the owner thread, so no
+        // atomic RMW is needed. They're registered to `entry` on construction, and
+        // folded into it on destruction.
+        class thread_pool_stats : public pool_counters {
+        public:
+            explicit thread_pool_stats(pool_stats_entry *entry);
+
+            ~thread_pool_stats();
+
+            void on_get(bool hit) noexcept {
+                bump(&gets);
+                bump(hit ? &hits : &misses);
+            }
+
+            void on_put() noexcept { bump(&puts); }
+
+            void on_free(std::uint64_t count, bool washed_out_by_idle) noexcept {
+                bump(&freed, count);
+                if (washed_out_by_idle) {
+                    bump(&washed_out, count);
+                }
+            }
+
+            void set_cached(std::size_t count) noexcept {
+                cached.store(count, std::memory_order_relaxed);
+            }
+
+        private:
+            template<class U>
+            static void bump(std::atomic<U> *counter, U value = 1) noexcept {
+                counter->store(counter->load(std::memory_order_relaxed) + value,
+                               std::memory_order_relaxed);
+            }
+
+        private:
+            pool_stats_entry *entry_;
+        };
+
+        // Statistics of object pool of a type, registered in a process-wide
+        // registry. Never freed.
+        class pool_stats_entry {
+        public:
+            pool_stats_entry(const type_descriptor *desc, std::string type_name,
+                             std::size_t object_size, std::string backend);
+
+            const type_descriptor *desc() const noexcept { return desc_; }
+
+            // Counters not attributed to a thread cache (i.e., of shared pools,
+            // or of `Disabled` pools). Thread-safe.
+            pool_counters *shared() noexcept { return &shared_; }
+
+            void register_thread(thread_pool_stats *stats);
+
+            void unregister_thread(thread_pool_stats *stats);
+
+            object_pool_stats read() const;
+
+        private:
+            const type_descriptor *desc_;
+            const std::string type_name_;
+            const std::size_t object_size_;
+            const std::string backend_;
+
+            pool_counters shared_;
+
+            mutable std::mutex lock_;
+            std::vector<thread_pool_stats *> threads_;
+            // Counters of threads that have exited.
+            object_pool_stats retired_{};
+        };
+
+        pool_stats_entry *register_object_pool(const type_descriptor *desc,
+                                               std::string type_name,
+                                               std::size_t object_size,
+                                               std::string backend);
+
+        template<class T>
+        pool_stats_entry *get_pool_stats_entry(const char *backend) {
+            static pool_stats_entry *entry = register_object_pool(
+                    get_type_desc<T>(), get_type_name<T>(), sizeof(T), backend);
+            return entry;
+        }
+
+    }  // namespace memory_internal
+}  // namespace abel
+
+#endif  // ABEL_MEMORY_INTERNAL_POOL_STATS_H_
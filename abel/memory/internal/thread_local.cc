@@ -28,20 +28,24 @@ namespace abel {
 
                 auto &&primary = pool->primary_cache;
                 auto &&secondary = pool->secondary_cache;
-                auto move_to_secondary_or_free = [&](std::size_t count) {
+                auto move_to_secondary_or_free = [&](std::size_t count, bool idle) {
+                    std::size_t freed = 0;
                     while (count--) {
                         if (secondary.size() < pool->low_water_mark) {
                             secondary.push_back(std::move(primary.front()));
+                        } else {
+                            ++freed;
                         }
                         primary.pop_front();
                     }
+                    pool->stats.on_free(freed, idle);
                 };
 
                 // We've reached the high-water mark, free some objects.
                 if (pool->primary_cache.size() > pool->high_water_mark) {
                     auto upto =
                             get_free_count(pool->primary_cache.size() - pool->high_water_mark);
-                    move_to_secondary_or_free(upto);
+                    move_to_secondary_or_free(upto, false);
                     if (upto == kMinimumFreePerWash) {
                         return;  // We've freed enough objects then.
                     }
@@ -58,7 +62,7 @@ namespace abel {
                                                      return ts - e.last_used < pool->max_idle;
                                                  }) -
                                     primary.begin();
-                move_to_secondary_or_free(get_free_count(idle_objects));
+                move_to_secondary_or_free(get_free_count(idle_objects), true);
 
 #ifndef NDEBUG
                 if (objects_had >= pool->low_water_mark) {
@@ -71,6 +75,8 @@ namespace abel {
         }  // namespace
 
         void *tls_get(const type_descriptor &desc, pool_descriptor *pool) {
+            pool->stats.on_get(!pool->primary_cache.empty() ||
+                               !pool->secondary_cache.empty());
             if (pool->primary_cache.empty()) {
                 if (!pool->secondary_cache.empty()) {
                     pool->primary_cache = std::move(pool->secondary_cache);
@@ -91,11 +97,18 @@ namespace abel {
             }
             auto rc = std::move(pool->primary_cache.back());
             pool->primary_cache.pop_back();
+            pool->stats.set_cached(pool->primary_cache.size() +
+                                   pool->secondary_cache.size());
             return rc.ptr.leak();
         }
 
         void tls_put(const type_descriptor &desc, pool_descriptor *pool, void *ptr) {
-            abel::scoped_deferred _([&] { wash_out_cache(pool); });
+            abel::scoped_deferred _([&] {
+                wash_out_cache(pool);
+                pool->stats.set_cached(pool->primary_cache.size() +
+                                       pool->secondary_cache.size());
+            });
+            pool->stats.on_put();
             pool->primary_cache.push_back(timestamped_object{
                     .ptr = {ptr, desc.destroy}, .last_used = abel::time_now()});
         }
@@ -9,6 +9,7 @@
 
 #include "abel/chrono/clock.h"
 #include "abel/memory/erased_ptr.h"
+#include "abel/memory/internal/pool_stats.h"
 #include "abel/memory/internal/type_descriptor.h"
 #include "abel/base/class_name.h"
 #include "abel/log/logging.h"
@@ -34,6 +35,8 @@ namespace abel {
 
             // Objects here are not subject to washing out.
             std::deque<timestamped_object> secondary_cache{};
+
+            thread_pool_stats stats;
         };
 
         // `template <class T> inline thread_local pool_descriptor pool` does not work:
@@ -54,7 +57,8 @@ namespace abel {
             thread_local pool_descriptor pool = {
                     .low_water_mark = pool_traits<T>::kLowWaterMark,
                     .high_water_mark = kEffectiveHighWaterMark,
-                    .max_idle = pool_traits<T>::kMaxIdle};
+                    .max_idle = pool_traits<T>::kMaxIdle,
+                    .stats = thread_pool_stats(get_pool_stats_entry<T>("ThreadLocal"))};
             DCHECK((pool.low_water_mark == pool_traits<T>::kLowWaterMark) &&
                        (pool.high_water_mark == kEffectiveHighWaterMark) &&
                        (pool.max_idle == pool_traits<T>::kMaxIdle),
@@ -17,7 +17,9 @@
 #include "abel/memory/internal/thread_local.h"
 #include "abel/memory/internal/disabled.h"
 #include "abel/memory/internal/global.h"
+#include "abel/memory/internal/memory_node_shared.h"
 #include "abel/memory/internal/type_descriptor.h"
+#include "abel/memory/object_pool_stats.h"
 
 namespace abel {
 
@@ -55,10 +57,10 @@ namespace abel {
         Global
     };
 
-    // Note that this pool uses thread-local cache. That is, it does not perform
-    // well in scenarios such as producer-consumer (in this case, the producer
-    // thread keeps allocating objects while the consumer thread keeps de-allocating
-    // objects, and nothing could be reused by either thread.). Be aware of this.
+    // Note that `ThreadLocal` pool does not perform well in scenarios such as
+    // producer-consumer (in this case, the producer thread keeps allocating objects
+    // while the consumer thread keeps de-allocating objects, and nothing could be
+    // reused by either thread.). Use `MemoryNodeShared` for such cases.
 
     // You need to customize these parameters before using this object pool.
     template<class T>
@@ -99,8 +101,12 @@ namespace abel {
         // static void OnPut(T*) { ... }
 
         // For type-specific arguments, see header for the corresponding backend.
-
-        // ... TODO
+        //
+        // `ThreadLocal`: `kLowWaterMark`, `kHighWaterMark`, `kMaxIdle`.
+        //
+        // `MemoryNodeShared` / `Global`: `kLowWaterMark`, `kHighWaterMark`,
+        // `kMaxIdle` (for the shared pool), `kMinimumThreadCacheSize` and
+        // `kTransferBatchSize`.
 
         static_assert(sizeof(T) == 0,
                       "You need to specialize `abel::object_pool::pool_traits` to "
@@ -115,13 +121,15 @@ namespace abel {
             constexpr auto kType = pool_traits<T>::kType;
 
             if constexpr (kType == pool_type::Disabled) {
-                return disabled_get(*get_type_desc<T>());
+                return disabled_get(*get_type_desc<T>(),
+                                    get_pool_stats_entry<T>("Disabled"));
             } else if constexpr (kType == pool_type::ThreadLocal) {
                 return tls_get(*get_type_desc<T>(), get_thread_local_pool<T>());
-                //} else if constexpr (kType == pool_type::MemoryNodeShared) {
-                //  return memory_node_shared::get<T>();
+            } else if constexpr (kType == pool_type::MemoryNodeShared) {
+                return memory_node_shared_get(*get_type_desc<T>(),
+                                              get_memory_node_shared_cache<T>());
             } else if constexpr (kType == pool_type::Global) {
-                return global_get(*get_type_desc<T>());
+                return global_get(*get_type_desc<T>(), get_global_cache<T>());
             } else {
                 static_assert(sizeof(T) == 0, "Unexpected pool type.");
                 DCHECK(0, "");
@@ -134,13 +142,15 @@ namespace abel {
             constexpr auto kType = pool_traits<T>::kType;
 
             if constexpr (kType == pool_type::Disabled) {
-                disabled_put(*get_type_desc<T>(), ptr);
+                disabled_put(*get_type_desc<T>(), get_pool_stats_entry<T>("Disabled"),
+                             ptr);
             } else if constexpr (kType == pool_type::ThreadLocal) {
                 tls_put(*get_type_desc<T>(), get_thread_local_pool<T>(), ptr);
-                // } else if constexpr (kType == pool_type::MemoryNodeShared) {
-                //    return memory_node_shared::Put<T>(ptr);
+            } else if constexpr (kType == pool_type::MemoryNodeShared) {
+                memory_node_shared_put(*get_type_desc<T>(),
+                                       get_memory_node_shared_cache<T>(), ptr);
             } else if constexpr (kType == pool_type::Global) {
-                global_put(*get_type_desc<T>(), ptr);
+                global_put(*get_type_desc<T>(), get_global_cache<T>(), ptr);
             } else {
                 static_assert(sizeof(T) == 0, "Unexpected pool type.");
                 DCHECK(0, "");
@@ -0,0 +1,61 @@
+//
+// Created by liyinbin on 2021/4/3.
+//
+
+#ifndef ABEL_MEMORY_OBJECT_POOL_STATS_H_
+#define ABEL_MEMORY_OBJECT_POOL_STATS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace abel {
+
+    // Statistics of object pool of a given type.
+    //
+    // Each type used with `object_pool::get` / `object_pool::put` is registered
+    // on first use. Counters are updated by each thread without synchronization,
+    // and summed up on read, so the numbers below are not necessarily consistent
+    // with each other.
+    struct object_pool_stats {
+        std::string type_name;
+        // `ThreadLocal`, `MemoryNodeShared`, ...
+        std::string backend;
+        std::size_t object_size;
+
+        // Calls to `object_pool::get` / `object_pool::put`.
+        std::uint64_t gets;
+        std::uint64_t puts;
+
+        // Calls to `get` satisfied by the pool, or resulting in a new object
+        // created.
+        std::uint64_t hits;
+        std::uint64_t misses;
+
+        // Objects freed because they had been idle for longer than `kMaxIdle`.
+        std::uint64_t washed_out;
+        // Objects freed by the pool, for whatever reason.
+        std::uint64_t freed;
+
+        // Objects created and not freed yet, either in use or cached.
+        std::uint64_t alive;
+        // Objects cached in thread caches, and in pools shared by threads.
+        std::uint64_t thread_cached;
+        std::uint64_t shared_cached;
+        // Threads holding a cache.
+        std::size_t threads;
+
+        // Bytes held by cached objects, i.e., memory not in use.
+        std::uint64_t bytes_cached;
+    };
+
+    // Returns statistics of all object pools used so far.
+    std::vector<object_pool_stats> get_object_pool_stats();
+
+    // Returns a human-readable table of `get_object_pool_stats()`.
+    std::string dump_object_pool_stats();
+
+}  // namespace abel
+
+#endif  // ABEL_MEMORY_OBJECT_POOL_STATS_H_
@@ -6,6 +6,7 @@
 #ifndef ABEL_METRICS_CACHE_METRICS_H_
 #define ABEL_METRICS_CACHE_METRICS_H_
 
+#include <cstdint>
 #include <vector>
 #include <unordered_map>
 #include <string>
@@ -24,6 +25,9 @@ struct cache_metrics {
     scope_family_ptr family;
     struct cached_counter {
         double value = 0.0;
+        // Set by `int_counter`, `int_value` holds the exact value then.
+        bool is_integral = false;
+        std::uint64_t int_value = 0;
     };
     cached_counter counter;
 
@@ -45,6 +49,18 @@ struct cache_metrics {
     };
     cached_histogram histogram;
 
+    struct cached_quantile {
+        double quantile = 0.0;
+        double value = 0.0;
+    };
+
+    struct cached_summary {
+        std::uint64_t sample_count = 0;
+        double sample_sum = 0.0;
+        std::vector<cached_quantile> quantiles;
+    };
+    cached_summary summary;
+
     std::int64_t timestamp_ms = 0;
 };
 
@@ -10,15 +10,18 @@ namespace abel {
 namespace metrics {
 
 void counter::inc() {
-    _gauge.inc();
+    inc(1.0);
 }
 
 void counter::inc(const double val) {
-    _gauge.inc(val);
+    if (val < 0.0) {
+        return;
+    }
+    _value.add(val);
 }
 
 double counter::value() const {
-    return _gauge.value();
+    return _value.sum();
 }
 
 cache_metrics counter::collect() const noexcept {
@@ -28,5 +31,14 @@ cache_metrics counter::collect() const noexcept {
     return cm;
 }
 
+cache_metrics int_counter::collect() const noexcept {
+    cache_metrics cm;
+    cm.counter.int_value = value();
+    cm.counter.value = static_cast<double>(cm.counter.int_value);
+    cm.counter.is_integral = true;
+    cm.type = metrics_type::mt_counter;
+    return cm;
+}
+
 }  // namespace metrics
 }  // namespace abel
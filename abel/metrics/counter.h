@@ -6,13 +6,16 @@
 #ifndef ABEL_ABEL_METRICS_COUNTER_H_
 #define ABEL_ABEL_METRICS_COUNTER_H_
 
+#include <cstdint>
 #include <memory>
-#include "abel/metrics/gauge.h"
 #include "abel/metrics/cache_metrics.h"
+#include "abel/metrics/sharded_counter.h"
 
 namespace abel {
 namespace metrics {
 
+// Increments are spread over per-thread slots (see `sharded_counter`), so
+// counters updated by many threads don't contend on a single cache line.
 class counter {
   public:
 
@@ -20,6 +23,7 @@ class counter {
 
     void inc();
 
+    // Negative values are ignored.
     void inc(double);
 
     double value() const;
@@ -27,11 +31,31 @@ class counter {
     cache_metrics collect() const noexcept;
 
   private:
-    gauge _gauge{0.0};
+    sharded_counter<double> _value;
 };
 
 typedef std::shared_ptr<counter> counter_ptr;
 
+// Same as `counter`, except that it counts in (exact) 64-bit integers.
+class int_counter {
+  public:
+
+    int_counter() = default;
+
+    void inc() noexcept { inc(1); }
+
+    void inc(std::uint64_t v) noexcept { _value.add(v); }
+
+    std::uint64_t value() const noexcept { return _value.sum(); }
+
+    cache_metrics collect() const noexcept;
+
+  private:
+    sharded_counter<std::uint64_t> _value;
+};
+
+typedef std::shared_ptr<int_counter> int_counter_ptr;
+
 }  // namespace ,metrics
 }  // namespace abel
 
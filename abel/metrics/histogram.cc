@@ -14,20 +14,59 @@ namespace abel {
 namespace metrics {
 
 histogram::histogram(const bucket &buckets) noexcept
-        : _bucket_boundaries{buckets}, _bucket_counts{buckets.size() + 1}, _sum{} {
+        : _bucket_boundaries{buckets}, _bucket_counts(buckets.size() + 1), _sum{} {
     assert(std::is_sorted(std::begin(_bucket_boundaries),
                           std::end(_bucket_boundaries)));
 }
 
 void histogram::observe(const double value) noexcept {
-    // TODO: determine bucket list size at which binary search would be faster
+    observe(value, 1);
+}
+
+void histogram::observe(const double value, const std::uint64_t count) noexcept {
     const auto bucket_index = static_cast<std::size_t>(std::distance(
             _bucket_boundaries.begin(),
-            std::find_if(
-                    std::begin(_bucket_boundaries), std::end(_bucket_boundaries),
-                    [value](const double boundary) { return boundary >= value; })));
-    _sum.inc(value);
-    _bucket_counts[bucket_index].inc();
+            std::lower_bound(std::begin(_bucket_boundaries), std::end(_bucket_boundaries),
+                             value)));
+    _sum.inc(value * count);
+    _bucket_counts.add(bucket_index, count);
+}
+
+double histogram::quantile(double q) const noexcept {
+    return quantile_of(_bucket_boundaries, bucket_counts(), q);
+}
+
+double histogram::quantile_of(const bucket &boundaries,
+                              const std::vector<std::uint64_t> &counts, double q) noexcept {
+    assert(counts.size() == boundaries.size() + 1);
+    auto total = std::accumulate(counts.begin(), counts.end(), std::uint64_t(0));
+    if (!total) {
+        return 0.0;
+    }
+    auto rank = std::clamp(q, 0.0, 1.0) * total;
+    std::uint64_t seen = 0;
+    for (std::size_t i{0}; i < counts.size(); ++i) {
+        if (seen + counts[i] < rank || !counts[i]) {
+            seen += counts[i];
+            continue;
+        }
+        if (i == boundaries.size()) {
+            break;  // The last bucket, which has no upper bound.
+        }
+        auto lower = i ? boundaries[i - 1] : std::min(0.0, boundaries[0]);
+        auto upper = boundaries[i];
+        return lower + (upper - lower) * (rank - seen) / counts[i];
+    }
+    return boundaries.empty() ? 0.0 : boundaries.back();
+}
+
+std::vector<std::uint64_t> histogram::bucket_counts() const {
+    std::vector<std::uint64_t> counts;
+    counts.reserve(_bucket_counts.size());
+    for (std::size_t i{0}; i < _bucket_counts.size(); ++i) {
+        counts.push_back(_bucket_counts.sum(i));
+    }
+    return counts;
 }
 
 cache_metrics histogram::collect() const noexcept {
@@ -37,7 +76,7 @@ cache_metrics histogram::collect() const noexcept {
 
     auto cumulative_count = 0ULL;
     for (std::size_t i{0}; i < _bucket_counts.size(); ++i) {
-        cumulative_count += _bucket_counts[i].value();
+        cumulative_count += _bucket_counts.sum(i);
         auto bucket = cache_metrics::cached_bucket{};
         bucket.cumulative_count = cumulative_count;
         bucket.upper_bound = (i == _bucket_boundaries.size()
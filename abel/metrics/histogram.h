@@ -22,11 +22,33 @@ class histogram {
 
     void observe(double value) noexcept;
 
+    // Same as calling `observe(value)` for `count` times.
+    void observe(double value, std::uint64_t count) noexcept;
+
+    // Estimates the value at quantile `q` (in [0, 1]) by linear interpolation
+    // within the bucket it falls in. The first bucket is assumed to start at 0,
+    // and values in the last (unbounded) bucket are reported as the largest
+    // boundary. Use `log_histogram` if precise quantiles are needed.
+    double quantile(double q) const noexcept;
+
+    // Same as `quantile`, for (non-cumulative) `counts` of buckets bounded by
+    // `boundaries`. There's one more count than boundaries.
+    static double quantile_of(const bucket &boundaries,
+                              const std::vector<std::uint64_t> &counts, double q) noexcept;
+
+    const bucket &boundaries() const noexcept { return _bucket_boundaries; }
+
+    // Count of each bucket, the last one being that of values above all the
+    // boundaries.
+    std::vector<std::uint64_t> bucket_counts() const;
+
+    double sum() const noexcept { return _sum.value(); }
+
     cache_metrics collect() const noexcept;
 
   private:
     const bucket _bucket_boundaries;
-    std::vector<counter> _bucket_counts;
+    sharded_counter_array<std::uint64_t> _bucket_counts;
     counter _sum;
 };
 
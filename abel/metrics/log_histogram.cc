@@ -0,0 +1,160 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+
+#include "abel/metrics/log_histogram.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include "abel/metrics/metrics_type.h"
+
+namespace abel {
+namespace metrics {
+
+log_histogram_snapshot::log_histogram_snapshot(int precision_bits, std::size_t bucket_count)
+        : _precision_bits(precision_bits), _counts(bucket_count) {}
+
+double log_histogram_snapshot::mean() const noexcept {
+    return _count ? static_cast<double>(_sum) / _count : 0.0;
+}
+
+std::uint64_t log_histogram_snapshot::quantile(double q) const noexcept {
+    if (!_count) {
+        return 0;
+    }
+    q = std::clamp(q, 0.0, 1.0);
+    // 1-based rank of the value we're looking for.
+    auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(q * _count)));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i != _counts.size(); ++i) {
+        seen += _counts[i];
+        if (seen >= rank) {
+            auto lower = lower_bound_of(i, _precision_bits);
+            auto upper = upper_bound_of(i, _precision_bits);
+            return lower + (upper - lower) / 2;
+        }
+    }
+    // Counts were being updated while the snapshot was taken.
+    return upper_bound_of(_counts.size() - 1, _precision_bits);
+}
+
+void log_histogram_snapshot::merge(const log_histogram_snapshot &other) {
+    assert(_precision_bits == other._precision_bits || _counts.empty());
+    _precision_bits = other._precision_bits;
+    if (_counts.size() < other._counts.size()) {
+        _counts.resize(other._counts.size());
+    }
+    for (std::size_t i = 0; i != other._counts.size(); ++i) {
+        _counts[i] += other._counts[i];
+    }
+    _count += other._count;
+    _sum += other._sum;
+}
+
+std::uint64_t log_histogram_snapshot::lower_bound_of(std::size_t index,
+                                                     int precision_bits) noexcept {
+    auto e = index >> precision_bits;
+    if (!e) {
+        return index;
+    }
+    auto m = index - ((e - 1) << precision_bits);
+    return std::uint64_t(m) << (e - 1);
+}
+
+std::uint64_t log_histogram_snapshot::upper_bound_of(std::size_t index,
+                                                     int precision_bits) noexcept {
+    auto e = index >> precision_bits;
+    if (!e) {
+        return index;
+    }
+    return lower_bound_of(index, precision_bits) + (std::uint64_t(1) << (e - 1)) - 1;
+}
+
+log_histogram::log_histogram(int precision_bits, std::uint64_t max_value,
+                             std::vector<double> quantiles)
+        : _precision_bits(precision_bits),
+          _max_value(max_value),
+          _bucket_count(log_histogram_snapshot::bucket_of(max_value, precision_bits) + 1),
+          _quantiles(std::move(quantiles)) {
+    assert(precision_bits > 0 && precision_bits < 16);
+}
+
+log_histogram::~log_histogram() {
+    for (auto &&e : _shards) {
+        delete e.load(std::memory_order_relaxed);
+    }
+}
+
+void log_histogram::observe(std::uint64_t value, std::uint64_t count) noexcept {
+    auto index = log_histogram_snapshot::bucket_of(std::min(value, _max_value),
+                                                   _precision_bits);
+    auto s = get_shard();
+    s->counts[index].fetch_add(count, std::memory_order_relaxed);
+    s->count.fetch_add(count, std::memory_order_relaxed);
+    s->sum.fetch_add(value * count, std::memory_order_relaxed);
+}
+
+void log_histogram::merge(const log_histogram_snapshot &snapshot) noexcept {
+    assert(snapshot.precision_bits() == _precision_bits || snapshot.counts().empty());
+    auto s = get_shard();
+    auto &&counts = snapshot.counts();
+    for (std::size_t i = 0; i != counts.size(); ++i) {
+        if (counts[i]) {
+            s->counts[std::min(i, _bucket_count - 1)].fetch_add(counts[i],
+                                                               std::memory_order_relaxed);
+        }
+    }
+    s->count.fetch_add(snapshot.count(), std::memory_order_relaxed);
+    s->sum.fetch_add(snapshot.sum(), std::memory_order_relaxed);
+}
+
+log_histogram_snapshot log_histogram::snapshot() const {
+    log_histogram_snapshot rc(_precision_bits, _bucket_count);
+    for (auto &&e : _shards) {
+        auto s = e.load(std::memory_order_acquire);
+        if (!s) {
+            continue;
+        }
+        for (std::size_t i = 0; i != _bucket_count; ++i) {
+            rc._counts[i] += s->counts[i].load(std::memory_order_relaxed);
+        }
+        rc._count += s->count.load(std::memory_order_relaxed);
+        rc._sum += s->sum.load(std::memory_order_relaxed);
+    }
+    return rc;
+}
+
+cache_metrics log_histogram::collect() const noexcept {
+    auto metric = cache_metrics{};
+    metric.type = metrics_type::mt_summary;
+
+    auto s = snapshot();
+    metric.summary.sample_count = s.count();
+    metric.summary.sample_sum = static_cast<double>(s.sum());
+    for (auto &&q : _quantiles) {
+        metric.summary.quantiles.push_back(
+                cache_metrics::cached_quantile{q, static_cast<double>(s.quantile(q))});
+    }
+    return metric;
+}
+
+log_histogram::shard *log_histogram::get_shard() noexcept {
+    auto &&slot = _shards[this_thread_counter_shard()];
+    auto s = slot.load(std::memory_order_acquire);
+    if (ABEL_LIKELY(s)) {
+        return s;
+    }
+    // Allocated on first use, so that histograms only touched by a few threads
+    // don't pay for all the shards.
+    auto allocated = new shard();
+    allocated->counts.reset(new std::atomic<std::uint64_t>[_bucket_count]());
+    if (slot.compare_exchange_strong(s, allocated, std::memory_order_acq_rel)) {
+        return allocated;
+    }
+    delete allocated;  // Someone else allocated it first.
+    return s;
+}
+
+}  // namespace metrics
+}  // namespace abel
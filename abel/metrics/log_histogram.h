@@ -0,0 +1,134 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+
+#ifndef ABEL_METRICS_LOG_HISTOGRAM_H_
+#define ABEL_METRICS_LOG_HISTOGRAM_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "abel/metrics/cache_metrics.h"
+#include "abel/metrics/sharded_counter.h"
+
+namespace abel {
+namespace metrics {
+
+// Counts of a `log_histogram` at some point, merged from all of its shards.
+class log_histogram_snapshot {
+  public:
+    log_histogram_snapshot() = default;
+
+    log_histogram_snapshot(int precision_bits, std::size_t bucket_count);
+
+    std::uint64_t count() const noexcept { return _count; }
+
+    std::uint64_t sum() const noexcept { return _sum; }
+
+    double mean() const noexcept;
+
+    // Returns the value at quantile `q` (in [0, 1]), e.g. `quantile(0.99)` for
+    // p99. The value returned is within the precision of the histogram. 0 is
+    // returned if nothing was observed.
+    std::uint64_t quantile(double q) const noexcept;
+
+    // Adds counts of `other` to us. Both must have the same precision.
+    void merge(const log_histogram_snapshot &other);
+
+    int precision_bits() const noexcept { return _precision_bits; }
+
+    // Count of each bucket.
+    const std::vector<std::uint64_t> &counts() const noexcept { return _counts; }
+
+    // Buckets are numbered as follows (`B` being `precision_bits`):
+    //
+    // - Values below `2^B` have a bucket of their own.
+    // - Values in `[2^(B + e - 1), 2^(B + e))` (for `e >= 1`) are split into
+    //   `2^B` buckets, each of width `2^(e - 1)`.
+    //
+    // Therefore a bucket spans no more than `2^-B` of its values.
+    static std::size_t bucket_of(std::uint64_t value, int precision_bits) noexcept {
+        if (value < (std::uint64_t(1) << precision_bits)) {
+            return value;
+        }
+        int e = 63 - __builtin_clzll(value) - precision_bits + 1;
+        return (std::size_t(e - 1) << precision_bits) + (value >> (e - 1));
+    }
+
+    // Smallest and largest value counted in bucket `index`.
+    static std::uint64_t lower_bound_of(std::size_t index, int precision_bits) noexcept;
+
+    static std::uint64_t upper_bound_of(std::size_t index, int precision_bits) noexcept;
+
+  private:
+    friend class log_histogram;
+
+    int _precision_bits = 0;
+    std::uint64_t _count = 0;
+    std::uint64_t _sum = 0;
+    std::vector<std::uint64_t> _counts;
+};
+
+// Log-linear (HDR-style) histogram of non-negative integers (latencies in
+// nanoseconds, sizes in bytes, etc.)
+//
+// Memory used is fixed by the precision and the largest value tracked. Finding
+// the bucket costs a couple of bit operations. Values are counted into
+// per-thread shards (allocated on first use by a thread), and merged on read.
+class log_histogram {
+  public:
+    static constexpr int kDefaultPrecisionBits = 7;  // Error < 1%.
+    static constexpr std::uint64_t kDefaultMaxValue = std::uint64_t(1) << 40;
+
+    // Values are tracked with relative error below `2^-precision_bits`.
+    // Values greater than `max_value` are counted as `max_value`.
+    //
+    // `quantiles` are reported by `collect()`.
+    explicit log_histogram(int precision_bits = kDefaultPrecisionBits,
+                           std::uint64_t max_value = kDefaultMaxValue,
+                           std::vector<double> quantiles = {0.5, 0.9, 0.99, 0.999});
+
+    ~log_histogram();
+
+    void observe(std::uint64_t value) noexcept { observe(value, 1); }
+
+    // Same as calling `observe(value)` for `count` times.
+    void observe(std::uint64_t value, std::uint64_t count) noexcept;
+
+    // Adds counts in `snapshot` to this histogram. It must be of the same
+    // precision.
+    void merge(const log_histogram_snapshot &snapshot) noexcept;
+
+    log_histogram_snapshot snapshot() const;
+
+    std::uint64_t quantile(double q) const { return snapshot().quantile(q); }
+
+    // Reported as a summary.
+    cache_metrics collect() const noexcept;
+
+  private:
+    struct shard {
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::uint64_t> sum{0};
+        std::unique_ptr<std::atomic<std::uint64_t>[]> counts;
+    };
+
+    shard *get_shard() noexcept;
+
+  private:
+    const int _precision_bits;
+    const std::uint64_t _max_value;
+    const std::size_t _bucket_count;
+    const std::vector<double> _quantiles;
+    std::array<std::atomic<shard *>, kCounterShards> _shards{};
+};
+
+typedef std::shared_ptr<log_histogram> log_histogram_ptr;
+
+}  // namespace metrics
+}  // namespace abel
+
+#endif  // ABEL_METRICS_LOG_HISTOGRAM_H_
@@ -0,0 +1,26 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+
+#include "abel/metrics/metric_registry.h"
+#include <algorithm>
+#include <tuple>
+#include "abel/hash/hash.h"
+
+namespace abel {
+namespace metrics {
+
+metric_key::metric_key(std::string name)
+        : _name(std::move(name)), _hash(abel::hash<std::string>()(_name)) {}
+
+metric_key::metric_key(std::string name,
+                       const std::unordered_map<std::string, std::string> &tags)
+        : _name(std::move(name)), _tags(tags.begin(), tags.end()) {
+    std::sort(_tags.begin(), _tags.end());
+    _hash = abel::hash<std::tuple<const std::string &, const tag_list &>>()(
+            std::tie(_name, _tags));
+}
+
+}  // namespace metrics
+}  // namespace abel
@@ -0,0 +1,125 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+
+#ifndef ABEL_METRICS_METRIC_REGISTRY_H_
+#define ABEL_METRICS_METRIC_REGISTRY_H_
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "abel/thread/thread_cache.h"
+
+namespace abel {
+namespace metrics {
+
+// Name of a metric, optionally with tags attached. The hash is computed on
+// construction, so a key built once (e.g., as a static variable at the call
+// site) makes further lookups cost a hash table probe only:
+//
+//   static const metric_key kRequests("requests");
+//   scope->get_counter(kRequests)->inc(1);
+//
+//   // Same as `scope->tagged({{"tenant", t}})->get_counter("requests")`.
+//   scope->get_counter(metric_key("requests", {{"tenant", t}}))->inc(1);
+class metric_key {
+  public:
+    typedef std::vector<std::pair<std::string, std::string>> tag_list;
+
+    metric_key(const char *name) : metric_key(std::string(name)) {}
+
+    metric_key(std::string name);
+
+    metric_key(std::string name, const std::unordered_map<std::string, std::string> &tags);
+
+    const std::string &name() const noexcept { return _name; }
+
+    // Sorted by tag name.
+    const tag_list &tags() const noexcept { return _tags; }
+
+    bool has_tags() const noexcept { return !_tags.empty(); }
+
+    std::size_t hash() const noexcept { return _hash; }
+
+    bool operator==(const metric_key &other) const noexcept {
+        return _hash == other._hash && _name == other._name && _tags == other._tags;
+    }
+
+  private:
+    std::string _name;
+    tag_list _tags;
+    std::size_t _hash;
+};
+
+struct metric_key_hash {
+    std::size_t operator()(const metric_key &key) const noexcept { return key.hash(); }
+};
+
+// Read-mostly map from `metric_key` to metrics of type `T`.
+//
+// Lookups don't touch any shared mutable state: each thread keeps its own
+// reference to an immutable snapshot of the map (via `thread_cache`), and only
+// takes the slow path when the map has been changed since. Insertions copy the
+// map, so they're O(n). That's fine as metrics are created far less often than
+// they're looked up.
+template<class T>
+class metric_registry {
+  public:
+    typedef std::shared_ptr<T> value_ptr;
+    typedef std::unordered_map<metric_key, value_ptr, metric_key_hash> map_type;
+
+    // Returns nullptr if `key` is not found.
+    value_ptr find(const metric_key &key) const {
+        auto &&map = _snapshot.non_idempotent_get();
+        auto it = map->find(key);
+        return it != map->end() ? it->second : nullptr;
+    }
+
+    // `creator` is called (and its result inserted) if `key` is not found.
+    // It's called with internal lock held, and should return `value_ptr`.
+    template<class F>
+    value_ptr find_or_create(const metric_key &key, F &&creator) {
+        if (auto p = find(key)) {
+            return p;
+        }
+
+        std::unique_lock<std::mutex> lk(_mutex);
+        auto it = _current->find(key);
+        if (it != _current->end()) {
+            return it->second;
+        }
+        value_ptr value = creator();
+        auto next = std::make_shared<map_type>(*_current);
+        next->emplace(key, value);
+        _current = next;
+        _snapshot.emplace(std::move(next));
+        return value;
+    }
+
+    // Consistent view of all metrics in this registry.
+    std::shared_ptr<const map_type> snapshot() const {
+        return _snapshot.non_idempotent_get();
+    }
+
+  private:
+    std::mutex _mutex;  // Serializes writers.
+    // Latest version of the map, guarded by `_mutex`.
+    //
+    // It must outlive `_snapshot`. Snapshots cached by threads are released
+    // with a lock (internal to `thread_cache`) held. Were they holding the last
+    // reference to a metric (e.g., a sub-scope, which has registries of its
+    // own), destroying the metric there would deadlock. As the map only grows,
+    // `_current` holds a reference to every metric that any snapshot does.
+    std::shared_ptr<const map_type> _current = std::make_shared<const map_type>();
+    thread_cache<std::shared_ptr<const map_type>> _snapshot{_current};
+};
+
+}  // namespace metrics
+}  // namespace abel
+
+#endif  // ABEL_METRICS_METRIC_REGISTRY_H_
@@ -13,7 +13,8 @@ enum class metrics_type {
     mt_counter,
     mt_timer,
     mt_gauge,
-    mt_histogram
+    mt_histogram,
+    mt_summary
 };
 
 }  // namespace metrics
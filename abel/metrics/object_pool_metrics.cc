@@ -0,0 +1,58 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+
+#include "abel/metrics/object_pool_metrics.h"
+#include "abel/memory/object_pool_stats.h"
+#include "abel/metrics/metrics_type.h"
+
+namespace abel {
+namespace metrics {
+
+namespace {
+
+void add_counter(std::vector<cache_metrics> &res, const scope_family_ptr &family,
+                 const char *name, std::uint64_t value) {
+    cache_metrics cm;
+    cm.type = metrics_type::mt_counter;
+    cm.name = name;
+    cm.family = family;
+    cm.counter.value = static_cast<double>(value);
+    cm.counter.is_integral = true;
+    cm.counter.int_value = value;
+    res.push_back(std::move(cm));
+}
+
+void add_gauge(std::vector<cache_metrics> &res, const scope_family_ptr &family,
+               const char *name, double value) {
+    cache_metrics cm;
+    cm.type = metrics_type::mt_gauge;
+    cm.name = name;
+    cm.family = family;
+    cm.gauge.value = value;
+    res.push_back(std::move(cm));
+}
+
+}  // namespace
+
+void collect_object_pool_metrics(std::vector<cache_metrics> &res) {
+    for (auto &&stats : get_object_pool_stats()) {
+        scope_family_ptr family(new scope_family(
+                "object_pool", "_", {{"type", stats.type_name}, {"backend", stats.backend}}));
+        add_counter(res, family, "gets_total", stats.gets);
+        add_counter(res, family, "puts_total", stats.puts);
+        add_counter(res, family, "hits_total", stats.hits);
+        add_counter(res, family, "misses_total", stats.misses);
+        add_counter(res, family, "washed_out_total", stats.washed_out);
+        add_counter(res, family, "freed_total", stats.freed);
+        add_gauge(res, family, "alive", stats.alive);
+        add_gauge(res, family, "thread_cached", stats.thread_cached);
+        add_gauge(res, family, "shared_cached", stats.shared_cached);
+        add_gauge(res, family, "threads", stats.threads);
+        add_gauge(res, family, "bytes_cached", stats.bytes_cached);
+    }
+}
+
+}  // namespace metrics
+}  // namespace abel
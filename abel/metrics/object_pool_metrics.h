@@ -0,0 +1,23 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+
+#ifndef ABEL_METRICS_OBJECT_POOL_METRICS_H_
+#define ABEL_METRICS_OBJECT_POOL_METRICS_H_
+
+#include <vector>
+#include "abel/metrics/cache_metrics.h"
+
+namespace abel {
+namespace metrics {
+
+// Appends statistics of object pools (see `abel::get_object_pool_stats()`) to
+// `res`, one series per type, named `object_pool_xxx` and tagged with `type`
+// and `backend`.
+void collect_object_pool_metrics(std::vector<cache_metrics> &res);
+
+}  // namespace metrics
+}  // namespace abel
+
+#endif  // ABEL_METRICS_OBJECT_POOL_METRICS_H_
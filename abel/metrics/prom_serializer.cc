@@ -29,6 +29,9 @@ static void SerializeHistogram(std::ostream &out, const std::string &name,
 static void SerializeGauge(std::ostream &out, const std::string &name,
                            const cache_metrics &metric);
 
+static void SerializeSummary(std::ostream &out, const std::string &name,
+                             const cache_metrics &metric);
+
 static void WriteValue(std::ostream &out, const std::string &value);
 
 static void WriteValue(std::ostream &out, double value);
@@ -92,7 +95,11 @@ void WriteTail(std::ostream &out, const cache_metrics &metrics) {
 
 void SerializeCounter(std::ostream &out, const std::string &name, const cache_metrics &metric) {
     WriteHead(out, name, metric);
-    WriteValue(out, metric.counter.value);
+    if (metric.counter.is_integral) {
+        out << metric.counter.int_value;
+    } else {
+        WriteValue(out, metric.counter.value);
+    }
     WriteTail(out, metric);
 }
 
@@ -129,6 +136,24 @@ void SerializeHistogram(std::ostream &out, const std::string &name,
     }
 }
 
+void SerializeSummary(std::ostream &out, const std::string &name,
+                      const cache_metrics &metric) {
+    auto &sum = metric.summary;
+    WriteHead(out, name, metric, "_count");
+    out << sum.sample_count;
+    WriteTail(out, metric);
+
+    WriteHead(out, name, metric, "_sum");
+    WriteValue(out, sum.sample_sum);
+    WriteTail(out, metric);
+
+    for (auto &q : sum.quantiles) {
+        WriteHead(out, name, metric, "", "quantile", q.quantile);
+        WriteValue(out, q.value);
+        WriteTail(out, metric);
+    }
+}
+
 std::string MakeName(const cache_metrics &metrics) {
     std::string ret;
     ret = metrics.family->prefix;
@@ -159,6 +184,10 @@ void SerializeMetrics(std::ostream &out, const cache_metrics &metrics) {
             out << "# TYPE " << metricsName << " histogram\n";
             SerializeHistogram(out, metricsName, metrics);
             break;
+        case metrics_type::mt_summary:
+            out << "# TYPE " << metricsName << " summary\n";
+            SerializeSummary(out, metricsName, metrics);
+            break;
         default:
             break;
     }
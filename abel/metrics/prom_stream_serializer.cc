@@ -0,0 +1,261 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+
+#include "abel/metrics/prom_stream_serializer.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string_view>
+#include "abel/base/profile.h"
+#include "abel/strings/numbers.h"
+
+namespace abel {
+namespace metrics {
+
+namespace {
+
+// Large enough for both `fast_int_to_buffer` and `six_digits_to_buffer`.
+using number_buffer = char[numbers_internal::kFastToBufferSize];
+
+std::string_view format_uint(std::uint64_t value, number_buffer &buffer) {
+    return std::string_view(buffer, numbers_internal::fast_int_to_buffer(value, buffer) - buffer);
+}
+
+std::string_view format_int(std::int64_t value, number_buffer &buffer) {
+    return std::string_view(buffer, numbers_internal::fast_int_to_buffer(value, buffer) - buffer);
+}
+
+// Same as `prometheus_serializer` for NaN and infinity.
+std::string_view format_double(double value, number_buffer &buffer) {
+    if (std::isnan(value)) {
+        return "Nan";
+    } else if (std::isinf(value)) {
+        return value < 0 ? "-Inf" : "+Inf";
+    }
+    // Integral values (counters, sums of integral samples, etc.) are common,
+    // and are written exactly.
+    constexpr double kMaxExactInteger = 9007199254740992.0;  // 2^53
+    if (value == std::trunc(value) && std::fabs(value) <= kMaxExactInteger) {
+        return format_int(static_cast<std::int64_t>(value), buffer);
+    }
+    auto size = numbers_internal::six_digits_to_buffer(value, buffer);
+    if (ABEL_UNLIKELY(std::strtod(buffer, nullptr) != value)) {
+        // Six digits lose precision of, e.g., large sums, which `rate()` and
+        // friends are computed from. Use the shortest representation that
+        // round-trips then.
+        for (int precision = 15; precision != 18; ++precision) {
+            size = std::snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+            if (std::strtod(buffer, nullptr) == value) {
+                break;
+            }
+        }
+    }
+    return std::string_view(buffer, size);
+}
+
+std::string escape_label_value(const std::string &value) {
+    std::string rc;
+    rc.reserve(value.size());
+    for (auto c : value) {
+        if (c == '\\' || c == '"') {
+            rc += '\\';
+            rc += c;
+        } else if (c == '\n') {
+            rc += "\\n";
+        } else {
+            rc += c;
+        }
+    }
+    return rc;
+}
+
+// Everything needed to write lines of a metric.
+struct line_writer {
+    iobuf_builder *builder;
+    std::string_view name_prefix;
+    std::string_view name;
+    std::string_view labels;
+    std::int64_t timestamp_ms;
+
+    // Writes `name{labels} `.
+    void head(std::string_view suffix) const {
+        if (labels.empty()) {
+            builder->append(name_prefix, name, suffix, " ");
+        } else {
+            builder->append(name_prefix, name, suffix, "{");
+            builder->append(labels, "} ");
+        }
+    }
+
+    // Writes `name{labels,extra_name="extra_value"} `. `extra_value` must not
+    // need escaping.
+    void head(std::string_view suffix, std::string_view extra_name,
+              std::string_view extra_value) const {
+        builder->append(name_prefix, name, suffix, "{");
+        if (!labels.empty()) {
+            builder->append(labels, ",");
+        }
+        builder->append(extra_name, "=\"", extra_value, "\"} ");
+    }
+
+    void value(std::uint64_t v) const {
+        number_buffer buffer;
+        builder->append(format_uint(v, buffer));
+    }
+
+    void value(double v) const {
+        number_buffer buffer;
+        builder->append(format_double(v, buffer));
+    }
+
+    void tail() const {
+        if (timestamp_ms != 0) {
+            number_buffer buffer;
+            builder->append(" ", format_int(timestamp_ms, buffer), "\n");
+        } else {
+            builder->append('\n');
+        }
+    }
+
+    void header(std::string_view type) const {
+        builder->append("# HELP ", name_prefix, name, "\n");
+        builder->append("# TYPE ", name_prefix, name, " ");
+        builder->append(type, "\n");
+    }
+
+    template<class T>
+    void line(std::string_view suffix, T v) const {
+        head(suffix);
+        value(v);
+        tail();
+    }
+
+    void histogram(const cache_metrics::cached_histogram &hist) const {
+        line("_count", hist.sample_count);
+        line("_sum", hist.sample_sum);
+
+        double last = -std::numeric_limits<double>::infinity();
+        for (auto &&b : hist.bucket) {
+            number_buffer le;
+            head("_bucket", "le", format_double(b.upper_bound, le));
+            last = b.upper_bound;
+            value(b.cumulative_count);
+            tail();
+        }
+        if (last != std::numeric_limits<double>::infinity()) {
+            head("_bucket", "le", "+Inf");
+            value(hist.sample_count);
+            tail();
+        }
+    }
+
+    void summary(const cache_metrics::cached_summary &sum) const {
+        line("_count", sum.sample_count);
+        line("_sum", sum.sample_sum);
+        for (auto &&q : sum.quantiles) {
+            number_buffer quantile;
+            head("", "quantile", format_double(q.quantile, quantile));
+            value(q.value);
+            tail();
+        }
+    }
+};
+
+}  // namespace
+
+void prometheus_stream_serializer::serialize(const cache_metrics &metric,
+                                             iobuf_builder *builder) {
+    auto &&family = get_family_cache(metric.family);
+    line_writer writer{builder, family.name_prefix, metric.name, family.labels,
+                       metric.timestamp_ms};
+
+    switch (metric.type) {
+        case metrics_type::mt_counter:
+            writer.header("counter");
+            writer.head("");
+            if (metric.counter.is_integral) {
+                writer.value(metric.counter.int_value);
+            } else {
+                writer.value(metric.counter.value);
+            }
+            writer.tail();
+            break;
+        case metrics_type::mt_gauge:
+            writer.header("gauge");
+            writer.line("", metric.gauge.value);
+            break;
+        case metrics_type::mt_histogram:
+        case metrics_type::mt_timer:
+            writer.header("histogram");
+            writer.histogram(metric.histogram);
+            break;
+        case metrics_type::mt_summary:
+            writer.header("summary");
+            writer.summary(metric.summary);
+            break;
+        default:
+            // `prometheus_serializer` writes `# HELP` for them, nothing else.
+            builder->append("# HELP ", family.name_prefix, metric.name, "\n");
+            break;
+    }
+}
+
+void prometheus_stream_serializer::serialize(const std::vector<cache_metrics> &metrics,
+                                             iobuf_builder *builder) {
+    for (auto &&e : metrics) {
+        serialize(e, builder);
+    }
+    evict_unused_families();
+}
+
+iobuf prometheus_stream_serializer::serialize(scope &s, std::size_t chunk_size) {
+    iobuf_builder builder;
+    s.collect(chunk_size, [&](std::vector<cache_metrics> &chunk) {
+        for (auto &&e : chunk) {
+            serialize(e, &builder);
+        }
+    });
+    evict_unused_families();
+    return builder.destructive_get();
+}
+
+void prometheus_stream_serializer::evict_unused_families() {
+    // Families built on each collection (e.g., by `collect_object_pool_metrics`)
+    // would pile up otherwise.
+    for (auto it = _families.begin(); it != _families.end();) {
+        if (it->second.family.use_count() == 1) {
+            it = _families.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+const prometheus_stream_serializer::family_cache &
+prometheus_stream_serializer::get_family_cache(const scope_family_ptr &family) {
+    auto it = _families.find(family.get());
+    if (ABEL_LIKELY(it != _families.end())) {
+        return it->second;
+    }
+
+    family_cache cache;
+    cache.family = family;
+    cache.name_prefix = family->prefix + family->separator;
+    for (auto &&tag : family->tags) {
+        if (!cache.labels.empty()) {
+            cache.labels += ',';
+        }
+        cache.labels += tag.first;
+        cache.labels += "=\"";
+        cache.labels += escape_label_value(tag.second);
+        cache.labels += '"';
+    }
+    return _families.emplace(family.get(), std::move(cache)).first->second;
+}
+
+}  // namespace metrics
+}  // namespace abel
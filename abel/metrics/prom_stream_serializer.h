@@ -0,0 +1,73 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+
+#ifndef ABEL_METRICS_PROM_STREAM_SERIALIZER_H_
+#define ABEL_METRICS_PROM_STREAM_SERIALIZER_H_
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "abel/io/iobuf.h"
+#include "abel/metrics/cache_metrics.h"
+#include "abel/metrics/scope.h"
+#include "abel/metrics/scope_family.h"
+
+namespace abel {
+namespace metrics {
+
+// Serializes metrics in Prometheus text format directly into an `iobuf`.
+//
+// Unlike `prometheus_serializer`, no `std::ostream` is involved: numbers are
+// formatted with `fast_int_to_buffer` / `six_digits_to_buffer`, and the
+// escaped label block of each `scope_family` is built once and cached. Keep
+// the serializer around (e.g., one per scrape handler) to reuse the cache
+// across scrapes. Families no longer referenced by anyone else are dropped
+// from the cache after serializing a batch of metrics or a scope.
+//
+// Non-integral values are written with 6 significant digits (the same as
+// "%g") if that's exact, with as many as needed to read them back otherwise.
+// Integral ones are written exactly.
+//
+// This class is NOT thread-safe.
+class prometheus_stream_serializer {
+  public:
+    // Metrics are collected from scopes in chunks of this size by default.
+    static constexpr std::size_t kDefaultChunkSize = 1024;
+
+    void serialize(const cache_metrics &metric, iobuf_builder *builder);
+
+    void serialize(const std::vector<cache_metrics> &metrics, iobuf_builder *builder);
+
+    // Collects metrics in `s` (and its sub-scopes) in chunks, and serializes
+    // them as they're collected.
+    iobuf serialize(scope &s, std::size_t chunk_size = kDefaultChunkSize);
+
+    // Drops cached label blocks (and references to families they're of).
+    void clear_cache() { _families.clear(); }
+
+    // Number of families whose label blocks are cached.
+    std::size_t cached_families() const { return _families.size(); }
+
+  private:
+    struct family_cache {
+        scope_family_ptr family;  // Keeps the key below alive.
+        std::string name_prefix;  // `prefix` + `separator`
+        std::string labels;  // `k1="v1",k2="v2"`, escaped.
+    };
+
+    const family_cache &get_family_cache(const scope_family_ptr &family);
+
+    // Drops cached families we hold the last reference to.
+    void evict_unused_families();
+
+  private:
+    std::unordered_map<const scope_family *, family_cache> _families;
+};
+
+}  // namespace metrics
+}  // namespace abel
+
+#endif  // ABEL_METRICS_PROM_STREAM_SERIALIZER_H_
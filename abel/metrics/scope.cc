@@ -5,8 +5,10 @@
 
 #include <sstream>
 #include <algorithm>
+#include <limits>
 
 #include "abel/metrics/scope.h"
+#include "abel/base/profile.h"
 #include "abel/metrics/scope_family.h"
 
 namespace abel {
@@ -24,52 +26,48 @@ std::shared_ptr<scope> scope::new_root_scope(const std::string &prefix, const st
     return s;
 }
 
-std::shared_ptr<counter> scope::get_counter(const std::string &prefix) {
-    std::unique_lock<std::mutex> lk(_counter_mutex);
-    auto it = _counters.find(prefix);
-    if (it != _counters.end()) {
-        return it->second;
-    }
-
-    counter_ptr counterPtr(new counter());
-    _counters[prefix] = counterPtr;
-    return counterPtr;
+std::shared_ptr<counter> scope::get_counter(const metric_key &key) {
+    return _counters.find_or_create(key, [&] {
+        return key.has_tags() ? tagged_scope_of(key)->get_counter(key.name())
+                              : counter_ptr(new counter());
+    });
 }
 
-std::shared_ptr<gauge> scope::get_gauge(const std::string &prefix) {
-    std::unique_lock<std::mutex> lk(_gauge_mutex);
-    auto it = _gauges.find(prefix);
-    if (it != _gauges.end()) {
-        return it->second;
-    }
-
-    gauge_ptr gaugePtr(new gauge());
-    _gauges[prefix] = gaugePtr;
-    return gaugePtr;
+std::shared_ptr<int_counter> scope::get_int_counter(const metric_key &key) {
+    return _int_counters.find_or_create(key, [&] {
+        return key.has_tags() ? tagged_scope_of(key)->get_int_counter(key.name())
+                              : int_counter_ptr(new int_counter());
+    });
 }
 
-std::shared_ptr<histogram> scope::get_histogram(const std::string &prefix, const bucket &bucket) {
-    std::unique_lock<std::mutex> lk(_histogram_mutex);
-    auto it = _histograms.find(prefix);
-    if (it != _histograms.end()) {
-        return it->second;
-    }
+std::shared_ptr<gauge> scope::get_gauge(const metric_key &key) {
+    return _gauges.find_or_create(key, [&] {
+        return key.has_tags() ? tagged_scope_of(key)->get_gauge(key.name())
+                              : gauge_ptr(new gauge());
+    });
+}
 
-    histogram_ptr histogramPtr(new histogram(bucket));
-    _histograms[prefix] = histogramPtr;
-    return histogramPtr;
+std::shared_ptr<histogram> scope::get_histogram(const metric_key &key, const bucket &bucket) {
+    return _histograms.find_or_create(key, [&] {
+        return key.has_tags() ? tagged_scope_of(key)->get_histogram(key.name(), bucket)
+                              : histogram_ptr(new histogram(bucket));
+    });
 }
 
-std::shared_ptr<timer> scope::get_timer(const std::string &prefix, const bucket &bucket) {
-    std::unique_lock<std::mutex> lk(_timer_mutex);
-    auto it = _timers.find(prefix);
-    if (it != _timers.end()) {
-        return it->second;
-    }
+std::shared_ptr<log_histogram> scope::get_log_histogram(const metric_key &key,
+                                                       int precision_bits) {
+    return _log_histograms.find_or_create(key, [&] {
+        return key.has_tags()
+               ? tagged_scope_of(key)->get_log_histogram(key.name(), precision_bits)
+               : log_histogram_ptr(new log_histogram(precision_bits));
+    });
+}
 
-    timer_ptr timerPtr = timer::new_timer(bucket);
-    _timers[prefix] = timerPtr;
-    return timerPtr;
+std::shared_ptr<timer> scope::get_timer(const metric_key &key, const bucket &bucket) {
+    return _timers.find_or_create(key, [&] {
+        return key.has_tags() ? tagged_scope_of(key)->get_timer(key.name(), bucket)
+                              : timer::new_timer(bucket);
+    });
 }
 
 std::shared_ptr<scope> scope::sub_scope(const std::string &prefix) {
@@ -94,50 +92,60 @@ std::string scope::prefix() const {
 }
 
 void scope::collect(std::vector<cache_metrics> &res) {
+    collect(res, std::numeric_limits<std::size_t>::max(), nullptr);
+}
 
-    {
-        std::unique_lock<std::mutex> lk(_counter_mutex);
-        for (auto const &counter : _counters) {
-            auto cm = counter.second->collect();
-            cm.name = counter.first;
-            cm.family = _family;
-            res.push_back(cm);
-        }
+void scope::collect(std::size_t chunk_size,
+                    const abel::function<void(std::vector<cache_metrics> &)> &sink) {
+    std::vector<cache_metrics> res;
+    res.reserve(chunk_size);
+    collect(res, std::max<std::size_t>(chunk_size, 1), &sink);
+    if (!res.empty()) {
+        sink(res);
     }
-    {
-        std::unique_lock<std::mutex> lk(_gauge_mutex);
-        for (auto const &gauge : _gauges) {
-            auto gm = gauge.second->collect();
-            gm.name = gauge.first;
-            gm.family = _family;
-            res.push_back(gm);
+}
+
+void scope::collect(std::vector<cache_metrics> &res, std::size_t chunk_size,
+                    const abel::function<void(std::vector<cache_metrics> &)> *sink) {
+    auto push = [&](cache_metrics &&cm) {
+        cm.family = _family;
+        res.push_back(std::move(cm));
+        if (ABEL_UNLIKELY(res.size() >= chunk_size)) {
+            (*sink)(res);
+            res.clear();
         }
-    }
-    {
-        std::unique_lock<std::mutex> lk(_histogram_mutex);
-        for (auto const &histogram : _histograms) {
-            auto hm = histogram.second->collect();
-            hm.name = histogram.first;
-            hm.family = _family;
-            res.push_back(hm);
+    };
+
+    // Metrics registered with tagged keys are collected by their own scope.
+    auto collect_from = [&](auto &&registry) {
+        for (auto const &metric : *registry.snapshot()) {
+            if (metric.first.has_tags()) {
+                continue;
+            }
+            auto cm = metric.second->collect();
+            cm.name = metric.first.name();
+            push(std::move(cm));
         }
-    }
-    {
-        std::unique_lock<std::mutex> lk(_timer_mutex);
-        for (auto const &timer : _timers) {
-            auto tm = timer.second->collect();
-            tm.name = timer.first;
-            tm.family = _family;
-            res.push_back(tm);
+    };
+
+    collect_from(_counters);
+    collect_from(_int_counters);
+    collect_from(_gauges);
+    collect_from(_histograms);
+    collect_from(_log_histograms);
+    collect_from(_timers);
+
+    for (auto const &timer : *_timers.snapshot()) {
+        if (timer.first.has_tags()) {
+            continue;
         }
-
+        auto qm = timer.second->collect_quantiles();
+        qm.name = timer.first.name() + "_quantiles";
+        push(std::move(qm));
     }
 
-    {
-        std::unique_lock<std::mutex> lk(_scope_mutex);
-        for (auto const &scope : _scopes) {
-            scope.second->collect(res);
-        }
+    for (auto const &scope : *_scopes.snapshot()) {
+        scope.second->collect(res, chunk_size, sink);
     }
 }
 
@@ -200,17 +208,15 @@ std::shared_ptr<scope> scope::sub_scope(
 
     auto id = scope_id(prefix, new_tags);
 
-    std::lock_guard<std::mutex> lock(_scope_mutex);
-    auto it = _scopes.find(id);
-    if (it != _scopes.end()) {
-        return it->second;
-    }
-
-    scope_family_ptr sf(new scope_family(prefix, _family->separator, new_tags));
-    std::shared_ptr<scope> s(new scope(sf));
+    return _scopes.find_or_create(id, [&] {
+        scope_family_ptr sf(new scope_family(prefix, _family->separator, new_tags));
+        return std::shared_ptr<scope>(new scope(sf));
+    });
+}
 
-    _scopes[id] = s;
-    return s;
+std::shared_ptr<scope> scope::tagged_scope_of(const metric_key &key) {
+    return tagged(std::unordered_map<std::string, std::string>(key.tags().begin(),
+                                                               key.tags().end()));
 }
 
 }  // namespace metrics
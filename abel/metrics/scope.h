@@ -7,13 +7,16 @@
 #define ABEL_METRICS_SCOPE_H_
 
 
+#include "abel/functional/function.h"
 #include "abel/metrics/counter.h"
 #include "abel/metrics/gauge.h"
 #include "abel/metrics/histogram.h"
+#include "abel/metrics/log_histogram.h"
 #include "abel/metrics/cache_metrics.h"
+#include "abel/metrics/metric_registry.h"
+#include "abel/metrics/scope_family.h"
 #include "abel/metrics/timer.h"
 #include <memory>
-#include <mutex>
 #include <string>
 
 namespace abel {
@@ -24,19 +27,31 @@ class scope;
 
 typedef std::shared_ptr<scope> scope_ptr;
 
+// Metrics are looked up without locking (@sa: `metric_registry`), so calling
+// `get_xxx` on hot path is fine. Callers that look up the same metric
+// repeatedly can save hashing its name by passing a `metric_key` built once.
+//
+// Metrics looked up with a tagged `metric_key` are the same as those returned
+// by `tagged(tags)->get_xxx(name)`.
 class scope {
   public:
 
     static std::shared_ptr<scope> new_root_scope(const std::string &prefix, const std::string &separator,
                                                  const std::unordered_map<std::string, std::string> &tags);
 
-    std::shared_ptr<counter> get_counter(const std::string &prefix);
+    std::shared_ptr<counter> get_counter(const metric_key &key);
 
-    std::shared_ptr<gauge> get_gauge(const std::string &prefix);
+    std::shared_ptr<int_counter> get_int_counter(const metric_key &key);
 
-    std::shared_ptr<histogram> get_histogram(const std::string &prefix, const bucket &bucket);
+    std::shared_ptr<gauge> get_gauge(const metric_key &key);
 
-    std::shared_ptr<timer> get_timer(const std::string &prefix, const bucket &bucket);
+    std::shared_ptr<histogram> get_histogram(const metric_key &key, const bucket &bucket);
+
+    // `precision_bits` only takes effect when the histogram is created.
+    std::shared_ptr<log_histogram> get_log_histogram(
+            const metric_key &key, int precision_bits = log_histogram::kDefaultPrecisionBits);
+
+    std::shared_ptr<timer> get_timer(const metric_key &key, const bucket &bucket);
 
     std::shared_ptr<scope> sub_scope(const std::string &prefix);
 
@@ -50,11 +65,23 @@ class scope {
 
     void collect(std::vector<cache_metrics> &res);
 
+    // Same as `collect(res)`, except that metrics are passed to `sink` in
+    // chunks (of no more than `chunk_size` metrics), so that metrics of a huge
+    // registry are never held in memory at once. `sink` may leave its argument
+    // in any state, it's cleared before being reused.
+    void collect(std::size_t chunk_size,
+                 const abel::function<void(std::vector<cache_metrics> &)> &sink);
+
   private:
     scope(const scope_family_ptr &family);
 
     std::string fully_qualified_name(const std::string &name);
 
+    // `sink` is called each time `res` has `chunk_size` metrics. It can be
+    // nullptr if `chunk_size` is never reached.
+    void collect(std::vector<cache_metrics> &res, std::size_t chunk_size,
+                 const abel::function<void(std::vector<cache_metrics> &)> *sink);
+
     std::string scope_id(
             const std::string &prefix,
             const std::unordered_map<std::string, std::string> &tags);
@@ -63,20 +90,21 @@ class scope {
             const std::string &prefix,
             const std::unordered_map<std::string, std::string> &tags);
 
+    // Scope in which metrics looked up by a tagged `key` live.
+    std::shared_ptr<scope> tagged_scope_of(const metric_key &key);
+
 
   private:
     scope_family_ptr _family;
-    std::unordered_map<std::string, counter_ptr> _counters;
-    std::unordered_map<std::string, gauge_ptr> _gauges;
-    std::unordered_map<std::string, histogram_ptr> _histograms;
-    std::unordered_map<std::string, scope_ptr> _scopes;
-    std::unordered_map<std::string, timer_ptr> _timers;
-
-    std::mutex _counter_mutex;
-    std::mutex _gauge_mutex;
-    std::mutex _histogram_mutex;
-    std::mutex _scope_mutex;
-    std::mutex _timer_mutex;
+    // Metrics looked up with a tagged key are owned (and collected) by the
+    // tagged sub-scope, they're registered here to speed up lookups only.
+    metric_registry<counter> _counters;
+    metric_registry<int_counter> _int_counters;
+    metric_registry<gauge> _gauges;
+    metric_registry<histogram> _histograms;
+    metric_registry<log_histogram> _log_histograms;
+    metric_registry<scope> _scopes;
+    metric_registry<timer> _timers;
 };
 
 
@@ -0,0 +1,19 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+
+#include "abel/metrics/sharded_counter.h"
+
+namespace abel {
+namespace metrics {
+
+std::size_t this_thread_counter_shard() noexcept {
+    static std::atomic<std::size_t> next_shard{0};
+    thread_local std::size_t shard =
+            next_shard.fetch_add(1, std::memory_order_relaxed) % kCounterShards;
+    return shard;
+}
+
+}  // namespace metrics
+}  // namespace abel
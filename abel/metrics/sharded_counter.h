@@ -0,0 +1,119 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+
+#ifndef ABEL_METRICS_SHARDED_COUNTER_H_
+#define ABEL_METRICS_SHARDED_COUNTER_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include "abel/base/profile.h"
+
+namespace abel {
+namespace metrics {
+
+// Number of slots in each `sharded_counter`.
+constexpr std::size_t kCounterShards = 16;
+
+// Number of shards in each `sharded_counter_array`.
+constexpr std::size_t kCounterArrayShards = 4;
+
+// Slot used by the calling thread. Threads are assigned to slots in a
+// round-robin fashion on their first call.
+std::size_t this_thread_counter_shard() noexcept;
+
+// A value that is only ever added to, split into per-thread slots, each in its
+// own cache line. Updating it is a relaxed add on a slot shared with few other
+// threads (once there are more than `kCounterShards` threads, slots are
+// shared, so contention is reduced, not eliminated). Reading it sums up all the
+// slots.
+//
+// That's `kCounterShards` cache lines a counter, meant for standalone counters
+// on hot paths. Use `sharded_counter_array` for groups of counters such as
+// histogram buckets.
+template<class T>
+class sharded_counter {
+    static_assert(std::is_arithmetic_v<T>);
+
+  public:
+    void add(T value) noexcept {
+        auto &&slot = _slots[this_thread_counter_shard()].value;
+        if constexpr (std::is_integral_v<T>) {
+            slot.fetch_add(value, std::memory_order_relaxed);
+        } else {
+            // `fetch_add` on `std::atomic<double>` is not available until C++20.
+            auto current = slot.load(std::memory_order_relaxed);
+            while (!slot.compare_exchange_weak(current, current + value,
+                                               std::memory_order_relaxed));
+        }
+    }
+
+    T sum() const noexcept {
+        T rc{};
+        for (auto &&e : _slots) {
+            rc += e.value.load(std::memory_order_relaxed);
+        }
+        return rc;
+    }
+
+  private:
+    struct alignas(hardware_destructive_interference_size) slot {
+        std::atomic<T> value{};
+    };
+    std::array<slot, kCounterShards> _slots;
+};
+
+// A fixed number of integral counters (e.g. the buckets of a histogram),
+// split into `kCounterArrayShards` shards. A shard holds all the counters next
+// to each other, and starts a cache line of its own. Threads updating
+// different counters of the same shard do contend, but that takes
+// `kCounterArrayShards` rows of counters instead of `kCounterShards` cache
+// lines for each counter.
+template<class T>
+class sharded_counter_array {
+    static_assert(std::is_integral_v<T>);
+
+  public:
+    explicit sharded_counter_array(std::size_t size)
+            : _size(size), _lines_per_shard((size + kPerLine - 1) / kPerLine),
+              _lines(std::make_unique<line[]>(_lines_per_shard * kCounterArrayShards)) {}
+
+    std::size_t size() const noexcept { return _size; }
+
+    void add(std::size_t index, T value) noexcept {
+        auto shard = this_thread_counter_shard() % kCounterArrayShards;
+        slot_of(shard, index).fetch_add(value, std::memory_order_relaxed);
+    }
+
+    T sum(std::size_t index) const noexcept {
+        T rc{};
+        for (std::size_t shard = 0; shard != kCounterArrayShards; ++shard) {
+            rc += slot_of(shard, index).load(std::memory_order_relaxed);
+        }
+        return rc;
+    }
+
+  private:
+    static constexpr std::size_t kPerLine = hardware_destructive_interference_size / sizeof(std::atomic<T>);
+
+    struct alignas(hardware_destructive_interference_size) line {
+        std::atomic<T> values[kPerLine] = {};
+    };
+
+    std::atomic<T> &slot_of(std::size_t shard, std::size_t index) const noexcept {
+        return _lines[shard * _lines_per_shard + index / kPerLine].values[index % kPerLine];
+    }
+
+    const std::size_t _size;
+    const std::size_t _lines_per_shard;
+    std::unique_ptr<line[]> _lines;
+};
+
+}  // namespace metrics
+}  // namespace abel
+
+#endif  // ABEL_METRICS_SHARDED_COUNTER_H_
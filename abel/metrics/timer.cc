@@ -12,7 +12,7 @@ namespace abel {
 namespace metrics {
 
 timer::timer(const bucket &buckets)
-        : _bucket_boundaries{buckets}, _bucket_counts{buckets.size() + 1}, _sum{} {
+        : _bucket_boundaries{buckets}, _bucket_counts(buckets.size() + 1), _sum{} {
     assert(std::is_sorted(std::begin(_bucket_boundaries),
                           std::end(_bucket_boundaries)));
 }
@@ -27,11 +27,12 @@ void timer::observe(abel::duration d) {
     auto value = d.to_double_microseconds();
     const auto bucket_index = static_cast<std::size_t>(std::distance(
             _bucket_boundaries.begin(),
-            std::find_if(
-                    std::begin(_bucket_boundaries), std::end(_bucket_boundaries),
-                    [value](const double boundary) { return boundary >= value; })));
-    _sum.inc(value);
-    _bucket_counts[bucket_index].inc();
+            std::lower_bound(std::begin(_bucket_boundaries), std::end(_bucket_boundaries),
+                             value)));
+    auto nanoseconds = std::max<std::int64_t>(0, d.to_int64_nanoseconds());
+    _sum.inc(nanoseconds);
+    _bucket_counts.add(bucket_index, 1);
+    _latency.observe(nanoseconds);
 
 }
 
@@ -56,7 +57,7 @@ cache_metrics timer::collect() const noexcept {
 
     auto cumulative_count = 0ULL;
     for (std::size_t i{0}; i < _bucket_counts.size(); ++i) {
-        cumulative_count += _bucket_counts[i].value();
+        cumulative_count += _bucket_counts.sum(i);
         auto bucket = cache_metrics::cached_bucket{};
         bucket.cumulative_count = cumulative_count;
         bucket.upper_bound = (i == _bucket_boundaries.size()
@@ -65,10 +66,23 @@ cache_metrics timer::collect() const noexcept {
         metric.histogram.bucket.push_back(std::move(bucket));
     }
     metric.histogram.sample_count = cumulative_count;
-    metric.histogram.sample_sum = _sum.value();
+    metric.histogram.sample_sum = _sum.value() / 1000.0;
 
     return metric;
 }
 
+abel::duration timer::quantile(double q) const noexcept {
+    return abel::duration::nanoseconds(static_cast<std::int64_t>(_latency.quantile(q)));
+}
+
+cache_metrics timer::collect_quantiles() const noexcept {
+    auto metric = _latency.collect();
+    metric.summary.sample_sum /= 1000.0;
+    for (auto &&e : metric.summary.quantiles) {
+        e.value /= 1000.0;
+    }
+    return metric;
+}
+
 }  // namespace metrics
 }  // namespace abel
@@ -12,6 +12,7 @@
 #include "abel/metrics/counter.h"
 #include "abel/metrics/bucket.h"
 #include "abel/metrics/cache_metrics.h"
+#include "abel/metrics/log_histogram.h"
 
 namespace abel {
 namespace metrics {
@@ -26,6 +27,13 @@ class timer : public std::enable_shared_from_this<timer> {
 
     cache_metrics collect() const noexcept;
 
+    // Duration at quantile `q` (in [0, 1]), e.g. `quantile(0.99)` for p99.
+    // Precise to about 3% (of the duration).
+    abel::duration quantile(double q) const noexcept;
+
+    // Quantiles (in microseconds, same as `collect()`) as a summary.
+    cache_metrics collect_quantiles() const noexcept;
+
     static std::shared_ptr<timer> new_timer(const bucket &buckets);
 
     void record(abel::time_point start);
@@ -35,8 +43,11 @@ class timer : public std::enable_shared_from_this<timer> {
 
   private:
     const bucket _bucket_boundaries;
-    std::vector<counter> _bucket_counts;
-    counter _sum;
+    sharded_counter_array<std::uint64_t> _bucket_counts;
+    // In nanoseconds.
+    int_counter _sum;
+    // In nanoseconds.
+    log_histogram _latency{5};
 };
 
 typedef std::shared_ptr<timer> timer_ptr;
@@ -0,0 +1,154 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+
+#include "abel/metrics/window.h"
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <thread>
+#include "abel/memory/non_destroy.h"
+#include "abel/thread/thread.h"
+
+namespace abel {
+namespace metrics {
+
+namespace window_internal {
+
+namespace {
+
+struct sampled {
+    void *object;
+    sample_fn take_sample;
+};
+
+struct sampler {
+    std::mutex lock;
+    std::vector<sampled> objects;
+    bool started = false;
+    bool enabled = true;
+};
+
+sampler *get_sampler() {
+    static non_destroy<sampler> s;
+    return s.get();
+}
+
+// Never returns. The thread is left running until the process exits.
+void sampler_proc() {
+    abel::thread::set_name("metrics_sampler");
+
+    auto s = get_sampler();
+    auto next = std::chrono::steady_clock::now();
+    while (true) {
+        next += std::chrono::seconds(1);
+        std::this_thread::sleep_until(next);
+        {
+            std::unique_lock<std::mutex> lk(s->lock);
+            if (s->enabled) {
+                for (auto &&e : s->objects) {
+                    e.take_sample(e.object);
+                }
+            }
+        }
+        // If we're lagging behind (the machine is overloaded, or the process
+        // was stopped), don't try to catch up with a burst of samples.
+        auto now = std::chrono::steady_clock::now();
+        if (now - next > std::chrono::seconds(1)) {
+            next = now;
+        }
+    }
+}
+
+}  // namespace
+
+void register_sampled(void *object, sample_fn take_sample) {
+    auto s = get_sampler();
+    std::unique_lock<std::mutex> lk(s->lock);
+    s->objects.push_back(sampled{object, take_sample});
+    if (!s->started) {
+        std::thread(sampler_proc).detach();
+        s->started = true;
+    }
+}
+
+void unregister_sampled(void *object) {
+    auto s = get_sampler();
+    // Once we return, `object` won't be touched by the sampler anymore, as it
+    // samples objects with the lock held.
+    std::unique_lock<std::mutex> lk(s->lock);
+    auto it = std::find_if(s->objects.begin(), s->objects.end(),
+                           [&](const sampled &e) { return e.object == object; });
+    assert(it != s->objects.end());
+    s->objects.erase(it);
+}
+
+void set_sampler_enabled(bool enabled) {
+    auto s = get_sampler();
+    std::unique_lock<std::mutex> lk(s->lock);
+    s->enabled = enabled;
+}
+
+}  // namespace window_internal
+
+window<histogram>::window(const bucket &buckets, std::size_t window_seconds)
+        : window(std::make_shared<histogram>(buckets), window_seconds) {}
+
+window<histogram>::window(std::shared_ptr<histogram> source, std::size_t window_seconds)
+        : _source(std::move(source)),
+          _window_seconds(window_seconds),
+          _samples(window_seconds + 1) {
+    assert(window_seconds > 0);
+    window_internal::register_sampled(this);
+}
+
+window<histogram>::~window() { window_internal::unregister_sampled(this); }
+
+double window<histogram>::quantile(double q) const {
+    return histogram::quantile_of(_source->boundaries(), delta().counts, q);
+}
+
+std::uint64_t window<histogram>::count() const {
+    auto counts = delta().counts;
+    return std::accumulate(counts.begin(), counts.end(), std::uint64_t(0));
+}
+
+double window<histogram>::sum() const { return delta().sum; }
+
+double window<histogram>::average() const {
+    auto d = delta();
+    auto count = std::accumulate(d.counts.begin(), d.counts.end(), std::uint64_t(0));
+    return count ? d.sum / count : 0.0;
+}
+
+std::vector<std::uint64_t> window<histogram>::bucket_counts() const { return delta().counts; }
+
+void window<histogram>::take_sample() {
+    sample s;
+    s.counts = _source->bucket_counts();
+    s.sum = _source->sum();
+    std::unique_lock<std::mutex> lk(_mutex);
+    _samples.push(std::move(s));
+}
+
+window<histogram>::sample window<histogram>::delta() const {
+    sample rc;
+    rc.counts.resize(_source->boundaries().size() + 1);
+
+    std::unique_lock<std::mutex> lk(_mutex);
+    auto span = std::min(_window_seconds, _samples.size() ? _samples.size() - 1 : 0);
+    if (!span) {
+        return rc;
+    }
+    auto &&latest = _samples.recent(0);
+    auto &&oldest = _samples.recent(span);
+    for (std::size_t i = 0; i != rc.counts.size(); ++i) {
+        rc.counts[i] = latest.counts[i] - oldest.counts[i];
+    }
+    rc.sum = latest.sum - oldest.sum;
+    return rc;
+}
+
+}  // namespace metrics
+}  // namespace abel
@@ -0,0 +1,324 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+
+#ifndef ABEL_METRICS_WINDOW_H_
+#define ABEL_METRICS_WINDOW_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "abel/base/profile.h"
+#include "abel/metrics/cache_metrics.h"
+#include "abel/metrics/counter.h"
+#include "abel/metrics/histogram.h"
+#include "abel/metrics/metrics_type.h"
+#include "abel/metrics/sharded_counter.h"
+
+// Metrics over a sliding window of recent seconds, for in-process logic that
+// needs to react to recent load (load shedding, concurrency limits, etc.)
+//
+// Writers update the underlying metric as usual, so the hot path costs the
+// same as that of a plain counter / histogram. A single background thread
+// samples all windows once a second into a ring of samples, and readers
+// compute the result from those samples. Therefore results lag by no more than
+// a second.
+//
+//   static per_second<int_counter> qps;
+//   qps.source()->inc();                  // Hot path.
+//   if (qps.value() > kMaxQps) { ... }    // Average QPS in the last 10 seconds.
+
+namespace abel {
+namespace metrics {
+
+namespace window_internal {
+
+// Takes a sample of `object`. Called by the sampler, with its internal lock
+// held.
+typedef void (*sample_fn)(void *object);
+
+// Once registered, `take_sample(object)` is called once a second until the
+// object is unregistered. Objects must be registered once what `take_sample`
+// touches is constructed, and unregistered before it's destroyed.
+//
+// The sampler calls a plain function, fixed at registration. It never looks at
+// the object's vtable, which changes while the object (if polymorphic) is
+// being constructed or destroyed.
+void register_sampled(void *object, sample_fn take_sample);
+
+void unregister_sampled(void *object);
+
+// Registers `object`, sampled by calling `T::take_sample()` on it.
+template<class T>
+void register_sampled(T *object) {
+    register_sampled(object, [](void *p) { static_cast<T *>(p)->T::take_sample(); });
+}
+
+// FOR TESTING PURPOSE ONLY. Pauses / resumes the background sampler, so that
+// tests can take samples by hand.
+void set_sampler_enabled(bool enabled);
+
+// The `capacity` most recent samples.
+template<class S>
+class sample_ring {
+  public:
+    explicit sample_ring(std::size_t capacity) : _samples(capacity) {}
+
+    void push(S sample) {
+        _samples[_next] = std::move(sample);
+        _next = (_next + 1) % _samples.size();
+        _size = std::min(_size + 1, _samples.size());
+    }
+
+    std::size_t size() const noexcept { return _size; }
+
+    // `i`-th most recent sample, 0 being the latest one. `i` must be less than
+    // `size()`.
+    const S &recent(std::size_t i) const noexcept {
+        assert(i < _size);
+        return _samples[(_next + _samples.size() - 1 - i) % _samples.size()];
+    }
+
+  private:
+    std::vector<S> _samples;
+    std::size_t _next = 0;
+    std::size_t _size = 0;
+};
+
+}  // namespace window_internal
+
+constexpr std::size_t kDefaultWindowSeconds = 10;
+
+// Increment of a counter (`counter` or `int_counter`) in the last N seconds.
+template<class T>
+class window {
+  public:
+    typedef decltype(std::declval<const T &>().value()) value_type;
+
+    explicit window(std::size_t window_seconds = kDefaultWindowSeconds)
+            : window(std::make_shared<T>(), window_seconds) {}
+
+    // Tracks an existing counter, e.g. one returned by `scope::get_counter`.
+    explicit window(std::shared_ptr<T> source,
+                    std::size_t window_seconds = kDefaultWindowSeconds)
+            : _source(std::move(source)),
+              _window_seconds(window_seconds),
+              _samples(window_seconds + 1) {
+        assert(window_seconds > 0);
+        window_internal::register_sampled(this);
+    }
+
+    ~window() { window_internal::unregister_sampled(this); }
+
+    // Counter to increment.
+    T *source() const noexcept { return _source.get(); }
+
+    // Increment in the last `window_seconds` seconds (or since we were created,
+    // if that's more recent).
+    value_type value() const { return value(_window_seconds); }
+
+    // Increment in the last `seconds` (no more than `window_seconds`) seconds.
+    value_type value(std::size_t seconds) const { return increment_of(seconds).first; }
+
+    std::size_t window_seconds() const noexcept { return _window_seconds; }
+
+    void take_sample() {
+        auto value = _source->value();
+        std::unique_lock<std::mutex> lk(_mutex);
+        _samples.push(value);
+    }
+
+  protected:
+    // Increment in the last `seconds` seconds, and the number of seconds it
+    // actually spans (which is less than `seconds` if we don't have enough
+    // samples yet).
+    std::pair<value_type, std::size_t> increment_of(std::size_t seconds) const {
+        std::unique_lock<std::mutex> lk(_mutex);
+        auto span = std::min(seconds, _samples.size() ? _samples.size() - 1 : 0);
+        if (!span) {
+            return {value_type{}, 0};
+        }
+        return {_samples.recent(0) - _samples.recent(span), span};
+    }
+
+  private:
+    const std::shared_ptr<T> _source;
+    const std::size_t _window_seconds;
+    mutable std::mutex _mutex;
+    window_internal::sample_ring<value_type> _samples;
+};
+
+// Average increment per second of a counter in the last N seconds.
+template<class T>
+class per_second : public window<T> {
+  public:
+    using window<T>::window;
+
+    // Average rate in the last `window_seconds` seconds (or since we were
+    // created, if that's more recent).
+    double value() const { return value(this->window_seconds()); }
+
+    double value(std::size_t seconds) const {
+        auto[increment, span] = this->increment_of(seconds);
+        return span ? static_cast<double>(increment) / span : 0.0;
+    }
+
+    // Reported as a gauge.
+    cache_metrics collect() const {
+        auto metric = cache_metrics{};
+        metric.type = metrics_type::mt_gauge;
+        metric.gauge.value = value();
+        return metric;
+    }
+};
+
+// Distribution of values observed by a histogram in the last N seconds.
+template<>
+class window<histogram> {
+  public:
+    window(const bucket &buckets, std::size_t window_seconds = kDefaultWindowSeconds);
+
+    // Tracks an existing histogram, e.g. one returned by `scope::get_histogram`.
+    explicit window(std::shared_ptr<histogram> source,
+                    std::size_t window_seconds = kDefaultWindowSeconds);
+
+    ~window();
+
+    // Histogram to observe values with.
+    histogram *source() const noexcept { return _source.get(); }
+
+    // Value at quantile `q` of values observed in the window, interpolated as
+    // `histogram::quantile` does. 0 if nothing was observed.
+    double quantile(double q) const;
+
+    // Number of values observed in the window.
+    std::uint64_t count() const;
+
+    // Sum of values observed in the window.
+    double sum() const;
+
+    // 0 if nothing was observed.
+    double average() const;
+
+    // Counts of each bucket in the window.
+    std::vector<std::uint64_t> bucket_counts() const;
+
+    std::size_t window_seconds() const noexcept { return _window_seconds; }
+
+    void take_sample();
+
+  private:
+    struct sample {
+        std::vector<std::uint64_t> counts;
+        double sum = 0.0;
+    };
+
+    // Difference between the latest sample and the oldest one in the window.
+    sample delta() const;
+
+  private:
+    const std::shared_ptr<histogram> _source;
+    const std::size_t _window_seconds;
+    mutable std::mutex _mutex;
+    window_internal::sample_ring<sample> _samples;
+};
+
+namespace window_internal {
+
+struct max_policy {
+    static constexpr double kIdentity = -std::numeric_limits<double>::infinity();
+
+    static bool prefer(double a, double b) noexcept { return a > b; }
+};
+
+struct min_policy {
+    static constexpr double kIdentity = std::numeric_limits<double>::infinity();
+
+    static bool prefer(double a, double b) noexcept { return a < b; }
+};
+
+// Maximum / minimum of values updated in the last N seconds. Updates go into
+// per-thread slots, which the sampler folds into a sample each second.
+template<class Policy>
+class window_extreme final {
+  public:
+    explicit window_extreme(std::size_t window_seconds = kDefaultWindowSeconds)
+            : _window_seconds(window_seconds), _samples(window_seconds) {
+        assert(window_seconds > 0);
+        register_sampled(this);
+    }
+
+    ~window_extreme() { unregister_sampled(this); }
+
+    void update(double value) noexcept {
+        auto &&slot = _slots[this_thread_counter_shard()].value;
+        auto current = slot.load(std::memory_order_relaxed);
+        while (Policy::prefer(value, current) &&
+               !slot.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Extreme of values updated in the last `window_seconds` seconds, not
+    // including those updated after the latest sample. 0 if there was none.
+    double value() const {
+        std::unique_lock<std::mutex> lk(_mutex);
+        auto rc = Policy::kIdentity;
+        for (std::size_t i = 0; i != _samples.size(); ++i) {
+            if (Policy::prefer(_samples.recent(i), rc)) {
+                rc = _samples.recent(i);
+            }
+        }
+        return rc == Policy::kIdentity ? 0.0 : rc;
+    }
+
+    std::size_t window_seconds() const noexcept { return _window_seconds; }
+
+    // Reported as a gauge.
+    cache_metrics collect() const {
+        auto metric = cache_metrics{};
+        metric.type = metrics_type::mt_gauge;
+        metric.gauge.value = value();
+        return metric;
+    }
+
+    void take_sample() {
+        auto rc = Policy::kIdentity;
+        for (auto &&e : _slots) {
+            auto v = e.value.exchange(Policy::kIdentity, std::memory_order_relaxed);
+            if (Policy::prefer(v, rc)) {
+                rc = v;
+            }
+        }
+        std::unique_lock<std::mutex> lk(_mutex);
+        _samples.push(rc);
+    }
+
+  private:
+    struct alignas(hardware_destructive_interference_size) slot {
+        std::atomic<double> value{Policy::kIdentity};
+    };
+
+    const std::size_t _window_seconds;
+    std::array<slot, kCounterShards> _slots;
+    mutable std::mutex _mutex;
+    sample_ring<double> _samples;  // Extreme of each second.
+};
+
+}  // namespace window_internal
+
+typedef window_internal::window_extreme<window_internal::max_policy> window_max;
+typedef window_internal::window_extreme<window_internal::min_policy> window_min;
+
+}  // namespace metrics
+}  // namespace abel
+
+#endif  // ABEL_METRICS_WINDOW_H_
@@ -15,6 +15,7 @@
 #include "abel/log/logging.h"
 #include <string_view>
 #include <sys/socket.h>                        // SO_REUSEADDR SO_REUSEPORT
+#include <sys/un.h>                            // sockaddr_un
 #include "abel/base/profile.h"
 #include "abel/memory/leaky_singleton.h"
 #include "abel/strings/numbers.h"
@@ -127,7 +128,7 @@ namespace abel {
                     case AF_UNIX: {
                         auto p = reinterpret_cast<const sockaddr_un*>(addr);
                         if (p->sun_path[0] == '\0' && p->sun_path[1] != '\0') {
-                            return "@"s + &p->sun_path[1];
+                            return std::string("@") + &p->sun_path[1];
                         } else {
                             return p->sun_path;
                         }
@@ -21,7 +21,7 @@ namespace abel {
 
         constexpr explicit byte_set(const char *str) : _rep(from_string(str)) {}
 
-        constexpr explicit byte_set(const std::string_view &bytes) : byte_set() {
+        explicit byte_set(const std::string_view &bytes) : byte_set() {
             insert(bytes);
         }
 
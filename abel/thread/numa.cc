@@ -196,7 +196,8 @@ namespace abel {
             unsigned cpu, node;
 
             // Another approach: https://stackoverflow.com/a/27450168
-            DCHECK(0 == GetCpu(&cpu, &node, nullptr), "Cannot get NUMA ID.");
+            [[maybe_unused]] auto rc = GetCpu(&cpu, &node, nullptr);
+            DCHECK(0 == rc, "Cannot get NUMA ID.");
             return node;
         }
 
@@ -226,7 +227,8 @@ namespace abel {
 
     int get_current_processor_id() {
         unsigned cpu, node;
-        DCHECK(0 == GetCpu(&cpu, &node, nullptr), "Cannot get current CPU ID.");
+        [[maybe_unused]] auto rc = GetCpu(&cpu, &node, nullptr);
+        DCHECK(0 == rc, "Cannot get current CPU ID.");
         return cpu;
     }
 
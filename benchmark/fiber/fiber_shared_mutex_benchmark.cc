@@ -0,0 +1,118 @@
+//
+// Created by liyinbin on 2021/5/8.
+//
+
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <type_traits>
+
+#include "benchmark/benchmark.h"
+
+#include "abel/fiber/fiber.h"
+#include "abel/fiber/fiber_config.h"
+#include "abel/fiber/fiber_mutex.h"
+#include "abel/fiber/fiber_shared_mutex.h"
+#include "abel/fiber/runtime.h"
+
+// Read-mostly lookups from many fibers, guarded by `fiber_mutex` and by
+// `fiber_shared_mutex`.
+//
+// `state.range(0)` is `workers_per_group` of the (single) scheduling group. With
+// `fiber_mutex`, readers are serialized no matter how many workers there are.
+// With `fiber_shared_mutex`, throughput is expected to scale with the number of
+// workers (given enough CPUs), as readers only do an atomic add.
+//
+// `state.range(1)` is the number of reads per write, 0 for no write at all.
+
+namespace abel {
+
+    namespace {
+
+        constexpr auto kFibersPerWorker = 4;
+        constexpr auto kOperationsPerFiber = 4096;
+
+        struct shared_table {
+            std::uint64_t values[16] = {};
+        };
+
+        template<class Mutex>
+        void read_table(Mutex &lock, const shared_table &table, std::uint64_t *sum) {
+            if constexpr (std::is_same_v<Mutex, fiber_shared_mutex>) {
+                std::shared_lock _(lock);
+                *sum += table.values[*sum % std::size(table.values)];
+            } else {
+                std::scoped_lock _(lock);
+                *sum += table.values[*sum % std::size(table.values)];
+            }
+        }
+
+        template<class Mutex>
+        void update_table(Mutex &lock, shared_table *table, std::uint64_t sum) {
+            std::scoped_lock _(lock);
+            ++table->values[sum % std::size(table->values)];
+        }
+
+        template<class Mutex>
+        void bench_read_mostly(benchmark::State &state) {
+            auto workers = static_cast<std::size_t>(state.range(0));
+            auto reads_per_write = state.range(1);
+            auto &&config = fiber_config::get_global_fiber_config();
+            config.scheduling_groups = 1;
+            config.workers_per_group = workers;
+            config.fiber_stack_enable_guard_page = false;
+            start_runtime();
+
+            Mutex lock;
+            shared_table table;
+            for (auto _ : state) {
+                std::atomic<std::size_t> running(workers * kFibersPerWorker);
+                for (std::size_t i = 0; i != workers * kFibersPerWorker; ++i) {
+                    fiber([&] {
+                        std::uint64_t sum = 0;
+                        for (int j = 0; j != kOperationsPerFiber; ++j) {
+                            if (reads_per_write && j % reads_per_write == 0) {
+                                update_table(lock, &table, sum);
+                            } else {
+                                read_table(lock, table, &sum);
+                            }
+                        }
+                        benchmark::DoNotOptimize(sum);
+                        --running;
+                    }).detach();
+                }
+                while (running.load(std::memory_order_relaxed)) {
+                    std::this_thread::yield();
+                }
+            }
+            state.SetItemsProcessed(state.iterations() * workers * kFibersPerWorker *
+                                    kOperationsPerFiber);
+
+            terminate_runtime();
+        }
+
+        void fiber_mutex_read_mostly(benchmark::State &state) {
+            bench_read_mostly<fiber_mutex>(state);
+        }
+
+        void fiber_shared_mutex_read_mostly(benchmark::State &state) {
+            bench_read_mostly<fiber_shared_mutex>(state);
+        }
+
+        void worker_args(benchmark::internal::Benchmark *b) {
+            for (auto workers : {1, 2, 4, 8, 16}) {
+                for (auto reads_per_write : {0, 100}) {
+                    b->Args({workers, reads_per_write});
+                }
+            }
+        }
+
+    }  // namespace
+
+    BENCHMARK(fiber_mutex_read_mostly)->Apply(worker_args)->UseRealTime();
+    BENCHMARK(fiber_shared_mutex_read_mostly)->Apply(worker_args)->UseRealTime();
+
+}  // namespace abel
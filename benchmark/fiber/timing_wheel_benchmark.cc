@@ -0,0 +1,126 @@
+//
+// Created by liyinbin on 2021/5/8.
+//
+
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "abel/base/random.h"
+#include "abel/fiber/internal/timing_wheel.h"
+
+// Arm / cancel churn, as is seen by `timer_worker` when an RPC deadline timer is
+// armed for each request and cancelled once the response arrives.
+//
+// `state.range(0)` timers are kept alive. Each iteration arms a new timer which
+// expires in about 1s (1000 ticks), and cancels the oldest one. Time advances
+// one tick every 16 iterations.
+//
+// The heap mirrors what `timer_worker` does without timing wheel: cancelled
+// timers are only marked, and stay in the heap until they reach the top.
+
+namespace abel {
+    namespace fiber_internal {
+
+        namespace {
+
+            constexpr auto kIterationsPerTick = 16;
+            constexpr std::uint64_t kTimeout = 1000;
+
+            struct bench_timer : timing_wheel_hook {
+                std::uint64_t generation = 0;  // Bumped on cancellation.
+                bool cancelled = false;
+            };
+
+            // Entries in the heap can't be modified in place, each arming pushes a new
+            // one. Entries of a cancelled timer are recognized by their generation.
+            struct heap_entry {
+                std::uint64_t expires_tick;
+                std::uint64_t generation;
+                bench_timer *timer;
+            };
+
+            struct heap_entry_comp {
+                bool operator()(const heap_entry &e1, const heap_entry &e2) const {
+                    return e1.expires_tick > e2.expires_tick;
+                }
+            };
+
+        }  // namespace
+
+        void BM_heap_arm_cancel(benchmark::State &state) {
+            std::size_t live = state.range(0);
+            std::vector<bench_timer> timers(live * 2);
+            std::priority_queue<heap_entry, std::vector<heap_entry>, heap_entry_comp> heap;
+            std::size_t next = 0;
+            std::uint64_t now = 0, iterations = 0;
+
+            auto arm = [&](bench_timer *t) {
+                t->cancelled = false;
+                t->expires_tick = now + kTimeout + Random<std::uint64_t>(kTimeout);
+                heap.push(heap_entry{t->expires_tick, t->generation, t});
+            };
+            auto advance = [&] {
+                ++now;
+                while (!heap.empty() && heap.top().expires_tick <= now) {
+                    auto &&top = heap.top();
+                    benchmark::DoNotOptimize(top.generation == top.timer->generation);
+                    heap.pop();
+                }
+            };
+
+            for (std::size_t i = 0; i != live; ++i) {
+                arm(&timers[i]);
+            }
+            for (auto _ : state) {
+                auto &&cancelling = timers[next % timers.size()];
+                cancelling.cancelled = true;
+                ++cancelling.generation;
+                arm(&timers[(next + live) % timers.size()]);
+                ++next;
+                if (++iterations % kIterationsPerTick == 0) {
+                    advance();
+                }
+            }
+            state.counters["heap_size"] = heap.size();
+        }
+
+        void BM_timing_wheel_arm_cancel(benchmark::State &state) {
+            std::size_t live = state.range(0);
+            std::vector<bench_timer> timers(live * 2);
+            timing_wheel<bench_timer> wheel;
+            std::size_t next = 0;
+            std::uint64_t iterations = 0;
+
+            auto arm = [&](bench_timer *t) {
+                t->cancelled = false;
+                t->expires_tick = wheel.current_tick() + kTimeout + Random<std::uint64_t>(kTimeout);
+                wheel.insert(t, t->expires_tick);
+            };
+
+            for (std::size_t i = 0; i != live; ++i) {
+                arm(&timers[i]);
+            }
+            for (auto _ : state) {
+                auto &&cancelling = timers[next % timers.size()];
+                cancelling.cancelled = true;
+                wheel.erase(&cancelling);
+                arm(&timers[(next + live) % timers.size()]);
+                ++next;
+                if (++iterations % kIterationsPerTick == 0) {
+                    wheel.advance(wheel.current_tick() + 1, [](bench_timer *t) {
+                        benchmark::DoNotOptimize(t->cancelled);
+                    });
+                }
+            }
+            state.counters["wheel_size"] = wheel.size();
+        }
+
+        BENCHMARK(BM_heap_arm_cancel)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+
+        BENCHMARK(BM_timing_wheel_arm_cancel)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+
+    }  // namespace fiber_internal
+}  // namespace abel
@@ -0,0 +1,143 @@
+//
+// Created by liyinbin on 2021/4/3.
+//
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "abel/memory/object_pool.h"
+
+// Objects are allocated in one thread and freed in another, as is seen by
+// `iobuf` blocks allocated by the reader and freed by the writer.
+//
+// Each iteration allocates a batch of objects and hands them to a consumer
+// thread, which frees them. At most `kMaxPendingBatches` batches are in flight.
+//
+// With `ThreadLocal`, objects freed by the consumer can't be reused by the
+// producer, which keeps creating new ones.
+
+namespace abel {
+
+    namespace {
+
+        constexpr auto kObjectsPerBatch = 64;
+        constexpr auto kMaxPendingBatches = 16;
+
+        template<pool_type kPoolType>
+        struct bench_object {
+            char payload[256];
+        };
+
+    }  // namespace
+
+    template<pool_type kPoolType>
+    struct pool_traits<bench_object<kPoolType>> {
+        static constexpr auto kType = kPoolType;
+        static constexpr auto kLowWaterMark = 1024;
+        static constexpr auto kHighWaterMark = 65536;
+        static constexpr auto kMaxIdle = abel::duration::seconds(10);
+        static constexpr auto kMinimumThreadCacheSize = 256;
+        static constexpr auto kTransferBatchSize = 64;
+    };
+
+    namespace {
+
+        class batch_queue {
+        public:
+            void push(std::vector<void *> batch) {
+                std::unique_lock lk(lock_);
+                cv_.wait(lk, [&] { return batches_.size() < kMaxPendingBatches; });
+                batches_.push_back(std::move(batch));
+                cv_.notify_all();
+            }
+
+            // Returns false once stopped and drained.
+            bool pop(std::vector<void *> *batch) {
+                std::unique_lock lk(lock_);
+                cv_.wait(lk, [&] { return !batches_.empty() || stopped_; });
+                if (batches_.empty()) {
+                    return false;
+                }
+                *batch = std::move(batches_.front());
+                batches_.pop_front();
+                cv_.notify_all();
+                return true;
+            }
+
+            void stop() {
+                std::scoped_lock _(lock_);
+                stopped_ = true;
+                cv_.notify_all();
+            }
+
+        private:
+            std::mutex lock_;
+            std::condition_variable cv_;
+            bool stopped_ = false;
+            std::deque<std::vector<void *>> batches_;
+        };
+
+        template<pool_type kPoolType>
+        void BM_cross_thread_alloc_free(benchmark::State &state) {
+            using object = bench_object<kPoolType>;
+            batch_queue queue;
+            std::thread consumer([&] {
+                std::vector<void *> batch;
+                while (queue.pop(&batch)) {
+                    for (auto &&e : batch) {
+                        object_pool::put<object>(static_cast<object *>(e));
+                    }
+                }
+            });
+
+            for (auto _ : state) {
+                std::vector<void *> batch;
+                batch.reserve(kObjectsPerBatch);
+                for (int i = 0; i != kObjectsPerBatch; ++i) {
+                    auto p = object_pool::get<object>().leak();
+                    benchmark::DoNotOptimize(p->payload[0] = 1);
+                    batch.push_back(p);
+                }
+                queue.push(std::move(batch));
+            }
+            queue.stop();
+            consumer.join();
+            state.SetItemsProcessed(state.iterations() * kObjectsPerBatch);
+        }
+
+        // Same thread allocates and frees, for reference.
+        template<pool_type kPoolType>
+        void BM_same_thread_alloc_free(benchmark::State &state) {
+            using object = bench_object<kPoolType>;
+            std::vector<object *> batch;
+            for (auto _ : state) {
+                for (int i = 0; i != kObjectsPerBatch; ++i) {
+                    auto p = object_pool::get<object>().leak();
+                    benchmark::DoNotOptimize(p->payload[0] = 1);
+                    batch.push_back(p);
+                }
+                for (auto &&e : batch) {
+                    object_pool::put<object>(e);
+                }
+                batch.clear();
+            }
+            state.SetItemsProcessed(state.iterations() * kObjectsPerBatch);
+        }
+
+    }  // namespace
+
+    BENCHMARK_TEMPLATE(BM_cross_thread_alloc_free, pool_type::Disabled)->UseRealTime();
+    BENCHMARK_TEMPLATE(BM_cross_thread_alloc_free, pool_type::ThreadLocal)->UseRealTime();
+    BENCHMARK_TEMPLATE(BM_cross_thread_alloc_free, pool_type::MemoryNodeShared)->UseRealTime();
+    BENCHMARK_TEMPLATE(BM_cross_thread_alloc_free, pool_type::Global)->UseRealTime();
+
+    BENCHMARK_TEMPLATE(BM_same_thread_alloc_free, pool_type::ThreadLocal);
+    BENCHMARK_TEMPLATE(BM_same_thread_alloc_free, pool_type::MemoryNodeShared);
+    BENCHMARK_TEMPLATE(BM_same_thread_alloc_free, pool_type::Global);
+
+}  // namespace abel
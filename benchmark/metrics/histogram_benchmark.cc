@@ -0,0 +1,80 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "abel/base/random.h"
+#include "abel/metrics/histogram.h"
+#include "abel/metrics/log_histogram.h"
+#include "abel/metrics/timer.h"
+
+// Cost of recording a latency, as is done for each RPC.
+//
+// Values are RPC-like latencies in nanoseconds, between 10us and 100ms.
+
+namespace abel {
+namespace metrics {
+
+namespace {
+
+std::vector<std::uint64_t> make_latencies() {
+    std::vector<std::uint64_t> rc;
+    for (int i = 0; i != 4096; ++i) {
+        rc.push_back(Random<std::uint64_t>(10000, 100000000));
+    }
+    return rc;
+}
+
+const std::vector<std::uint64_t> kLatencies = make_latencies();
+
+}  // namespace
+
+void BM_histogram_observe(benchmark::State &state) {
+    histogram hist(bucket_builder::exponential_values(10000, 1.5, state.range(0)));
+    std::size_t i = 0;
+    for (auto _ : state) {
+        hist.observe(kLatencies[i++ % kLatencies.size()]);
+    }
+}
+
+void BM_log_histogram_observe(benchmark::State &state) {
+    static log_histogram hist;
+    std::size_t i = 0;
+    for (auto _ : state) {
+        hist.observe(kLatencies[i++ % kLatencies.size()]);
+    }
+}
+
+void BM_timer_observe(benchmark::State &state) {
+    static auto t = timer::new_timer(bucket_builder::exponential_values(10, 1.5, 30));
+    std::size_t i = 0;
+    for (auto _ : state) {
+        t->observe(abel::duration::nanoseconds(kLatencies[i++ % kLatencies.size()]));
+    }
+}
+
+void BM_log_histogram_quantile(benchmark::State &state) {
+    log_histogram hist;
+    for (auto &&e : kLatencies) {
+        hist.observe(e);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(hist.quantile(0.99));
+    }
+}
+
+BENCHMARK(BM_histogram_observe)->Arg(10)->Arg(30)->Threads(1)->Threads(4);
+
+BENCHMARK(BM_log_histogram_observe)->Threads(1)->Threads(4);
+
+BENCHMARK(BM_timer_observe)->Threads(1)->Threads(4);
+
+BENCHMARK(BM_log_histogram_quantile);
+
+}  // namespace metrics
+}  // namespace abel
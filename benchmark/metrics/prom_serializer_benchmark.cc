@@ -0,0 +1,69 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "abel/metrics/prom_serializer.h"
+#include "abel/metrics/prom_stream_serializer.h"
+#include "abel/metrics/scope.h"
+
+// Cost of a scrape of ~100k series: 1000 tenants, each with 90 counters /
+// gauges and a histogram of 8 buckets (11 series).
+
+namespace abel {
+namespace metrics {
+
+namespace {
+
+scope_ptr get_scope() {
+    static scope_ptr s = [] {
+        auto rc = scope::new_root_scope("bench", "_", {{"service", "demo"}});
+        auto buckets = bucket_builder::exponential_values(1, 4, 8);
+        for (int i = 0; i != 1000; ++i) {
+            auto tenant = rc->tagged({{"tenant", "tenant_" + std::to_string(i)}});
+            for (int j = 0; j != 45; ++j) {
+                tenant->get_int_counter("requests_" + std::to_string(j))->inc(i * j);
+                tenant->get_gauge("load_" + std::to_string(j))->update(i * 0.37 + j);
+            }
+            auto h = tenant->get_histogram("latency", buckets);
+            for (int j = 0; j != 100; ++j) {
+                h->observe(j * 97 % 20000);
+            }
+        }
+        return rc;
+    }();
+    return s;
+}
+
+}  // namespace
+
+void BM_prometheus_serializer(benchmark::State &state) {
+    auto s = get_scope();
+    prometheus_serializer serializer;
+    for (auto _ : state) {
+        std::vector<cache_metrics> cm;
+        s->collect(cm);
+        auto &&base = static_cast<const abel::metrics::serializer &>(serializer);
+        benchmark::DoNotOptimize(base.format(cm));
+    }
+}
+
+BENCHMARK(BM_prometheus_serializer)->Unit(benchmark::kMillisecond);
+
+void BM_prometheus_stream_serializer(benchmark::State &state) {
+    auto s = get_scope();
+    prometheus_stream_serializer serializer;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(serializer.serialize(*s));
+    }
+}
+
+BENCHMARK(BM_prometheus_stream_serializer)->Unit(benchmark::kMillisecond);
+
+}  // namespace metrics
+}  // namespace abel
@@ -0,0 +1,96 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "abel/metrics/scope.h"
+
+// Throughput of looking up metrics in a scope, as is done when metrics are
+// resolved per request (e.g. with a per-tenant tag).
+
+namespace abel {
+namespace metrics {
+
+namespace {
+
+constexpr int kTenants = 64;
+
+scope_ptr get_scope() {
+    static scope_ptr s = [] {
+        auto rc = scope::new_root_scope("bench", "_", {});
+        for (int i = 0; i != kTenants; ++i) {
+            rc->get_counter("requests_" + std::to_string(i));
+        }
+        return rc;
+    }();
+    return s;
+}
+
+std::vector<std::string> make_tenants() {
+    std::vector<std::string> rc;
+    for (int i = 0; i != kTenants; ++i) {
+        rc.push_back(std::to_string(i));
+    }
+    return rc;
+}
+
+const std::vector<std::string> kTenantNames = make_tenants();
+
+}  // namespace
+
+// Lookup by name, hashing it on each call.
+void BM_scope_get_counter(benchmark::State &state) {
+    auto s = get_scope();
+    std::string name = "requests_" + std::to_string(state.thread_index() % kTenants);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(s->get_counter(name));
+    }
+}
+
+BENCHMARK(BM_scope_get_counter)->ThreadRange(1, 8);
+
+// Lookup by a key built once.
+void BM_scope_get_counter_cached_key(benchmark::State &state) {
+    auto s = get_scope();
+    metric_key key("requests_" + std::to_string(state.thread_index() % kTenants));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(s->get_counter(key));
+    }
+}
+
+BENCHMARK(BM_scope_get_counter_cached_key)->ThreadRange(1, 8);
+
+// Per-tenant lookup through `tagged()`, which builds the sub-scope's ID.
+void BM_scope_tagged_get_counter(benchmark::State &state) {
+    auto s = get_scope();
+    std::size_t i = state.thread_index();
+    for (auto _ : state) {
+        auto &&tenant = kTenantNames[i++ % kTenants];
+        benchmark::DoNotOptimize(s->tagged({{"tenant", tenant}})->get_counter("requests"));
+    }
+}
+
+BENCHMARK(BM_scope_tagged_get_counter)->ThreadRange(1, 8);
+
+// Per-tenant lookup with a tagged key.
+void BM_scope_get_counter_tagged_key(benchmark::State &state) {
+    auto s = get_scope();
+    std::vector<metric_key> keys;
+    for (auto &&e : kTenantNames) {
+        keys.emplace_back("requests", std::unordered_map<std::string, std::string>{{"tenant", e}});
+    }
+    std::size_t i = state.thread_index();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(s->get_counter(keys[i++ % kTenants]));
+    }
+}
+
+BENCHMARK(BM_scope_get_counter_tagged_key)->ThreadRange(1, 8);
+
+}  // namespace metrics
+}  // namespace abel
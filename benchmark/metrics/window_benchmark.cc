@@ -0,0 +1,45 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+
+#include "benchmark/benchmark.h"
+
+#include "abel/metrics/counter.h"
+#include "abel/metrics/window.h"
+
+// Hot path of windowed metrics compared with that of a plain counter.
+
+namespace abel {
+namespace metrics {
+
+void BM_int_counter_inc(benchmark::State &state) {
+    static int_counter c;
+    for (auto _ : state) {
+        c.inc();
+    }
+}
+
+BENCHMARK(BM_int_counter_inc)->ThreadRange(1, 8);
+
+void BM_per_second_inc(benchmark::State &state) {
+    static per_second<int_counter> qps;
+    for (auto _ : state) {
+        qps.source()->inc();
+    }
+}
+
+BENCHMARK(BM_per_second_inc)->ThreadRange(1, 8);
+
+void BM_window_max_update(benchmark::State &state) {
+    static window_max max;
+    double v = 0;
+    for (auto _ : state) {
+        max.update(v += 1);
+    }
+}
+
+BENCHMARK(BM_window_max_update)->ThreadRange(1, 8);
+
+}  // namespace metrics
+}  // namespace abel
@@ -0,0 +1,101 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+#include "gtest/gtest.h"
+#include "abel/atomic/mpmc_ring.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST(mpmc_ring, Basic) {
+    abel::mpmc_ring<int> ring(3);
+    EXPECT_EQ(4, ring.capacity());
+
+    int v;
+    EXPECT_FALSE(ring.try_pop(&v));
+    for (int i = 0; i != 4; ++i) {
+        EXPECT_TRUE(ring.try_push(i));
+    }
+    EXPECT_FALSE(ring.try_push(4));
+    EXPECT_EQ(4, ring.size_approx());
+
+    ASSERT_TRUE(ring.try_pop(&v));
+    EXPECT_EQ(0, v);
+    EXPECT_TRUE(ring.try_push(4));
+
+    int values[8];
+    ASSERT_EQ(4, ring.try_pop_bulk(values, 8));
+    for (int i = 0; i != 4; ++i) {
+        EXPECT_EQ(i + 1, values[i]);
+    }
+    EXPECT_EQ(0, ring.try_pop_bulk(values, 8));
+}
+
+TEST(mpmc_ring, MoveOnlyAndDestruction) {
+    auto counter = std::make_shared<int>();
+    {
+        abel::mpmc_ring<std::shared_ptr<int>> ring(8);
+        for (int i = 0; i != 5; ++i) {
+            ASSERT_TRUE(ring.try_emplace(counter));
+        }
+        std::shared_ptr<int> p;
+        ASSERT_TRUE(ring.try_pop(&p));
+        EXPECT_EQ(6, counter.use_count());
+    }
+    // Items left in the ring are destroyed with it.
+    EXPECT_EQ(1, counter.use_count());
+
+    abel::mpmc_ring<std::unique_ptr<int>> ring(2);
+    auto value = std::make_unique<int>(1);
+    ASSERT_TRUE(ring.try_push(std::move(value)));
+    ASSERT_TRUE(ring.try_push(std::make_unique<int>(2)));
+    value = std::make_unique<int>(3);
+    // Not moved from if the ring is full.
+    EXPECT_FALSE(ring.try_push(std::move(value)));
+    ASSERT_TRUE(value);
+}
+
+TEST(mpmc_ring, MultiProducerMultiConsumer) {
+    constexpr int kProducers = 8;
+    constexpr int kConsumers = 4;
+    constexpr int kItemsPerProducer = 100000;
+
+    abel::mpmc_ring<std::uint64_t> ring(1024);
+    std::atomic<std::uint64_t> sum{0};
+    std::atomic<int> popped{0};
+    std::vector<std::thread> ts;
+
+    for (int i = 0; i != kProducers; ++i) {
+        ts.emplace_back([&, i] {
+            for (int j = 0; j != kItemsPerProducer; ++j) {
+                while (!ring.try_push(i * kItemsPerProducer + j)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int i = 0; i != kConsumers; ++i) {
+        ts.emplace_back([&] {
+            std::uint64_t values[32];
+            while (popped.load() != kProducers * kItemsPerProducer) {
+                auto n = ring.try_pop_bulk(values, 32);
+                for (size_t k = 0; k != n; ++k) {
+                    sum += values[k];
+                }
+                popped += n;
+                if (!n) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto &&t : ts) {
+        t.join();
+    }
+
+    std::uint64_t n = kProducers * kItemsPerProducer;
+    EXPECT_EQ(n * (n - 1) / 2, sum.load());
+}
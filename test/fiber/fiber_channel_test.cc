@@ -0,0 +1,270 @@
+//
+// Created by liyinbin on 2021/5/8.
+//
+
+
+#include "abel/fiber/fiber_channel.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "abel/base/random.h"
+#include "abel/fiber/fiber.h"
+#include "abel/fiber/this_fiber.h"
+#include "testing/fiber.h"
+
+namespace abel {
+
+    TEST(fiber_channel, Basic) {
+        testing::run_as_fiber([] {
+            fiber_channel<std::unique_ptr<int>> ch(3);
+            ASSERT_EQ(4, ch.capacity());
+            ASSERT_FALSE(ch.try_receive());
+            for (int i = 0; i != 4; ++i) {
+                ASSERT_TRUE(ch.try_send(std::make_unique<int>(i)));
+            }
+            auto v = std::make_unique<int>(4);
+            ASSERT_FALSE(ch.try_send(std::move(v)));
+            ASSERT_TRUE(v);  // Untouched on failure.
+            for (int i = 0; i != 4; ++i) {
+                auto rc = ch.receive();
+                ASSERT_TRUE(rc);
+                ASSERT_EQ(i, **rc);
+            }
+            ASSERT_TRUE(ch.send(std::move(v)));
+            ch.close();
+            ASSERT_FALSE(ch.send(std::make_unique<int>(5)));
+            auto rc = ch.receive();  // Drained after close.
+            ASSERT_TRUE(rc);
+            ASSERT_EQ(4, **rc);
+            ASSERT_FALSE(ch.receive());
+        });
+    }
+
+    TEST(fiber_channel, ProducerConsumer) {
+        testing::run_as_fiber([] {
+            constexpr auto kProducers = 16;
+            constexpr auto kConsumers = 16;
+            constexpr auto kValuesPerProducer = 20000;
+
+            // Small capacity so that both sides block from time to time.
+            fiber_channel<std::uint64_t> ch(64);
+            std::atomic<std::uint64_t> sum{}, received{};
+            std::vector<fiber> producers, consumers;
+            for (int i = 0; i != kConsumers; ++i) {
+                consumers.emplace_back([&, i] {
+                    std::uint64_t buffer[16];
+                    while (true) {
+                        if (i % 2) {
+                            auto n = ch.receive_batch(buffer, std::size(buffer));
+                            if (!n) {
+                                break;
+                            }
+                            for (std::size_t j = 0; j != n; ++j) {
+                                sum += buffer[j];
+                            }
+                            received += n;
+                        } else {
+                            auto v = ch.receive();
+                            if (!v) {
+                                break;
+                            }
+                            sum += *v;
+                            ++received;
+                        }
+                    }
+                });
+            }
+            for (int i = 0; i != kProducers; ++i) {
+                producers.emplace_back([&, i] {
+                    std::vector<std::uint64_t> values;
+                    for (int j = 0; j != kValuesPerProducer; ++j) {
+                        values.push_back(i * kValuesPerProducer + j);
+                    }
+                    if (i % 2) {
+                        for (auto &&e : values) {
+                            ASSERT_TRUE(ch.send(e));
+                        }
+                    } else {
+                        for (std::size_t j = 0; j < values.size(); j += 100) {
+                            auto last = std::min(j + 100, values.size());
+                            ASSERT_EQ(last - j, ch.send_batch(values.begin() + j, values.begin() + last));
+                        }
+                    }
+                });
+            }
+            for (auto &&e : producers) {
+                e.join();
+            }
+            ch.close();
+            for (auto &&e : consumers) {
+                e.join();
+            }
+            constexpr std::uint64_t kTotal = kProducers * kValuesPerProducer;
+            ASSERT_EQ(kTotal, received);
+            ASSERT_EQ(kTotal * (kTotal - 1) / 2, sum);
+        });
+    }
+
+    TEST(fiber_channel, CloseWakesUp) {
+        testing::run_as_fiber([] {
+            fiber_channel<int> ch(2);
+            ASSERT_TRUE(ch.send(1));
+            ASSERT_TRUE(ch.send(2));
+            std::atomic<int> done{};
+            fiber sender([&] {
+                ASSERT_FALSE(ch.send(3));  // Blocks until closed.
+                ++done;
+            });
+            fiber_channel<int> empty(2);
+            fiber receiver([&] {
+                ASSERT_FALSE(empty.receive());
+                ++done;
+            });
+            fiber_sleep_for(abel::duration::milliseconds(10));
+            ASSERT_EQ(0, done);
+            ch.close();
+            empty.close();
+            sender.join();
+            receiver.join();
+            ASSERT_EQ(2, done);
+        });
+    }
+
+    TEST(fiber_channel, Select) {
+        testing::run_as_fiber([] {
+            fiber_channel<int> ch1(2);
+            fiber_channel<std::string> ch2(2);
+
+            // Timeout.
+            auto start = abel::time_now();
+            ASSERT_EQ(-1, fiber_select({select_receive(ch1), select_receive(ch2)},
+                                       abel::duration::milliseconds(10)));
+            ASSERT_GE(abel::time_now() - start, abel::duration::milliseconds(10));
+
+            // Ready already.
+            ASSERT_EQ(0, fiber_select({select_send(ch1), select_receive(ch2)}));
+
+            // Woken up by a sender.
+            fiber sender([&] {
+                fiber_sleep_for(abel::duration::milliseconds(10));
+                ch2.send("hello");
+            });
+            ASSERT_EQ(1, fiber_select({select_receive(ch1), select_receive(ch2)}));
+            ASSERT_EQ("hello", *ch2.try_receive());
+            sender.join();
+
+            // Woken up by a receiver.
+            ch1.send(1);
+            ch1.send(2);
+            fiber receiver([&] {
+                fiber_sleep_for(abel::duration::milliseconds(10));
+                ch1.receive();
+            });
+            ASSERT_EQ(1, fiber_select({select_receive(ch2), select_send(ch1)}));
+            receiver.join();
+
+            // Closed.
+            ch2.close();
+            ASSERT_EQ(0, fiber_select({select_receive(ch2)}));
+        });
+    }
+
+    TEST(fiber_channel, SelectMany) {
+        testing::run_as_fiber([] {
+            constexpr auto kChannels = 4;
+            constexpr auto kValues = 10000;
+            std::vector<std::unique_ptr<fiber_channel<int>>> chs;
+            for (int i = 0; i != kChannels; ++i) {
+                chs.push_back(std::make_unique<fiber_channel<int>>(8));
+            }
+            std::vector<fiber> senders;
+            for (int i = 0; i != kChannels; ++i) {
+                senders.emplace_back([&, i] {
+                    for (int j = 0; j != kValues; ++j) {
+                        ASSERT_TRUE(chs[i]->send(j));
+                        if (Random(100) == 0) {
+                            fiber_yield();
+                        }
+                    }
+                });
+            }
+            int received = 0;
+            while (received != kChannels * kValues) {
+                auto index = fiber_select({select_receive(*chs[0]), select_receive(*chs[1]),
+                                           select_receive(*chs[2]), select_receive(*chs[3])});
+                ASSERT_NE(-1, index);
+                // We're the only receiver, so it must succeed.
+                ASSERT_TRUE(chs[index]->try_receive());
+                ++received;
+            }
+            for (auto &&e : senders) {
+                e.join();
+            }
+        });
+    }
+
+    TEST(fiber_channel, SelectMixedWithBlocking) {
+        testing::run_as_fiber([] {
+            constexpr auto kSenders = 4;
+            constexpr auto kReceivers = 4;
+            constexpr auto kValuesPerSender = 5000;
+            constexpr auto kTotal = kSenders * kValuesPerSender;
+
+            fiber_channel<int> ch(2);
+            std::atomic<bool> done{false};
+            std::atomic<int> received{};
+
+            // Selecting fibers wait on both sides of `ch`, but never act on it. They
+            // must not eat up wake-ups meant for fibers blocked in `send` / `receive`.
+            std::vector<fiber> selectors;
+            for (int i = 0; i != 4; ++i) {
+                selectors.emplace_back([&, i] {
+                    while (!done.load()) {
+                        fiber_select({i % 2 ? select_send(ch) : select_receive(ch)},
+                                     abel::duration::milliseconds(10));
+                        fiber_sleep_for(abel::duration::microseconds(100));
+                    }
+                });
+            }
+            std::vector<fiber> senders, receivers;
+            for (int i = 0; i != kReceivers; ++i) {
+                receivers.emplace_back([&] {
+                    while (ch.receive()) {
+                        ++received;
+                    }
+                });
+            }
+            for (int i = 0; i != kSenders; ++i) {
+                senders.emplace_back([&] {
+                    for (int j = 0; j != kValuesPerSender; ++j) {
+                        ASSERT_TRUE(ch.send(j));
+                    }
+                });
+            }
+            // A lost wake-up leaves values (or room) in `ch` with receivers (or
+            // senders) parked forever.
+            auto deadline = abel::time_now() + abel::duration::seconds(10);
+            while (received.load() != kTotal && abel::time_now() < deadline) {
+                fiber_sleep_for(abel::duration::milliseconds(1));
+            }
+            done = true;
+            ch.close();  // Unblocks everyone, should the test fail.
+            for (auto &&e : senders) {
+                e.join();
+            }
+            for (auto &&e : receivers) {
+                e.join();
+            }
+            for (auto &&e : selectors) {
+                e.join();
+            }
+            ASSERT_EQ(kTotal, received.load());
+        });
+    }
+
+}  // namespace abel
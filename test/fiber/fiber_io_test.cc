@@ -0,0 +1,220 @@
+//
+// Created by liyinbin on 2021/5/8.
+//
+
+
+#include "abel/fiber/fiber_io.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "abel/fiber/fiber.h"
+#include "abel/fiber/this_fiber.h"
+#include "abel/io/fd_utility.h"
+#include "testing/fiber.h"
+
+namespace abel {
+
+    TEST(fiber_io, ReadWaitsForData) {
+        testing::run_as_fiber([] {
+            int fds[2];
+            ASSERT_EQ(0, pipe(fds));
+            make_non_blocking(fds[0]);
+            make_non_blocking(fds[1]);
+
+            {
+                fiber_io_descriptor desc(fds[0]);
+                system_io_stream io(fds[0]);
+                std::atomic<bool> written{false};
+
+                fiber writer([&] {
+                    fiber_sleep_for(abel::duration::milliseconds(100));
+                    written = true;
+                    ASSERT_EQ(5, write(fds[1], "hello", 5));
+                });
+
+                iobuf buffer;
+                std::size_t bytes_read;
+                ASSERT_EQ(read_status::eDrained,
+                          fiber_read_iobuf(100, &desc, &io, &buffer, &bytes_read));
+                EXPECT_TRUE(written);
+                EXPECT_EQ(5, bytes_read);
+                EXPECT_EQ("hello", flatten_slow(buffer));
+
+                writer.join();
+                close(fds[1]);
+                ASSERT_EQ(read_status::eEof,
+                          fiber_read_iobuf(100, &desc, &io, &buffer, &bytes_read));
+            }
+            close(fds[0]);
+        });
+    }
+
+    TEST(fiber_io, PingPong) {
+        testing::run_as_fiber([] {
+            constexpr auto kRounds = 1000;
+            int fds[2];
+            ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+            make_non_blocking(fds[0]);
+            make_non_blocking(fds[1]);
+
+            auto desc0 = std::make_unique<fiber_io_descriptor>(fds[0]);
+            auto desc1 = std::make_unique<fiber_io_descriptor>(fds[1]);
+            system_io_stream io0(fds[0]), io1(fds[1]);
+
+            fiber echo([&] {
+                iobuf buffer;
+                std::size_t bytes_read;
+                while (fiber_read_iobuf(4096, desc1.get(), &io1, &buffer, &bytes_read) ==
+                       read_status::eDrained) {
+                    write_iobuf_list list;
+                    std::vector<std::uintptr_t> ctxs;
+                    bool emptied;
+                    list.append(std::move(buffer), 0);
+                    ASSERT_EQ(bytes_read, fiber_flush_iobuf_list(&list, desc1.get(), &io1, 4096,
+                                                                 &ctxs, &emptied));
+                    ASSERT_TRUE(emptied);
+                    buffer.clear();
+                }
+            });
+
+            for (int i = 0; i != kRounds; ++i) {
+                auto msg = std::to_string(i);
+                write_iobuf_list list;
+                std::vector<std::uintptr_t> ctxs;
+                bool emptied;
+                list.append(create_buffer_slow(msg), i);
+                ASSERT_EQ(msg.size(), fiber_flush_iobuf_list(&list, desc0.get(), &io0, 4096,
+                                                             &ctxs, &emptied));
+                ASSERT_EQ(1, ctxs.size());
+                ASSERT_EQ(i, ctxs[0]);
+
+                iobuf buffer;
+                while (buffer.byte_size() != msg.size()) {
+                    std::size_t bytes_read;
+                    ASSERT_EQ(read_status::eDrained,
+                              fiber_read_iobuf(4096, desc0.get(), &io0, &buffer, &bytes_read));
+                }
+                ASSERT_EQ(msg, flatten_slow(buffer));
+            }
+
+            shutdown(fds[0], SHUT_WR);
+            echo.join();
+            desc0 = nullptr;
+            desc1 = nullptr;
+            close(fds[0]);
+            close(fds[1]);
+        });
+    }
+
+    TEST(fiber_io, FlushWaitsForWritable) {
+        testing::run_as_fiber([] {
+            constexpr auto kBytes = 16 * 1024 * 1024;
+            int fds[2];
+            ASSERT_EQ(0, pipe(fds));
+            make_non_blocking(fds[0]);
+            make_non_blocking(fds[1]);
+
+            auto rdesc = std::make_unique<fiber_io_descriptor>(fds[0]);
+            system_io_stream rio(fds[0]);
+
+            // Far more than what the pipe can hold. The writer has to wait for the
+            // reader to make room.
+            fiber writer([&] {
+                {
+                    fiber_io_descriptor wdesc(fds[1]);
+                    system_io_stream wio(fds[1]);
+                    write_iobuf_list list;
+                    std::vector<std::uintptr_t> ctxs;
+                    bool emptied;
+                    list.append(create_buffer_slow(std::string(kBytes, 'x')), 1);
+                    ASSERT_EQ(kBytes, fiber_flush_iobuf_list(&list, &wdesc, &wio, kBytes,
+                                                             &ctxs, &emptied));
+                    ASSERT_TRUE(emptied);
+                }  // `wdesc` must be destroyed before closing the pipe.
+                close(fds[1]);
+            });
+
+            std::size_t total = 0;
+            iobuf buffer;
+            std::size_t bytes_read;
+            while (true) {
+                auto rc = fiber_read_iobuf(65536, rdesc.get(), &rio, &buffer, &bytes_read);
+                if (rc == read_status::eEof) {
+                    break;
+                }
+                ASSERT_NE(read_status::eError, rc);
+                total += bytes_read;
+                buffer.clear();
+            }
+            EXPECT_EQ(kBytes, total);
+            writer.join();
+            rdesc = nullptr;
+            close(fds[0]);
+        });
+    }
+
+    // epoll refuses regular files, the descriptor is still usable (waits return
+    // immediately) and its destruction leaves the poller alone.
+    TEST(fiber_io, RegularFile) {
+        testing::run_as_fiber([] {
+            std::string path = ::testing::TempDir() + "/fiber_io_regular_XXXXXX";
+            int fd = mkstemp(&path[0]);
+            ASSERT_NE(-1, fd);
+            ASSERT_EQ(5, write(fd, "hello", 5));
+            ASSERT_EQ(0, lseek(fd, 0, SEEK_SET));
+            make_non_blocking(fd);
+
+            for (int i = 0; i != 10; ++i) {
+                fiber_io_descriptor desc(fd);
+                EXPECT_EQ(EPERM, desc.error());
+                desc.wait_readable();
+                desc.wait_writable();
+            }
+
+            {
+                fiber_io_descriptor desc(fd);
+                system_io_stream io(fd);
+                iobuf buffer;
+                std::size_t bytes_read;
+                ASSERT_EQ(read_status::eDrained,
+                          fiber_read_iobuf(100, &desc, &io, &buffer, &bytes_read));
+                EXPECT_EQ(5, bytes_read);
+                EXPECT_EQ("hello", flatten_slow(buffer));
+                ASSERT_EQ(read_status::eEof,
+                          fiber_read_iobuf(100, &desc, &io, &buffer, &bytes_read));
+            }
+            close(fd);
+            unlink(path.c_str());
+
+            // The poller is still fine.
+            int fds[2];
+            ASSERT_EQ(0, pipe(fds));
+            make_non_blocking(fds[0]);
+            {
+                fiber_io_descriptor desc(fds[0]);
+                EXPECT_EQ(0, desc.error());
+                ASSERT_EQ(5, write(fds[1], "world", 5));
+                system_io_stream io(fds[0]);
+                iobuf buffer;
+                std::size_t bytes_read;
+                ASSERT_EQ(read_status::eDrained,
+                          fiber_read_iobuf(100, &desc, &io, &buffer, &bytes_read));
+                EXPECT_EQ("world", flatten_slow(buffer));
+            }
+            close(fds[0]);
+            close(fds[1]);
+        });
+    }
+
+}  // namespace abel
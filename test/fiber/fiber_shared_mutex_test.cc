@@ -0,0 +1,134 @@
+//
+// Created by liyinbin on 2021/5/8.
+//
+
+
+#include "abel/fiber/fiber_shared_mutex.h"
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "abel/base/random.h"
+#include "abel/fiber/fiber.h"
+#include "abel/fiber/this_fiber.h"
+#include "testing/fiber.h"
+
+namespace abel {
+
+    TEST(fiber_shared_mutex, Basic) {
+        testing::run_as_fiber([] {
+            fiber_shared_mutex m;
+            ASSERT_TRUE(m.try_lock_shared());
+            ASSERT_TRUE(m.try_lock_shared());
+            ASSERT_FALSE(m.try_lock());
+            m.unlock_shared();
+            m.unlock_shared();
+            ASSERT_TRUE(m.try_lock());
+            ASSERT_FALSE(m.try_lock_shared());
+            ASSERT_FALSE(m.try_lock_shared_for(abel::duration::milliseconds(10)));
+            m.unlock();
+            ASSERT_TRUE(m.try_lock_shared_for(abel::duration::milliseconds(10)));
+            m.unlock_shared();
+        });
+    }
+
+    TEST(fiber_shared_mutex, WriterPreferred) {
+        testing::run_as_fiber([] {
+            fiber_shared_mutex m;
+            std::atomic<int> step{};
+            m.lock_shared();
+            fiber writer([&] {
+                std::scoped_lock _(m);
+                ASSERT_EQ(0, step.exchange(1));  // Before the second reader.
+            });
+            while (m.try_lock_shared() && (m.unlock_shared(), true)) {
+                fiber_yield();  // Wait until the writer is pending.
+            }
+            fiber reader([&] {
+                std::shared_lock _(m);
+                ASSERT_EQ(1, step.exchange(2));
+            });
+            fiber_sleep_for(abel::duration::milliseconds(10));
+            ASSERT_EQ(0, step);  // Both of them are blocked by us.
+            m.unlock_shared();
+            writer.join();
+            reader.join();
+            ASSERT_EQ(2, step);
+        });
+    }
+
+    TEST(fiber_shared_mutex, TimedReaderGivesUp) {
+        testing::run_as_fiber([] {
+            fiber_shared_mutex m;
+            m.lock();
+            std::vector<fiber> readers;
+            std::atomic<int> timed_out{}, acquired{};
+            for (int i = 0; i != 10; ++i) {
+                readers.emplace_back([&, i] {
+                    if (m.try_lock_shared_for(abel::duration::milliseconds(i % 2 ? 5 : 1000))) {
+                        ++acquired;
+                        m.unlock_shared();
+                    } else {
+                        ++timed_out;
+                    }
+                });
+            }
+            fiber_sleep_for(abel::duration::milliseconds(100));
+            ASSERT_EQ(5, timed_out);
+            m.unlock();
+            for (auto &&e : readers) {
+                e.join();
+            }
+            ASSERT_EQ(5, acquired);
+
+            // Readers who gave up must not leave anything behind.
+            ASSERT_TRUE(m.try_lock());
+            m.unlock();
+        });
+    }
+
+    TEST(fiber_shared_mutex, Torture) {
+        testing::run_as_fiber([] {
+            fiber_shared_mutex m;
+            int value = 0;
+            std::atomic<int> readers{}, writers{};
+            std::vector<fiber> fibers;
+            for (int i = 0; i != 64; ++i) {
+                fibers.emplace_back([&, i] {
+                    for (int j = 0; j != 2000; ++j) {
+                        if (i % 8 == 0) {
+                            std::scoped_lock _(m);
+                            ASSERT_EQ(1, ++writers);
+                            ASSERT_EQ(0, readers);
+                            ++value;
+                            --writers;
+                        } else if (j % 2 || !m.try_lock_shared_for(
+                                abel::duration::microseconds(Random(100)))) {
+                            std::shared_lock _(m);
+                            ++readers;
+                            ASSERT_EQ(0, writers);
+                            --readers;
+                        } else {
+                            ++readers;
+                            ASSERT_EQ(0, writers);
+                            --readers;
+                            m.unlock_shared();
+                        }
+                        if (Random(16) == 0) {
+                            fiber_yield();
+                        }
+                    }
+                });
+            }
+            for (auto &&e : fibers) {
+                e.join();
+            }
+            ASSERT_EQ(8 * 2000, value);
+        });
+    }
+
+}  // namespace abel
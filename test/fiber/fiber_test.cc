@@ -5,6 +5,8 @@
 
 #include "abel/fiber/fiber.h"
 
+#include <alloca.h>
+
 #include <atomic>
 #include <thread>
 #include <vector>
@@ -16,8 +18,10 @@
 #include "abel/fiber/fiber_local.h"
 #include "abel/fiber/fiber_latch.h"
 #include "abel/fiber/runtime.h"
+#include "abel/fiber/internal/scheduling_group.h"
 #include "abel/fiber/this_fiber.h"
 #include "abel/fiber/fiber_config.h"
+#include "abel/metrics/scope.h"
 
 using namespace std::literals;
 
@@ -179,6 +183,92 @@ namespace abel {
         });
     }
 
+    TEST(fiber, RuntimeMetrics) {
+        run_as_fiber([] {
+            constexpr auto N = 1000;
+            std::vector<fiber> fs(N);
+            for (auto &&e : fs) {
+                e = fiber([] { fiber_sleep_for(abel::duration::milliseconds(1)); });
+            }
+            for (auto &&e : fs) {
+                e.join();
+            }
+
+            auto scope = metrics::scope::new_root_scope("fiber", ".", {});
+            report_runtime_metrics(scope);
+            report_runtime_metrics(scope);  // Counters should not be doubled.
+
+            std::vector<metrics::cache_metrics> collected;
+            scope->collect(collected);
+            double fibers_run = 0, timers_fired = 0;
+            std::uint64_t latency_samples = 0;
+            for (auto &&e : collected) {
+                if (e.name == "fibers_run") {
+                    fibers_run += e.counter.value;
+                } else if (e.name == "timers_fired") {
+                    timers_fired += e.counter.value;
+                } else if (e.name == "ready_to_run_latency_us") {
+                    latency_samples += e.histogram.sample_count;
+                }
+            }
+            std::uint64_t expected_fibers_run = 0, expected_timers_fired = 0;
+            for (std::size_t i = 0; i != get_scheduling_group_count(); ++i) {
+                auto stats = fiber_internal::routine_get_scheduling_group(i)->get_stats();
+                expected_fibers_run += stats.fibers_run;
+                expected_timers_fired += stats.timers_fired;
+            }
+            // Each fiber is run at least twice (started, and woken up by its timer).
+            EXPECT_GE(fibers_run, N * 2);
+            EXPECT_LE(fibers_run, expected_fibers_run);
+            EXPECT_GE(timers_fired, N);
+            EXPECT_LE(timers_fired, expected_timers_fired);
+            EXPECT_GT(latency_samples, 0);
+        });
+    }
+
+    TEST(fiber, StackClass) {
+        fiber_config::get_global_fiber_config().fiber_stack_usage_sampling_rate = 1;
+        run_as_fiber([] {
+            // Touch most of the stack.
+            auto use_stack = [](std::size_t bytes) {
+                auto p = static_cast<volatile char *>(alloca(bytes));
+                for (std::size_t i = 0; i < bytes; i += 64) {
+                    p[i] = 1;
+                }
+            };
+            std::vector<fiber> fs;
+            fs.emplace_back(fiber::attributes{.stack_class = fiber_stack_class::eSmall},
+                            [&] { use_stack(16384); });
+            fs.emplace_back(fiber::attributes{.stack_class = fiber_stack_class::eNormal},
+                            [&] { use_stack(65536); });
+            fs.emplace_back(fiber::attributes{.stack_class = fiber_stack_class::eLarge},
+                            [&] { use_stack(524288); });
+            for (auto &&e : fs) {
+                e.join();
+            }
+
+            auto scope = metrics::scope::new_root_scope("fiber", ".", {});
+            report_runtime_metrics(scope);
+            std::vector<metrics::cache_metrics> collected;
+            scope->collect(collected);
+            std::uint64_t samples = 0, deep_samples = 0;
+            for (auto &&e : collected) {
+                if (e.name == "fiber_stack_usage_bytes") {
+                    samples = e.histogram.sample_count;
+                    for (auto &&b : e.histogram.bucket) {
+                        if (b.upper_bound == 524288) {
+                            deep_samples = samples - b.cumulative_count;
+                        }
+                    }
+                }
+            }
+            // Some fibers are started by the runtime (and us) as well.
+            EXPECT_GE(samples, 3);
+            EXPECT_GE(deep_samples, 1);  // The one on the large stack.
+        });
+        fiber_config::get_global_fiber_config().fiber_stack_usage_sampling_rate = 0;
+    }
+
     TEST(fiber, BatchStart) {
         run_as_fiber([&] {
             static constexpr auto N = 10;
@@ -205,6 +295,33 @@ namespace abel {
         });
     }
 
+    TEST(fiber, WakerSpinsUntilWakeeRuns) {
+        fiber_config::get_global_fiber_config().fiber_stack_enable_guard_page = false;
+
+        run_as_fiber([] {
+            for (int i = 0; i != 100; ++i) {
+                fiber_latch latch(1);
+                std::atomic<bool> woken{};
+                fiber wakee([&] {
+                    latch.wait();
+                    woken = true;
+                });
+                // Let `wakee` block on the latch.
+                fiber_sleep_for(abel::duration::milliseconds(1));
+
+                // `wakee` goes to our worker's "run next" slot, and we never give
+                // the worker up. Someone else has to run it.
+                latch.count_down();
+                auto deadline = abel::time_now() + abel::duration::seconds(10);
+                while (!woken && abel::time_now() < deadline) {
+                    // NOTHING.
+                }
+                ASSERT_TRUE(woken);
+                wakee.join();
+            }
+        });
+    }
+
     TEST(fiber, start_fiber_from_pthread) {
         run_as_fiber([&] {
             std::atomic<bool> called{};
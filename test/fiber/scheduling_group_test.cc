@@ -138,6 +138,67 @@ namespace fiber_internal {
     }
 
 
+    TEST(scheduling_group, PingPong) {
+        // Fibers woken up by fibers go to worker's local queue, and are possibly stolen
+        // by other workers.
+        constexpr auto kPairs = 64;
+        constexpr auto kRounds = 1000;
+
+        struct ping_pong_context {
+            fiber_mutex lock;
+            fiber_cond cv;
+            int turn = 0;
+        };
+
+        auto sg =
+                std::make_unique<scheduling_group>(core_affinity(), 4);
+        std::thread workers[4];
+        timer_worker dummy(sg.get());
+        sg->set_timer_worker(&dummy);
+
+        for (int i = 0; i != 4; ++i) {
+            workers[i] = std::thread(WorkerTest, sg.get(), i);
+        }
+
+        std::atomic<std::size_t> done{};
+        auto contexts = std::make_unique<ping_pong_context[]>(kPairs);
+        for (int i = 0; i != kPairs; ++i) {
+            for (int parity = 0; parity != 2; ++parity) {
+                testing::start_fiber_entity_in_group(sg.get(), false, [&, i, parity] {
+                    auto &&ctx = contexts[i];
+                    for (int j = 0; j != kRounds; ++j) {
+                        std::unique_lock lk(ctx.lock);
+                        ctx.cv.wait(lk, [&] { return ctx.turn % 2 == parity; });
+                        ++ctx.turn;
+                        ctx.cv.notify_one();
+                    }
+                    ++done;
+                });
+            }
+        }
+        while (done != kPairs * 2) {
+            std::this_thread::sleep_for(10ms);
+        }
+        sg->stop();
+        for (auto &&t : workers) {
+            t.join();
+        }
+        for (int i = 0; i != kPairs; ++i) {
+            ASSERT_EQ(kRounds * 2, contexts[i].turn);
+        }
+
+        // Each round wakes up the peer at least once.
+        auto stats = sg->get_stats();
+        EXPECT_GE(stats.fibers_run, kPairs * kRounds * 2);
+        std::uint64_t sampled = 0;
+        for (auto &&e : stats.ready_to_run_latency) {
+            sampled += e;
+        }
+        EXPECT_GT(sampled, 0);
+        EXPECT_LE(sampled, stats.fibers_run / scheduling_group_stats::kSampleInterval);
+        EXPECT_LE(stats.spin_hits, stats.spins);
+    }
+
     std::atomic<std::size_t> switched{};
 
     void SwitchToNewFiber(scheduling_group *sg, bool system_fiber,
@@ -5,7 +5,13 @@
 
 #include "abel/fiber/internal/stack_allocator.h"
 
+#include <sys/mman.h>
 #include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "abel/base/annotation.h"
 #include "abel/log/logging.h"
@@ -38,6 +44,67 @@ namespace abel {
             free_user_stack(stack);
         }
 
+        TEST(StackAllocator, user_stack_classes) {
+            for (auto stack_class : {fiber_stack_class::eSmall, fiber_stack_class::eNormal,
+                                     fiber_stack_class::eLarge}) {
+                auto stack = create_user_stack(stack_class);
+                ASSERT_TRUE(stack);
+                memset(stack, 0, get_user_stack_size(stack_class));
+                free_user_stack(stack, stack_class);
+            }
+            ASSERT_LT(get_user_stack_size(fiber_stack_class::eSmall),
+                      get_user_stack_size(fiber_stack_class::eNormal));
+            ASSERT_GT(get_user_stack_size(fiber_stack_class::eLarge),
+                      get_user_stack_size(fiber_stack_class::eNormal));
+        }
+
+        TEST(StackAllocator, release_user_stack_pages) {
+            auto page_size = getpagesize();
+            auto stack_class = fiber_stack_class::eLarge;
+            auto stack_size = get_user_stack_size(stack_class);
+            auto watermark = fiber_config::get_global_fiber_config().fiber_stack_release_watermark;
+            ASSERT_LT(watermark, stack_size);
+            auto stack = reinterpret_cast<char *>(create_user_stack(stack_class));
+            auto resident_pages = [&] {
+                std::vector<unsigned char> pages(stack_size / page_size);
+                EXPECT_EQ(0, mincore(stack, stack_size, pages.data()));
+                return std::count_if(pages.begin(), pages.end(), [](auto e) { return e & 1; });
+            };
+
+            // Pages beyond the watermark are released.
+            memset(stack, 1, stack_size);
+            ASSERT_EQ(stack_size / page_size, resident_pages());
+            release_user_stack_pages(stack, stack_size);
+            ASSERT_EQ(watermark / page_size, resident_pages());
+            ASSERT_EQ(1, stack[stack_size - 1]);
+
+            // Shallow usage is kept. The page right beyond the watermark is probed,
+            // which maps the (shared) zero page, nothing else is touched.
+            memset(stack + stack_size - watermark, 2, watermark);
+            release_user_stack_pages(stack, stack_size);
+            ASSERT_EQ(watermark / page_size + 1, resident_pages());
+            ASSERT_EQ(2, stack[stack_size - 1]);
+            free_user_stack(stack, stack_class);
+        }
+
+        TEST(StackAllocator, stack_usage_sampling) {
+            constexpr auto kUsed = 20000;  // Falls into the 32K bucket.
+            auto stack_size = get_user_stack_size(fiber_stack_class::eNormal);
+            auto stack = reinterpret_cast<char *>(create_user_stack());
+            memset(stack, 1, stack_size);  // Dirtied by a previous user.
+
+            std::uint64_t before[kStackUsageBuckets], after[kStackUsageBuckets];
+            get_stack_usage_samples(before);
+            prepare_stack_usage_sampling(stack, stack_size);
+            memset(stack + stack_size - kUsed, 1, kUsed);
+            record_stack_usage(stack, stack_size);
+            get_stack_usage_samples(after);
+            for (std::size_t i = 0; i != kStackUsageBuckets; ++i) {
+                ASSERT_EQ(before[i] + (i == 5 ? 1 : 0), after[i]);
+            }
+            free_user_stack(stack);
+        }
+
 #ifndef ABEL_INTERNAL_USE_ASAN
 
         TEST(StackAllocator, system_stack
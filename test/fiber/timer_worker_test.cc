@@ -10,6 +10,7 @@
 #include "abel/thread/latch.h"
 #include "abel/base/random.h"
 #include "abel/fiber/internal/scheduling_group.h"
+#include "abel/fiber/fiber_config.h"
 
 using namespace std::literals;
 
@@ -88,6 +89,59 @@ namespace abel {
             ASSERT_TRUE(called);
         }
 
+        TEST(timer_worker, TimingWheel) {
+            constexpr auto N = 10000;
+            std::atomic<std::size_t> fired = 0, periodic_fired = 0;
+
+            auto &&config = fiber_config::get_global_fiber_config();
+            auto old_config = config;
+            config.fiber_timer_timing_wheel = true;
+            config.fiber_timer_wheel_tick_us = 1000;
+
+            auto sg =
+                    std::make_unique<scheduling_group>(core_affinity(), 1);
+            timer_worker worker(sg.get());
+            sg->set_timer_worker(&worker);
+            std::thread t = std::thread([&] {
+                sg->enter_group(0);
+
+                std::vector<std::uint64_t> cancelling;
+                for (int i = 0; i != N; ++i) {
+                    auto expires_at = abel::time_now() + abel::duration::milliseconds(Random(500));
+                    if (i % 2 == 0) {
+                        (void) set_timer_at(sg, expires_at, [&, expires_at](auto tid) {
+                            EXPECT_GE(abel::time_now(), expires_at);  // Never fires early.
+                            sg->remove_timer(tid);
+                            ++fired;
+                        });
+                    } else {
+                        // Far enough to be cancelled before firing.
+                        cancelling.push_back(set_timer_at(
+                                sg, expires_at + abel::duration::seconds(10),
+                                [](auto) { ADD_FAILURE(); }));
+                    }
+                }
+                auto periodic = sg->create_timer(abel::time_now(), abel::duration::milliseconds(10),
+                                                 [&](auto) { ++periodic_fired; });
+                sg->enable_timer(periodic);
+                for (auto &&e : cancelling) {
+                    sg->remove_timer(e);
+                }
+                std::this_thread::sleep_for(1s);
+                sg->remove_timer(periodic);
+                sg->leave_group();
+            });
+
+            worker.start();
+            t.join();
+            worker.stop();
+            worker.join();
+            config = old_config;
+
+            EXPECT_EQ(N / 2, fired);
+            EXPECT_GT(periodic_fired, 50);
+        }
+
         std::atomic<std::size_t> timer_set, timer_removed;
 
         TEST(timer_worker, Torture) {
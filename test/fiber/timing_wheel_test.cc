@@ -0,0 +1,128 @@
+//
+// Created by liyinbin on 2021/5/8.
+//
+
+#include "abel/fiber/internal/timing_wheel.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "abel/base/random.h"
+
+namespace abel {
+    namespace fiber_internal {
+
+        struct test_timer : timing_wheel_hook {
+            std::uint64_t deadline;
+            std::uint64_t fired_at = 0;
+            int fire_count = 0;
+        };
+
+        TEST(timing_wheel, Basic) {
+            timing_wheel<test_timer> wheel(100);
+            test_timer t1, t2, t3;
+            wheel.insert(&t1, 105);
+            wheel.insert(&t2, 100);  // Expired already.
+            wheel.insert(&t3, 103);
+            ASSERT_EQ(3, wheel.size());
+            EXPECT_EQ(100, wheel.next_expiry_tick());
+
+            std::vector<test_timer *> fired;
+            auto on_expired = [&](test_timer *t) { fired.push_back(t); };
+            wheel.advance(100, on_expired);
+            ASSERT_EQ(1, fired.size());
+            EXPECT_EQ(&t2, fired[0]);
+            EXPECT_EQ(103, wheel.next_expiry_tick());
+
+            wheel.advance(104, on_expired);
+            ASSERT_EQ(2, fired.size());
+            EXPECT_EQ(&t3, fired[1]);
+
+            wheel.advance(1000, on_expired);
+            ASSERT_EQ(3, fired.size());
+            EXPECT_EQ(&t1, fired[2]);
+            EXPECT_TRUE(wheel.empty());
+            EXPECT_EQ(std::numeric_limits<std::uint64_t>::max(), wheel.next_expiry_tick());
+            EXPECT_EQ(1000, wheel.current_tick());
+        }
+
+        TEST(timing_wheel, Erase) {
+            timing_wheel<test_timer> wheel;
+            test_timer t1, t2;
+            wheel.insert(&t1, 10);
+            wheel.insert(&t2, 100000);  // In an outer level.
+            EXPECT_TRUE(wheel.erase(&t1));
+            EXPECT_FALSE(wheel.erase(&t1));
+            EXPECT_TRUE(wheel.erase(&t2));
+            EXPECT_TRUE(wheel.empty());
+
+            bool fired = false;
+            wheel.advance(200000, [&](auto) { fired = true; });
+            EXPECT_FALSE(fired);
+        }
+
+        TEST(timing_wheel, ReinsertOnExpiry) {
+            timing_wheel<test_timer> wheel;
+            test_timer t;
+            wheel.insert(&t, 10);
+            wheel.advance(1000, [&](test_timer *p) {
+                // Periodic timer, fired every 10 ticks.
+                p->fired_at = wheel.current_tick();
+                if (++p->fire_count != 100) {
+                    wheel.insert(p, p->expires_tick + 10);
+                }
+            });
+            EXPECT_EQ(100, t.fire_count);
+            EXPECT_EQ(1000, t.fired_at);
+            EXPECT_TRUE(wheel.empty());
+        }
+
+        TEST(timing_wheel, Torture) {
+            constexpr auto N = 100000;
+            // Cover all levels, including timers beyond the wheel's span.
+            constexpr std::uint64_t kRange = timing_wheel<test_timer>::kMaxSpan * 2;
+
+            timing_wheel<test_timer> wheel(12345);
+            std::vector<std::unique_ptr<test_timer>> timers;
+            for (int i = 0; i != N; ++i) {
+                auto t = std::make_unique<test_timer>();
+                // Biased towards near timers, as in practice.
+                auto range = i % 2 ? kRange : 10000;
+                t->deadline = wheel.current_tick() + Random<std::uint64_t>(range);
+                wheel.insert(t.get(), t->deadline);
+                timers.push_back(std::move(t));
+            }
+            std::size_t erased = 0;
+            for (int i = 0; i < N; i += 7) {
+                erased += wheel.erase(timers[i].get());
+            }
+            ASSERT_EQ(N - erased, wheel.size());
+
+            std::uint64_t last_deadline = 0;
+            std::size_t fired = 0;
+            auto on_expired = [&](test_timer *t) {
+                // Never early, never late, and in order.
+                ASSERT_EQ(t->deadline, wheel.current_tick());
+                ASSERT_GE(t->deadline, last_deadline);
+                last_deadline = t->deadline;
+                ++t->fire_count;
+                ++fired;
+            };
+            while (!wheel.empty()) {
+                auto next = wheel.next_expiry_tick();
+                ASSERT_GE(next, wheel.current_tick());
+                // Advance in irregular steps.
+                wheel.advance(next + Random<std::uint64_t>(100), on_expired);
+            }
+            EXPECT_EQ(N - erased, fired);
+            for (int i = 0; i != N; ++i) {
+                ASSERT_EQ(i % 7 ? 1 : 0, timers[i]->fire_count);
+            }
+        }
+
+    }  // namespace fiber_internal
+}  // namespace abel
@@ -0,0 +1,162 @@
+//
+// Created by liyinbin on 2021/5/8.
+//
+
+
+#include "abel/fiber/uring_io_stream.h"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "abel/fiber/fiber.h"
+#include "abel/fiber/fiber_config.h"
+#include "abel/fiber/fiber_io.h"
+#include "abel/fiber/this_fiber.h"
+#include "abel/io/fd_utility.h"
+#include "testing/fiber.h"
+
+namespace abel {
+
+    class uring_io_stream_test : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            fiber_config::get_global_fiber_config().fiber_enable_io_uring = true;
+        }
+
+        void TearDown() override {
+            fiber_config::get_global_fiber_config().fiber_enable_io_uring = false;
+        }
+    };
+
+    TEST_F(uring_io_stream_test, ReadWaitsForData) {
+        testing::run_as_fiber([] {
+            int fds[2];
+            ASSERT_EQ(0, pipe(fds));
+            uring_io_stream reader(fds[0]), writer(fds[1]);
+            if (!reader.is_uring_enabled()) {
+                std::cerr << "io_uring is not usable, falling back to plain syscalls."
+                          << std::endl;
+            }
+            std::atomic<bool> written{false};
+
+            fiber f([&] {
+                fiber_sleep_for(abel::duration::milliseconds(100));
+                written = true;
+                iovec iov[2] = {{const_cast<char *>("hel"), 3},
+                                {const_cast<char *>("lo"), 2}};
+                ASSERT_EQ(5, writer.writev(iov, 2));
+            });
+
+            // The pipe is blocking, only the calling fiber is parked.
+            iobuf buffer;
+            ASSERT_EQ(5, reader.read(&buffer, 100));
+            EXPECT_TRUE(written);
+            EXPECT_EQ("hello", flatten_slow(buffer));
+            f.join();
+
+            close(fds[1]);
+            ASSERT_EQ(0, reader.read(&buffer, 100));  // EOF.
+            close(fds[0]);
+        });
+    }
+
+    TEST_F(uring_io_stream_test, NonBlocking) {
+        testing::run_as_fiber([] {
+            int fds[2];
+            ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+            make_non_blocking(fds[0]);
+            make_non_blocking(fds[1]);
+
+            {
+                fiber_io_descriptor desc(fds[0]);
+                auto reader = make_fiber_io_stream(fds[0]);
+                uring_io_stream writer(fds[1]);
+
+                char buf[16];
+                iovec iov = {buf, sizeof(buf)};
+                ASSERT_EQ(-1, reader->readv(&iov, 1));
+                ASSERT_EQ(EAGAIN, errno);
+
+                fiber f([&] {
+                    fiber_sleep_for(abel::duration::milliseconds(10));
+                    iovec iov = {const_cast<char *>("hello"), 5};
+                    ASSERT_EQ(5, writer.writev(&iov, 1));
+                });
+
+                // Works with fiber I/O helpers.
+                iobuf buffer;
+                std::size_t bytes_read;
+                ASSERT_EQ(read_status::eDrained,
+                          fiber_read_iobuf(100, &desc, reader.get(), &buffer, &bytes_read));
+                EXPECT_EQ("hello", flatten_slow(buffer));
+                f.join();
+            }
+            close(fds[0]);
+            close(fds[1]);
+        });
+    }
+
+    TEST_F(uring_io_stream_test, Concurrent) {
+        testing::run_as_fiber([] {
+            constexpr auto kFibers = 64;
+            constexpr auto kRounds = 100;
+            std::vector<fiber> fibers;
+            for (int i = 0; i != kFibers; ++i) {
+                fibers.emplace_back([] {
+                    int fds[2];
+                    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+                    uring_io_stream left(fds[0]), right(fds[1]);
+                    fiber echo([&] {
+                        iobuf buffer;
+                        while (right.read(&buffer, 100) > 0) {
+                            auto s = flatten_slow(buffer);
+                            buffer.clear();
+                            iovec iov = {s.data(), s.size()};
+                            ASSERT_EQ(s.size(), right.writev(&iov, 1));
+                        }
+                    });
+                    for (int j = 0; j != kRounds; ++j) {
+                        auto s = std::to_string(j);
+                        iovec iov = {s.data(), s.size()};
+                        ASSERT_EQ(s.size(), left.writev(&iov, 1));
+                        char buf[16];
+                        iov = {buf, sizeof(buf)};
+                        ASSERT_EQ(s.size(), left.readv(&iov, 1));
+                        ASSERT_EQ(s, std::string(buf, s.size()));
+                    }
+                    shutdown(fds[0], SHUT_WR);
+                    echo.join();
+                    close(fds[0]);
+                    close(fds[1]);
+                });
+            }
+            for (auto &&e : fibers) {
+                e.join();
+            }
+        });
+    }
+
+    TEST(uring_io_stream, Fallback) {
+        testing::run_as_fiber([] {
+            int fds[2];
+            ASSERT_EQ(0, pipe(fds));
+            uring_io_stream reader(fds[0]), writer(fds[1]);
+            ASSERT_FALSE(reader.is_uring_enabled());  // Not enabled by default.
+            iovec iov = {const_cast<char *>("hello"), 5};
+            ASSERT_EQ(5, writer.writev(&iov, 1));
+            iobuf buffer;
+            ASSERT_EQ(5, reader.read(&buffer, 100));
+            EXPECT_EQ("hello", flatten_slow(buffer));
+            close(fds[0]);
+            close(fds[1]);
+        });
+    }
+
+}  // namespace abel
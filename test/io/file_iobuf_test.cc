@@ -0,0 +1,127 @@
+//
+// Created by liyinbin on 2021/5/1.
+//
+
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "abel/base/random.h"
+#include "abel/io/iobuf.h"
+#include "abel/io/temp_file.h"
+#include "abel/io/write_iobuf_list.h"
+
+namespace abel {
+
+    class file_iobuf_test : public ::testing::Test {
+    public:
+        void SetUp() override {
+            for (int i = 0; i != 100000; ++i) {
+                content_.push_back(Random<char>());
+            }
+            ASSERT_EQ(0, file_.save_bin(content_.data(), content_.size()));
+        }
+
+    protected:
+        temp_file file_;
+        std::string content_;
+    };
+
+    // A stream that does not support `sendfile`.
+    class string_io_stream : public io_stream_base {
+    public:
+        hand_shake_status handshake() override { return hand_shake_status::eSuccess; }
+
+        ssize_t readv(const iovec *iov, int iovcnt) override { return -1; }
+
+        ssize_t writev(const iovec *iov, int iovcnt) override {
+            ssize_t rc = 0;
+            for (int i = 0; i != iovcnt; ++i) {
+                written.append(reinterpret_cast<const char *>(iov[i].iov_base), iov[i].iov_len);
+                rc += iov[i].iov_len;
+            }
+            return rc;
+        }
+
+        std::string written;
+    };
+
+    // Flush everything in `list` into `io`.
+    void flush_all(write_iobuf_list *list, io_stream_base *io) {
+        std::vector<std::uintptr_t> ctxs;
+        bool emptied = false, short_write;
+        while (!emptied) {
+            ASSERT_GT(list->flush(io, 65536, &ctxs, &emptied, &short_write), 0);
+        }
+    }
+
+    TEST_F(file_iobuf_test, Read) {
+        auto buffer = make_file_iobuf(file_.fname(), 0, content_.size());
+        ASSERT_TRUE(buffer);
+        EXPECT_EQ(content_, flatten_slow(*buffer));
+
+        // Unaligned offset.
+        buffer = make_file_iobuf(file_.fname(), 12345, 54321);
+        ASSERT_TRUE(buffer);
+        EXPECT_EQ(content_.substr(12345, 54321), flatten_slow(*buffer));
+
+        // Shared by slices.
+        auto copy = *buffer;
+        buffer->skip(1000);
+        EXPECT_EQ(content_.substr(13345, 53321), flatten_slow(*buffer));
+        EXPECT_EQ(content_.substr(12345, 54321), flatten_slow(copy));
+
+        buffer = make_file_iobuf(file_.fname(), content_.size(), 0);
+        ASSERT_TRUE(buffer);
+        EXPECT_TRUE(buffer->empty());
+    }
+
+    TEST_F(file_iobuf_test, Error) {
+        EXPECT_FALSE(make_file_iobuf("/path/to/nowhere", 0, 1));
+        EXPECT_EQ(ENOENT, errno);
+        EXPECT_FALSE(make_file_iobuf(file_.fname(), 1, content_.size()));
+        EXPECT_EQ(EINVAL, errno);
+    }
+
+    TEST_F(file_iobuf_test, FlushViaSendfile) {
+        int fds[2];
+        ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+        std::string received;
+        std::thread reader([&] {
+            char buf[4096];
+            ssize_t rc;
+            while ((rc = read(fds[1], buf, sizeof(buf))) > 0) {
+                received.append(buf, rc);
+            }
+        });
+
+        write_iobuf_list list;
+        list.append(create_buffer_slow("header"), 0);
+        list.append(*make_file_iobuf(file_.fname(), 100, 90000), 1);
+        list.append(create_buffer_slow("trailer"), 2);
+        system_io_stream io(fds[0]);
+        flush_all(&list, &io);
+        shutdown(fds[0], SHUT_WR);
+        reader.join();
+        EXPECT_EQ("header" + content_.substr(100, 90000) + "trailer", received);
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    TEST_F(file_iobuf_test, FlushWithoutSendfile) {
+        write_iobuf_list list;
+        list.append(create_buffer_slow("header"), 0);
+        list.append(*make_file_iobuf(file_.fname(), 100, 90000), 1);
+        string_io_stream io;
+        flush_all(&list, &io);
+        EXPECT_EQ("header" + content_.substr(100, 90000), io.written);
+    }
+
+}  // namespace abel
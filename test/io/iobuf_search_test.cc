@@ -0,0 +1,115 @@
+//
+// Created by liyinbin on 2021/4/19.
+//
+
+
+#include "abel/io/iobuf_search.h"
+
+#include <initializer_list>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "abel/base/random.h"
+
+namespace abel {
+
+    iobuf make_iobuf_of(std::initializer_list<std::string> slices) {
+        iobuf buffer;
+        for (auto &&e : slices) {
+            buffer.append(make_foreign_slice(e));
+        }
+        return buffer;
+    }
+
+    TEST(iobuf_search, FindChar) {
+        auto buffer = make_iobuf_of({"hello", std::string(100, 'a') + "x", "world"});
+        EXPECT_EQ(0, find(buffer, 'h'));
+        EXPECT_EQ(4, find(buffer, 'o'));
+        EXPECT_EQ(5, find(buffer, 'a'));
+        EXPECT_EQ(105, find(buffer, 'x'));
+        EXPECT_EQ(107, find(buffer, 'o', 5));
+        EXPECT_EQ(110, find(buffer, 'd'));
+        EXPECT_EQ(iobuf_npos, find(buffer, 'z'));
+        EXPECT_EQ(iobuf_npos, find(buffer, 'h', 1000));
+        EXPECT_EQ(iobuf_npos, find(iobuf(), 'h'));
+    }
+
+    TEST(iobuf_search, FindPattern) {
+        auto buffer = make_iobuf_of(
+                {std::string(100, 'a') + "GET / HTTP/1.1\r\n", "Host: x\r\n\r\nbody"});
+        EXPECT_EQ(100, find(buffer, "GET"));
+        EXPECT_EQ(114, find(buffer, "\r\n"));
+        EXPECT_EQ(123, find(buffer, "\r\n", 115));
+        EXPECT_EQ(123, find(buffer, "\r\n\r\n"));
+        EXPECT_EQ(127, find(buffer, "body"));
+        EXPECT_EQ(98, find(buffer, "aaG"));
+        EXPECT_EQ(iobuf_npos, find(buffer, "bodyy"));
+        EXPECT_EQ(iobuf_npos, find(buffer, "\r\n\r\n", 124));
+        EXPECT_EQ(5, find(buffer, "", 5));
+    }
+
+    TEST(iobuf_search, PatternAcrossSlices) {
+        // The pattern spreads over three slices.
+        auto buffer = make_iobuf_of({"xx\r", "\n", "\r\nyy"});
+        EXPECT_EQ(2, find(buffer, "\r\n\r\n"));
+        EXPECT_EQ(1, find(buffer, "x\r\n\r\ny"));
+        // Partial matches at the end of a slice are not mistaken for a match.
+        buffer = make_iobuf_of({"ab\r\n\r", "x\r\n", "\r\n"});
+        EXPECT_EQ(6, find(buffer, "\r\n\r\n"));
+        // The buffer ends in the middle of the pattern.
+        buffer = make_iobuf_of({"abc", "\r\n\r"});
+        EXPECT_EQ(iobuf_npos, find(buffer, "\r\n\r\n"));
+    }
+
+    TEST(iobuf_search, FindAnyOf) {
+        auto buffer = make_iobuf_of({std::string(40, 'a'), std::string(40, 'b') + ";"});
+        EXPECT_EQ(0, find_any_of(buffer, "ab"));
+        EXPECT_EQ(40, find_any_of(buffer, "cb"));
+        EXPECT_EQ(80, find_any_of(buffer, ",;"));
+        EXPECT_EQ(iobuf_npos, find_any_of(buffer, "xyz"));
+        EXPECT_EQ(iobuf_npos, find_any_of(buffer, ""));
+        // Too many needles for comparing with each of them.
+        EXPECT_EQ(80, find_any_of(buffer, "0123456789ABCDEFGHIJ;"));
+        EXPECT_EQ(50, find_any_of(buffer, "0123456789ABCDEFGHIJb", 50));
+    }
+
+    TEST(iobuf_search, Random) {
+        std::string str;
+        for (int i = 0; i != 10000; ++i) {
+            str.push_back('a' + Random(3));
+        }
+        iobuf buffer;
+        for (std::size_t i = 0; i < str.size();) {
+            auto len = std::min<std::size_t>(Random(1, 100), str.size() - i);
+            buffer.append(make_foreign_slice(str.substr(i, len)));
+            i += len;
+        }
+        for (auto &&pattern : {"a", "ab", "abc", "dab", "cabab", "aaaaa", "abcabcab"}) {
+            for (std::size_t start = 0; start < str.size(); start += 997) {
+                auto expected = str.find(pattern, start);
+                EXPECT_EQ(expected == std::string::npos ? iobuf_npos : expected,
+                          find(buffer, pattern, start));
+            }
+        }
+        for (std::size_t start = 0; start < str.size(); start += 997) {
+            auto expected = str.find_first_of("cd", start);
+            EXPECT_EQ(expected == std::string::npos ? iobuf_npos : expected,
+                      find_any_of(buffer, "cd", start));
+        }
+    }
+
+    TEST(iobuf_search, CutUntil) {
+        auto buffer = make_iobuf_of({"*3\r", "\n$3\r\nSET\r\n", "$1\r\nk"});
+        auto line = cut_until(&buffer, "\r\n");
+        ASSERT_TRUE(line);
+        EXPECT_EQ("*3\r\n", flatten_slow(*line));
+        line = cut_until(&buffer, "\r\n");
+        ASSERT_TRUE(line);
+        EXPECT_EQ("$3\r\n", flatten_slow(*line));
+        EXPECT_EQ("SET\r\n", flatten_slow(*cut_until(&buffer, "\r\n")));
+        EXPECT_EQ("$1\r\n", flatten_slow(*cut_until(&buffer, "\r\n")));
+        EXPECT_FALSE(cut_until(&buffer, "\r\n"));
+        EXPECT_EQ("k", flatten_slow(buffer));
+    }
+
+}  // namespace abel
@@ -0,0 +1,82 @@
+//
+// Created by liyinbin on 2021/4/19.
+//
+
+
+#include "abel/io/iobuf.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "abel/base/random.h"
+
+namespace abel {
+
+    std::string random_string(std::size_t size) {
+        std::string str;
+        for (std::size_t i = 0; i != size; ++i) {
+            str.push_back(Random<char>());
+        }
+        return str;
+    }
+
+    std::size_t count_slices(const iobuf &buffer) {
+        std::size_t slices = 0;
+        for ([[maybe_unused]] auto &&e : buffer) {
+            ++slices;
+        }
+        return slices;
+    }
+
+    TEST(iobuf_builder, SmallPayloadUsesSmallBlocks) {
+        iobuf_builder builder;
+        builder.append("hello");
+        ASSERT_LT(builder.size_available(), 4096);
+        auto buffer = builder.destructive_get();
+        EXPECT_EQ("hello", flatten_slow(buffer));
+    }
+
+    TEST(iobuf_builder, BlockSizeGrows) {
+        auto source = random_string(10 * 1024 * 1024);
+        iobuf_builder builder;
+        for (std::size_t i = 0; i < source.size(); i += 1000) {
+            builder.append(source.data() + i, std::min<std::size_t>(1000, source.size() - i));
+        }
+        auto buffer = builder.destructive_get();
+        ASSERT_EQ(source, flatten_slow(buffer));
+        // Would be 2600+ slices with 4K blocks only.
+        EXPECT_LT(count_slices(buffer), 100);
+    }
+
+    TEST(iobuf_builder, ReserveHint) {
+        auto source = random_string(10 * 1024 * 1024);
+        iobuf_builder builder;
+        builder.reserve_hint(source.size());
+        ASSERT_GE(builder.size_available(), 1000000);
+        builder.append(source.data(), source.size());
+        auto buffer = builder.destructive_get();
+        ASSERT_EQ(source, flatten_slow(buffer));
+        EXPECT_LE(count_slices(buffer), 11);
+
+        // The hint does not affect blocks already in use.
+        iobuf_builder builder2;
+        builder2.append("x");
+        auto available = builder2.size_available();
+        builder2.reserve_hint(1048576);
+        EXPECT_EQ(available, builder2.size_available());
+        EXPECT_EQ("x", flatten_slow(builder2.destructive_get()));
+    }
+
+    TEST(iobuf_builder, AppendMultiple) {
+        iobuf_builder builder;
+        std::string s = "world";
+        std::string_view sv = "!";
+        builder.append("hello ", s, sv);
+        // Crosses block boundary.
+        auto large = random_string(10000);
+        builder.append(s, large, "tail");
+        EXPECT_EQ("hello world!" + s + large + "tail",
+                  flatten_slow(builder.destructive_get()));
+    }
+
+}  // namespace abel
@@ -16,6 +16,7 @@
 
 #include "abel/base/random.h"
 #include "abel/io/fd_utility.h"
+#include "abel/io/temp_file.h"
 
 using namespace std::literals;
 
@@ -90,6 +91,88 @@ namespace abel {
         EXPECT_EQ("1234567", flatten_slow(buffer_));
     }
 
+    TEST(read_iobuf, LargeTransferUsesLargeBlocks) {
+        constexpr auto kSize = 10 * 1024 * 1024;
+        std::string source;
+        for (int i = 0; i != kSize; ++i) {
+            source.push_back(Random<char>());
+        }
+        temp_file file;
+        ASSERT_EQ(0, file.save_bin(source.data(), source.size()));
+        int fd = open(file.fname(), O_RDONLY);
+        ASSERT_GE(fd, 0);
+        system_io_stream io(fd);
+
+        iobuf buffer;
+        std::size_t bytes_read;
+        ASSERT_EQ(read_status::eMaxBytesRead,
+                  read_iobuf(kSize, &io, &buffer, &bytes_read));
+        ASSERT_EQ(kSize, bytes_read);
+        ASSERT_EQ(flatten_slow(buffer), source);
+        // Would be 2600+ slices with 4K blocks only.
+        std::size_t slices = 0;
+        for ([[maybe_unused]] auto &&e : buffer) {
+            ++slices;
+        }
+        EXPECT_LT(slices, 100);
+        close(fd);
+    }
+
+    TEST_F(read_iobuf_test, AdaptiveReader) {
+        adaptive_iobuf_reader reader;
+        ASSERT_EQ(read_status::eDrained,
+                  reader.read(8, io_.get(), &buffer_, &bytes_read_));
+        EXPECT_EQ("1234567", flatten_slow(buffer_));
+        EXPECT_EQ(7, bytes_read_);
+        EXPECT_EQ(7, reader.total_bytes_read());
+        EXPECT_EQ(get_native_iobuf_block_size(0) - 7, reader.total_bytes_wasted());
+
+        ASSERT_EQ(read_status::eDrained,
+                  reader.read(8, io_.get(), &buffer_, &bytes_read_));
+        EXPECT_EQ(0, bytes_read_);
+
+        DCHECK(close(fd_[1]) == 0);
+        ASSERT_EQ(read_status::eEof,
+                  reader.read(8, io_.get(), &buffer_, &bytes_read_));
+    }
+
+    TEST(adaptive_iobuf_reader, Probing) {
+        constexpr auto kSize = 100000;
+        int fd[2];
+        DCHECK(pipe(fd) == 0);
+#if defined(ABEL_PLATFORM_LINUX)
+        ASSERT_GE(fcntl(fd[0], F_SETPIPE_SZ, 1048576), kSize);
+#endif
+        make_non_blocking(fd[0]);
+        system_io_stream io(fd[0]);
+
+        std::string source;
+        for (int i = 0; i != kSize; ++i) {
+            source.push_back(Random<char>());
+        }
+        ASSERT_EQ(kSize, write(fd[1], source.data(), source.size()));
+
+        adaptive_iobuf_reader reader(fd[0]);
+        iobuf buffer;
+        std::size_t bytes_read;
+        ASSERT_EQ(read_status::eDrained, reader.read(1048576, &io, &buffer, &bytes_read));
+        EXPECT_EQ(kSize, bytes_read);
+        EXPECT_EQ(source, flatten_slow(buffer));
+        // Sized to what's pending, so no 4K blocks are used.
+        std::size_t slices = 0;
+        for ([[maybe_unused]] auto &&e : buffer) {
+            ++slices;
+        }
+        EXPECT_LE(slices, 2);
+        EXPECT_GE(reader.expected_bytes(), kSize / 4);
+
+        // Nothing left, and we don't even try reading the pipe again.
+        ASSERT_EQ(read_status::eDrained, reader.read(1048576, &io, &buffer, &bytes_read));
+        EXPECT_EQ(0, bytes_read);
+        close(fd[0]);
+        close(fd[1]);
+    }
+
 /*
     TEST(read_iobuf, LargeChunk) {
 
@@ -0,0 +1,279 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+#include "abel/log/binary_logger.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "abel/log/sinks/base_sink.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+// keeps the payloads it receives (those starting with `prefix`). while
+// closed, the backend thread blocks in it, so the staging rings fill up.
+class collect_sink final : public abel::sinks::base_sink<std::mutex> {
+  public:
+    explicit collect_sink(std::string prefix = "") : prefix_(std::move(prefix)) {}
+
+    std::vector<std::string> messages() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return messages_;
+    }
+
+    void close() {
+        open_ = false;
+    }
+
+    void open() {
+        open_ = true;
+    }
+
+    // wait for the backend thread to block in the sink.
+    void wait_entered() {
+        while (!entered_) {
+            std::this_thread::yield();
+        }
+    }
+
+  protected:
+    void sink_it_(const abel::details::log_msg &msg) override {
+        entered_ = true;
+        while (!open_) {
+            std::this_thread::yield();
+        }
+        if (msg.payload.substr(0, prefix_.size()) == prefix_) {
+            messages_.emplace_back(msg.payload.data(), msg.payload.size());
+        }
+    }
+
+    void flush_() override {}
+
+  private:
+    const std::string prefix_;
+    std::vector<std::string> messages_;
+    std::atomic<bool> open_{true};
+    std::atomic<bool> entered_{false};
+};
+
+uint32_t tag_of(const char *chunk) {
+    // `padding` is 0 for records, the tag lives after the header.
+    return *reinterpret_cast<const uint32_t *>(chunk + sizeof(abel::details::binlog_chunk_header));
+}
+
+char *write_tagged(abel::details::binlog_ring &ring, size_t size, uint32_t tag) {
+    auto chunk = ring.reserve(size);
+    if (!chunk) {
+        return nullptr;
+    }
+    auto header = reinterpret_cast<abel::details::binlog_chunk_header *>(chunk);
+    header->size = static_cast<uint32_t>(size);
+    header->padding = 0;
+    std::memcpy(chunk + sizeof(*header), &tag, sizeof(tag));
+    ring.commit(size);
+    return chunk;
+}
+
+}  // namespace
+
+TEST(binlog_ring, fifo) {
+    abel::details::binlog_ring ring(4096);
+    EXPECT_EQ(ring.max_record_size(), 2048u);
+    EXPECT_EQ(ring.peek(), nullptr);
+    for (uint32_t i = 0; i < 4; ++i) {
+        ASSERT_NE(write_tagged(ring, 1024, i), nullptr);
+    }
+    // full.
+    EXPECT_EQ(ring.reserve(8), nullptr);
+    for (uint32_t i = 0; i < 4; ++i) {
+        auto chunk = ring.peek();
+        ASSERT_NE(chunk, nullptr);
+        EXPECT_EQ(tag_of(chunk), i);
+        ring.consume(chunk);
+    }
+    EXPECT_EQ(ring.peek(), nullptr);
+}
+
+TEST(binlog_ring, wraparound_with_padding) {
+    abel::details::binlog_ring ring(4096);
+    auto first = write_tagged(ring, 1200, 0);
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(write_tagged(ring, 1200, 1), nullptr);
+    ASSERT_NE(write_tagged(ring, 1200, 2), nullptr);
+    // 496 bytes left before the end of the ring, and the oldest records are
+    // still there.
+    EXPECT_EQ(ring.reserve(1200), nullptr);
+    for (uint32_t i = 0; i < 2; ++i) {
+        auto chunk = ring.peek();
+        ASSERT_NE(chunk, nullptr);
+        EXPECT_EQ(tag_of(chunk), i);
+        ring.consume(chunk);
+    }
+    // doesn't fit before the end, the tail of the ring is padded and the
+    // record goes at the beginning.
+    auto wrapped = write_tagged(ring, 1200, 3);
+    EXPECT_EQ(wrapped, first);
+
+    auto chunk = ring.peek();
+    ASSERT_NE(chunk, nullptr);
+    EXPECT_EQ(tag_of(chunk), 2u);
+    ring.consume(chunk);
+    // the padding is skipped.
+    chunk = ring.peek();
+    EXPECT_EQ(chunk, wrapped);
+    EXPECT_EQ(tag_of(chunk), 3u);
+    ring.consume(chunk);
+    EXPECT_EQ(ring.peek(), nullptr);
+
+    // and the ring is usable again from there.
+    for (uint32_t i = 4; i < 100; ++i) {
+        ASSERT_NE(write_tagged(ring, 1200 + (i % 3) * 8, i), nullptr);
+        chunk = ring.peek();
+        ASSERT_NE(chunk, nullptr);
+        EXPECT_EQ(tag_of(chunk), i);
+        ring.consume(chunk);
+    }
+    EXPECT_EQ(ring.peek(), nullptr);
+}
+
+TEST(binary_logger, drain) {
+    auto sink = std::make_shared<collect_sink>();
+    auto logger = std::make_shared<abel::binary_logger>("binlog_drain", sink);
+    for (int i = 0; i < 1000; ++i) {
+        BINLOG_INFO(logger, "message {} {}", i, "x");
+    }
+    logger->flush();
+    auto messages = sink->messages();
+    ASSERT_EQ(messages.size(), 1000u);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(messages[i], "message " + std::to_string(i) + " x");
+    }
+}
+
+TEST(binary_logger, deferred_and_regular_ordering) {
+    auto sink = std::make_shared<collect_sink>();
+    auto logger = std::make_shared<abel::binary_logger>("binlog_ordering", sink);
+    for (int i = 0; i < 500; ++i) {
+        BINLOG_INFO(logger, "deferred {}", i);
+        logger->info("regular {}", i);
+    }
+    logger->flush();
+    auto messages = sink->messages();
+    ASSERT_EQ(messages.size(), 1000u);
+    for (int i = 0; i < 500; ++i) {
+        EXPECT_EQ(messages[2 * i], "deferred " + std::to_string(i));
+        EXPECT_EQ(messages[2 * i + 1], "regular " + std::to_string(i));
+    }
+}
+
+TEST(binary_logger, overrun_oldest) {
+    auto sink = std::make_shared<collect_sink>();
+    auto logger = std::make_shared<abel::binary_logger>("binlog_overrun", sink,
+                                                        abel::async_overflow_policy::overrun_oldest);
+    auto backend = abel::details::binlog_backend::instance();
+    // only applies to threads that haven't logged yet.
+    backend->set_thread_buffer_size(4096);
+    const int total = 1000;
+    std::thread producer([&] {
+        sink->close();
+        BINLOG_INFO(logger, "message {}", 0);
+        sink->wait_entered();
+        // the backend is stuck on the first message, the rest can't fit.
+        for (int i = 1; i < total; ++i) {
+            BINLOG_INFO(logger, "message {}", i);
+        }
+        EXPECT_GT(logger->dropped_counter(), 0u);
+        sink->open();
+    });
+    producer.join();
+    backend->set_thread_buffer_size(abel::details::binlog_backend::default_thread_buffer_size);
+    logger->flush();
+
+    auto messages = sink->messages();
+    EXPECT_EQ(messages.size() + logger->dropped_counter(), static_cast<size_t>(total));
+    // the newest messages are the ones dropped, what went through is in order.
+    ASSERT_FALSE(messages.empty());
+    for (size_t i = 0; i < messages.size(); ++i) {
+        EXPECT_EQ(messages[i], "message " + std::to_string(i));
+    }
+}
+
+TEST(binary_logger, producer_thread_exit) {
+    auto sink = std::make_shared<collect_sink>();
+    auto logger = std::make_shared<abel::binary_logger>("binlog_exit", sink);
+    sink->close();
+    logger->info("first");
+    sink->wait_entered();
+    // these are still in the staging rings when their threads exit.
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; ++t) {
+        producers.emplace_back([&logger, t] {
+            for (int i = 0; i < 100; ++i) {
+                BINLOG_INFO(logger, "thread {} message {}", t, i);
+            }
+        });
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    sink->open();
+    logger->flush();
+    auto messages = sink->messages();
+    ASSERT_EQ(messages.size(), 401u);
+    EXPECT_EQ(messages[0], "first");
+
+    // the backend keeps working once the rings of the exited threads are
+    // gone.
+    std::thread([&logger] { BINLOG_INFO(logger, "last"); }).join();
+    logger->flush();
+    messages = sink->messages();
+    ASSERT_EQ(messages.size(), 402u);
+    EXPECT_EQ(messages.back(), "last");
+}
+
+// producers never let the rings go empty, flush() only waits for what was
+// logged before it.
+TEST(binary_logger, flush_under_load) {
+    auto sink = std::make_shared<collect_sink>("marker");
+    auto logger = std::make_shared<abel::binary_logger>("binlog_load", sink);
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; ++t) {
+        producers.emplace_back([&logger, &stop, t] {
+            for (int i = 0; !stop; ++i) {
+                BINLOG_INFO(logger, "thread {} message {}", t, i);
+            }
+        });
+    }
+
+    std::atomic<int> flushed{0};
+    std::thread flusher([&] {
+        for (int i = 0; i < 100; ++i) {
+            BINLOG_INFO(logger, "marker {}", i);
+            logger->flush();
+            auto messages = sink->messages();
+            ASSERT_EQ(messages.size(), static_cast<size_t>(i + 1));
+            EXPECT_EQ(messages.back(), "marker " + std::to_string(i));
+            ++flushed;
+        }
+    });
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (flushed != 100 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(flushed, 100);
+    stop = true;
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    flusher.join();
+}
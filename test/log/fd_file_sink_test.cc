@@ -0,0 +1,131 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+#include "abel/log/sinks/fd_file_sink.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "abel/log/details/os.h"
+#include "abel/log/log.h"
+#include "abel/log/sinks/rotating_file_sink.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+std::string temp_file(const std::string &name) {
+    auto fname = ::testing::TempDir() + "/" + name;
+    abel::details::os::remove_if_exists(fname);
+    for (size_t i = 1; i < 4; ++i) {
+        abel::details::os::remove_if_exists(abel::sinks::rotating_file_sink_st::calc_filename(fname, i));
+    }
+    return fname;
+}
+
+std::vector<std::string> read_lines(const std::string &fname) {
+    std::ifstream in(fname);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(in, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+std::string message(int i) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "message %06d", i);
+    return buf;
+}
+
+}  // namespace
+
+// the periodic flusher and explicit flushes race with the logging threads.
+TEST(fd_file_sink, concurrent_flush) {
+    auto fname = temp_file("fd_file_sink_concurrent.log");
+    abel::fd_file_options options;
+    options.buffer_size = 4096;
+    options.flush_interval = std::chrono::milliseconds(1);
+    auto sink = std::make_shared<abel::sinks::fd_file_sink_mt>(fname, true, options);
+    abel::logger logger("fd_file_concurrent", sink);
+    logger.set_pattern("%v");
+
+    const int threads = 4;
+    const int per_thread = 5000;
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; ++t) {
+        writers.emplace_back([&logger, t] {
+            for (int i = 0; i < per_thread; ++i) {
+                logger.info("thread {} message {}", t, i);
+                if (i % 100 == 0) {
+                    logger.flush();
+                }
+            }
+        });
+    }
+    for (auto &writer : writers) {
+        writer.join();
+    }
+    logger.flush();
+
+    auto lines = read_lines(fname);
+    ASSERT_EQ(lines.size(), static_cast<size_t>(threads * per_thread));
+    std::set<std::string> unique(lines.begin(), lines.end());
+    EXPECT_EQ(unique.size(), lines.size());
+    for (int t = 0; t < threads; ++t) {
+        for (int i = 0; i < per_thread; i += 999) {
+            std::ostringstream expected;
+            expected << "thread " << t << " message " << i;
+            EXPECT_EQ(unique.count(expected.str()), 1u);
+        }
+    }
+}
+
+TEST(fd_file_sink, st_has_no_flusher) {
+    auto fname = temp_file("fd_file_sink_st.log");
+    abel::fd_file_options options;
+    options.flush_interval = std::chrono::milliseconds(1);
+    auto logger = abel::fd_file_logger_st("fd_file_st", fname, true, options);
+    logger->set_pattern("%v");
+    logger->info("buffered");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_TRUE(read_lines(fname).empty());
+    logger->flush();
+    auto lines = read_lines(fname);
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_EQ(lines[0], "buffered");
+    abel::drop("fd_file_st");
+}
+
+TEST(fd_file_sink, factory_rotation) {
+    auto fname = temp_file("fd_file_sink_rotating.log");
+    abel::fd_file_options options;
+    options.flush_interval = std::chrono::milliseconds(0);
+    auto logger = abel::fd_file_logger_mt("fd_file_rotating", fname, true, options, 1024, 2);
+    logger->set_pattern("%v");
+    // 15 bytes a line with the eol, 68 lines a file.
+    for (int i = 0; i < 200; ++i) {
+        logger->info("message {:06d}", i);
+    }
+    logger->flush();
+
+    auto current = read_lines(fname);
+    auto first = read_lines(abel::sinks::rotating_file_sink_st::calc_filename(fname, 1));
+    auto second = read_lines(abel::sinks::rotating_file_sink_st::calc_filename(fname, 2));
+    EXPECT_FALSE(abel::details::os::path_exists(abel::sinks::rotating_file_sink_st::calc_filename(fname, 3)));
+    ASSERT_EQ(current.size(), 64u);
+    ASSERT_EQ(first.size(), 68u);
+    ASSERT_EQ(second.size(), 68u);
+    EXPECT_EQ(second.front(), message(0));
+    EXPECT_EQ(first.front(), message(68));
+    EXPECT_EQ(current.front(), message(136));
+    EXPECT_EQ(current.back(), message(199));
+    abel::drop("fd_file_rotating");
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+#include "abel/log/details/log_sampler.h"
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "abel/log/sinks/ostream_sink.h"
+#include "gtest/gtest.h"
+
+using abel::details::token_bucket;
+
+TEST(token_bucket, unlimited) {
+    token_bucket bucket;
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_TRUE(bucket.try_acquire(1000));
+    }
+    bucket.reset(0, 10);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_TRUE(bucket.try_acquire(1000));
+    }
+}
+
+TEST(token_bucket, burst) {
+    token_bucket bucket(10, 5);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(bucket.try_acquire(1000));
+    }
+    EXPECT_FALSE(bucket.try_acquire(1000));
+    EXPECT_FALSE(bucket.try_acquire(1099));
+
+    // a burst of 0 still lets one message through.
+    token_bucket single(10, 0);
+    EXPECT_TRUE(single.try_acquire(1000));
+    EXPECT_FALSE(single.try_acquire(1000));
+}
+
+TEST(token_bucket, refill) {
+    token_bucket bucket(10, 5);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(bucket.try_acquire(1000));
+    }
+    // a token every 100ms.
+    EXPECT_FALSE(bucket.try_acquire(1050));
+    EXPECT_TRUE(bucket.try_acquire(1100));
+    EXPECT_FALSE(bucket.try_acquire(1100));
+    EXPECT_TRUE(bucket.try_acquire(1200));
+
+    // idle for long, no more than the burst.
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(bucket.try_acquire(10000));
+    }
+    EXPECT_FALSE(bucket.try_acquire(10000));
+}
+
+TEST(token_bucket, release) {
+    token_bucket bucket(10, 2);
+    EXPECT_TRUE(bucket.try_acquire(1000));
+    EXPECT_TRUE(bucket.try_acquire(1000));
+    EXPECT_FALSE(bucket.try_acquire(1000));
+    bucket.release();
+    EXPECT_TRUE(bucket.try_acquire(1000));
+    EXPECT_FALSE(bucket.try_acquire(1000));
+
+    // a full bucket doesn't grow.
+    bucket.release();
+    bucket.release();
+    bucket.release();
+    EXPECT_TRUE(bucket.try_acquire(10000));
+    EXPECT_TRUE(bucket.try_acquire(10000));
+    EXPECT_FALSE(bucket.try_acquire(10000));
+}
+
+// the budget drops messages the sites let through, without using their
+// tokens.
+TEST(log_sampler, budget) {
+    std::ostringstream out;
+    auto sink = std::make_shared<abel::sinks::ostream_sink_st>(out);
+    abel::logger logger("log_sampler_budget", sink);
+    logger.set_pattern("%v");
+
+    // rates low enough that nothing refills while the test runs.
+    abel::details::log_sampling_site site(1, 2);
+    abel::details::log_sampling_site other(1, 1);
+    abel::set_log_budget(1, 1);
+    auto log = [&](abel::details::log_sampling_site &s, int i) {
+        abel::details::log_sampled(&logger, s, abel::source_loc{}, abel::level::info, "message {}", i);
+    };
+    log(site, 0);
+    log(site, 1);
+    log(site, 2);
+    log(other, 3);
+    EXPECT_EQ(out.str(), "message 0\n");
+
+    abel::set_log_budget(0, 0);
+    // the site has a token left, `other` still has its own.
+    log(site, 4);
+    log(site, 5);
+    log(other, 6);
+    log(other, 7);
+    EXPECT_EQ(out.str(), "message 0\n"
+                         "message 4 [2 similar messages suppressed]\n"
+                         "message 6 [1 similar messages suppressed]\n");
+}
@@ -0,0 +1,147 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+#include "abel/log/sinks/mmap_ring_sink.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include "abel/log/details/os.h"
+#include "abel/log/logger.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using record = std::pair<uint64_t, std::string>;
+
+// what log_ring_dump prints, as (sequence number, message).
+std::vector<record> dump(const std::string &fname) {
+    std::vector<record> records;
+    abel::details::mmap_ring::read(fname, [&](uint64_t seq, std::string_view msg) {
+        records.emplace_back(seq, std::string(msg));
+    });
+    return records;
+}
+
+std::string message(int i) {
+    char buf[128];
+    std::snprintf(buf, sizeof(buf), "message %06d %s\n", i, std::string(i % 50, 'x').c_str());
+    return buf;
+}
+
+std::string temp_file(const std::string &name) {
+    auto fname = ::testing::TempDir() + "/" + name;
+    abel::details::os::remove_if_exists(fname);
+    return fname;
+}
+
+void log_messages(const std::string &fname, size_t capacity, int begin, int end) {
+    auto sink = std::make_shared<abel::sinks::mmap_ring_sink_st>(fname, capacity);
+    abel::logger logger("mmap_ring", sink);
+    logger.set_pattern("%v");
+    for (int i = begin; i < end; ++i) {
+        auto msg = message(i);
+        logger.info(std::string_view(msg.data(), msg.size() - 1));
+    }
+    sink->sync();
+}
+
+// the records are the newest messages logged, with consecutive sequence
+// numbers.
+void expect_newest(const std::vector<record> &records, int end, uint64_t end_seq) {
+    ASSERT_FALSE(records.empty());
+    EXPECT_EQ(records.back().first, end_seq - 1);
+    for (size_t i = 0; i < records.size(); ++i) {
+        auto n = records.size() - i;
+        EXPECT_EQ(records[i].first, end_seq - n);
+        EXPECT_EQ(records[i].second, message(end - static_cast<int>(n)));
+    }
+}
+
+}  // namespace
+
+TEST(mmap_ring_sink, wraparound) {
+    auto fname = temp_file("mmap_ring_wraparound.ring");
+    // about 4 times the capacity, records of varying sizes so that the end of
+    // the data area gets padded.
+    log_messages(fname, 64 * 1024, 0, 4000);
+    auto records = dump(fname);
+    expect_newest(records, 4000, 4000);
+    size_t bytes = 0;
+    for (auto &r : records) {
+        bytes += r.second.size();
+    }
+    EXPECT_LE(bytes, 64u * 1024);
+    EXPECT_GT(bytes, 32u * 1024);
+}
+
+TEST(mmap_ring_sink, reopen) {
+    auto fname = temp_file("mmap_ring_reopen.ring");
+    log_messages(fname, 64 * 1024, 0, 3000);
+    auto before = dump(fname);
+
+    // same capacity: the records of the earlier run are kept.
+    log_messages(fname, 64 * 1024, 3000, 3010);
+    auto after = dump(fname);
+    expect_newest(after, 3010, 3010);
+    EXPECT_GT(after.size(), 10u);
+    EXPECT_EQ(after[after.size() - 11], before.back());
+
+    // another capacity: the ring starts over.
+    log_messages(fname, 128 * 1024, 3010, 3020);
+    auto reset = dump(fname);
+    ASSERT_EQ(reset.size(), 10u);
+    for (size_t i = 0; i < reset.size(); ++i) {
+        EXPECT_EQ(reset[i].first, i);
+        EXPECT_EQ(reset[i].second, message(3010 + static_cast<int>(i)));
+    }
+}
+
+// the writer died in the middle of a record: the record is ignored, the
+// others are intact and the next run goes on from there.
+TEST(mmap_ring_sink, torn_record) {
+    auto fname = temp_file("mmap_ring_torn.ring");
+    log_messages(fname, 64 * 1024, 0, 2000);
+    auto before = dump(fname);
+
+    int fd = ::open(fname.c_str(), O_RDWR);
+    ASSERT_NE(fd, -1);
+    auto size = abel::details::mmap_ring::page_size + 64 * 1024;
+    auto mapping = static_cast<char *>(::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    ::close(fd);
+    ASSERT_NE(mapping, MAP_FAILED);
+    auto header = reinterpret_cast<abel::details::mmap_ring_header *>(mapping);
+    // what the writer does before it starts copying a record.
+    auto head = header->head.load();
+    auto offset = head & (64 * 1024 - 1);
+    auto room = std::min<uint64_t>(64 * 1024 - offset, header->tail.load() + 64 * 1024 - head);
+    header->reserved.store(head + 64);
+    std::memset(mapping + abel::details::mmap_ring::page_size + offset, 0xab, std::min<uint64_t>(room, 48));
+    ::munmap(mapping, size);
+
+    EXPECT_EQ(dump(fname), before);
+
+    log_messages(fname, 64 * 1024, 2000, 2100);
+    expect_newest(dump(fname), 2100, 2100);
+}
+
+TEST(mmap_ring_sink, not_a_ring) {
+    auto fname = temp_file("mmap_ring_garbage.ring");
+    {
+        std::FILE *f = std::fopen(fname.c_str(), "w");
+        ASSERT_NE(f, nullptr);
+        std::string garbage(8192, 'g');
+        std::fwrite(garbage.data(), 1, garbage.size(), f);
+        std::fclose(f);
+    }
+    EXPECT_THROW(dump(fname), abel::log_ex);
+}
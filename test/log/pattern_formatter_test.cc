@@ -0,0 +1,156 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+#include "abel/log/pattern_formatter.h"
+
+#include <cctype>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+// prints nothing. put between all the flags of a pattern, nothing is merged
+// into time runs and each flag renders on its own.
+class separator_formatter final : public abel::custom_flag_formatter {
+  public:
+    void format(const abel::details::log_msg &, const std::tm &, abel::memory_buf_t &) override {}
+
+    std::unique_ptr<custom_flag_formatter> clone() const override {
+        return abel::make_unique<separator_formatter>();
+    }
+};
+
+// changes on every message, whatever the time.
+class counter_formatter final : public abel::custom_flag_formatter {
+  public:
+    void format(const abel::details::log_msg &, const std::tm &, abel::memory_buf_t &dest) override {
+        abel::details::fmt_helper::append_int(count_++, dest);
+    }
+
+    std::unique_ptr<custom_flag_formatter> clone() const override {
+        return abel::make_unique<counter_formatter>();
+    }
+
+  private:
+    int count_ = 0;
+};
+
+// `pattern` with a separator after each flag and each character.
+std::string uncached(const std::string &pattern) {
+    std::string result;
+    for (auto it = pattern.begin(); it != pattern.end(); ++it) {
+        if (*it == '%') {
+            result.push_back(*it++);
+            if (it != pattern.end() && (*it == '-' || *it == '=')) {
+                result.push_back(*it++);
+            }
+            while (it != pattern.end() && (std::isdigit(static_cast<unsigned char>(*it)) || *it == '!')) {
+                result.push_back(*it++);
+            }
+        }
+        result.push_back(*it);
+        result += "%*";
+    }
+    return result;
+}
+
+std::unique_ptr<abel::pattern_formatter> make_formatter(const std::string &pattern, abel::pattern_time_type time_type) {
+    auto formatter = abel::make_unique<abel::pattern_formatter>(time_type, "\n");
+    formatter->add_flag<separator_formatter>('*').add_flag<counter_formatter>('Q');
+    formatter->set_pattern(pattern);
+    return formatter;
+}
+
+// messages stepping over second, millisecond and microsecond boundaries, a few
+// of them in the same tick, and time going backwards once in a while.
+std::vector<abel::log_clock::time_point> message_times() {
+    using namespace std::chrono;
+    // just before a second boundary.
+    auto base = abel::log_clock::time_point(duration_cast<abel::log_clock::duration>(
+            seconds(1600000000) - microseconds(1500)));
+    std::vector<abel::log_clock::time_point> times;
+    const nanoseconds steps[] = {nanoseconds(1), nanoseconds(400), microseconds(1), microseconds(7),
+                                 microseconds(333), microseconds(999), milliseconds(1), milliseconds(77),
+                                 milliseconds(999), seconds(1), seconds(61)};
+    auto now = base;
+    for (auto step : steps) {
+        for (int i = 0; i < 40; ++i) {
+            times.push_back(now);
+            if (i % 3 == 0) {
+                times.push_back(now);
+            }
+            now += duration_cast<abel::log_clock::duration>(step);
+        }
+        times.push_back(base);
+    }
+    return times;
+}
+
+void expect_same_output(const std::string &pattern) {
+    for (auto time_type : {abel::pattern_time_type::local, abel::pattern_time_type::utc}) {
+        auto cached = make_formatter(pattern, time_type);
+        auto reference = make_formatter(uncached(pattern), time_type);
+        for (auto time : message_times()) {
+            abel::details::log_msg msg(time, abel::source_loc{"file.cc", 42, "func"}, "logger", abel::level::info,
+                                       "message");
+            abel::memory_buf_t expected, actual;
+            reference->format(msg, expected);
+            cached->format(msg, actual);
+            ASSERT_EQ(std::string(actual.data(), actual.size()), std::string(expected.data(), expected.size()))
+                    << "pattern: " << pattern;
+        }
+    }
+}
+
+}  // namespace
+
+TEST(pattern_formatter, uncached_reference) {
+    EXPECT_EQ(uncached("%Y-%-4m %=8!e"), "%Y%*-%*%-4m%* %*%=8!e%*");
+}
+
+TEST(pattern_formatter, time_runs) {
+    expect_same_output("[%Y-%m-%d %H:%M:%S.%e] [%n] [%l] %v");
+    expect_same_output("%a %A %b %h %B %c %C %D %x %I %p %r %R %T %X %z %E");
+    expect_same_output("%H:%M:%S.%e");
+    expect_same_output("%T.%f %v %T.%e");
+    expect_same_output("%%%S%%");
+}
+
+TEST(pattern_formatter, padding) {
+    expect_same_output("%-12Y|%=10e|%8S|%3!f|%=20T|%-5!E %v");
+    expect_same_output("%20c %-6e%=6f");
+}
+
+TEST(pattern_formatter, sub_second_flags) {
+    expect_same_output("%S.%e %S.%f %S.%F");
+    expect_same_output("%T.%F.%e");
+    expect_same_output("%e%f%F%f%e");
+}
+
+TEST(pattern_formatter, elapsed) {
+    expect_same_output("%T.%e %u %i %o %O %T.%f");
+    expect_same_output("%6u|%-6i|%=6o|%O");
+}
+
+// custom flags are never cached, not even those taking the letter of a time
+// flag.
+TEST(pattern_formatter, custom_flag_in_time_run) {
+    expect_same_output("%Y-%m-%d %Q %H:%M:%S.%e");
+    expect_same_output("%T.%e%Q%5Q%T.%f");
+
+    auto formatter = abel::make_unique<abel::pattern_formatter>(abel::pattern_time_type::utc, "\n");
+    formatter->add_flag<counter_formatter>('S');
+    formatter->set_pattern("%H:%M:%S");
+    abel::details::log_msg msg(abel::log_clock::time_point(std::chrono::seconds(1600000000)), abel::source_loc{},
+                               "logger", abel::level::info, "message");
+    for (int i = 0; i < 3; ++i) {
+        abel::memory_buf_t dest;
+        formatter->format(msg, dest);
+        EXPECT_EQ(std::string(dest.data(), dest.size()), "12:26:" + std::to_string(i) + "\n");
+    }
+}
@@ -0,0 +1,85 @@
+//
+// Created by liyinbin on 2021/4/3.
+//
+
+
+#include "abel/memory/object_pool.h"
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace std::literals;
+
+namespace abel {
+
+    int alive = 0;
+
+    struct C {
+        C() { ++alive; }
+
+        ~C() { --alive; }
+    };
+
+    template<>
+    struct pool_traits<C> {
+        static constexpr auto kType = pool_type::Global;
+        static constexpr auto kLowWaterMark = 16;
+        static constexpr auto kHighWaterMark = 128;
+        static constexpr auto kMaxIdle = abel::duration::milliseconds(100);
+        static constexpr auto kMinimumThreadCacheSize = 8;
+        static constexpr auto kTransferBatchSize = 8;
+    };
+
+    namespace object_pool {
+
+        TEST(GlobalPool, All) {
+            std::vector<C *> ptrs;
+            std::thread([&] {
+                for (int i = 0; i != 1000; ++i) {
+                    ptrs.push_back(get<C>().leak());
+                }
+            }).join();
+            ASSERT_EQ(1000, alive);
+
+            // Freed in another thread. Objects are moved to the global pool in batches
+            // (and on thread exit), up to the high-water mark.
+            std::thread([&] {
+                for (auto &&e : ptrs) {
+                    put<C>(e);
+                }
+            }).join();
+            ptrs.clear();
+            ASSERT_EQ(pool_traits<C>::kHighWaterMark, alive);
+
+            // They can be reused by yet another thread.
+            for (int i = 0; i != pool_traits<C>::kHighWaterMark; ++i) {
+                ptrs.push_back(get<C>().leak());
+            }
+            ASSERT_EQ(pool_traits<C>::kHighWaterMark, alive);
+            ptrs.push_back(get<C>().leak());
+            ASSERT_EQ(pool_traits<C>::kHighWaterMark + 1, alive);
+            std::thread([&] {
+                for (auto &&e : ptrs) {
+                    put<C>(e);
+                }
+            }).join();
+            ptrs.clear();
+            ASSERT_EQ(pool_traits<C>::kHighWaterMark, alive);
+
+            // Idle objects are freed, down to the low-water mark.
+            std::this_thread::sleep_for(200ms);
+            std::thread([&] {
+                for (int i = 0; i != pool_traits<C>::kTransferBatchSize; ++i) {
+                    ptrs.push_back(get<C>().leak());
+                }
+                for (auto &&e : ptrs) {
+                    put<C>(e);
+                }
+            }).join();
+            ASSERT_EQ(pool_traits<C>::kLowWaterMark, alive);
+        }
+
+    }  // namespace object_pool
+}  // namespace abel
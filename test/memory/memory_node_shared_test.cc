@@ -0,0 +1,97 @@
+//
+// Created by liyinbin on 2021/4/3.
+//
+
+
+#include "abel/memory/object_pool.h"
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "abel/thread/numa.h"
+
+namespace abel {
+
+    int alive = 0;
+
+    struct C {
+        C() { ++alive; }
+
+        ~C() { --alive; }
+    };
+
+    template<>
+    struct pool_traits<C> {
+        static constexpr auto kType = pool_type::MemoryNodeShared;
+        static constexpr auto kLowWaterMark = 16;
+        static constexpr auto kHighWaterMark = 128;
+        static constexpr auto kMaxIdle = abel::duration::milliseconds(3000);
+        static constexpr auto kMinimumThreadCacheSize = 8;
+        static constexpr auto kTransferBatchSize = 8;
+    };
+
+    struct D {
+        int x;
+        inline static int put_called = 0;
+    };
+
+    template<>
+    struct pool_traits<D> {
+        static constexpr auto kType = pool_type::MemoryNodeShared;
+        static constexpr auto kLowWaterMark = 16;
+        static constexpr auto kHighWaterMark = 128;
+        static constexpr auto kMaxIdle = abel::duration::milliseconds(3000);
+        static constexpr auto kMinimumThreadCacheSize = 8;
+        static constexpr auto kTransferBatchSize = 8;
+
+        static void OnGet(D *p) { p->x = 0; }
+
+        static void OnPut(D *) { ++D::put_called; }
+    };
+
+    namespace object_pool {
+
+        TEST(MemoryNodeSharedPool, ProducerConsumer) {
+            auto nodes = numa::get_number_of_nodes_available();
+            std::vector<C *> ptrs;
+            for (int round = 0; round != 10; ++round) {
+                std::thread([&] {
+                    for (int i = 0; i != 1000; ++i) {
+                        ptrs.push_back(get<C>().leak());
+                    }
+                }).join();
+                std::thread([&] {
+                    for (auto &&e : ptrs) {
+                        put<C>(e);
+                    }
+                }).join();
+                ptrs.clear();
+                // Objects freed by the consumer are kept by the pool of the node it
+                // ran on, up to the high-water mark.
+                ASSERT_LE(alive, pool_traits<C>::kHighWaterMark * nodes);
+            }
+            if (nodes == 1) {
+                // The producer reuses objects freed by the consumer.
+                ASSERT_EQ(pool_traits<C>::kHighWaterMark, alive);
+                for (int i = 0; i != pool_traits<C>::kHighWaterMark; ++i) {
+                    ptrs.push_back(get<C>().leak());
+                }
+                ASSERT_EQ(pool_traits<C>::kHighWaterMark, alive);
+                for (auto &&e : ptrs) {
+                    put<C>(e);
+                }
+            }
+        }
+
+        TEST(MemoryNodeSharedPool, OnGetHook) {
+            { auto ptr = get<D>(); }
+            {
+                auto ptr = get<D>();
+                ASSERT_EQ(0, ptr->x);
+            }
+            ASSERT_EQ(2, D::put_called);
+        }
+
+    }  // namespace object_pool
+}  // namespace abel
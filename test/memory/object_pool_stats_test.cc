@@ -0,0 +1,122 @@
+//
+// Created by liyinbin on 2021/4/3.
+//
+
+
+#include "abel/memory/object_pool_stats.h"
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "abel/memory/object_pool.h"
+#include "abel/metrics/object_pool_metrics.h"
+#include "abel/metrics/prom_serializer.h"
+
+namespace abel {
+
+    struct tls_object {
+        char payload[100];
+    };
+
+    struct shared_object {
+        char payload[200];
+    };
+
+    template<>
+    struct pool_traits<tls_object> {
+        static constexpr auto kType = pool_type::ThreadLocal;
+        static constexpr auto kLowWaterMark = 16;
+        static constexpr auto kHighWaterMark = 128;
+        static constexpr auto kMaxIdle = abel::duration::milliseconds(3000);
+    };
+
+    template<>
+    struct pool_traits<shared_object> {
+        static constexpr auto kType = pool_type::MemoryNodeShared;
+        static constexpr auto kLowWaterMark = 16;
+        static constexpr auto kHighWaterMark = 128;
+        static constexpr auto kMaxIdle = abel::duration::milliseconds(3000);
+        static constexpr auto kMinimumThreadCacheSize = 8;
+        static constexpr auto kTransferBatchSize = 8;
+    };
+
+    template<class T>
+    object_pool_stats get_stats_of() {
+        for (auto &&e : get_object_pool_stats()) {
+            if (e.type_name == get_type_name<T>()) {
+                return e;
+            }
+        }
+        ADD_FAILURE() << "Not registered: " << get_type_name<T>();
+        return {};
+    }
+
+    TEST(object_pool_stats, ThreadLocal) {
+        std::vector<pooled_ptr<tls_object>> ptrs;
+        for (int i = 0; i != 10; ++i) {
+            ptrs.push_back(object_pool::get<tls_object>());
+        }
+        auto stats = get_stats_of<tls_object>();
+        EXPECT_EQ("ThreadLocal", stats.backend);
+        EXPECT_EQ(sizeof(tls_object), stats.object_size);
+        EXPECT_EQ(10, stats.gets);
+        EXPECT_EQ(10, stats.misses);
+        EXPECT_EQ(10, stats.alive);
+        EXPECT_EQ(0, stats.thread_cached);
+
+        ptrs.clear();
+        ptrs.push_back(object_pool::get<tls_object>());
+        stats = get_stats_of<tls_object>();
+        EXPECT_EQ(10, stats.puts);
+        EXPECT_EQ(1, stats.hits);
+        EXPECT_EQ(10, stats.alive);
+        EXPECT_EQ(9, stats.thread_cached);
+        EXPECT_EQ(9 * sizeof(tls_object), stats.bytes_cached);
+        EXPECT_EQ(1, stats.threads);
+    }
+
+    TEST(object_pool_stats, MemoryNodeShared) {
+        std::vector<shared_object *> ptrs;
+        for (int i = 0; i != 100; ++i) {
+            ptrs.push_back(object_pool::get<shared_object>().leak());
+        }
+        std::thread([&] {
+            for (auto &&e : ptrs) {
+                object_pool::put<shared_object>(e);
+            }
+            auto stats = get_stats_of<shared_object>();
+            EXPECT_EQ(2, stats.threads);
+            EXPECT_EQ(100, stats.puts);
+            EXPECT_EQ(100, stats.alive);
+            EXPECT_EQ(100, stats.thread_cached + stats.shared_cached);
+        }).join();
+
+        // Objects cached by the exited thread are moved to the shared pool.
+        auto stats = get_stats_of<shared_object>();
+        EXPECT_EQ(1, stats.threads);
+        EXPECT_EQ(100, stats.misses);
+        EXPECT_EQ(100, stats.alive);
+        EXPECT_EQ(0, stats.thread_cached);
+        EXPECT_EQ(100, stats.shared_cached);
+        EXPECT_EQ(100 * sizeof(shared_object), stats.bytes_cached);
+    }
+
+    TEST(object_pool_stats, Dump) {
+        object_pool::get<tls_object>().reset();
+        auto dump = dump_object_pool_stats();
+        EXPECT_NE(dump.npos, dump.find(get_type_name<tls_object>()));
+    }
+
+    TEST(object_pool_stats, Metrics) {
+        object_pool::get<tls_object>().reset();
+        std::vector<metrics::cache_metrics> res;
+        metrics::collect_object_pool_metrics(res);
+        metrics::prometheus_serializer serializer;
+        auto text = static_cast<const metrics::serializer &>(serializer).format(res);
+        EXPECT_NE(text.npos, text.find("object_pool_gets_total{"));
+        EXPECT_NE(text.npos, text.find("object_pool_bytes_cached{"));
+        EXPECT_NE(text.npos, text.find(get_type_name<tls_object>()));
+    }
+
+}  // namespace abel
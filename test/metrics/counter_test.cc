@@ -8,9 +8,14 @@
 //
 
 #include "abel/metrics/counter.h"
+
+#include <thread>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 using abel::metrics::counter;
+using abel::metrics::int_counter;
 
 TEST(CounterTest, initialize_with_zero) {
     counter ctr;
@@ -46,3 +51,76 @@ TEST(CounterTest, inc_negative_value
 }
 
 
+
+TEST(CounterTest, inc_concurrently) {
+    counter ctr;
+    std::vector<std::thread> threads;
+    for (int i = 0; i != 8; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j != 100000; ++j) {
+                ctr.inc();
+            }
+        });
+    }
+    for (auto &&t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(ctr.value(), 800000.0);
+}
+
+TEST(IntCounterTest, inc) {
+    int_counter ctr;
+    EXPECT_EQ(ctr.value(), 0);
+    ctr.inc();
+    ctr.inc(5);
+    EXPECT_EQ(ctr.value(), 6);
+}
+
+TEST(IntCounterTest, exact_beyond_double_precision) {
+    int_counter ctr;
+    ctr.inc(1ULL << 53);
+    ctr.inc();
+    EXPECT_EQ(ctr.value(), (1ULL << 53) + 1);
+    auto cm = ctr.collect();
+    EXPECT_TRUE(cm.counter.is_integral);
+    EXPECT_EQ(cm.counter.int_value, (1ULL << 53) + 1);
+}
+
+TEST(IntCounterTest, inc_concurrently) {
+    int_counter ctr;
+    std::vector<std::thread> threads;
+    for (int i = 0; i != 8; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j != 100000; ++j) {
+                ctr.inc();
+            }
+        });
+    }
+    for (auto &&t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(ctr.value(), 800000);
+}
+
+TEST(ShardedCounterArrayTest, add_concurrently) {
+    // More counters than a cache line holds, from more threads than shards.
+    abel::metrics::sharded_counter_array<std::uint64_t> counters(37);
+    EXPECT_EQ(counters.size(), 37);
+    std::vector<std::thread> threads;
+    for (int i = 0; i != 8; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j != 100000; ++j) {
+                counters.add(j % 37, 1);
+            }
+        });
+    }
+    for (auto &&t : threads) {
+        t.join();
+    }
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i != counters.size(); ++i) {
+        EXPECT_EQ(counters.sum(i), 8 * (100000 / 37 + (i < 100000 % 37)));
+        total += counters.sum(i);
+    }
+    EXPECT_EQ(total, 800000);
+}
@@ -104,3 +104,28 @@ TEST(HistogramTest, BucketBuilder) {
 }
 
 
+
+TEST(HistogramTest, observe_many) {
+    histogram hist{{1, 2}};
+    hist.observe(2, 3);
+    hist.observe(5, 0);
+    auto metric = hist.collect();
+    auto h = metric.histogram;
+    EXPECT_EQ(h.sample_count, 3U);
+    EXPECT_EQ(h.sample_sum, 6);
+    EXPECT_EQ(h.bucket.at(0).cumulative_count, 0U);
+    EXPECT_EQ(h.bucket.at(1).cumulative_count, 3U);
+    EXPECT_EQ(h.bucket.at(2).cumulative_count, 3U);
+}
+
+TEST(HistogramTest, quantile) {
+    histogram hist{{10, 20, 30}};
+    EXPECT_EQ(hist.quantile(0.5), 0);
+    for (int i = 0; i != 100; ++i) {
+        hist.observe(15);
+    }
+    EXPECT_DOUBLE_EQ(hist.quantile(0.5), 15);
+    EXPECT_DOUBLE_EQ(hist.quantile(1.0), 20);
+    hist.observe(100);
+    EXPECT_DOUBLE_EQ(hist.quantile(1.0), 30);
+}
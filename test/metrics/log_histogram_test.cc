@@ -0,0 +1,136 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+
+#include "abel/metrics/log_histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "abel/base/random.h"
+#include "abel/metrics/prom_serializer.h"
+#include "gtest/gtest.h"
+
+using abel::metrics::log_histogram;
+using abel::metrics::log_histogram_snapshot;
+
+TEST(LogHistogramTest, buckets) {
+    for (int bits : {1, 3, 5, 7}) {
+        std::uint64_t expected_lower = 0;
+        auto buckets = log_histogram_snapshot::bucket_of(~0ULL, bits) + 1;
+        for (std::size_t i = 0; i != buckets; ++i) {
+            auto lower = log_histogram_snapshot::lower_bound_of(i, bits);
+            auto upper = log_histogram_snapshot::upper_bound_of(i, bits);
+            // Buckets are contiguous.
+            ASSERT_EQ(expected_lower, lower);
+            ASSERT_LE(lower, upper);
+            ASSERT_EQ(i, log_histogram_snapshot::bucket_of(lower, bits));
+            ASSERT_EQ(i, log_histogram_snapshot::bucket_of(upper, bits));
+            // Relative error is bounded by precision.
+            ASSERT_LE(static_cast<double>(upper - lower), std::ldexp(lower, -bits));
+            expected_lower = upper + 1;
+        }
+        // The last bucket ends at the largest value.
+        ASSERT_EQ(0, expected_lower);
+    }
+    EXPECT_EQ(log_histogram_snapshot::bucket_of(~0ULL, 7),
+              log_histogram_snapshot::bucket_of(~0ULL - 1, 7));
+}
+
+TEST(LogHistogramTest, quantile) {
+    log_histogram hist;
+    std::vector<std::uint64_t> values;
+    for (int i = 0; i != 100000; ++i) {
+        values.push_back(abel::Random<std::uint64_t>(1, 10000000));
+        hist.observe(values.back());
+    }
+    std::sort(values.begin(), values.end());
+    for (double q : {0.0, 0.5, 0.9, 0.99, 0.999, 1.0}) {
+        auto expected = values[std::max<std::size_t>(1, std::ceil(q * values.size())) - 1];
+        auto actual = hist.quantile(q);
+        EXPECT_NEAR(expected, actual, expected / 100.0) << q;
+    }
+    auto snapshot = hist.snapshot();
+    EXPECT_EQ(100000, snapshot.count());
+    std::uint64_t sum = 0;
+    for (auto &&e : values) {
+        sum += e;
+    }
+    EXPECT_EQ(sum, snapshot.sum());
+}
+
+TEST(LogHistogramTest, small_values_are_exact) {
+    log_histogram hist(3);
+    for (int i = 0; i != 8; ++i) {
+        hist.observe(i, 10);
+    }
+    EXPECT_EQ(0, hist.quantile(0.1));
+    EXPECT_EQ(3, hist.quantile(0.5));
+    EXPECT_EQ(7, hist.quantile(1.0));
+    EXPECT_EQ(0, log_histogram().quantile(0.5));
+}
+
+TEST(LogHistogramTest, max_value) {
+    log_histogram hist(5, 1000);
+    hist.observe(1000000);
+    EXPECT_NEAR(1000, hist.quantile(1.0), 1000 / 32.0);
+    EXPECT_EQ(1000000, hist.snapshot().sum());
+}
+
+TEST(LogHistogramTest, merge) {
+    log_histogram h1, h2;
+    for (int i = 0; i != 1000; ++i) {
+        h1.observe(100);
+        h2.observe(10000);
+    }
+    auto merged = h1.snapshot();
+    merged.merge(h2.snapshot());
+    EXPECT_EQ(2000, merged.count());
+    EXPECT_NEAR(100, merged.quantile(0.5), 1);
+    EXPECT_NEAR(10000, merged.quantile(0.51), 100);
+
+    h1.merge(h2.snapshot());
+    EXPECT_EQ(2000, h1.snapshot().count());
+    EXPECT_NEAR(10000, h1.quantile(0.99), 100);
+}
+
+TEST(LogHistogramTest, concurrent) {
+    log_histogram hist;
+    std::vector<std::thread> threads;
+    for (int i = 0; i != 8; ++i) {
+        threads.emplace_back([&, i] {
+            for (int j = 0; j != 10000; ++j) {
+                hist.observe(i * 1000 + 1);
+            }
+        });
+    }
+    for (auto &&t : threads) {
+        t.join();
+    }
+    auto snapshot = hist.snapshot();
+    EXPECT_EQ(80000, snapshot.count());
+    EXPECT_NEAR(7001, hist.quantile(1.0), 70);
+}
+
+TEST(LogHistogramTest, collect) {
+    log_histogram hist(7, log_histogram::kDefaultMaxValue, {0.5, 0.99});
+    for (int i = 1; i <= 100; ++i) {
+        hist.observe(i);
+    }
+    auto cm = hist.collect();
+    cm.name = "latency";
+    cm.family = std::make_shared<abel::metrics::scope_family>("rpc", "_", std::unordered_map<std::string, std::string>{});
+    ASSERT_EQ(abel::metrics::metrics_type::mt_summary, cm.type);
+    EXPECT_EQ(100, cm.summary.sample_count);
+    EXPECT_EQ(5050, cm.summary.sample_sum);
+    ASSERT_EQ(2, cm.summary.quantiles.size());
+    EXPECT_EQ(50, cm.summary.quantiles[0].value);
+    EXPECT_EQ(99, cm.summary.quantiles[1].value);
+
+    abel::metrics::prometheus_serializer serializer;
+    auto text = static_cast<const abel::metrics::serializer &>(serializer).format({cm});
+    EXPECT_NE(text.npos, text.find("# TYPE rpc_latency summary"));
+    EXPECT_NE(text.npos, text.find("rpc_latency_count 100"));
+    EXPECT_NE(text.npos, text.find("rpc_latency{quantile=\"0.990000\"} 99"));
+}
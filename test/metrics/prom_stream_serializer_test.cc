@@ -0,0 +1,127 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+
+#include "abel/metrics/prom_stream_serializer.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace abel {
+namespace metrics {
+
+namespace {
+
+std::string to_string(const iobuf &buf) { return flatten_slow(buf); }
+
+}  // namespace
+
+TEST(PromStreamSerializerTest, format) {
+    auto s = scope::new_root_scope("test", "_", {{"product", "demo"}});
+    s->get_int_counter("requests")->inc(3);
+    s->get_counter("bytes")->inc(1.5);
+    s->get_gauge("qps")->update(-2);
+    s->get_histogram("latency", bucket_builder::exponential_values(1, 2, 2))->observe(1.5);
+
+    std::vector<cache_metrics> cm;
+    s->collect(cm);
+    prometheus_stream_serializer serializer;
+    iobuf_builder builder;
+    serializer.serialize(cm, &builder);
+    auto result = to_string(builder.destructive_get());
+
+    EXPECT_NE(std::string::npos,
+              result.find("# TYPE test_requests counter\ntest_requests{product=\"demo\"} 3\n"));
+    EXPECT_NE(std::string::npos, result.find("test_bytes{product=\"demo\"} 1.5\n"));
+    EXPECT_NE(std::string::npos, result.find("test_qps{product=\"demo\"} -2\n"));
+    EXPECT_NE(std::string::npos, result.find("# TYPE test_latency histogram\n"
+                                             "test_latency_count{product=\"demo\"} 1\n"
+                                             "test_latency_sum{product=\"demo\"} 1.5\n"
+                                             "test_latency_bucket{product=\"demo\",le=\"1\"} 0\n"
+                                             "test_latency_bucket{product=\"demo\",le=\"2\"} 1\n"
+                                             "test_latency_bucket{product=\"demo\",le=\"+Inf\"} 1\n"));
+}
+
+TEST(PromStreamSerializerTest, escape) {
+    auto s = scope::new_root_scope("test", "_", {{"path", "a\"b\\c\nd"}});
+    s->get_gauge("g")->update(1);
+    prometheus_stream_serializer serializer;
+    EXPECT_EQ("# HELP test_g\n# TYPE test_g gauge\ntest_g{path=\"a\\\"b\\\\c\\nd\"} 1\n",
+              to_string(serializer.serialize(*s)));
+}
+
+TEST(PromStreamSerializerTest, chunked) {
+    auto s = scope::new_root_scope("test", "_", {});
+    for (int i = 0; i != 100; ++i) {
+        auto tagged = s->tagged({{"tenant", std::to_string(i)}});
+        tagged->get_int_counter("requests")->inc(i);
+        tagged->get_gauge("qps")->update(i * 0.25);
+    }
+    s->get_timer("latency", bucket_builder::exponential_values(1, 2, 10))->observe(100);
+
+    std::vector<cache_metrics> cm;
+    s->collect(cm);
+    prometheus_stream_serializer serializer;
+    iobuf_builder builder;
+    serializer.serialize(cm, &builder);
+    auto expected = to_string(builder.destructive_get());
+
+    for (auto chunk : {1, 7, 64, 100000}) {
+        std::size_t collected = 0;
+        s->collect(chunk, [&](std::vector<cache_metrics> &c) {
+            ASSERT_LE(c.size(), static_cast<std::size_t>(chunk));
+            collected += c.size();
+        });
+        EXPECT_EQ(cm.size(), collected);
+        EXPECT_EQ(expected, to_string(serializer.serialize(*s, chunk)));
+    }
+}
+
+TEST(PromStreamSerializerTest, precision) {
+    auto s = scope::new_root_scope("test", "_", {});
+    s->get_gauge("tenth")->update(0.1);
+    s->get_gauge("tiny")->update(1.5e-10);
+    s->get_gauge("third")->update(1.0 / 3);
+    s->get_gauge("large")->update(123456789.125);
+    prometheus_stream_serializer serializer;
+    auto result = to_string(serializer.serialize(*s));
+
+    EXPECT_NE(std::string::npos, result.find("test_tenth 0.1\n"));
+    EXPECT_NE(std::string::npos, result.find("test_tiny 1.5e-10\n"));
+    // Six digits aren't enough for these.
+    EXPECT_NE(std::string::npos, result.find("test_third 0.3333333333333333\n"));
+    EXPECT_NE(std::string::npos, result.find("test_large 123456789.125\n"));
+}
+
+TEST(PromStreamSerializerTest, evict_unused_families) {
+    auto s = scope::new_root_scope("test", "_", {});
+    s->get_gauge("g")->update(1);
+    prometheus_stream_serializer serializer;
+    serializer.serialize(*s);
+    auto cached = serializer.cached_families();
+    ASSERT_GT(cached, 0u);
+
+    // A new family on each collection, as `collect_object_pool_metrics` does.
+    for (int i = 0; i != 100; ++i) {
+        std::vector<cache_metrics> cm(1);
+        cm[0].type = metrics_type::mt_gauge;
+        cm[0].name = "g";
+        cm[0].family = std::make_shared<scope_family>(
+                "temporary", "_", std::unordered_map<std::string, std::string>{{"i", std::to_string(i)}});
+        cm[0].gauge.value = i;
+        iobuf_builder builder;
+        serializer.serialize(cm, &builder);
+        EXPECT_LE(serializer.cached_families(), cached + 2);
+        serializer.serialize(*s);
+    }
+    serializer.serialize(*s);
+    EXPECT_EQ(cached, serializer.cached_families());
+}
+
+}  // namespace metrics
+}  // namespace abel
@@ -50,3 +50,62 @@ TEST(ScopeTest, scope) {
     std::cout << p << std::endl;
 }
 
+
+TEST(ScopeTest, metric_key) {
+    abel::metrics::metric_key plain("requests");
+    abel::metrics::metric_key tagged("requests", {{"tenant", "t1"}, {"zone", "z1"}});
+    abel::metrics::metric_key tagged2("requests", {{"zone", "z1"}, {"tenant", "t1"}});
+
+    EXPECT_FALSE(plain.has_tags());
+    EXPECT_TRUE(tagged.has_tags());
+    EXPECT_EQ("tenant", tagged.tags()[0].first);
+    EXPECT_EQ(tagged, tagged2);
+    EXPECT_EQ(tagged.hash(), tagged2.hash());
+    EXPECT_FALSE(plain == tagged);
+}
+
+TEST(ScopeTest, tagged_lookup) {
+    auto scopePtr = abel::metrics::scope::new_root_scope("test", "_", {});
+    static const abel::metrics::metric_key kRequests("requests");
+    EXPECT_EQ(scopePtr->get_counter(kRequests), scopePtr->get_counter("requests"));
+
+    abel::metrics::metric_key key("requests", {{"tenant", "t1"}});
+    auto c = scopePtr->get_counter(key);
+    EXPECT_EQ(c, scopePtr->get_counter(key));
+    EXPECT_EQ(c, scopePtr->tagged({{"tenant", "t1"}})->get_counter("requests"));
+    EXPECT_NE(c, scopePtr->get_counter("requests"));
+    c->inc(3);
+
+    // The tagged counter is only reported once, with its tags.
+    std::vector<abel::metrics::cache_metrics> cm;
+    scopePtr->collect(cm);
+    int tagged = 0;
+    for (auto &&e : cm) {
+        if (e.name == "requests" && e.family->tags.count("tenant")) {
+            ++tagged;
+            EXPECT_EQ(3, e.counter.value);
+        }
+    }
+    EXPECT_EQ(1, tagged);
+}
+
+TEST(ScopeTest, concurrent_lookup) {
+    auto scopePtr = abel::metrics::scope::new_root_scope("test", "_", {});
+    std::vector<std::thread> ts;
+    for (int i = 0; i != 8; ++i) {
+        ts.emplace_back([&] {
+            for (int j = 0; j != 1000; ++j) {
+                scopePtr->get_int_counter(
+                        abel::metrics::metric_key("hits", {{"shard", std::to_string(j % 16)}}))->inc(1);
+            }
+        });
+    }
+    for (auto &&t : ts) {
+        t.join();
+    }
+    std::uint64_t total = 0;
+    for (int j = 0; j != 16; ++j) {
+        total += scopePtr->tagged({{"shard", std::to_string(j)}})->get_int_counter("hits")->value();
+    }
+    EXPECT_EQ(8000, total);
+}
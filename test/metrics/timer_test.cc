@@ -0,0 +1,25 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+
+#include "abel/metrics/timer.h"
+#include "gtest/gtest.h"
+
+using abel::metrics::timer;
+
+TEST(TimerTest, quantile) {
+    auto t = timer::new_timer(abel::metrics::bucket_builder::liner_values(100, 100, 10));
+    for (int i = 1; i <= 1000; ++i) {
+        t->observe(abel::duration::microseconds(i));
+    }
+    EXPECT_NEAR(500, t->quantile(0.5).to_double_microseconds(), 500 / 32.0);
+    EXPECT_NEAR(990, t->quantile(0.99).to_double_microseconds(), 990 / 32.0);
+
+    auto cm = t->collect_quantiles();
+    EXPECT_EQ(abel::metrics::metrics_type::mt_summary, cm.type);
+    EXPECT_EQ(1000, cm.summary.sample_count);
+    EXPECT_NEAR(500500, cm.summary.sample_sum, 1);
+    ASSERT_EQ(4, cm.summary.quantiles.size());
+    EXPECT_NEAR(990, cm.summary.quantiles[2].value, 990 / 32.0);
+}
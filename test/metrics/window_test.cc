@@ -0,0 +1,127 @@
+// Copyright (c) 2021, gottingen group.
+// All rights reserved.
+// Created by liyinbin lijippy@163.com
+
+
+#include "abel/metrics/window.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// Samples are taken by hand (by calling `take_sample()`) so as not to depend
+// on timing, except for the last test.
+
+namespace abel {
+namespace metrics {
+
+class WindowTest : public testing::Test {
+  protected:
+    void SetUp() override { window_internal::set_sampler_enabled(false); }
+
+    void TearDown() override { window_internal::set_sampler_enabled(true); }
+};
+
+TEST_F(WindowTest, counter) {
+    window<int_counter> w(3);
+    EXPECT_EQ(0, w.value());
+    w.take_sample();
+    EXPECT_EQ(0, w.value());
+
+    for (int i = 1; i != 6; ++i) {
+        w.source()->inc(i);
+        w.take_sample();
+    }
+    // Increments in the last 3 seconds: 3 + 4 + 5.
+    EXPECT_EQ(12, w.value());
+    EXPECT_EQ(5, w.value(1));
+    EXPECT_EQ(15, w.source()->value());
+}
+
+TEST_F(WindowTest, per_second) {
+    auto c = std::make_shared<counter>();
+    per_second<counter> qps(c, 2);
+    qps.take_sample();
+    c->inc(10);
+    qps.take_sample();
+    // Only one second sampled so far.
+    EXPECT_DOUBLE_EQ(10, qps.value());
+    c->inc(30);
+    qps.take_sample();
+    EXPECT_DOUBLE_EQ(20, qps.value());
+    EXPECT_DOUBLE_EQ(30, qps.value(1));
+    EXPECT_DOUBLE_EQ(20, qps.collect().gauge.value);
+}
+
+TEST_F(WindowTest, histogram) {
+    window<histogram> w(bucket_builder::exponential_values(1, 10, 3), 2);  // 1, 10, 100
+    w.take_sample();
+    w.source()->observe(1000);  // Drops out of the window below.
+    w.take_sample();
+    for (int i = 0; i != 100; ++i) {
+        w.source()->observe(5);
+    }
+    w.take_sample();
+    for (int i = 0; i != 100; ++i) {
+        w.source()->observe(50);
+    }
+    w.take_sample();
+
+    EXPECT_EQ(200, w.count());
+    EXPECT_DOUBLE_EQ(5500, w.sum());
+    EXPECT_DOUBLE_EQ(27.5, w.average());
+    EXPECT_EQ((std::vector<std::uint64_t>{0, 100, 100, 0}), w.bucket_counts());
+    EXPECT_DOUBLE_EQ(10, w.quantile(0.5));
+    EXPECT_DOUBLE_EQ(55, w.quantile(0.75));
+    // The whole history is still in the histogram itself.
+    EXPECT_EQ(100, w.source()->quantile(1));
+}
+
+TEST_F(WindowTest, max_min) {
+    window_max max(2);
+    window_min min(2);
+    EXPECT_EQ(0, max.value());
+
+    std::vector<std::thread> ts;
+    for (int i = 0; i != 8; ++i) {
+        ts.emplace_back([&, i] {
+            for (int j = 0; j != 1000; ++j) {
+                max.update(i * 1000 + j);
+                min.update(i * 1000 + j + 5);
+            }
+        });
+    }
+    for (auto &&t : ts) {
+        t.join();
+    }
+    // Not sampled yet.
+    EXPECT_EQ(0, max.value());
+    max.take_sample();
+    min.take_sample();
+    EXPECT_EQ(7999, max.value());
+    EXPECT_EQ(5, min.value());
+
+    max.update(1);
+    max.take_sample();
+    EXPECT_EQ(7999, max.value());
+    max.take_sample();  // 7999 falls out of the window.
+    EXPECT_EQ(1, max.value());
+    max.take_sample();
+    EXPECT_EQ(0, max.value());
+}
+
+TEST(WindowSamplerTest, background) {
+    per_second<int_counter> qps(5);
+    auto start = std::chrono::steady_clock::now();
+    while (qps.value() == 0 &&
+           std::chrono::steady_clock::now() - start < std::chrono::seconds(10)) {
+        qps.source()->inc(100);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_GT(qps.value(), 0);
+}
+
+}  // namespace metrics
+}  // namespace abel
@@ -0,0 +1,32 @@
+//
+
+#include <cstdio>
+#include <cstring>
+#include <exception>
+
+#include "abel/log/details/mmap_ring.h"
+
+// Prints the messages kept in a mmap_ring_sink file, oldest first.
+//
+//   log_ring_dump [-s] <file>
+//
+// -s prefixes each message with its sequence number.
+int main(int argc, char **argv) {
+    bool with_seq = argc == 3 && std::strcmp(argv[1], "-s") == 0;
+    if (argc != (with_seq ? 3 : 2)) {
+        std::fprintf(stderr, "usage: %s [-s] <file>\n", argv[0]);
+        return 1;
+    }
+    try {
+        abel::details::mmap_ring::read(argv[argc - 1], [&](uint64_t seq, std::string_view msg) {
+            if (with_seq) {
+                std::printf("%llu ", static_cast<unsigned long long>(seq));
+            }
+            std::fwrite(msg.data(), 1, msg.size(), stdout);
+        });
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}